@@ -6,6 +6,7 @@
 #define DECODERCONFIGURATION_H
 #include "DecoderConfiguration_fwd.h"
 #include <Codecs/DataSource.h>
+#include <Common/ThreadOptions.h>
 
 namespace QuickFAST{
   namespace Application{
@@ -55,6 +56,9 @@ namespace QuickFAST{
         , packetHeaderBigEndian_(true)
         , packetHeaderPrefixCount_(0)
         , packetHeaderSuffixCount_(0)
+        , packetHeaderHasSequence_(false)
+        , packetHeaderSequencePosition_(0)
+        , packetHeaderSequenceBytes_(4)
         , messageHeaderType_(NO_HEADER)
         , messageHeaderMessageSizeBytes_(0)
         , messageHeaderBigEndian_(true)
@@ -65,12 +69,19 @@ namespace QuickFAST{
         , receiverType_(UNSPECIFIED_RECEIVER)
         , multicastGroupIP_("224.1.2.133")
         , portNumber_(13014)
+        , portNumberB_(0)
         , listenInterfaceIP_("0.0.0.0")
         , bufferSize_(1400)
         , bufferCount_(2)
         , nonstandard_(0)
         , privateIOService_(false)
         , testSkip_(0)
+        , mappedFileChunkSize_(0)
+        , mappedFilePrefetch_(0)
+        , mappedFileHugePages_(false)
+        , asynchFileDirect_(false)
+        , pipelineCapacity_(0)
+        , pipelineDiscard_(false)
       {
       }
 
@@ -94,6 +105,9 @@ namespace QuickFAST{
         , packetHeaderBigEndian_(rhs.packetHeaderBigEndian_)
         , packetHeaderPrefixCount_(rhs.packetHeaderPrefixCount_)
         , packetHeaderSuffixCount_(rhs.packetHeaderSuffixCount_)
+        , packetHeaderHasSequence_(rhs.packetHeaderHasSequence_)
+        , packetHeaderSequencePosition_(rhs.packetHeaderSequencePosition_)
+        , packetHeaderSequenceBytes_(rhs.packetHeaderSequenceBytes_)
         , messageHeaderType_(rhs.messageHeaderType_)
         , messageHeaderMessageSizeBytes_(rhs.messageHeaderMessageSizeBytes_)
         , messageHeaderBigEndian_(rhs.messageHeaderBigEndian_)
@@ -104,6 +118,8 @@ namespace QuickFAST{
         , receiverType_(rhs.receiverType_)
         , multicastGroupIP_(rhs.multicastGroupIP_)
         , portNumber_(rhs.portNumber_)
+        , multicastGroupIPB_(rhs.multicastGroupIPB_)
+        , portNumberB_(rhs.portNumberB_)
         , listenInterfaceIP_(rhs.listenInterfaceIP_)
         , hostName_(rhs.hostName_)
         , portName_(rhs.portName_)
@@ -112,6 +128,13 @@ namespace QuickFAST{
         , nonstandard_(rhs.nonstandard_)
         , privateIOService_(rhs.privateIOService_)
         , testSkip_(rhs.testSkip_)
+        , mappedFileChunkSize_(rhs.mappedFileChunkSize_)
+        , mappedFilePrefetch_(rhs.mappedFilePrefetch_)
+        , mappedFileHugePages_(rhs.mappedFileHugePages_)
+        , asynchFileDirect_(rhs.asynchFileDirect_)
+        , pipelineCapacity_(rhs.pipelineCapacity_)
+        , pipelineDiscard_(rhs.pipelineDiscard_)
+        , threadOptions_(rhs.threadOptions_)
         , extras_(rhs.extras_)
       {
       }
@@ -225,6 +248,24 @@ namespace QuickFAST{
         return packetHeaderSuffixCount_;
       }
 
+      /// @brief Does the packet header carry a sequence number?
+      bool packetHeaderHasSequence()const
+      {
+        return packetHeaderHasSequence_;
+      }
+
+      /// @brief For FIXED_HEADER byte offset of the sequence number; for FAST_HEADER index of the prefix field
+      size_t packetHeaderSequencePosition()const
+      {
+        return packetHeaderSequencePosition_;
+      }
+
+      /// @brief For FIXED_HEADER the size of the sequence number in bytes
+      size_t packetHeaderSequenceBytes()const
+      {
+        return packetHeaderSequenceBytes_;
+      }
+
       /// @brief What type of header is expected for each message.
       HeaderType messageHeaderType()const
       {
@@ -286,6 +327,18 @@ namespace QuickFAST{
         return portNumber_;
       }
 
+      /// @brief For MulticastReceiver the group carrying a duplicate (B) feed.  Empty if none.
+      const std::string & multicastGroupIPB()const
+      {
+        return multicastGroupIPB_;
+      }
+
+      /// @brief For MulticastReceiver the port number of the B feed
+      unsigned short portNumberB()const
+      {
+        return portNumberB_ != 0 ? portNumberB_ : portNumber_;
+      }
+
       /// @brief For MulticastReceiver selects the NIC on which to subscribe/listen
       const std::string & listenInterfaceIP()const
       {
@@ -349,6 +402,52 @@ namespace QuickFAST{
         return testSkip_;
       }
 
+      /// @brief For BUFFERED_RAWFILE_RECEIVER: how much of the file each buffer covers.
+      ///
+      /// Zero uses MappedFileReceiver::defaultChunkSize.
+      size_t mappedFileChunkSize()const
+      {
+        return mappedFileChunkSize_;
+      }
+
+      /// @brief For BUFFERED_RAWFILE_RECEIVER: how far ahead to ask for the file to be read.
+      ///
+      /// Zero lets the operating system decide.
+      size_t mappedFilePrefetch()const
+      {
+        return mappedFilePrefetch_;
+      }
+
+      /// @brief For BUFFERED_RAWFILE_RECEIVER: should the mapped file use huge pages?
+      bool mappedFileHugePages()const
+      {
+        return mappedFileHugePages_;
+      }
+
+      /// @brief For ASYNCHRONOUS_FILE_RECEIVER: should reads bypass the system's file cache?
+      bool asynchFileDirect()const
+      {
+        return asynchFileDirect_;
+      }
+
+      /// @brief How many decoded messages may wait for the builder's thread.  Zero means no pipeline.
+      size_t pipelineCapacity()const
+      {
+        return pipelineCapacity_;
+      }
+
+      /// @brief Should the pipeline drop messages rather than hold up decoding?
+      bool pipelineDiscard()const
+      {
+        return pipelineDiscard_;
+      }
+
+      /// @brief Placement of the threads that service the receiver.
+      const ThreadOptionsList & threadOptions()const
+      {
+        return threadOptions_;
+      }
+
       /// @brief Process the first "head" messages then stop.
       void setHead(size_t head)
       {
@@ -505,6 +604,16 @@ namespace QuickFAST{
         packetHeaderSuffixCount_ = headerSuffixCount;
 
       }
+
+      /// @brief Find a sequence number in the packet header's prefix.
+      /// @param position for FIXED_HEADER is the byte offset; for FAST_HEADER the field index
+      /// @param bytes for FIXED_HEADER is the size of the sequence number
+      void setPacketHeaderSequence(size_t position, size_t bytes = 4)
+      {
+        packetHeaderHasSequence_ = true;
+        packetHeaderSequencePosition_ = position;
+        packetHeaderSequenceBytes_ = bytes;
+      }
       /// @brief What type of header is expected for each message.
       void setMessageHeaderType(HeaderType headerType)
       {
@@ -568,6 +677,21 @@ namespace QuickFAST{
         portNumber_ = portNumber;
       }
 
+      /// @brief For MulticastReceiver the group carrying a duplicate (B) feed
+      ///
+      /// The A and B packets are arbitrated by packet sequence number, so the
+      /// packet header must carry one.  @see setPacketHeaderSequence()
+      void setMulticastGroupIPB(const std::string & multicastGroupIP)
+      {
+        multicastGroupIPB_ = multicastGroupIP;
+      }
+
+      /// @brief For MulticastReceiver the port number of the B feed.  Zero means the same as the A feed.
+      void setPortNumberB(unsigned short portNumber)
+      {
+        portNumberB_ = portNumber;
+      }
+
       /// @brief For MulticastReceiver selects the NIC on which to subscribe/listen
       void setListenInterfaceIP(const std::string & listenInterfaceIP)
       {
@@ -633,6 +757,65 @@ namespace QuickFAST{
         testSkip_ = testSkip;
       }
 
+      /// @brief Set how much of a memory mapped FAST file each buffer covers.
+      /// @param bytes per buffer. Zero restores the default.
+      void setMappedFileChunkSize(size_t bytes)
+      {
+        mappedFileChunkSize_ = bytes;
+      }
+
+      /// @brief Set the read-ahead distance for a memory mapped FAST file.
+      /// @param bytes beyond the data being decoded to request in advance.
+      void setMappedFilePrefetch(size_t bytes)
+      {
+        mappedFilePrefetch_ = bytes;
+      }
+
+      /// @brief Request huge pages for a memory mapped FAST file.
+      ///
+      /// This is only a hint.  It is ignored where the system cannot honor it.
+      void setMappedFileHugePages(bool hugePages)
+      {
+        mappedFileHugePages_ = hugePages;
+      }
+
+      /// @brief Read an asynchronous FAST file straight from the device.
+      ///
+      /// Worthwhile for files much larger than memory that will be read once.
+      /// Only honored on Linux (O_DIRECT).  On Windows use the
+      /// INPUT_ATTRIBUTES extra to pass FILE_FLAG_NO_BUFFERING instead.
+      void setAsynchFileDirect(bool direct)
+      {
+        asynchFileDirect_ = direct;
+      }
+
+      /// @brief Call the builder from its own thread.
+      ///
+      /// Decoded messages are handed to that thread through a ring that holds
+      /// this many of them.  See Messages::PipelinedMessageBuilder.
+      /// @param capacity is the size of the ring.  Zero calls the builder
+      ///        directly from the decoding thread.
+      void setPipelineCapacity(size_t capacity)
+      {
+        pipelineCapacity_ = capacity;
+      }
+
+      /// @brief Choose what happens when the pipeline is full.
+      /// @param discard true to drop messages; false to wait for the builder.
+      void setPipelineDiscard(bool discard)
+      {
+        pipelineDiscard_ = discard;
+      }
+
+      /// @brief Describe the next thread that will service the receiver.
+      ///
+      /// Call once per thread, in the order the threads are started.
+      /// See Communication::Receiver::setThreadOptions().
+      void addThreadOptions(const ThreadOptions & options)
+      {
+        threadOptions_.push_back(options);
+      }
+
       /// @brief support application-defined configuration information: store name/value pair
       ///
       /// @param name is the name to be assigned a value
@@ -669,10 +852,19 @@ namespace QuickFAST{
         out << "  -vo filename         : Write verbose output to file" << std::endl;
         out << "                         (cout for standard out;" << std::endl;
         out << "                         cerr for standard error)." << std::endl;
+        out << "  -pipeline n          : Call the message builder from its own thread," << std::endl;
+        out << "                         with up to n decoded messages waiting for it." << std::endl;
+        out << "  -pipelinediscard     : With -pipeline, drop messages instead of waiting" << std::endl;
+        out << "                         when the builder falls n messages behind." << std::endl;
         out << std::endl;
         out << "  -file file           : Input from FAST message file." << std::endl;
         out << "  -afile file          : Use asynchronous reads from FAST message file." << std::endl;
-        out << "  -bfile file          : Buffer entire FAST message file in memory." << std::endl;
+        out << "                         (Windows overlapped I/O or Linux io_uring)." << std::endl;
+        out << "  -afiledirect         : With -afile on Linux, bypass the file cache (O_DIRECT)." << std::endl;
+        out << "  -bfile file          : Map the FAST message file into memory and decode it in place." << std::endl;
+        out << "  -bfilechunk bytes    : With -bfile, how much of the file each buffer covers. (default: 1MB)." << std::endl;
+        out << "  -bfileprefetch bytes : With -bfile, how far ahead to read. (default: system decides)." << std::endl;
+        out << "  -bfilehuge           : With -bfile, request huge pages for the mapping." << std::endl;
         out << "  -pcap file           : Input from PCap FAST message file." << std::endl;
         out << "  -pcapsource [64|32]    : Word size of the machine where the PCap data was captured." << std::endl;
         out << "                           Defaults to the current platform." << std::endl;
@@ -685,12 +877,22 @@ namespace QuickFAST{
         out << "                           on which to subscribe and listen." << std::endl;
         out << "                           0.0.0.0 means pick any NIC." << std::endl;
         out << "  -mbind ip            : Multicast bind address.  Defaults to listenIP. Override if you dare." << std::endl;
+        out << "  -multicastb ip[:port]" << std::endl;
+        out << "                       : With -multicast, also subscribe to a duplicate B feed." << std::endl;
+        out << "                         Each packet is decoded once, from whichever feed" << std::endl;
+        out << "                         delivers it first.  Requires -pseq." << std::endl;
         out << "  -tcp host:port       : Input from TCP/IP.  Connect to \"host\" name or" << std::endl;
         out << "                         dotted IP on named or numbered port." << std::endl;
         out << std::endl;
         out << "  -threads n           : Number of threads to service incoming messages." << std::endl;
         out << "                         Valid for multicast or tcp" << std::endl;
         out << "                         Must be >= 1.   Default is 1." << std::endl;
+        out << "  -threadopts cpus[:priority[:name]]" << std::endl;
+        out << "                       : Placement of the next service thread. Repeat once per thread;" << std::endl;
+        out << "                         the last one applies to any remaining threads." << std::endl;
+        out << "                         cpus: processor list such as 2 or 4-6,8 (* for any)." << std::endl;
+        out << "                         priority: SCHED_FIFO priority 1-99 (0 for normal)." << std::endl;
+        out << "                         name: thread name shown by debuggers and top." << std::endl;
         out << "  -privateioservice    : Create a separate I/O service for the receiver." << std::endl;
         out << "                         This doesn't do much for this program, but it helps with testing." << std::endl;
         out << "                         The option would be used when you need multiple independent connections in the" << std::endl;
@@ -728,6 +930,10 @@ namespace QuickFAST{
         out << "                         block size." << std::endl;
         out << "  -psuffix n           : 'n' bytes (fixed) or fields (FAST) follow" << std::endl;
         out << "                         block size." << std::endl;
+        out << "  -pseq n[:bytes]      : Packet sequence number is at byte offset 'n' (fixed)" << std::endl;
+        out << "                         or is prefix field 'n' (FAST).  It must precede" << std::endl;
+        out << "                         block size.  Fixed size defaults to 4 bytes." << std::endl;
+        out << "                         Gaps in the sequence are logged as warnings." << std::endl;
         out << std::endl;
         out << "  -buffersize size     : Size of communication buffers." << std::endl;
         out << "                         For \"-datagram\" largest expected message." << std::endl;
@@ -843,6 +1049,36 @@ namespace QuickFAST{
           setFastFileName(argv[1]);
           consumed = 2;
         }
+        else if(opt == "-bfilechunk" && argc > 1)
+        {
+          setMappedFileChunkSize(boost::lexical_cast<size_t>(argv[1]));
+          consumed = 2;
+        }
+        else if(opt == "-bfileprefetch" && argc > 1)
+        {
+          setMappedFilePrefetch(boost::lexical_cast<size_t>(argv[1]));
+          consumed = 2;
+        }
+        else if(opt == "-bfilehuge")
+        {
+          setMappedFileHugePages(true);
+          consumed = 1;
+        }
+        else if(opt == "-afiledirect")
+        {
+          setAsynchFileDirect(true);
+          consumed = 1;
+        }
+        else if(opt == "-pipeline" && argc > 1)
+        {
+          setPipelineCapacity(boost::lexical_cast<size_t>(argv[1]));
+          consumed = 2;
+        }
+        else if(opt == "-pipelinediscard")
+        {
+          setPipelineDiscard(true);
+          consumed = 1;
+        }
         else if(opt == "-pcap" && argc > 1)
         {
           setReceiverType(Application::DecoderConfiguration::PCAPFILE_RECEIVER);
@@ -886,6 +1122,18 @@ namespace QuickFAST{
           setMulticastBindIP(argv[1]);
           consumed = 2;
         }
+        else if(opt == "-multicastb" && argc > 1)
+        {
+          std::string address = argv[1];
+          std::string::size_type colon = address.find(':');
+          setMulticastGroupIPB(address.substr(0, colon));
+          if(colon != std::string::npos)
+          {
+            setPortNumberB(boost::lexical_cast<unsigned short>(
+              address.substr(colon+1)));
+          }
+          consumed = 2;
+        }
         else if(opt == "-tcp" && argc > 1)
         {
           setReceiverType(Application::DecoderConfiguration::TCP_RECEIVER);
@@ -991,6 +1239,18 @@ namespace QuickFAST{
           setPacketHeaderSuffixCount(boost::lexical_cast<size_t>(argv[1]));
           consumed = 2;
         }
+        else if(opt == "-pseq" && argc > 1)
+        {
+          std::string position = argv[1];
+          std::string::size_type colon = position.find(':');
+          size_t bytes = 4;
+          if(colon != std::string::npos)
+          {
+            bytes = boost::lexical_cast<size_t>(position.substr(colon+1));
+          }
+          setPacketHeaderSequence(boost::lexical_cast<size_t>(position.substr(0, colon)), bytes);
+          consumed = 2;
+        }
         else if(opt == "-pbig" ) //                 : fixed size header is big-endian" << std::endl;
         {
           setPacketHeaderBigEndian(true);
@@ -1014,6 +1274,11 @@ namespace QuickFAST{
           setPrivateIOService(true);
           consumed = 1;
         }
+        else if(opt == "-threadopts" && argc > 1)
+        {
+          addThreadOptions(ThreadOptions(argv[1]));
+          consumed = 2;
+        }
         else if(opt == "-testskip" && argc > 1)
         {
           setTestSkip(boost::lexical_cast<size_t>(argv[1]));
@@ -1078,6 +1343,12 @@ namespace QuickFAST{
       size_t packetHeaderPrefixCount_;
       /// @brief For FIXED_HEADER byte count after size; for FAST_HEADER field count after size
       size_t packetHeaderSuffixCount_;
+      /// @brief Does the packet header prefix carry a sequence number?
+      bool packetHeaderHasSequence_;
+      /// @brief For FIXED_HEADER byte offset of the sequence number; for FAST_HEADER the prefix field
+      size_t packetHeaderSequencePosition_;
+      /// @brief For FIXED_HEADER the size of the sequence number in bytes
+      size_t packetHeaderSequenceBytes_;
 
       /// @brief What type of header is expected for each message
       HeaderType messageHeaderType_;
@@ -1104,6 +1375,10 @@ namespace QuickFAST{
       std::string multicastGroupIP_;
       /// @brief For MulticastRecevier the port number of the multicast group
       unsigned short portNumber_;
+      /// @brief For MulticastReceiver the group carrying a duplicate (B) feed
+      std::string multicastGroupIPB_;
+      /// @brief For MulticastReceiver the port number of the B feed (0: same as portNumber_)
+      unsigned short portNumberB_;
       /// @brief For MulticastReceiver selects the NIC on which to subscribe/listen
       std::string listenInterfaceIP_;
       /// @brief For MulticastReceiver the IP to which the socket will be bound
@@ -1132,6 +1407,22 @@ namespace QuickFAST{
 
       size_t testSkip_;
 
+      /// @brief For BUFFERED_RAWFILE_RECEIVER, bytes per buffer (0 means the receiver's default)
+      size_t mappedFileChunkSize_;
+      /// @brief For BUFFERED_RAWFILE_RECEIVER, read-ahead distance in bytes (0 means system default)
+      size_t mappedFilePrefetch_;
+      /// @brief For BUFFERED_RAWFILE_RECEIVER, request huge pages
+      bool mappedFileHugePages_;
+      /// @brief For ASYNCHRONOUS_FILE_RECEIVER, open the file for direct I/O
+      bool asynchFileDirect_;
+      /// @brief Decoded messages that may wait for the builder's thread (0: no pipeline)
+      size_t pipelineCapacity_;
+      /// @brief Drop messages when the pipeline is full
+      bool pipelineDiscard_;
+
+      /// @brief Placement of the threads that service the receiver.
+      ThreadOptionsList threadOptions_;
+
       typedef std::map<std::string, std::string> NameValuePairs;
       NameValuePairs extras_;
     };
@@ -7,6 +7,7 @@
 #include <Application/DecoderConfiguration_fwd.h>
 #include <Codecs/XMLTemplateParser.h>
 #include <Codecs/MessagePerPacketAssembler.h>
+#include <Codecs/ArbitratingAssembler.h>
 #include <Codecs/StreamingAssembler.h>
 #include <Codecs/NoHeaderAnalyzer.h>
 #include <Codecs/FixedSizeHeaderAnalyzer.h>
@@ -19,6 +20,7 @@
 #include <Communication/RawFileReceiver.h>
 #include <Communication/BufferedRawFileReceiver.h>
 #include <Communication/PCapFileReceiver.h>
+#include <Communication/MappedFileReceiver.h>
 #include <Communication/AsynchFileReceiver.h>
 #include <Communication/BufferReceiver.h>
 #include <Communication/AsioService.h>
@@ -66,10 +68,30 @@ DecoderConnection::setTemplateRegistry(Codecs::TemplateRegistryPtr registry)
 
 void
 DecoderConnection::configure(
-  Messages::ValueMessageBuilder & builder,
+  Messages::ValueMessageBuilder & applicationBuilder,
   Application::DecoderConfiguration &configuration)
 {
-  if(!configuration.asynchReads() && !configuration.fastFileName().empty())
+  if(configuration.pipelineCapacity() != 0)
+  {
+    pipeline_.reset(new Messages::PipelinedMessageBuilder(
+      applicationBuilder,
+      configuration.pipelineCapacity(),
+      configuration.pipelineDiscard()
+        ? Messages::PipelinedMessageBuilder::DISCARD
+        : Messages::PipelinedMessageBuilder::WAIT));
+    pipeline_->start();
+  }
+  // The decoder feeds the pipeline, if there is one.
+  Messages::ValueMessageBuilder & builder = pipeline_
+    ? static_cast<Messages::ValueMessageBuilder &>(*pipeline_)
+    : applicationBuilder;
+
+  // A file decoded in place is mapped by its receiver rather than read through a stream.
+  bool mapped = configuration.receiverType() == Application::DecoderConfiguration::BUFFERED_RAWFILE_RECEIVER;
+#ifndef _WIN32
+  mapped = mapped && configuration.fastFileName() != "cin";
+#endif
+  if(!configuration.asynchReads() && !mapped && !configuration.fastFileName().empty())
   {
 #ifndef _WIN32
     // on Windows cin is opened in ascii mode which garbles FAST data
@@ -187,15 +209,26 @@ DecoderConnection::configure(
         configuration.packetHeaderPrefixCount(),
         configuration.packetHeaderSuffixCount());
       fixedSizeHeaderAnalyzer->setTestSkip(configuration.testSkip());
+      if(configuration.packetHeaderHasSequence())
+      {
+        fixedSizeHeaderAnalyzer->setSequenceNumber(
+          configuration.packetHeaderSequencePosition(),
+          configuration.packetHeaderSequenceBytes());
+      }
       packetHeaderAnalyzer_.reset(fixedSizeHeaderAnalyzer);
       break;
     }
   case Application::DecoderConfiguration::FAST_HEADER:
     {
-      packetHeaderAnalyzer_.reset(new Codecs::FastEncodedHeaderAnalyzer(
+      Codecs::FastEncodedHeaderAnalyzer * fastHeaderAnalyzer = new Codecs::FastEncodedHeaderAnalyzer(
         configuration.packetHeaderPrefixCount(),
         configuration.packetHeaderSuffixCount(),
-        configuration.packetHeaderMessageSizeBytes() != 0)); // true if header contains message size
+        configuration.packetHeaderMessageSizeBytes() != 0); // true if header contains message size
+      if(configuration.packetHeaderHasSequence())
+      {
+        fastHeaderAnalyzer->setSequenceNumberField(configuration.packetHeaderSequencePosition());
+      }
+      packetHeaderAnalyzer_.reset(fastHeaderAnalyzer);
       break;
     }
   }
@@ -230,7 +263,32 @@ DecoderConnection::configure(
     }
   }
 
-  switch(configuration.assemblerType())
+  bool hasFeedB = configuration.receiverType() == Application::DecoderConfiguration::MULTICAST_RECEIVER
+    && !configuration.multicastGroupIPB().empty();
+  if(hasFeedB)
+  {
+    if(configuration.assemblerType() == Application::DecoderConfiguration::STREAMING_ASSEMBLER)
+    {
+      throw std::invalid_argument("DecoderConnection: A and B feeds can only be arbitrated one packet at a time.");
+    }
+    if(!configuration.packetHeaderHasSequence())
+    {
+      throw std::invalid_argument("DecoderConnection: A and B feeds need a sequence number in the packet header.");
+    }
+    Codecs::ArbitratingAssembler * pAssembler = new Codecs::ArbitratingAssembler(
+      registry_,
+      *packetHeaderAnalyzer_,
+      *messageHeaderAnalyzer_,
+      builder);
+    assembler_.reset(pAssembler);
+    pAssembler->setEcho(
+      *echoFile_,
+      static_cast<Codecs::DataSource::EchoType>(configuration.echoType()),
+      configuration.echoMessage(),
+      configuration.echoField());
+    pAssembler->setMessageLimit(configuration.head());
+  }
+  else switch(configuration.assemblerType())
   {
   case Application::DecoderConfiguration::MESSAGE_PER_PACKET_ASSEMBLER:
     {
@@ -332,6 +390,15 @@ DecoderConnection::configure(
           configuration.listenInterfaceIP(),
           configuration.multicastBindIP(),
           configuration.portNumber()));
+        if(hasFeedB)
+        {
+          receiverB_.reset(new Communication::MulticastReceiver(
+            *ioService_,
+            configuration.multicastGroupIPB(),
+            configuration.listenInterfaceIP(),
+            configuration.multicastBindIP(),
+            configuration.portNumberB()));
+        }
       }
       else
       {
@@ -340,6 +407,15 @@ DecoderConnection::configure(
           configuration.listenInterfaceIP(),
           configuration.multicastBindIP(),
           configuration.portNumber()));
+        if(hasFeedB)
+        {
+          // Both feeds share the default I/O service, so running one runs both.
+          receiverB_.reset(new Communication::MulticastReceiver(
+            configuration.multicastGroupIPB(),
+            configuration.listenInterfaceIP(),
+            configuration.multicastBindIP(),
+            configuration.portNumberB()));
+        }
       }
       break;
     }
@@ -369,8 +445,20 @@ DecoderConnection::configure(
     }
   case Application::DecoderConfiguration::BUFFERED_RAWFILE_RECEIVER:
     {
-      receiver_.reset(new Communication::BufferedRawFileReceiver(
-        *fastFile_));
+      if(fastFile_ == &std::cin)
+      {
+        // a pipe can't be mapped, so read it all.
+        receiver_.reset(new Communication::BufferedRawFileReceiver(
+          *fastFile_));
+      }
+      else
+      {
+        receiver_.reset(new Communication::MappedFileReceiver(
+          configuration.fastFileName(),
+          configuration.mappedFileChunkSize(),
+          configuration.mappedFilePrefetch(),
+          configuration.mappedFileHugePages()));
+      }
       break;
     }
   case Application::DecoderConfiguration::PCAPFILE_RECEIVER:
@@ -396,6 +484,12 @@ DecoderConnection::configure(
       {
         ; // for now ignore this
       }
+#if defined(QUICKFAST_HAS_IO_URING)
+      if(configuration.asynchFileDirect())
+      {
+        attributes |= O_DIRECT;
+      }
+#endif // QUICKFAST_HAS_IO_URING
 
       receiver_.reset(new Communication::AsynchFileReceiver(
         configuration.fastFileName(),
@@ -415,7 +509,13 @@ DecoderConnection::configure(
     }
   }
 
+  receiver_->setThreadOptions(configuration.threadOptions());
   receiver_->start(*assembler_, configuration.bufferSize(), configuration.bufferCount());
+  if(receiverB_)
+  {
+    receiverB_->setThreadOptions(configuration.threadOptions());
+    receiverB_->start(*assembler_, configuration.bufferSize(), configuration.bufferCount());
+  }
 
 }
 
@@ -6,6 +6,7 @@
 #define DECODERCONNECTION_H
 #include <Common/QuickFAST_Export.h>
 #include <Messages/ValueMessageBuilder.h>
+#include <Messages/PipelinedMessageBuilder.h>
 
 #include <Common/Exceptions.h>
 #include <Codecs/TemplateRegistry_fwd.h>
@@ -32,6 +33,9 @@ namespace QuickFAST{
       void setTemplateRegistry(Codecs::TemplateRegistryPtr registry);
 
       /// @brief Configure the connection for use
+      ///
+      /// If the configuration asks for a pipeline, the builder is called from
+      /// a separate consumer thread rather than from the decoding thread.
       /// @param builder accepts the decoded fields
       /// @param configuration contains configuration parameters
       void configure(Messages::ValueMessageBuilder & builder, Application::DecoderConfiguration &configuration);
@@ -46,6 +50,7 @@ namespace QuickFAST{
       void run()
       {
         receiver_->run();
+        flushPipeline();
       }
 
       /// @brief run the event loop until one event is handled.
@@ -70,6 +75,10 @@ namespace QuickFAST{
       void runThreads(size_t threadCount = 0, bool useThisThread = true)
       {
         receiver_->runThreads(threadCount, useThisThread);
+        if(useThisThread)
+        {
+          flushPipeline();
+        }
       }
 
       /// @brief join all additional threads after calling stopService()
@@ -78,6 +87,7 @@ namespace QuickFAST{
       void joinThreads()
       {
         receiver_->joinThreads();
+        flushPipeline();
       }
 
       /// @brief Reuse AsioService after calling stop and joinThreads
@@ -157,9 +167,36 @@ namespace QuickFAST{
         return *receiver_;
       }
 
+      /// @brief Access the receiver for the duplicate (B) multicast feed.
+      ///
+      /// It shares the A feed's I/O service, so the calls forwarded to
+      /// receiver() run and stop both.
+      /// @returns zero unless the configuration named a B feed.
+      Communication::Receiver * receiverB()const
+      {
+        return receiverB_.get();
+      }
+
       /// @brief Access the decoder.
       Codecs::Decoder & decoder() const;
 
+      /// @brief The pipeline between the decoder and the builder, for its statistics.
+      /// @returns zero unless the configuration asked for a pipeline.
+      const Messages::PipelinedMessageBuilder * pipeline()const
+      {
+        return pipeline_.get();
+      }
+
+    private:
+      /// Wait for the builder to see every message decoded so far.
+      void flushPipeline()
+      {
+        if(pipeline_)
+        {
+          pipeline_->flush();
+        }
+      }
+
     private:
       std::istream * fastFile_;
       std::ostream * echoFile_;
@@ -171,8 +208,11 @@ namespace QuickFAST{
       boost::scoped_ptr<boost::asio::io_service> ioService_;
       boost::scoped_ptr<Codecs::HeaderAnalyzer> packetHeaderAnalyzer_;
       boost::scoped_ptr<Codecs::HeaderAnalyzer> messageHeaderAnalyzer_;
+      // declared ahead of the assembler so decoding stops before the pipeline does.
+      boost::scoped_ptr<Messages::PipelinedMessageBuilder> pipeline_;
       boost::scoped_ptr<Communication::Assembler> assembler_;
       boost::scoped_ptr<Communication::Receiver> receiver_;
+      boost::scoped_ptr<Communication::Receiver> receiverB_;
 
     };
   }
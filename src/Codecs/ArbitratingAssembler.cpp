@@ -0,0 +1,198 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#include <Common/QuickFASTPch.h>
+#include "ArbitratingAssembler.h"
+#include <Communication/Receiver.h>
+#include <Communication/LinkedBuffer.h>
+#include <Codecs/DataSourceBuffer.h>
+
+using namespace QuickFAST;
+using namespace Codecs;
+
+const uint64 ArbitratingAssembler::defaultRestartWindow;
+
+ArbitratingAssembler::ArbitratingAssembler(
+      TemplateRegistryPtr templateRegistry,
+      HeaderAnalyzer & packetHeaderAnalyzer,
+      HeaderAnalyzer & messageHeaderAnalyzer,
+      Messages::ValueMessageBuilder & builder)
+  : MessagePerPacketAssembler(templateRegistry, packetHeaderAnalyzer, messageHeaderAnalyzer, builder)
+  , packetHeaderAnalyzer_(packetHeaderAnalyzer)
+  , started_(false)
+  , highest_(0)
+  , restartWindow_(defaultRestartWindow)
+  , beforeRestart_(0)
+  , active_(0)
+  , accepted_(0)
+  , duplicates_(0)
+  , gaps_(0)
+  , missing_(0)
+  , restarts_(0)
+  , unsequenced_(0)
+{
+}
+
+ArbitratingAssembler::~ArbitratingAssembler()
+{
+}
+
+void
+ArbitratingAssembler::restartSequence()
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  started_ = false;
+  beforeRestart_ = 0;
+}
+
+void
+ArbitratingAssembler::receiverStarted(Communication::Receiver & receiver)
+{
+  bool first = false;
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    (void)feedIndex(receiver);
+    first = (active_++ == 0);
+  }
+  // The feeds share one decoder, so it starts with the first of them.
+  if(first)
+  {
+    MessagePerPacketAssembler::receiverStarted(receiver);
+  }
+}
+
+void
+ArbitratingAssembler::receiverStopped(Communication::Receiver & receiver)
+{
+  bool last = false;
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    if(active_ > 0)
+    {
+      last = (--active_ == 0);
+    }
+  }
+  if(last)
+  {
+    MessagePerPacketAssembler::receiverStopped(receiver);
+  }
+}
+
+bool
+ArbitratingAssembler::serviceQueue(Communication::Receiver & receiver)
+{
+  bool result = true;
+  Communication::LinkedBuffer * buffer = receiver.getBuffer(false);
+  while(result && buffer != 0)
+  {
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      try
+      {
+        if(arbitrate(receiver, *buffer, result))
+        {
+          result = consumeBuffer(buffer->get(), buffer->used(), buffer->receiveTime()) && result;
+        }
+      }
+      catch(const std::exception &ex)
+      {
+        result = reportDecodingError(ex.what());
+        reset();
+      }
+    }
+    receiver.releaseBuffer(buffer);
+    buffer = 0;
+    if(result)
+    {
+      buffer = receiver.getBuffer(false);
+    }
+  }
+  return result;
+}
+
+bool
+ArbitratingAssembler::arbitrate(
+  Communication::Receiver & receiver,
+  const Communication::LinkedBuffer & buffer,
+  bool & result)
+{
+  // Peek at the header; consumeBuffer analyzes it again when it decodes the packet.
+  DataSourceBuffer source(buffer.get(), buffer.used());
+  size_t blockSize = 0;
+  bool skip = false;
+  uint64 sequence = 0;
+  if(!packetHeaderAnalyzer_.analyzeHeader(source, blockSize, skip)
+    || !packetHeaderAnalyzer_.getSequenceNumber(sequence))
+  {
+    packetHeaderAnalyzer_.reset();
+    ++unsequenced_;
+    return true;
+  }
+
+  if(started_ && sequence < highest_ && highest_ - sequence > restartWindow_)
+  {
+    // Too old to be a late copy: the publisher has started over.
+    ++restarts_;
+    logSequence("Sequence restart", sequence, result);
+    beforeRestart_ = highest_;
+    started_ = false;
+    // so do the publisher's dictionaries
+    decoder_.reset();
+  }
+  else if(started_ && sequence > highest_ + restartWindow_ && sequence <= beforeRestart_)
+  {
+    // a slower feed still delivering packets sent before the restart
+    ++duplicates_;
+    return false;
+  }
+
+  if(started_ && sequence <= highest_)
+  {
+    ++duplicates_;
+    return false;
+  }
+  if(started_ && sequence > highest_ + 1)
+  {
+    uint64 skipped = sequence - highest_ - 1;
+    ++gaps_;
+    missing_ += skipped;
+    logSequence("Sequence gap", sequence, result);
+  }
+  started_ = true;
+  highest_ = sequence;
+  ++accepted_;
+  ++firstArrivals_[feedIndex(receiver)];
+  return true;
+}
+
+size_t
+ArbitratingAssembler::feedIndex(Communication::Receiver & receiver)
+{
+  for(size_t nFeed = 0; nFeed < feeds_.size(); ++nFeed)
+  {
+    if(feeds_[nFeed] == &receiver)
+    {
+      return nFeed;
+    }
+  }
+  feeds_.push_back(&receiver);
+  firstArrivals_.push_back(0);
+  return feeds_.size() - 1;
+}
+
+void
+ArbitratingAssembler::logSequence(const char * event, uint64 sequence, bool & result)
+{
+  if(wantLog(Common::Logger::QF_LOG_WARNING))
+  {
+    std::stringstream message;
+    message << event << ": expecting " << highest_ + 1
+      << " received " << sequence;
+    if(sequence > highest_ + 1)
+    {
+      message << " (" << sequence - highest_ - 1 << " missing)";
+    }
+    result = logMessage(Common::Logger::QF_LOG_WARNING, message.str());
+  }
+}
@@ -0,0 +1,169 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifndef ARBITRATINGASSEMBLER_H
+#define ARBITRATINGASSEMBLER_H
+
+#include "ArbitratingAssembler_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Codecs/MessagePerPacketAssembler.h>
+#include <Communication/LinkedBuffer_fwd.h>
+
+namespace QuickFAST
+{
+  namespace Codecs
+  {
+    /// @brief Decode one stream from redundant feeds, such as an exchange's A and B multicast lines.
+    ///
+    /// Every receiver started with this assembler is treated as a copy of
+    /// the same packet stream.  The packet header analyzer must report a
+    /// sequence number (see HeaderAnalyzer::getSequenceNumber).  A packet is
+    /// decoded only if its sequence number is higher than any seen so far,
+    /// so whichever feed delivers a packet first wins and the other copy is
+    /// dropped without being decoded.
+    ///
+    /// When the accepted sequence jumps forward the skipped packets are
+    /// counted as missing and a warning is logged.  A packet that turns up
+    /// after a later one has been accepted is dropped as well: decoding it
+    /// out of order would corrupt the dictionary.
+    ///
+    /// A sequence number more than the restart window below the highest
+    /// one accepted is too old to be a late copy.  It is taken to mean the
+    /// publisher started over (after a restart or a daily reset): a warning
+    /// is logged, the decoder is reset, and the sequence is followed from
+    /// there.  Until the new sequence catches up, packets from before the
+    /// restart that a slower feed delivers late are dropped as duplicates.
+    ///
+    /// Packets whose header yields no sequence number are decoded as they
+    /// come and counted by unsequenced().
+    ///
+    /// The receivers may run on different threads; decoding is serialized
+    /// so the builder sees one message at a time.
+    class QuickFAST_Export ArbitratingAssembler
+      : public MessagePerPacketAssembler
+    {
+    public:
+      /// @brief Constuct the Assembler
+      /// @param templateRegistry defines the decoding instructions for the decoder
+      /// @param packetHeaderAnalyzer analyzes the header of each packet and supplies its sequence number
+      /// @param messageHeaderAnalyzer analyzes the header of each message (if any)
+      /// @param builder receives the data from the decoder.
+      ArbitratingAssembler(
+          TemplateRegistryPtr templateRegistry,
+          HeaderAnalyzer & packetHeaderAnalyzer,
+          HeaderAnalyzer & messageHeaderAnalyzer,
+          Messages::ValueMessageBuilder & builder);
+
+      virtual ~ArbitratingAssembler();
+
+      /// @brief Accept the next sequenced packet whatever its number.
+      ///
+      /// Use this when the publisher is known to have started its sequence
+      /// over but the restart is too small to be detected.
+      void restartSequence();
+
+      /// @brief How far back must a sequence number go to be taken as a restart?
+      /// @param window the largest backward step that is still just a late copy.
+      ///        Make it larger than the most packets one feed can lag the other.
+      void setRestartWindow(uint64 window)
+      {
+        restartWindow_ = window;
+      }
+
+      /// @brief The restart window used unless setRestartWindow() is called.
+      static const uint64 defaultRestartWindow = 1000;
+
+      /// @brief Statistic: How many sequenced packets were decoded?
+      size_t accepted()const
+      {
+        return accepted_;
+      }
+
+      /// @brief Statistic: How many packets were dropped because a copy, or a later packet, came first?
+      size_t duplicates()const
+      {
+        return duplicates_;
+      }
+
+      /// @brief Statistic: How many times did the sequence skip forward?
+      size_t gaps()const
+      {
+        return gaps_;
+      }
+
+      /// @brief Statistic: How many sequence numbers were skipped in all?
+      uint64 missing()const
+      {
+        return missing_;
+      }
+
+      /// @brief Statistic: How many times did the publisher start its sequence over?
+      size_t restarts()const
+      {
+        return restarts_;
+      }
+
+      /// @brief Statistic: How many packets had no sequence number?
+      size_t unsequenced()const
+      {
+        return unsequenced_;
+      }
+
+      /// @brief How many receivers have been started with this assembler?
+      size_t feedCount()const
+      {
+        return feeds_.size();
+      }
+
+      /// @brief Statistic: How many accepted packets came from one feed?
+      ///
+      /// Comparing the feeds shows which line is usually faster.
+      /// @param feed counts from zero in the order the receivers were started.
+      size_t firstArrivals(size_t feed)const
+      {
+        return feed < firstArrivals_.size() ? firstArrivals_[feed] : 0;
+      }
+
+      ///////////////////////////
+      // Implement Assembler
+      virtual void receiverStarted(Communication::Receiver & receiver);
+      virtual void receiverStopped(Communication::Receiver & receiver);
+      virtual bool serviceQueue(Communication::Receiver & receiver);
+
+    private:
+      ArbitratingAssembler & operator = (const ArbitratingAssembler &);
+      ArbitratingAssembler(const ArbitratingAssembler &);
+      ArbitratingAssembler();
+
+      /// Decide whether a packet should be decoded.
+      bool arbitrate(Communication::Receiver & receiver, const Communication::LinkedBuffer & buffer, bool & result);
+      size_t feedIndex(Communication::Receiver & receiver);
+      void logSequence(const char * event, uint64 sequence, bool & result);
+
+    private:
+      HeaderAnalyzer & packetHeaderAnalyzer_;
+
+      boost::mutex mutex_;
+      // The rest are protected by mutex_
+      bool started_;
+      uint64 highest_;
+      uint64 restartWindow_;
+      /// The highest sequence accepted before the last restart; zero if none.
+      uint64 beforeRestart_;
+      /// Receivers started and not yet stopped.
+      size_t active_;
+
+      std::vector<Communication::Receiver *> feeds_;
+      std::vector<size_t> firstArrivals_;
+
+      size_t accepted_;
+      size_t duplicates_;
+      size_t gaps_;
+      uint64 missing_;
+      size_t restarts_;
+      size_t unsequenced_;
+    };
+  }
+}
+#endif // ARBITRATINGASSEMBLER_H
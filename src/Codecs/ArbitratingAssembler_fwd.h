@@ -0,0 +1,18 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifndef ARBITRATINGASSEMBLER_FWD_H
+#define ARBITRATINGASSEMBLER_FWD_H
+
+namespace QuickFAST
+{
+  namespace Codecs
+  {
+    class ArbitratingAssembler;
+
+    ///@brief smart pointer to ArbitratingAssembler
+    typedef boost::shared_ptr<ArbitratingAssembler> ArbitratingAssemblerPtr;
+  }
+}
+#endif // ARBITRATINGASSEMBLER_FWD_H
@@ -0,0 +1,245 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "ChannelGroup.h"
+#include <Codecs/MessagePerPacketAssembler.h>
+#include <Common/Exceptions.h>
+
+using namespace QuickFAST;
+using namespace Codecs;
+
+ChannelGroup::ChannelGroup(size_t workerCount)
+: workers_(workerCount == 0 ? 1 : workerCount)
+, bufferSize_(1400)
+, bufferCount_(2)
+, started_(false)
+{
+  for(size_t nWorker = 0; nWorker < workers_.size(); ++nWorker)
+  {
+    Worker & worker = workers_[nWorker];
+    worker.ioService_.reset(new boost::asio::io_service);
+    worker.service_.reset(new Communication::AsioService(*worker.ioService_));
+  }
+}
+
+ChannelGroup::~ChannelGroup()
+{
+  if(started_)
+  {
+    stop();
+    joinThreads();
+  }
+}
+
+size_t
+ChannelGroup::addChannel(
+  const std::string & name,
+  TemplateRegistryPtr templateRegistry,
+  const std::string & multicastGroupIP,
+  const std::string & listenAddressIP,
+  const std::string & bindIP,
+  unsigned short portNumber,
+  Messages::ValueMessageBuilder & builder)
+{
+  return addChannel(
+    name,
+    templateRegistry,
+    multicastGroupIP,
+    listenAddressIP,
+    bindIP,
+    portNumber,
+    builder,
+    0,
+    0);
+}
+
+size_t
+ChannelGroup::addChannel(
+  const std::string & name,
+  TemplateRegistryPtr templateRegistry,
+  const std::string & multicastGroupIP,
+  const std::string & listenAddressIP,
+  const std::string & bindIP,
+  unsigned short portNumber,
+  Messages::ValueMessageBuilder & builder,
+  HeaderAnalyzer & packetHeaderAnalyzer,
+  HeaderAnalyzer & messageHeaderAnalyzer)
+{
+  return addChannel(
+    name,
+    templateRegistry,
+    multicastGroupIP,
+    listenAddressIP,
+    bindIP,
+    portNumber,
+    builder,
+    &packetHeaderAnalyzer,
+    &messageHeaderAnalyzer);
+}
+
+size_t
+ChannelGroup::addChannel(
+  const std::string & name,
+  TemplateRegistryPtr templateRegistry,
+  const std::string & multicastGroupIP,
+  const std::string & listenAddressIP,
+  const std::string & bindIP,
+  unsigned short portNumber,
+  Messages::ValueMessageBuilder & builder,
+  HeaderAnalyzer * packetHeaderAnalyzer,
+  HeaderAnalyzer * messageHeaderAnalyzer)
+{
+  if(started_)
+  {
+    throw UsageError("Coding Error", "Channels must be added to a ChannelGroup before it is started.");
+  }
+  size_t index = channels_.size();
+  ChannelPtr channel(new Channel);
+  channel->name_ = name;
+  channel->worker_ = index % workers_.size();
+  channel->bufferSize_ = bufferSize_;
+  channel->bufferCount_ = bufferCount_;
+  channel->receiver_.reset(new Communication::MulticastReceiver(
+    *workers_[channel->worker_].ioService_,
+    multicastGroupIP,
+    listenAddressIP,
+    bindIP,
+    portNumber));
+  channel->assembler_.reset(new MessagePerPacketAssembler(
+    templateRegistry,
+    packetHeaderAnalyzer != 0 ? *packetHeaderAnalyzer : channel->packetHeaderAnalyzer_,
+    messageHeaderAnalyzer != 0 ? *messageHeaderAnalyzer : channel->messageHeaderAnalyzer_,
+    builder));
+  channels_.push_back(channel);
+  return index;
+}
+
+Communication::MulticastReceiver &
+ChannelGroup::receiver(size_t channel)
+{
+  if(channel >= channels_.size())
+  {
+    throw UsageError("Coding Error", "No such channel in ChannelGroup.");
+  }
+  return *channels_[channel]->receiver_;
+}
+
+void
+ChannelGroup::start()
+{
+  if(started_)
+  {
+    return;
+  }
+  started_ = true;
+  // Join the groups first so every worker has work to wait for.
+  for(size_t nChannel = 0; nChannel < channels_.size(); ++nChannel)
+  {
+    Channel & channel = *channels_[nChannel];
+    channel.receiver_->start(*channel.assembler_, channel.bufferSize_, channel.bufferCount_);
+  }
+  for(size_t nWorker = 0; nWorker < workers_.size(); ++nWorker)
+  {
+    workers_[nWorker].thread_.reset(
+      new boost::thread(boost::bind(&ChannelGroup::runWorker, this, nWorker)));
+  }
+}
+
+void
+ChannelGroup::runWorker(size_t worker)
+{
+  // Channel n belongs to worker n % workers, so this is the worker's first channel.
+  Common::Logger * logger = 0;
+  if(worker < channels_.size())
+  {
+    logger = channels_[worker]->assembler_.get();
+  }
+  ThreadOptions::select(threadOptions_, worker).applyToCurrentThread(logger);
+  workers_[worker].service_->run();
+}
+
+void
+ChannelGroup::stop()
+{
+  // A receiver may only be stopped by the worker that services it.
+  for(size_t nWorker = 0; nWorker < workers_.size(); ++nWorker)
+  {
+    workers_[nWorker].service_->post(boost::bind(&ChannelGroup::stopWorker, this, nWorker));
+  }
+}
+
+void
+ChannelGroup::stopWorker(size_t worker)
+{
+  for(size_t nChannel = 0; nChannel < channels_.size(); ++nChannel)
+  {
+    if(channels_[nChannel]->worker_ == worker)
+    {
+      channels_[nChannel]->receiver_->stop();
+    }
+  }
+  workers_[worker].service_->stopService();
+}
+
+void
+ChannelGroup::joinThreads()
+{
+  for(size_t nWorker = 0; nWorker < workers_.size(); ++nWorker)
+  {
+    Worker & worker = workers_[nWorker];
+    if(worker.thread_)
+    {
+      worker.thread_->join();
+      worker.thread_.reset();
+    }
+  }
+  // A worker that had already stopped, for example because one of its
+  // channels stopped it, never ran stopWorker().  No worker is running now
+  // so this thread can finish the job.
+  for(size_t nWorker = 0; nWorker < workers_.size(); ++nWorker)
+  {
+    stopWorker(nWorker);
+  }
+  started_ = false;
+}
+
+void
+ChannelGroup::getStatistics(size_t channel, ChannelStatistics & statistics)const
+{
+  if(channel >= channels_.size())
+  {
+    throw UsageError("Coding Error", "No such channel in ChannelGroup.");
+  }
+  const Channel & source = *channels_[channel];
+  const Communication::MulticastReceiver & receiver = *source.receiver_;
+  statistics.name_ = source.name_;
+  statistics.worker_ = source.worker_;
+  statistics.packetsReceived_ = receiver.packetsReceived();
+  statistics.packetsProcessed_ = receiver.packetsProcessed();
+  statistics.packetsWithErrors_ = receiver.packetsWithErrors();
+  statistics.bytesReceived_ = receiver.bytesReceived();
+  statistics.noBufferAvailable_ = receiver.noBufferAvailable();
+  statistics.queueOverflows_ = receiver.queueOverflows();
+  statistics.messagesDecoded_ = source.assembler_->decodedMessageCount();
+}
+
+void
+ChannelGroup::writeStatistics(std::ostream & out)const
+{
+  for(size_t nChannel = 0; nChannel < channels_.size(); ++nChannel)
+  {
+    ChannelStatistics statistics;
+    getStatistics(nChannel, statistics);
+    out << statistics.name_
+      << " worker " << statistics.worker_
+      << ": received " << statistics.packetsReceived_
+      << " packets (" << statistics.bytesReceived_ << " bytes)"
+      << "; processed " << statistics.packetsProcessed_
+      << "; messages " << statistics.messagesDecoded_
+      << "; errors " << statistics.packetsWithErrors_
+      << "; no buffer " << statistics.noBufferAvailable_
+      << "; overflows " << statistics.queueOverflows_
+      << std::endl;
+  }
+}
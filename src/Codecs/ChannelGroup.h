@@ -0,0 +1,242 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifndef CHANNELGROUP_H
+#define CHANNELGROUP_H
+#include <Common/QuickFAST_Export.h>
+#include "ChannelGroup_fwd.h"
+#include <Communication/MulticastReceiver.h>
+#include <Communication/AsioService.h>
+#include <Codecs/MessagePerPacketAssembler_fwd.h>
+#include <Codecs/NoHeaderAnalyzer.h>
+#include <Codecs/TemplateRegistry_fwd.h>
+#include <Common/ThreadOptions.h>
+#include <Messages/ValueMessageBuilder_fwd.h>
+
+namespace QuickFAST{
+  namespace Codecs {
+    /// @brief A snapshot of one channel's counters.
+    struct ChannelStatistics
+    {
+      ChannelStatistics()
+        : worker_(0)
+        , packetsReceived_(0)
+        , packetsProcessed_(0)
+        , packetsWithErrors_(0)
+        , bytesReceived_(0)
+        , noBufferAvailable_(0)
+        , queueOverflows_(0)
+        , messagesDecoded_(0)
+      {
+      }
+
+      /// The channel's name as given to addChannel()
+      std::string name_;
+      /// The worker thread that services the channel
+      size_t worker_;
+      /// Packets read from the socket
+      size_t packetsReceived_;
+      /// Packets handed to the decoder
+      size_t packetsProcessed_;
+      /// Packets that could not be received cleanly
+      size_t packetsWithErrors_;
+      /// Bytes read from the socket
+      size_t bytesReceived_;
+      /// Times a packet could have been read but every buffer was busy
+      size_t noBufferAvailable_;
+      /// Times the decoder fell behind the hand-off ring
+      size_t queueOverflows_;
+      /// Messages delivered to the channel's builder
+      size_t messagesDecoded_;
+    };
+
+    /// @brief Decode many multicast channels with a small, fixed set of threads.
+    ///
+    /// A MulticastDecoder needs its own receiver and, in practice, its own
+    /// threads.  An exchange that publishes dozens of channels would need dozens
+    /// of threads, most of them idle most of the time.  A ChannelGroup instead
+    /// spreads its channels over a fixed number of workers.  Each worker is one
+    /// thread running its own io_service, and every socket assigned to it is
+    /// serviced there.
+    ///
+    /// Each channel keeps its own Decoder, so its dictionaries (the Context)
+    /// are only ever touched by the one thread that services the channel.
+    /// No locking is needed between channels and a channel's state never
+    /// migrates between processor caches.
+    ///
+    /// Channels are assigned to workers round robin as they are added.  Add
+    /// every channel, adjust individual receivers through receiver() if
+    /// needed, then start().
+    ///
+    /// Because a worker's io_service is shared, a channel that stops itself
+    /// (for example because its builder asked to stop after an error) stops
+    /// every channel serviced by the same worker.
+    class QuickFAST_Export ChannelGroup
+    {
+    public:
+      /// @brief Construct an empty group.
+      /// @param workerCount is the number of threads that will service the channels.
+      ChannelGroup(size_t workerCount = 1);
+
+      ~ChannelGroup();
+
+      /// @brief Place the worker threads.
+      ///
+      /// Worker n uses the n'th entry.  See ThreadOptions::select().
+      /// A worker that can't be placed reports it through the builder of
+      /// its first channel and runs anyway.
+      /// Must be called before start().
+      /// @param options for each worker.
+      void setThreadOptions(const ThreadOptionsList & options)
+      {
+        threadOptions_ = options;
+      }
+
+      /// @brief Size the buffers for the channels added after this call.
+      /// @param bufferSize should be >= the largest expected packet
+      /// @param bufferCount is how many buffers each channel allocates (minimum 2 suggested)
+      void setBuffers(size_t bufferSize, size_t bufferCount)
+      {
+        bufferSize_ = bufferSize;
+        bufferCount_ = bufferCount;
+      }
+
+      /// @brief Add a channel without packet or message headers.
+      ///
+      /// @param name identifies the channel in statistics.
+      /// @param templateRegistry the templates to use for decoding
+      /// @param multicastGroupIP multicast address as a text string
+      /// @param listenAddressIP listen address as a text string
+      /// @param bindIP bind address as a text string
+      /// @param portNumber port number
+      /// @param builder receives the channel's decoded messages.
+      ///        It is called only from the channel's worker thread.
+      /// @returns the channel's index
+      size_t addChannel(
+        const std::string & name,
+        TemplateRegistryPtr templateRegistry,
+        const std::string & multicastGroupIP,
+        const std::string & listenAddressIP,
+        const std::string & bindIP,
+        unsigned short portNumber,
+        Messages::ValueMessageBuilder & builder);
+
+      /// @brief Add a channel whose packets or messages carry headers.
+      ///
+      /// The header analyzers must outlive the group and must not be shared
+      /// with channels on other workers.
+      /// @param name identifies the channel in statistics.
+      /// @param templateRegistry the templates to use for decoding
+      /// @param multicastGroupIP multicast address as a text string
+      /// @param listenAddressIP listen address as a text string
+      /// @param bindIP bind address as a text string
+      /// @param portNumber port number
+      /// @param builder receives the channel's decoded messages.
+      /// @param packetHeaderAnalyzer analyzes the packet headers
+      /// @param messageHeaderAnalyzer analyzes the message headers
+      /// @returns the channel's index
+      size_t addChannel(
+        const std::string & name,
+        TemplateRegistryPtr templateRegistry,
+        const std::string & multicastGroupIP,
+        const std::string & listenAddressIP,
+        const std::string & bindIP,
+        unsigned short portNumber,
+        Messages::ValueMessageBuilder & builder,
+        HeaderAnalyzer & packetHeaderAnalyzer,
+        HeaderAnalyzer & messageHeaderAnalyzer);
+
+      /// @brief How many channels have been added.
+      size_t channelCount()const
+      {
+        return channels_.size();
+      }
+
+      /// @brief How many threads service the channels.
+      size_t workerCount()const
+      {
+        return workers_.size();
+      }
+
+      /// @brief Access a channel's receiver, for example to enable batch
+      /// receive or latency tracking before start().
+      /// @param channel is the index returned by addChannel()
+      Communication::MulticastReceiver & receiver(size_t channel);
+
+      /// @brief Join every multicast group and start the worker threads.
+      ///
+      /// Returns immediately.
+      void start();
+
+      /// @brief Stop every channel and every worker.
+      ///
+      /// Each worker stops its own channels.  Returns immediately.
+      /// Builders may receive a few more messages.
+      void stop();
+
+      /// @brief Wait for the worker threads to finish.  Call after stop().
+      ///
+      /// Also stops any channel whose worker was no longer running.
+      void joinThreads();
+
+      /// @brief Collect one channel's counters.
+      /// @param channel is the index returned by addChannel()
+      /// @param[out] statistics receives the counters.
+      void getStatistics(size_t channel, ChannelStatistics & statistics)const;
+
+      /// @brief Write a line of counters for every channel.
+      /// @param out is the destination.
+      void writeStatistics(std::ostream & out)const;
+
+    private:
+      ChannelGroup(const ChannelGroup &);
+      ChannelGroup & operator=(const ChannelGroup &);
+
+      size_t addChannel(
+        const std::string & name,
+        TemplateRegistryPtr templateRegistry,
+        const std::string & multicastGroupIP,
+        const std::string & listenAddressIP,
+        const std::string & bindIP,
+        unsigned short portNumber,
+        Messages::ValueMessageBuilder & builder,
+        HeaderAnalyzer * packetHeaderAnalyzer,
+        HeaderAnalyzer * messageHeaderAnalyzer);
+
+      void runWorker(size_t worker);
+      void stopWorker(size_t worker);
+
+    private:
+      /// One thread and the io_service it runs.
+      struct Worker
+      {
+        boost::shared_ptr<boost::asio::io_service> ioService_;
+        boost::shared_ptr<Communication::AsioService> service_;
+        boost::shared_ptr<boost::thread> thread_;
+      };
+
+      /// Everything needed to decode one feed.
+      struct Channel
+      {
+        std::string name_;
+        size_t worker_;
+        boost::shared_ptr<Communication::MulticastReceiver> receiver_;
+        NoHeaderAnalyzer packetHeaderAnalyzer_;
+        NoHeaderAnalyzer messageHeaderAnalyzer_;
+        MessagePerPacketAssemblerPtr assembler_;
+        size_t bufferSize_;
+        size_t bufferCount_;
+      };
+      typedef boost::shared_ptr<Channel> ChannelPtr;
+
+      std::vector<Worker> workers_;
+      std::vector<ChannelPtr> channels_;
+      ThreadOptionsList threadOptions_;
+      size_t bufferSize_;
+      size_t bufferCount_;
+      bool started_;
+    };
+  }
+}
+#endif // CHANNELGROUP_H
@@ -0,0 +1,14 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifndef CHANNELGROUP_FWD_H
+#define CHANNELGROUP_FWD_H
+
+namespace QuickFAST{
+  namespace Codecs{
+    class ChannelGroup;
+    struct ChannelStatistics;
+  }
+}
+#endif // CHANNELGROUP_FWD_H
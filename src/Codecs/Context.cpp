@@ -17,10 +17,19 @@ Context::Context(Codecs::TemplateRegistryCPtr registry)
 , templateRegistry_(registry)
 , templateId_(~0)
 , strict_(true)
-, indexedDictionarySize_(registry->dictionarySize())
-//, indexedDictionary_(new Messages::FieldCPtr[indexedDictionarySize_])
-, indexedDictionary_(new Value[indexedDictionarySize_])
+, throwOnError_(true)
+, errorPending_(false)
+, numericDictionarySize_(registry->numericDictionarySize())
+, numericDictionary_(new int64[numericDictionarySize_])
+, exponentDictionary_(new exponent_t[numericDictionarySize_])
+, numericDefined_(new uint64[bitWords(numericDictionarySize_)])
+, numericNull_(new uint64[bitWords(numericDictionarySize_)])
+, stringDictionarySize_(registry->stringDictionarySize())
+, stringDictionary_(new StringBuffer[stringDictionarySize_])
+, stringDefined_(new uint64[bitWords(stringDictionarySize_)])
+, stringNull_(new uint64[bitWords(stringDictionarySize_)])
 {
+  reset();
 }
 
 Context::~Context()
@@ -30,10 +39,11 @@ Context::~Context()
 void
 Context::reset(bool resetTemplateId /*= true*/)
 {
-  for(size_t nDict = 0; nDict < indexedDictionarySize_; ++nDict)
-  {
-    indexedDictionary_[nDict].erase();
-  }
+  // String buffers keep their capacity; only the state bits are cleared.
+  std::memset(numericDefined_.get(), 0, bitWords(numericDictionarySize_) * sizeof(uint64));
+  std::memset(numericNull_.get(), 0, bitWords(numericDictionarySize_) * sizeof(uint64));
+  std::memset(stringDefined_.get(), 0, bitWords(stringDictionarySize_) * sizeof(uint64));
+  std::memset(stringNull_.get(), 0, bitWords(stringDictionarySize_) * sizeof(uint64));
   if(resetTemplateId)
   {
     templateId_ = ~0;
@@ -102,7 +112,7 @@ Context::reportError(const std::string & errorCode, const std::string & message)
       return;
     }
   }
-  throw EncodingError(errorCode + ' ' + message);
+  raiseError(errorCode + ' ' + message);
 }
 
 void
@@ -111,7 +121,7 @@ Context::reportError(
   const std::string & message,
   const Messages::FieldIdentity & identity)
 {
-  throw EncodingError(errorCode + ' ' + message + " Field: " + identity.name());
+  raiseError(errorCode + ' ' + message + " Field: " + identity.name());
 }
 
 void
@@ -120,13 +130,13 @@ Context::reportError(
   const std::string & message,
   const std::string & name)
 {
-  throw EncodingError(errorCode + ' ' + message + " Field: " + name);
+  raiseError(errorCode + ' ' + message + " Field: " + name);
 }
 
 void
 Context::reportFatal(const std::string & errorCode, const std::string & message)
 {
-  throw EncodingError(errorCode + ' ' +  message);
+  raiseError(errorCode + ' ' +  message);
 }
 
 void
@@ -135,7 +145,7 @@ Context::reportFatal(
   const std::string & message,
   const Messages::FieldIdentity & identity)
 {
-  throw EncodingError(errorCode + ' ' + message + " Field: " + identity.name());
+  raiseError(errorCode + ' ' + message + " Field: " + identity.name());
 }
 
 void
@@ -144,6 +154,20 @@ Context::reportFatal(
   const std::string & message,
   const std::string & name)
 {
-  throw EncodingError(errorCode + ' ' + message + " Field: " + name);
+  raiseError(errorCode + ' ' + message + " Field: " + name);
 }
 
+void
+Context::raiseError(const std::string & error)
+{
+  if(throwOnError_)
+  {
+    throw EncodingError(error);
+  }
+  // Later errors are usually consequences of the first one.
+  if(!errorPending_)
+  {
+    errorPending_ = true;
+    errorMessage_ = error;
+  }
+}
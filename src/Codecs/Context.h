@@ -8,7 +8,8 @@
 #define CONTEXT_H
 #include <Common/QuickFAST_Export.h>
 #include <Common/Types.h>
-#include <Common/Value.h>
+#include <Common/Decimal.h>
+#include <Common/StringBuffer.h>
 #include <Common/Exceptions.h>
 #include <Common/WorkingBuffer.h>
 #include <Codecs/TemplateRegistry_fwd.h>
@@ -56,6 +57,46 @@ namespace QuickFAST
         return strict_;
       }
 
+      /// @brief Choose how errors are reported.
+      ///
+      /// By default reportError() and reportFatal() throw EncodingError.
+      /// If throwOnError is false the first error is recorded instead, the Xcoder
+      /// abandons the current message at the next field boundary, and the caller
+      /// uses hasError() and getErrorMessage() to find out what happened.
+      /// This avoids the cost of unwinding the stack for every corrupt message.
+      /// @param throwOnError false to report errors by status
+      void setThrowOnError(bool throwOnError)
+      {
+        throwOnError_ = throwOnError;
+      }
+
+      /// @brief get the current status of the throwOnError property.
+      /// @returns true if errors are reported by throwing EncodingError.
+      bool getThrowOnError()const
+      {
+        return throwOnError_;
+      }
+
+      /// @brief Has an error been recorded since the last clearError()?
+      ///
+      /// Only meaningful when throwOnError is false.
+      bool hasError()const
+      {
+        return errorPending_;
+      }
+
+      /// @brief Describe the first error recorded since the last clearError()
+      const std::string & getErrorMessage()const
+      {
+        return errorMessage_;
+      }
+
+      /// @brief Forget any recorded error.
+      void clearError()
+      {
+        errorPending_ = false;
+      }
+
       /// @brief Reset decoding state to initial conditions
       /// @param resetTemplateId Normally you want to reset the template ID
       ///        however there are cases when you don't.
@@ -89,45 +130,72 @@ namespace QuickFAST
 
       //////////////////////////////
       // Support for decoding fields
-      /// @brief Find the definition of a field in the dictionary
-      /// @param index identifies the dictionary entry corresponding to this field
-      /// @param value receives the pointer to the value found
-      /// @returns true if a valid entry was found
-      bool findDictionaryField(size_t index, Value *& value);
+      //
+      // The dictionary is split by type.  Integer and decimal entries are
+      // packed densely into an array of int64 (decimal exponents live in a
+      // parallel array).  String entries live in a separate array of
+      // StringBuffers.  The undefined/null state of each entry is kept in
+      // bitsets so reset() only needs to clear a few words.
+      // DictionaryIndexer assigns numeric and string indexes separately.
+      //
+      // Indexes are validated once by TemplateRegistry::finalize() so the
+      // accessors below do not check them.  Build with DICTIONARY_INDEX_CHECK
+      // defined to check every access while debugging.
 
       /// @brief Sets the value in the dictionary to NULL
       /// @param index identifies the dictionary entry corresponding to this field
       void setDictionaryValueNull(size_t index)
       {
-        if(index > indexedDictionarySize_)
-        {
-          throw TemplateDefinitionError("Illegal dictionary index.");
-        }
-        indexedDictionary_[index].setNull();
+        checkNumericIndex(index);
+        setBit(numericDefined_, index);
+        setBit(numericNull_, index);
+      }
+
+      /// @brief Sets the string value in the dictionary to NULL
+      /// @param index identifies the dictionary entry corresponding to this field
+      void setDictionaryStringNull(size_t index)
+      {
+        checkStringIndex(index);
+        setBit(stringDefined_, index);
+        setBit(stringNull_, index);
       }
 
       /// @brief Sets the value in the dictionary to be undefined
       /// @param index identifies the dictionary entry corresponding to this field
       void setDictionaryValueUndefined(size_t index)
       {
-        if(index > indexedDictionarySize_)
-        {
-          throw TemplateDefinitionError("Illegal dictionary index.");
-        }
-        indexedDictionary_[index].setUndefined();
+        checkNumericIndex(index);
+        clearBit(numericDefined_, index);
+      }
+
+      /// @brief Sets the string value in the dictionary to be undefined
+      /// @param index identifies the dictionary entry corresponding to this field
+      void setDictionaryStringUndefined(size_t index)
+      {
+        checkStringIndex(index);
+        clearBit(stringDefined_, index);
       }
 
-      /// @brief Sets the value in the dictionary
+      /// @brief Sets an integer value in the dictionary
       /// @param index identifies the dictionary entry corresponding to this field
       /// @param value is the new value for the dictionary entry
       template<typename VALUE_TYPE>
       void setDictionaryValue(size_t index, const VALUE_TYPE & value)
       {
-        if(index > indexedDictionarySize_)
-        {
-          throw TemplateDefinitionError("Illegal dictionary index.");
-        }
-        indexedDictionary_[index].setValue(value);
+        checkNumericIndex(index);
+        numericDictionary_[index] = static_cast<int64>(value);
+        setNumericOk(index);
+      }
+
+      /// @brief Sets a decimal value in the dictionary
+      /// @param index identifies the dictionary entry corresponding to this field
+      /// @param value is the new value for the dictionary entry
+      void setDictionaryValue(size_t index, const Decimal & value)
+      {
+        checkNumericIndex(index);
+        numericDictionary_[index] = value.getMantissa();
+        exponentDictionary_[index] = value.getExponent();
+        setNumericOk(index);
       }
 
       /// @brief Sets the string value in the dictionary
@@ -136,57 +204,109 @@ namespace QuickFAST
       /// @param length is the lenght of the string pointed to by value
       void setDictionaryValue(size_t index, const unsigned char * value, size_t length)
       {
-        if(index > indexedDictionarySize_)
-        {
-          throw TemplateDefinitionError("Illegal dictionary index.");
-        }
-        indexedDictionary_[index].setValue(value, length);
+        checkStringIndex(index);
+        stringDictionary_[index].assign(value, length);
+        setStringOk(index);
+      }
+
+      /// @brief Sets the string value in the dictionary
+      /// @param index identifies the dictionary entry corresponding to this field
+      /// @param value is the new value (null terminated)
+      void setDictionaryValue(size_t index, const char * value)
+      {
+        setDictionaryValue(index, reinterpret_cast<const unsigned char *>(value), std::strlen(value));
       }
 
-      /// @brief Get a value from the dictionary
+      /// @brief Sets the string value in the dictionary
+      /// @param index identifies the dictionary entry corresponding to this field
+      /// @param value is the new value for the dictionary entry
+      void setDictionaryValue(size_t index, const std::string & value)
+      {
+        setDictionaryValue(index, reinterpret_cast<const unsigned char *>(value.data()), value.size());
+      }
+
+      /// @brief Edit the front of a string value in the dictionary in place
+      /// @param index identifies the dictionary entry corresponding to this field
+      /// @param removeLength is how many bytes to remove from the front of the current value.
+      /// @param value points to the bytes to be inserted in their place
+      /// @param length is the number of bytes to insert
+      void replaceDictionaryStringFront(size_t index, size_t removeLength, const unsigned char * value, size_t length)
+      {
+        checkStringIndex(index);
+        stringDictionary_[index].replaceFront(removeLength, value, length);
+        setStringOk(index);
+      }
+
+      /// @brief Edit the end of a string value in the dictionary in place
+      /// @param index identifies the dictionary entry corresponding to this field
+      /// @param removeLength is how many bytes to remove from the end of the current value.
+      /// @param value points to the bytes to be appended in their place
+      /// @param length is the number of bytes to append
+      void replaceDictionaryStringBack(size_t index, size_t removeLength, const unsigned char * value, size_t length)
+      {
+        checkStringIndex(index);
+        stringDictionary_[index].replaceBack(removeLength, value, length);
+        setStringOk(index);
+      }
+
+      /// @brief Get an integer value from the dictionary
       /// @param index identifies the dictionary entry corresponding to this field
       /// @param value receives the stored value
       template<typename VALUE_TYPE>
       DictionaryStatus getDictionaryValue(size_t index, VALUE_TYPE & value)
       {
-        if(index > indexedDictionarySize_)
+        checkNumericIndex(index);
+        DictionaryStatus status = entryStatus(numericDefined_, numericNull_, index);
+        if(status == OK_VALUE)
         {
-          throw TemplateDefinitionError("Illegal dictionary index.");
+          value = static_cast<VALUE_TYPE>(numericDictionary_[index]);
         }
-        Value & entry = indexedDictionary_[index];
-        if(!entry.isDefined())
+        return status;
+      }
+
+      /// @brief Get a decimal value from the dictionary
+      /// @param index identifies the dictionary entry corresponding to this field
+      /// @param value receives the stored value
+      DictionaryStatus getDictionaryValue(size_t index, Decimal & value)
+      {
+        checkNumericIndex(index);
+        DictionaryStatus status = entryStatus(numericDefined_, numericNull_, index);
+        if(status == OK_VALUE)
         {
-          return UNDEFINED_VALUE;
+          value = Decimal(numericDictionary_[index], exponentDictionary_[index]);
         }
-        if(entry.isNull())
+        return status;
+      }
+
+      /// @brief Get a string value from the dictionary
+      /// @param index identifies the dictionary entry corresponding to this field
+      /// @param value receives a copy of the stored value
+      DictionaryStatus getDictionaryValue(size_t index, std::string & value)
+      {
+        const unsigned char * buffer = 0;
+        size_t length = 0;
+        DictionaryStatus status = getDictionaryValue(index, buffer, length);
+        if(status == OK_VALUE)
         {
-          return NULL_VALUE;
+          value.assign(reinterpret_cast<const char *>(buffer), length);
         }
-        (void)entry.getValue(value);
-        return OK_VALUE;
+        return status;
       }
 
-      /// @brief Sets the value in the dictionary
+      /// @brief Get a string value from the dictionary without copying it
       /// @param index identifies the dictionary entry corresponding to this field
-      /// @param value is the new value for the dictionary entry
+      /// @param value is set to point to the stored value
       /// @param length is the length of the string pointed to by value
       DictionaryStatus getDictionaryValue(size_t index, const unsigned char *& value, size_t &length)
       {
-        if(index > indexedDictionarySize_)
-        {
-          throw TemplateDefinitionError("Illegal dictionary index.");
-        }
-        Value & entry = indexedDictionary_[index];
-        if(!entry.isDefined())
+        checkStringIndex(index);
+        DictionaryStatus status = entryStatus(stringDefined_, stringNull_, index);
+        if(status == OK_VALUE)
         {
-          return UNDEFINED_VALUE;
-        }
-        if(entry.isNull())
-        {
-          return NULL_VALUE;
+          value = stringDictionary_[index].data();
+          length = stringDictionary_[index].size();
         }
-        (void)entry.getValue(value, length);
-        return OK_VALUE;
+        return status;
       }
 
       /// @brief Report a warning
@@ -219,7 +339,7 @@ namespace QuickFAST
       /// @param errorCode as defined in the FIX standard (or invented for QuickFAST)
       ///                  i.e [R123]
       /// @param message a text description of the problem.
-      /// @throws EncodingError unless overridden.
+      /// @throws EncodingError unless overridden or throwOnError is false.
       virtual void reportError(const std::string & errorCode, const std::string & message);
 
       /// @brief Report a recoverable error
@@ -227,7 +347,7 @@ namespace QuickFAST
       ///                  i.e [R123]
       /// @param message a text description of the problem.
       /// @param identity identifies the field being Xcoded
-      /// @throws EncodingError unless overridden.
+      /// @throws EncodingError unless overridden or throwOnError is false.
       virtual void reportError(
         const std::string & errorCode,
         const std::string & message,
@@ -239,38 +359,38 @@ namespace QuickFAST
       ///                  i.e [R123]
       /// @param message a text description of the problem.
       /// @param name identifies the field being Xcoded
-      /// @throws EncodingError unless overridden.
+      /// @throws EncodingError unless overridden or throwOnError is false.
       virtual void reportError(
         const std::string & errorCode,
         const std::string & message,
         const std::string & name
         );
 
-      /// @brief Report a fatal error (always throws)
+      /// @brief Report a fatal error
       /// @param errorCode as defined in the FIX standard (or invented for QuickFAST)
       ///                  i.e [R123]
       /// @param message a text description of the problem.
-      /// @throws EncodingError "always"
+      /// @throws EncodingError unless throwOnError is false.
       virtual void reportFatal(const std::string & errorCode, const std::string & message);
 
-      /// @brief Report a fatal error (always throws)
+      /// @brief Report a fatal error
       /// @param errorCode as defined in the FIX standard (or invented for QuickFAST)
       ///                  i.e [R123]
       /// @param message a text description of the problem.
       /// @param identity identifies the field being Xcoded
-      /// @throws EncodingError "always"
+      /// @throws EncodingError unless throwOnError is false.
       virtual void reportFatal(
         const std::string & errorCode,
         const std::string & message,
         const Messages::FieldIdentity & identity
         );
 
-      /// @brief Report a fatal error (always throws)
+      /// @brief Report a fatal error
       /// @param errorCode as defined in the FIX standard (or invented for QuickFAST)
       ///                  i.e [R123]
       /// @param message a text description of the problem.
       /// @param name identifies the field being Xcoded
-      /// @throws EncodingError "always"
+      /// @throws EncodingError unless throwOnError is false.
       virtual void reportFatal(
         const std::string & errorCode,
         const std::string & message,
@@ -350,10 +470,100 @@ namespace QuickFAST
 
       /// false makes the Xcoder more forgiving
       bool strict_;
+      /// false reports errors by status rather than by exception
+      bool throwOnError_;
+      /// An error has been recorded (throwOnError_ is false)
+      bool errorPending_;
+      /// The first error recorded
+      std::string errorMessage_;
     private:
-      size_t indexedDictionarySize_;
-      typedef boost::scoped_array<Value> IndexedDictionary;
-      IndexedDictionary indexedDictionary_;
+      /// @brief Throw the error or record it, depending on throwOnError_.
+      void raiseError(const std::string & error);
+
+      /// @brief one bit per dictionary entry
+      typedef boost::scoped_array<uint64> DictionaryBits;
+
+      static size_t bitWords(size_t entries)
+      {
+        return (entries + 63) / 64;
+      }
+
+      static void setBit(DictionaryBits & bits, size_t index)
+      {
+        bits[index >> 6] |= uint64(1) << (index & 63);
+      }
+
+      static void clearBit(DictionaryBits & bits, size_t index)
+      {
+        bits[index >> 6] &= ~(uint64(1) << (index & 63));
+      }
+
+      static bool testBit(const DictionaryBits & bits, size_t index)
+      {
+        return ((bits[index >> 6] >> (index & 63)) & 1) != 0;
+      }
+
+      static DictionaryStatus entryStatus(const DictionaryBits & defined, const DictionaryBits & null, size_t index)
+      {
+        if(!testBit(defined, index))
+        {
+          return UNDEFINED_VALUE;
+        }
+        if(testBit(null, index))
+        {
+          return NULL_VALUE;
+        }
+        return OK_VALUE;
+      }
+
+      void checkNumericIndex(size_t index) const
+      {
+#ifdef DICTIONARY_INDEX_CHECK
+        if(index >= numericDictionarySize_)
+        {
+          throw TemplateDefinitionError("Illegal dictionary index.");
+        }
+#else
+        (void)index;
+#endif
+      }
+
+      void checkStringIndex(size_t index) const
+      {
+#ifdef DICTIONARY_INDEX_CHECK
+        if(index >= stringDictionarySize_)
+        {
+          throw TemplateDefinitionError("Illegal dictionary index.");
+        }
+#else
+        (void)index;
+#endif
+      }
+
+      void setNumericOk(size_t index)
+      {
+        setBit(numericDefined_, index);
+        clearBit(numericNull_, index);
+      }
+
+      void setStringOk(size_t index)
+      {
+        setBit(stringDefined_, index);
+        clearBit(stringNull_, index);
+      }
+
+    private:
+      size_t numericDictionarySize_;
+      boost::scoped_array<int64> numericDictionary_;
+      boost::scoped_array<exponent_t> exponentDictionary_;
+      DictionaryBits numericDefined_;
+      DictionaryBits numericNull_;
+
+      size_t stringDictionarySize_;
+      boost::scoped_array<StringBuffer> stringDictionary_;
+      DictionaryBits stringDefined_;
+      DictionaryBits stringNull_;
+
       WorkingBuffer workingBuffer_;
     };
   }
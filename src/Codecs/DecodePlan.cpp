@@ -0,0 +1,346 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "DecodePlan.h"
+#include <Codecs/SegmentBody.h>
+#include <Codecs/FieldInstruction.h>
+#include <Codecs/Decoder.h>
+#include <Codecs/DataSource.h>
+#include <Codecs/PresenceMap.h>
+#include <Messages/ValueMessageBuilder.h>
+#include <Common/Profiler.h>
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Codecs;
+
+// Must produce the same value as DecodeStep::integerOpCode(); this form is usable as a case label.
+#define DECODE_PLAN_OPCODE(kind, op, mandatory) \
+  (1 + ((((kind) * FieldOp::UNKNOWN) + (op)) << 1) + ((mandatory) ? 1 : 0))
+
+const unsigned short DecodeStep::GENERIC;
+
+unsigned short
+DecodeStep::integerOpCode(IntegerKind kind, FieldOp::OpType op, bool mandatory)
+{
+  return static_cast<unsigned short>(DECODE_PLAN_OPCODE(kind, op, mandatory));
+}
+
+namespace
+{
+  // The functions in this namespace mirror the corresponding methods in
+  // FieldInstructionInteger.  The difference is that everything they need
+  // comes from the DecodeStep, and the type/operator/presence decisions have
+  // been made at compile time rather than via virtual dispatch.
+  // If you change one, change the other.
+
+  template<typename INTEGER_TYPE, bool SIGNED>
+  inline
+  void
+  decodePlannedInteger(
+    DataSource & source,
+    Decoder & decoder,
+    const DecodeStep & step,
+    INTEGER_TYPE & value)
+  {
+    if(SIGNED) // expect compile-time optimization here
+    {
+      FieldInstruction::decodeSignedInteger(source, decoder, value, step.identity_->name(), false, step.ignoreOverflow_);
+    }
+    else
+    {
+      FieldInstruction::decodeUnsignedInteger(source, decoder, value, step.identity_->name(), step.ignoreOverflow_);
+    }
+  }
+
+  template<typename INTEGER_TYPE, bool SIGNED, bool MANDATORY>
+  void
+  planNop(
+    DataSource & source,
+    Decoder & decoder,
+    const DecodeStep & step,
+    Messages::ValueMessageBuilder & builder)
+  {
+    INTEGER_TYPE value = 0;
+    decodePlannedInteger<INTEGER_TYPE, SIGNED>(source, decoder, step, value);
+    if(MANDATORY || !FieldInstruction::checkNullInteger(value))
+    {
+      builder.addValue(step.identity_, step.valueType_, value);
+    }
+  }
+
+  template<typename INTEGER_TYPE, bool MANDATORY>
+  void
+  planConstant(
+    PresenceMap & pmap,
+    const DecodeStep & step,
+    Messages::ValueMessageBuilder & builder)
+  {
+    if(MANDATORY || pmap.checkNextField())
+    {
+      builder.addValue(step.identity_, step.valueType_, INTEGER_TYPE(step.initialValue_));
+    }
+  }
+
+  template<typename INTEGER_TYPE, bool SIGNED, bool MANDATORY>
+  void
+  planDefault(
+    DataSource & source,
+    PresenceMap & pmap,
+    Decoder & decoder,
+    const DecodeStep & step,
+    Messages::ValueMessageBuilder & builder)
+  {
+    if(pmap.checkNextField())
+    {
+      INTEGER_TYPE value = 0;
+      decodePlannedInteger<INTEGER_TYPE, SIGNED>(source, decoder, step, value);
+      if(MANDATORY || !FieldInstruction::checkNullInteger(value))
+      {
+        builder.addValue(step.identity_, step.valueType_, value);
+      }
+    }
+    else if(step.hasInitialValue_)
+    {
+      builder.addValue(step.identity_, step.valueType_, INTEGER_TYPE(step.initialValue_));
+    }
+    else if(MANDATORY)
+    {
+      decoder.reportError("[ERR D5]", "Mandatory default operator with no value.", *step.identity_);
+    }
+  }
+
+  template<typename INTEGER_TYPE, bool SIGNED, bool MANDATORY>
+  void
+  planCopy(
+    DataSource & source,
+    PresenceMap & pmap,
+    Decoder & decoder,
+    const DecodeStep & step,
+    Messages::ValueMessageBuilder & builder)
+  {
+    if(pmap.checkNextField())
+    {
+      INTEGER_TYPE value = INTEGER_TYPE(step.initialValue_);
+      decodePlannedInteger<INTEGER_TYPE, SIGNED>(source, decoder, step, value);
+      if(!MANDATORY && FieldInstruction::checkNullInteger(value))
+      {
+        decoder.setDictionaryValueNull(step.dictionaryIndex_);
+      }
+      else
+      {
+        builder.addValue(step.identity_, step.valueType_, value);
+        decoder.setDictionaryValue(step.dictionaryIndex_, value);
+      }
+      return;
+    }
+
+    INTEGER_TYPE previousValue = 0;
+    Context::DictionaryStatus previousStatus = decoder.getDictionaryValue(step.dictionaryIndex_, previousValue);
+    if(previousStatus == Context::OK_VALUE)
+    {
+      builder.addValue(step.identity_, step.valueType_, previousValue);
+    }
+    else if(previousStatus == Context::UNDEFINED_VALUE)
+    {
+      if(step.hasInitialValue_)
+      {
+        INTEGER_TYPE initialValue = INTEGER_TYPE(step.initialValue_);
+        builder.addValue(step.identity_, step.valueType_, initialValue);
+        decoder.setDictionaryValue(step.dictionaryIndex_, initialValue);
+      }
+      else if(MANDATORY)
+      {
+        decoder.reportError(
+          "[ERR D5]",
+          "Copy operator missing mandatory integer field/no initial value",
+          *step.identity_);
+        builder.addValue(step.identity_, step.valueType_, INTEGER_TYPE(0));
+        decoder.setDictionaryValue(step.dictionaryIndex_, INTEGER_TYPE(0));
+      }
+    }
+    else if(MANDATORY) // NULL value
+    {
+      decoder.reportError(
+        "[ERR D5]",
+        "Copy operator mandatory integer field, but previous value was NULL",
+        *step.identity_);
+      builder.addValue(step.identity_, step.valueType_, INTEGER_TYPE(0));
+      decoder.setDictionaryValue(step.dictionaryIndex_, INTEGER_TYPE(0));
+    }
+  }
+
+  template<typename INTEGER_TYPE, bool SIGNED, bool MANDATORY>
+  void
+  planIncrement(
+    DataSource & source,
+    PresenceMap & pmap,
+    Decoder & decoder,
+    const DecodeStep & step,
+    Messages::ValueMessageBuilder & builder)
+  {
+    if(pmap.checkNextField())
+    {
+      INTEGER_TYPE value = 0;
+      decodePlannedInteger<INTEGER_TYPE, SIGNED>(source, decoder, step, value);
+      if(!MANDATORY && FieldInstruction::checkNullInteger(value))
+      {
+        decoder.setDictionaryValueNull(step.dictionaryIndex_);
+      }
+      else
+      {
+        builder.addValue(step.identity_, step.valueType_, value);
+        decoder.setDictionaryValue(step.dictionaryIndex_, value);
+      }
+      return;
+    }
+
+    INTEGER_TYPE value = INTEGER_TYPE(step.initialValue_);
+    Context::DictionaryStatus previousStatus = decoder.getDictionaryValue(step.dictionaryIndex_, value);
+    if(previousStatus == Context::OK_VALUE)
+    {
+      value += 1;
+    }
+    else if(previousStatus == Context::UNDEFINED_VALUE)
+    {
+      if(step.hasInitialValue_)
+      {
+        value = INTEGER_TYPE(step.initialValue_);
+      }
+      else if(MANDATORY)
+      {
+        decoder.reportError("[ERR D5]", "Missing initial value for mandatory integer with increment operator", *step.identity_);
+        value = 0;
+      }
+      else
+      {
+        // missing value for optional field.  We're done
+        return;
+      }
+    }
+    else // previousStatus = NULL_VALUE
+    {
+      if(MANDATORY)
+      {
+        decoder.reportError("[ERR D5]", "Null value for mandatory integer with increment operator", *step.identity_);
+        value = 0;
+      }
+      else
+      {
+        // missing value for optional field.  We're done
+        return;
+      }
+    }
+    builder.addValue(step.identity_, step.valueType_, value);
+    decoder.setDictionaryValue(step.dictionaryIndex_, value);
+  }
+
+  template<typename INTEGER_TYPE, bool MANDATORY>
+  void
+  planDelta(
+    DataSource & source,
+    Decoder & decoder,
+    const DecodeStep & step,
+    Messages::ValueMessageBuilder & builder)
+  {
+    int64 delta;
+    FieldInstruction::decodeSignedInteger(source, decoder, delta, step.identity_->name(), true);
+    if(!MANDATORY && FieldInstruction::checkNullInteger(delta))
+    {
+      return; // nothing in Message; no change to saved value
+    }
+    INTEGER_TYPE value = INTEGER_TYPE(step.initialValue_);
+    Context::DictionaryStatus previousStatus = decoder.getDictionaryValue(step.dictionaryIndex_, value);
+    if(previousStatus == Context::UNDEFINED_VALUE && step.hasInitialValue_)
+    {
+      value = INTEGER_TYPE(step.initialValue_);
+    }
+    value = INTEGER_TYPE(value + delta);
+    builder.addValue(step.identity_, step.valueType_, value);
+    decoder.setDictionaryValue(step.dictionaryIndex_, value);
+  }
+}
+
+DecodePlan::DecodePlan(const SegmentBody & segment)
+  : specializedCount_(0)
+{
+  size_t instructionCount = segment.size();
+  steps_.resize(instructionCount);
+  for(size_t nField = 0; nField < instructionCount; ++nField)
+  {
+    const FieldInstructionCPtr & instruction = segment.getInstruction(nField);
+    DecodeStep & step = steps_[nField];
+    step.instruction_ = instruction.get();
+    step.identity_ = instruction->getIdentity();
+    if(instruction->compileDecodeStep(step))
+    {
+      ++specializedCount_;
+    }
+    else
+    {
+      step.opCode_ = DecodeStep::GENERIC;
+    }
+  }
+}
+
+#define DECODE_PLAN_INTEGER_CASES(KIND, TYPE, SIGNED) \
+  case DECODE_PLAN_OPCODE(DecodeStep::KIND, FieldOp::NOP, true): \
+    planNop<TYPE, SIGNED, true>(source, decoder, step, builder); break; \
+  case DECODE_PLAN_OPCODE(DecodeStep::KIND, FieldOp::NOP, false): \
+    planNop<TYPE, SIGNED, false>(source, decoder, step, builder); break; \
+  case DECODE_PLAN_OPCODE(DecodeStep::KIND, FieldOp::CONSTANT, true): \
+    planConstant<TYPE, true>(pmap, step, builder); break; \
+  case DECODE_PLAN_OPCODE(DecodeStep::KIND, FieldOp::CONSTANT, false): \
+    planConstant<TYPE, false>(pmap, step, builder); break; \
+  case DECODE_PLAN_OPCODE(DecodeStep::KIND, FieldOp::DEFAULT, true): \
+    planDefault<TYPE, SIGNED, true>(source, pmap, decoder, step, builder); break; \
+  case DECODE_PLAN_OPCODE(DecodeStep::KIND, FieldOp::DEFAULT, false): \
+    planDefault<TYPE, SIGNED, false>(source, pmap, decoder, step, builder); break; \
+  case DECODE_PLAN_OPCODE(DecodeStep::KIND, FieldOp::COPY, true): \
+    planCopy<TYPE, SIGNED, true>(source, pmap, decoder, step, builder); break; \
+  case DECODE_PLAN_OPCODE(DecodeStep::KIND, FieldOp::COPY, false): \
+    planCopy<TYPE, SIGNED, false>(source, pmap, decoder, step, builder); break; \
+  case DECODE_PLAN_OPCODE(DecodeStep::KIND, FieldOp::INCREMENT, true): \
+    planIncrement<TYPE, SIGNED, true>(source, pmap, decoder, step, builder); break; \
+  case DECODE_PLAN_OPCODE(DecodeStep::KIND, FieldOp::INCREMENT, false): \
+    planIncrement<TYPE, SIGNED, false>(source, pmap, decoder, step, builder); break; \
+  case DECODE_PLAN_OPCODE(DecodeStep::KIND, FieldOp::DELTA, true): \
+    planDelta<TYPE, true>(source, decoder, step, builder); break; \
+  case DECODE_PLAN_OPCODE(DecodeStep::KIND, FieldOp::DELTA, false): \
+    planDelta<TYPE, false>(source, decoder, step, builder); break;
+
+void
+DecodePlan::execute(
+  DataSource & source,
+  PresenceMap & pmap,
+  Decoder & decoder,
+  Messages::ValueMessageBuilder & builder)const
+{
+  PROFILE_POINT("decode plan");
+  // beginField only matters when echo is enabled, so don't pay for the virtual call otherwise.
+  const bool echo = source.getEcho() != 0;
+  const DecodeStep * end = steps_.empty() ? 0 : &steps_[0] + steps_.size();
+  for(const DecodeStep * it = steps_.empty() ? 0 : &steps_[0]; it != end; ++it)
+  {
+    const DecodeStep & step = *it;
+    if(echo)
+    {
+      source.beginField(step.identity_->name());
+    }
+    switch(step.opCode_)
+    {
+      DECODE_PLAN_INTEGER_CASES(INT32_KIND, int32, true)
+      DECODE_PLAN_INTEGER_CASES(UINT32_KIND, uint32, false)
+      DECODE_PLAN_INTEGER_CASES(INT64_KIND, int64, true)
+      DECODE_PLAN_INTEGER_CASES(UINT64_KIND, uint64, false)
+    case DecodeStep::GENERIC:
+    default:
+      step.instruction_->decode(source, pmap, decoder, builder);
+      break;
+    }
+    if(decoder.hasError())
+    {
+      return;
+    }
+  }
+}
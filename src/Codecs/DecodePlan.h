@@ -0,0 +1,144 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef DECODEPLAN_H
+#define DECODEPLAN_H
+#include "DecodePlan_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Common/Types.h>
+#include <Codecs/FieldOp.h>
+#include <Codecs/FieldInstruction_fwd.h>
+#include <Codecs/SegmentBody_fwd.h>
+#include <Codecs/DataSource_fwd.h>
+#include <Codecs/Decoder_fwd.h>
+#include <Codecs/PresenceMap_fwd.h>
+#include <Messages/FieldIdentity_fwd.h>
+#include <Messages/ValueMessageBuilder_fwd.h>
+
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief One entry in a DecodePlan.
+    ///
+    /// A step is a flattened copy of everything the decoder needs to know about
+    /// a field instruction: the representation of the data, the field operator,
+    /// whether the field is nullable, the dictionary index, and the initial value.
+    /// Instructions that do not have a specialized op code are executed by
+    /// calling FieldInstruction::decode() -- the GENERIC op code.
+    class QuickFAST_Export DecodeStep
+    {
+    public:
+      /// @brief Integer representations that have specialized op codes.
+      enum IntegerKind
+      {
+        INT32_KIND,
+        UINT32_KIND,
+        INT64_KIND,
+        UINT64_KIND,
+        INTEGER_KIND_COUNT
+      };
+
+      /// @brief The op code for steps that dispatch through the FieldInstruction
+      static const unsigned short GENERIC = 0;
+
+      /// @brief Calculate the op code for an integer field.
+      ///
+      /// The op code combines representation, field operator and nullability
+      /// so the interpreter needs exactly one switch per field.
+      /// @param kind identifies the integer representation
+      /// @param op is the field operator
+      /// @param mandatory is false if the field is nullable
+      /// @returns the op code.
+      static unsigned short integerOpCode(IntegerKind kind, FieldOp::OpType op, bool mandatory);
+
+      /// @brief Construct a GENERIC step.
+      DecodeStep()
+        : opCode_(GENERIC)
+        , instruction_(0)
+        , valueType_(ValueType::UNDEFINED)
+        , dictionaryIndex_(0)
+        , initialValue_(0)
+        , hasInitialValue_(false)
+        , ignoreOverflow_(false)
+      {
+      }
+
+      /// @brief What to do.  GENERIC or a value returned by integerOpCode()
+      unsigned short opCode_;
+      /// @brief The instruction from which this step was compiled.
+      const FieldInstruction * instruction_;
+      /// @brief Identifies the field to the message builder.
+      mutable Messages::FieldIdentityCPtr identity_;
+      /// @brief The value type reported to the message builder.
+      ValueType::Type valueType_;
+      /// @brief The dictionary entry used by the field operator (if any)
+      size_t dictionaryIndex_;
+      /// @brief The initial value bit pattern; converted to the integer type when used.
+      uint64 initialValue_;
+      /// @brief True if the field operator specified a value= attribute
+      bool hasInitialValue_;
+      /// @brief Ignore integer overflow while decoding
+      bool ignoreOverflow_;
+    };
+
+    /// @brief A template-compiled alternative to per-field virtual dispatch.
+    ///
+    /// The plan is a flat array of DecodeSteps, one per field instruction in a
+    /// SegmentBody, built by TemplateRegistry::finalize().  The Decoder runs the
+    /// plan with a tight interpreter loop when Decoder::setUseDecodePlans(true)
+    /// has been called.  Results are identical to decoding via the FieldInstructions.
+    class QuickFAST_Export DecodePlan
+    {
+    public:
+      /// @brief Compile the instructions in a segment into a plan.
+      /// @param segment supplies the field instructions.  It must be finalized
+      ///        and its dictionaries must be indexed.
+      explicit DecodePlan(const SegmentBody & segment);
+
+      /// @brief How many steps are in the plan
+      size_t size()const
+      {
+        return steps_.size();
+      }
+
+      /// @brief How many steps use a specialized op code.
+      size_t specializedCount()const
+      {
+        return specializedCount_;
+      }
+
+      /// @brief Access a step in the plan
+      /// @param index identifies the step
+      const DecodeStep & getStep(size_t index)const
+      {
+        return steps_[index];
+      }
+
+      /// @brief Decode the fields described by this plan.
+      ///
+      /// Equivalent to Decoder::decodeSegmentBody() for the segment from which
+      /// the plan was compiled.
+      /// @param source supplies the FAST encoded data.
+      /// @param pmap is used to determine which fields are present
+      /// @param decoder provides the context (dictionaries, error handling)
+      /// @param builder receives the decoded fields.
+      void execute(
+        DataSource & source,
+        PresenceMap & pmap,
+        Decoder & decoder,
+        Messages::ValueMessageBuilder & builder)const;
+
+    private:
+      DecodePlan(const DecodePlan &);
+      DecodePlan & operator =(const DecodePlan &);
+
+    private:
+      typedef std::vector<DecodeStep> StepVector;
+      StepVector steps_;
+      size_t specializedCount_;
+    };
+  }
+}
+#endif // DECODEPLAN_H
@@ -0,0 +1,19 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef DECODEPLAN_FWD_H
+#define DECODEPLAN_FWD_H
+namespace QuickFAST{
+  namespace Codecs{
+    class DecodeStep;
+    class DecodePlan;
+    /// @brief A smart pointer to a DecodePlan.
+    typedef boost::shared_ptr<DecodePlan> DecodePlanPtr;
+    /// @brief A smart pointer to a const DecodePlan.
+    typedef boost::shared_ptr<const DecodePlan> DecodePlanCPtr;
+  }
+}
+#endif // DECODEPLAN_FWD_H
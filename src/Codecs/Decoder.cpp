@@ -8,6 +8,7 @@
 #include <Codecs/PresenceMap.h>
 #include <Codecs/TemplateRegistry.h>
 #include <Codecs/FieldInstruction.h>
+#include <Codecs/DecodePlan.h>
 #include <Messages/ValueMessageBuilder.h>
 #include <Common/Profiler.h>
 
@@ -16,7 +17,28 @@ using namespace ::QuickFAST::Codecs;
 
 Decoder::Decoder(Codecs::TemplateRegistryPtr registry)
 : Context(registry)
+, useDecodePlans_(false)
+, presenceMapDepth_(0)
 {
+  // One for the message plus one for each level of nested group or sequence.
+  size_t depth = registry->maxNestingDepth() + 1;
+  presenceMaps_.reserve(depth);
+  for(size_t nMap = 0; nMap < depth; ++nMap)
+  {
+    presenceMaps_.push_back(PresenceMapPtr(new PresenceMap(registry->presenceMapBits())));
+  }
+}
+
+PresenceMap &
+Decoder::pushPresenceMap()
+{
+  if(presenceMapDepth_ >= presenceMaps_.size())
+  {
+    presenceMaps_.push_back(PresenceMapPtr(new PresenceMap(templateRegistry_->presenceMapBits())));
+  }
+  PresenceMap & pmap = *presenceMaps_[presenceMapDepth_++];
+  pmap.setVerbose(verboseOut_);
+  return pmap;
 }
 
 //Decoder::Decoder()
@@ -24,23 +46,27 @@ Decoder::Decoder(Codecs::TemplateRegistryPtr registry)
 //}
 
 
-void
+bool
 Decoder::decodeMessage(
    DataSource & source,
    Messages::ValueMessageBuilder & messageBuilder)
 {
   PROFILE_POINT("decode");
   source.beginMessage();
+  clearError();
 
-  Codecs::PresenceMap pmap(getTemplateRegistry()->presenceMapBits());
-  if(this->verboseOut_)
-  {
-    pmap.setVerbose(verboseOut_);
-  }
+  // A message is always the outermost level.  This also recovers
+  // the nesting depth if the previous message threw an exception.
+  presenceMapDepth_ = 0;
+  Codecs::PresenceMap & pmap = pushPresenceMap();
 
   static const std::string pmp("PMAP");
   source.beginField(pmp);
-  pmap.decode(source);
+  if(!pmap.decode(source))
+  {
+    reportFatal("[ERR U03]", "EOF while decoding presence map.");
+    return false;
+  }
 
   static const std::string tid("templateID");
   source.beginField(tid);
@@ -48,14 +74,18 @@ Decoder::decodeMessage(
   {
     template_id_t id;
     FieldInstruction::decodeUnsignedInteger(source, *this, id, tid);
+    if(errorPending_)
+    {
+      return false;
+    }
     setTemplateId(id);
   }
   if(verboseOut_)
   {
     (*verboseOut_) << "Template ID: " << getTemplateId() << std::endl;
   }
-  Codecs::TemplateCPtr templatePtr;
-  if(getTemplateRegistry()->getTemplate(templateId_, templatePtr))
+  const Codecs::Template * templatePtr = templateRegistry_->findTemplate(templateId_);
+  if(templatePtr != 0)
   {
     if(templatePtr->getReset())
     {
@@ -67,7 +97,21 @@ Decoder::decodeMessage(
         templatePtr->getApplicationTypeNamespace(),
         templatePtr->fieldCount()));
 
-    decodeSegmentBody(source, pmap, templatePtr, bodyBuilder);
+    try
+    {
+      decodeSegmentBody(source, pmap, *templatePtr, bodyBuilder);
+    }
+    catch(...)
+    {
+      // don't leave the builder holding a half-built message
+      messageBuilder.ignoreMessage(bodyBuilder);
+      throw;
+    }
+    if(errorPending_)
+    {
+      messageBuilder.ignoreMessage(bodyBuilder);
+      return false;
+    }
     if(templatePtr->getIgnore())
     {
       messageBuilder.ignoreMessage(bodyBuilder);
@@ -86,8 +130,9 @@ Decoder::decodeMessage(
     std::string error =  "Unknown template ID:";
     error += boost::lexical_cast<std::string>(getTemplateId());
     reportError("[ERR D9]", error);
+    return false;
   }
-  return;
+  return true;
 }
 
 void
@@ -96,15 +141,16 @@ Decoder::decodeNestedTemplate(
    Messages::ValueMessageBuilder & messageBuilder,
    Messages::FieldIdentityCPtr & identity)
 {
-  Codecs::PresenceMap pmap(getTemplateRegistry()->presenceMapBits());
-  if(this->verboseOut_)
-  {
-    pmap.setVerbose(verboseOut_);
-  }
+  Codecs::PresenceMap & pmap = pushPresenceMap();
 
   static const std::string pmp("PMAP");
   source.beginField(pmp);
-  pmap.decode(source);
+  if(!pmap.decode(source))
+  {
+    reportFatal("[ERR U03]", "EOF while decoding presence map.");
+    popPresenceMap();
+    return;
+  }
 
   static const std::string tid("templateID");
   source.beginField(tid);
@@ -112,14 +158,19 @@ Decoder::decodeNestedTemplate(
   {
     template_id_t id;
     FieldInstruction::decodeUnsignedInteger(source, *this, id, tid);
+    if(errorPending_)
+    {
+      popPresenceMap();
+      return;
+    }
     setTemplateId(id);
   }
   if(verboseOut_)
   {
     (*verboseOut_) << "Nested Template ID: " << getTemplateId() << std::endl;
   }
-  Codecs::TemplateCPtr templatePtr;
-  if(getTemplateRegistry()->getTemplate(getTemplateId(), templatePtr))
+  const Codecs::Template * templatePtr = templateRegistry_->findTemplate(getTemplateId());
+  if(templatePtr != 0)
   {
     if(templatePtr->getReset())
     {
@@ -132,7 +183,7 @@ Decoder::decodeNestedTemplate(
         templatePtr->getApplicationTypeNamespace(),
         templatePtr->fieldCount()));
 
-    decodeSegmentBody(source, pmap, templatePtr, groupBuilder);
+    decodeSegmentBody(source, pmap, *templatePtr, groupBuilder);
     messageBuilder.endGroup(identity, groupBuilder);
   }
   else
@@ -141,49 +192,69 @@ Decoder::decodeNestedTemplate(
     error += boost::lexical_cast<std::string>(getTemplateId());
     reportError("[ERR D9]", error);
   }
-  return;
+  popPresenceMap();
 }
 
 void
 Decoder::decodeGroup(
   DataSource & source,
-  const Codecs::SegmentBodyCPtr & group,
+  const Codecs::SegmentBody & group,
   Messages::ValueMessageBuilder & messageBuilder)
 {
-  size_t presenceMapBits = group->presenceMapBitCount();
-  Codecs::PresenceMap pmap(presenceMapBits);
-  if(this->verboseOut_)
-  {
-    pmap.setVerbose(verboseOut_);
-  }
-
+  size_t presenceMapBits = group.presenceMapBitCount();
+  Codecs::PresenceMap & pmap = pushPresenceMap();
   if(presenceMapBits > 0)
   {
     static const std::string pm("PMAP");
     source.beginField(pm);
-    pmap.decode(source);
+    if(!pmap.decode(source))
+    {
+      reportFatal("[ERR U03]", "EOF while decoding presence map.");
+      popPresenceMap();
+      return;
+    }
+  }
+  else
+  {
+    // Nothing in this group uses the map, but don't leave the previous group's bits visible.
+    pmap.reset();
   }
 // for debugging:  pmap.setVerbose(source.getEcho());
   decodeSegmentBody(source, pmap, group, messageBuilder);
+  popPresenceMap();
 }
 
 void
 Decoder::decodeSegmentBody(
   DataSource & source,
   Codecs::PresenceMap & pmap,
-  const Codecs::SegmentBodyCPtr & segment,
+  const Codecs::SegmentBody & segment,
   Messages::ValueMessageBuilder & messageBuilder)
 {
-  size_t instructionCount = segment->size();
+  if(useDecodePlans_ && !verboseOut_)
+  {
+    const DecodePlan * plan = segment.getDecodePlan();
+    if(plan != 0)
+    {
+      plan->execute(source, pmap, *this, messageBuilder);
+      return;
+    }
+  }
+  size_t instructionCount = segment.size();
   for( size_t nField = 0; nField < instructionCount; ++nField)
   {
     PROFILE_POINT("decode field");
-    const Codecs::FieldInstructionCPtr & instruction = segment->getInstruction(nField);
+    const Codecs::FieldInstructionCPtr & instruction = segment.getInstruction(nField);
     if(verboseOut_)
     {
       (*verboseOut_) <<std::endl << "Decode instruction[" <<nField << "]: " << instruction->getIdentity()->name() << std::endl;
     }
     source.beginField(instruction->getIdentity()->name());
     (void)instruction->decode(source, pmap, *this, messageBuilder);
+    if(errorPending_)
+    {
+      // the rest of the segment can't be trusted.
+      return;
+    }
   }
 }
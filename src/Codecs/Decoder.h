@@ -31,10 +31,29 @@ namespace QuickFAST{
       /// @param registry A registry containing all templates to be used to decode messages.
       explicit Decoder(TemplateRegistryPtr registry);
 
+      /// @brief Select the mechanism used to decode the fields in a segment.
+      ///
+      /// If true the DecodePlan compiled by TemplateRegistry::finalize() is used.
+      /// If false (the default) each FieldInstruction decodes itself via virtual dispatch.
+      /// The results are the same either way.  Verbose output always uses the FieldInstructions.
+      /// @param useDecodePlans true to use the compiled plans.
+      void setUseDecodePlans(bool useDecodePlans)
+      {
+        useDecodePlans_ = useDecodePlans;
+      }
+
+      /// @brief Are compiled decode plans being used?
+      bool getUseDecodePlans()const
+      {
+        return useDecodePlans_;
+      }
+
       /// @brief Decode the next message.
       /// @param[in] source where to read the incoming message(s).
       /// @param[out] message an empty message into which the decoded fields will be stored.
-      void decodeMessage(
+      /// @returns false if an error was recorded rather than thrown; @see Context::setThrowOnError()
+      ///          In that case the message is abandoned without calling endMessage().
+      bool decodeMessage(
         DataSource & source,
         Messages::ValueMessageBuilder & message);
 
@@ -52,7 +71,7 @@ namespace QuickFAST{
       void
       decodeGroup(
         DataSource & source,
-        const SegmentBodyCPtr & segment,
+        const SegmentBody & segment,
         Messages::ValueMessageBuilder & messageBuilder);
 
       /// @brief Decode a segment into a messageBuilder.
@@ -75,8 +94,28 @@ namespace QuickFAST{
       void decodeSegmentBody(
         DataSource & source,
         PresenceMap & pmap,
-        const SegmentBodyCPtr & segment,
+        const SegmentBody & segment,
         Messages::ValueMessageBuilder & messageBuilder);
+
+    private:
+      /// @brief Get the PresenceMap for the next level of nesting.
+      ///
+      /// The maps are reused from message to message so decoding
+      /// does not construct (or allocate) a PresenceMap per segment.
+      PresenceMap & pushPresenceMap();
+
+      /// @brief Release the PresenceMap returned by the most recent pushPresenceMap()
+      void popPresenceMap()
+      {
+        --presenceMapDepth_;
+      }
+
+    private:
+      bool useDecodePlans_;
+      /// One PresenceMap per nesting level.  Grows if templates nest deeper than expected.
+      std::vector<PresenceMapPtr> presenceMaps_;
+      /// How many of the presenceMaps_ are in use.
+      size_t presenceMapDepth_;
     };
   }
 }
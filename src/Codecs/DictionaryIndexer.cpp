@@ -9,6 +9,7 @@ using namespace Codecs;
 
 DictionaryIndexer::DictionaryIndexer()
 : index_(0)
+, stringIndex_(0)
 {
 }
 
@@ -29,53 +30,72 @@ DictionaryIndexer::getIndex(
   const std::string & typeName,
   const std::string & typeNamespace,
   const std::string & key,
-  const std::string & keyNamespace)
+  const std::string & keyNamespace,
+  bool isString)
 {
   if(dictionaryName.empty() || dictionaryName == "global")
   {
     return getDictionaryIndex(
       globalNames_,
-      keyNamespace + '\t' + key);
+      keyNamespace + '\t' + key,
+      isString);
   }
   else if(dictionaryName == "type")
   {
     return getDictionaryIndex(
       typeNames_,
-      typeNamespace + '\t' +typeName + '\t' + keyNamespace + '\t' + key);
+      typeNamespace + '\t' +typeName + '\t' + keyNamespace + '\t' + key,
+      isString);
   }
   else if(dictionaryName == "template")
   {
     return getDictionaryIndex(
       templateNames_,
-      keyNamespace + '\t' + key);
+      keyNamespace + '\t' + key,
+      isString);
   }
   else
   {
     return getDictionaryIndex(
       qualifiedNames_,
-      dictionaryName + '\t' + keyNamespace + '\t' + key);
+      dictionaryName + '\t' + keyNamespace + '\t' + key,
+      isString);
   }
 }
 
 size_t
-DictionaryIndexer::getDictionaryIndex(NameToIndex & nameToIndex, const std::string & key)
+DictionaryIndexer::getDictionaryIndex(NameToIndex & nameToIndex, const std::string & key, bool isString)
 {
+  // numeric and string entries with the same key are distinct.
+  std::string typedKey = (isString ? "s\t" : "n\t") + key;
   size_t result = 0;
-  NameToIndex::const_iterator it = nameToIndex.find(key);
+  NameToIndex::const_iterator it = nameToIndex.find(typedKey);
   if(it != nameToIndex.end())
   {
     result = it->second;
   }
   else
   {
-    result = index_++;
-    nameToIndex[key] = result;
+    result = isString ? stringIndex_++ : index_++;
+    nameToIndex[typedKey] = result;
   }
   return result;
 }
 
 size_t
 DictionaryIndexer::size()const
+{
+  return index_ + stringIndex_;
+}
+
+size_t
+DictionaryIndexer::numericSize()const
 {
   return index_;
 }
+
+size_t
+DictionaryIndexer::stringSize()const
+{
+  return stringIndex_;
+}
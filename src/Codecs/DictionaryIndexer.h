@@ -36,26 +36,41 @@ namespace QuickFAST{
       /// @param typeNamespace namespace to qualifytypeName
       /// @param key is the key to identify the element in the dictionary
       /// @param keyNamespace qualifies the key name.
+      /// @param isString selects the string entries rather than the numeric ones.
+      ///        Numeric and string entries are indexed separately.
       size_t getIndex(
         const std::string & dictionaryName,
         const std::string & typeName,
         const std::string & typeNamespace,
         const std::string & key,
-        const std::string & keyNamespace);
+        const std::string & keyNamespace,
+        bool isString = false);
 
       /// @brief How many dictionary entries are needed.
+      ///
+      /// This is the total of numericSize() and stringSize() so it is large enough
+      /// for either kind of entry.
       /// @returns a count of dictionary entries.
       size_t size()const;
 
+      /// @brief How many numeric (integer and decimal) dictionary entries are needed.
+      /// @returns a count of numeric dictionary entries.
+      size_t numericSize()const;
+
+      /// @brief How many string dictionary entries are needed.
+      /// @returns a count of string dictionary entries.
+      size_t stringSize()const;
+
     private:
       typedef std::map<std::string, size_t> NameToIndex;
-      size_t getDictionaryIndex(NameToIndex & nameToIndex, const std::string & key);
+      size_t getDictionaryIndex(NameToIndex & nameToIndex, const std::string & key, bool isString);
 
       NameToIndex globalNames_;
       NameToIndex templateNames_;
       NameToIndex typeNames_;
       NameToIndex qualifiedNames_;
       size_t index_;
+      size_t stringIndex_;
     };
   }
 }
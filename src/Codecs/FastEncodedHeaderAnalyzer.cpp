@@ -20,6 +20,10 @@ FastEncodedHeaderAnalyzer::FastEncodedHeaderAnalyzer(
 , hasBlockSize_(hasBlockSize)
 , blockSize_(0)
 , fieldCount_(0)
+, hasSequenceField_(false)
+, sequenceField_(0)
+, sequence_(0)
+, sequenceValid_(false)
 {
 }
 
@@ -40,6 +44,8 @@ FastEncodedHeaderAnalyzer::analyzeHeader(DataSource & source, size_t & blockSize
       {
         state_ = ParsingPrefix;
         fieldCount_ = 0;
+        sequence_ = 0;
+        sequenceValid_ = false;
 //        break;
       }
     case ParsingPrefix:
@@ -51,6 +57,11 @@ FastEncodedHeaderAnalyzer::analyzeHeader(DataSource & source, size_t & blockSize
           {
             return false;
           }
+          if(hasSequenceField_ && fieldCount_ == sequenceField_)
+          {
+            sequence_ <<= 7;
+            sequence_ |= (next & 0x7f);
+          }
           if((next & 0x80) != 0)
           {
             ++fieldCount_;
@@ -110,5 +121,26 @@ FastEncodedHeaderAnalyzer::analyzeHeader(DataSource & source, size_t & blockSize
   blockSize = blockSize_;
   skip = false;
   state_ = ParsingIdle;
+  sequenceValid_ = hasSequenceField_ && sequenceField_ < prefixCount_;
   return true;
 }
+
+void
+FastEncodedHeaderAnalyzer::reset()
+{
+  state_ = ParsingIdle;
+  blockSize_ = 0;
+  fieldCount_ = 0;
+  sequence_ = 0;
+  sequenceValid_ = false;
+}
+
+bool
+FastEncodedHeaderAnalyzer::getSequenceNumber(uint64 & sequenceNumber)const
+{
+  if(sequenceValid_)
+  {
+    sequenceNumber = sequence_;
+  }
+  return sequenceValid_;
+}
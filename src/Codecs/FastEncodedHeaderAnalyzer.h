@@ -34,9 +34,19 @@ namespace QuickFAST{
       /// @brief Typical virtual destructor
       virtual ~FastEncodedHeaderAnalyzer();
 
+      /// @brief Take the packet sequence number from one of the prefix fields.
+      /// @param field counts from zero; it must be less than the prefix count.
+      void setSequenceNumberField(size_t field)
+      {
+        sequenceField_ = field;
+        hasSequenceField_ = true;
+      }
+
       ////////////////////////
       // Implement HeaderAnalyzer
       virtual bool analyzeHeader(DataSource & source, size_t & blockSize, bool & skip);
+      virtual void reset();
+      virtual bool getSequenceNumber(uint64 & sequenceNumber)const;
     private:
       size_t prefixCount_;
       size_t suffixCount_;
@@ -51,6 +61,11 @@ namespace QuickFAST{
       bool hasBlockSize_;
       size_t blockSize_;
       size_t fieldCount_;
+      bool hasSequenceField_;
+      size_t sequenceField_;
+      uint64 sequence_;
+      // sequence_ came from a complete header
+      bool sequenceValid_;
     };
   }
 }
@@ -95,6 +95,12 @@ FieldInstruction::getFieldOp() const
   return fieldOp_;
 }
 
+bool
+FieldInstruction::compileDecodeStep(DecodeStep & /*step*/) const
+{
+  return false;
+}
+
 void
 FieldInstruction::decodeConstant(
   Codecs::DataSource & /*source*/,
@@ -244,6 +250,22 @@ FieldInstruction::decodeAscii(
   WorkingBuffer & workingBuffer)
 {
   workingBuffer.clear(false);
+  // If the whole string is in the current buffer, copy it in one block.
+  const uchar * buffer = 0;
+  size_t available = source.currentBytesAvailable();
+  if(source.hasContiguous(available, buffer))
+  {
+    for(size_t pos = 0; pos < available; ++pos)
+    {
+      if((buffer[pos] & stopBit) != 0)
+      {
+        workingBuffer.append(buffer, pos);
+        workingBuffer.push(buffer[pos] & dataBits);
+        source.skipContiguous(pos + 1);
+        return true;
+      }
+    }
+  }
   uchar byte = 0;
   if(!source.getByte(byte))
   {
@@ -308,6 +330,7 @@ FieldInstruction::decodeByteVector(
     if(!source.getByte(byte))
     {
       decoder.reportFatal("[ERR U03]", "End of file: Too few bytes in ByteVector.", name);
+      return;
     }
     buffer.push(byte);
   }
@@ -320,13 +343,21 @@ FieldInstruction::indexDictionaries(
   const std::string & typeName,
   const std::string & typeNamespace)
 {
+  ValueType::Type type = fieldInstructionType();
   fieldOp_->indexDictionaries(
     indexer,
     dictionaryName,
    typeName,
     typeNamespace,
     identity_->getLocalName(),
-    identity_->getNamespace());
+    identity_->getNamespace(),
+    type == ValueType::ASCII || type == ValueType::UTF8 || type == ValueType::BYTEVECTOR);
+}
+
+void
+FieldInstruction::validateDictionaryIndexes(size_t numericSize, size_t stringSize) const
+{
+  fieldOp_->validateDictionaryIndex(numericSize, stringSize);
 }
 
 void
@@ -21,8 +21,12 @@
 #include <Codecs/Context.h>
 #include <Codecs/FieldOp.h>
 #include <Codecs/PresenceMap.h>
+#include <Codecs/DecodePlan_fwd.h>
 
 #include <Common/Profiler.h>
+#if defined(_MSC_VER) && defined(_M_X64)
+# include <intrin.h> // _BitScanReverse64
+#endif
 
 namespace QuickFAST{
   namespace Codecs{
@@ -143,6 +147,13 @@ namespace QuickFAST{
         return identity_->id();
       }
 
+      /// @brief Record where this field is expected to appear in the decoded FieldSet.
+      /// @param ordinal is the position of the field; @see Messages::FieldIdentity::setOrdinal()
+      void setFieldOrdinal(size_t ordinal)
+      {
+        mutableIdentity_->setOrdinal(ordinal);
+      }
+
       /// @brief Retrieve the field's identity.
       /// @returns the field identity.
       Messages::FieldIdentityCPtr & getIdentity()const
@@ -202,6 +213,12 @@ namespace QuickFAST{
         const std::string & typeName,
         const std::string & typeNamespace);
 
+      /// @brief Verify that the dictionary indexes used by this field and any subfields are valid.
+      /// @param numericSize is the number of numeric entries in the dictionary
+      /// @param stringSize is the number of string entries in the dictionary
+      /// @throws TemplateDefinitionError if an index is out of range
+      virtual void validateDictionaryIndexes(size_t numericSize, size_t stringSize) const;
+
       /// @brief Decode the field from a data source.
       ///
       /// @param[in] source supplies the data
@@ -217,6 +234,14 @@ namespace QuickFAST{
         fieldOp_->decode(*this, source, pmap, decoder, builder);
       }
 
+      /// @brief Describe this instruction as a step in a DecodePlan.
+      ///
+      /// The default implementation leaves the step GENERIC which means the
+      /// plan will call decode() for this instruction.
+      /// @param[out] step is filled in if a specialized op code applies.
+      /// @returns true if step was assigned a specialized op code.
+      virtual bool compileDecodeStep(DecodeStep & step) const;
+
       /// @brief Decode the field from a data source.
       ///
       /// @param destination receives the encoded data
@@ -537,6 +562,17 @@ namespace QuickFAST{
         const std::string & name,
         bool ignoreOverflow = false);
 
+      /// @brief Collect the data bits of a stop-bit encoded integer from contiguous data.
+      ///
+      /// Looks at eight bytes at once rather than calling DataSource::getByte()
+      /// for each byte.  Used by decodeSignedInteger() and decodeUnsignedInteger()
+      /// when DataSource::hasContiguous() reports enough data.
+      /// @param[in] buffer points to at least eight bytes of encoded data.
+      /// @param[out] byteCount is the number of bytes in the encoded integer,
+      ///             or zero if none of the eight bytes has the stop bit set.
+      /// @returns the data bits with the first byte most significant (no sign extension).
+      static uint64 gatherStopBitInteger(const uchar * buffer, size_t & byteCount);
+
       /// @brief Check nullable signed or unsigned integer field for null value
       ///
       /// Fixes value to reverse the effect of null encoding.
@@ -671,10 +707,30 @@ namespace QuickFAST{
       bool ignoreOverflow)
     {
       PROFILE_POINT("decodeSignedInteger");
+      const uchar * buffer = 0;
+      if(source.hasContiguous(sizeof(uint64), buffer))
+      {
+        size_t byteCount = 0;
+        uint64 bits = gatherStopBitInteger(buffer, byteCount);
+        // Only take the short cut when the overflow checks below can't fail.
+        if(byteCount != 0 && byteCount <= (sizeof(IntType) * byteSize) / dataShift)
+        {
+          if((buffer[0] & signBit) != 0)
+          {
+            bits |= ~uint64(0) << (byteCount * dataShift);
+          }
+          value = IntType(bits);
+          source.skipContiguous(byteCount);
+          return;
+        }
+      }
+
       uchar byte = 0;
       if(!source.getByte(byte))
       {
         context.reportFatal("[ERR U03]", "Unexpected end of data decoding signedinteger", name);
+        value = 0;
+        return;
       }
 
       value = 0;
@@ -706,6 +762,8 @@ namespace QuickFAST{
         if(!source.getByte(byte))
         {
           context.reportFatal("[ERR D2]", "Unexpected EOF in signed integer field.", name);
+          value = 0;
+          return;
         }
       }
       // include the last byte (the one with the stop bit)
@@ -717,6 +775,47 @@ namespace QuickFAST{
       value |= (byte & dataBits);
     }
 
+    inline
+    uint64
+    FieldInstruction::gatherStopBitInteger(const uchar * buffer, size_t & byteCount)
+    {
+      // Assemble the first byte into the most significant position.
+      // Compilers recognize this idiom as a single (byte swapped) 64 bit load.
+      uint64 word =
+          (uint64(buffer[0]) << 56) | (uint64(buffer[1]) << 48)
+        | (uint64(buffer[2]) << 40) | (uint64(buffer[3]) << 32)
+        | (uint64(buffer[4]) << 24) | (uint64(buffer[5]) << 16)
+        | (uint64(buffer[6]) << 8)  |  uint64(buffer[7]);
+      uint64 stops = word & 0x8080808080808080ULL;
+      if(stops == 0)
+      {
+        byteCount = 0;
+        return 0;
+      }
+      // The first stop bit is the most significant one that is set.
+#if defined(__GNUC__)
+      byteCount = size_t(__builtin_clzll(stops)) / byteSize + 1;
+#elif defined(_MSC_VER) && defined(_M_X64)
+      unsigned long highBit = 0;
+      _BitScanReverse64(&highBit, stops);
+      byteCount = (63 - highBit) / byteSize + 1;
+#else
+      byteCount = 1;
+      while((stops & (uint64(stopBit) << (64 - byteCount * byteSize))) == 0)
+      {
+        ++byteCount;
+      }
+#endif
+      // Discard the stop bits and the bytes following the integer,
+      // then squeeze the 7 bit groups together.
+      word &= 0x7F7F7F7F7F7F7F7FULL;
+      word >>= (sizeof(uint64) - byteCount) * byteSize;
+      word = ((word & 0x7F007F007F007F00ULL) >> 1) | (word & 0x007F007F007F007FULL);
+      word = ((word & 0x3FFF00003FFF0000ULL) >> 2) | (word & 0x00003FFF00003FFFULL);
+      word = ((word & 0x0FFFFFFF00000000ULL) >> 4) | (word & 0x000000000FFFFFFFULL);
+      return word;
+    }
+
     template<typename IntType>
     bool
     FieldInstruction::checkNullInteger(IntType & value)
@@ -795,6 +894,8 @@ namespace QuickFAST{
                       if(!source.getByte(trash))
                       {
                         context.reportFatal("[ERR D2]", "Unexpected EOF in signed 32 bit integer field.", name);
+                        value = 0;
+                        return;
                       }
                     } // overflow
                     return;
@@ -817,6 +918,8 @@ namespace QuickFAST{
         if(!source.getByte(byte))
         {
           context.reportFatal("[ERR U03]", "Unexpected end of data decoding signedinteger", name);
+          value = 0;
+          return;
         }
 
         int32 result = 0;
@@ -848,6 +951,8 @@ namespace QuickFAST{
           if(!source.getByte(byte))
           {
             context.reportFatal("[ERR D2]", "Unexpected EOF in signed integer field.", name);
+            value = 0;
+            return;
           }
         }
         // include the last byte (the one with the stop bit)
@@ -916,6 +1021,8 @@ namespace QuickFAST{
                       if(!source.getByte(trash))
                       {
                         context.reportFatal("[ERR D2]", "Unexpected EOF in integer field.", name);
+                        value = 0;
+                        return;
                       }
                     } // overflow
                     return;
@@ -936,6 +1043,8 @@ namespace QuickFAST{
         if(!source.getByte(byte)) // byte 0
         {
           context.reportFatal("[ERR D2]", "Unexpected EOF in integer field.", name);
+          value = 0;
+          return;
         }
         if(0 == (byte & stopBit))
         {
@@ -944,6 +1053,8 @@ namespace QuickFAST{
           if(!source.getByte(byte)) // byte 1
           {
             context.reportFatal("[ERR D2]", "Unexpected EOF in integer field.", name);
+            value = 0;
+            return;
           }
           if(0 == (byte & stopBit))
           {
@@ -952,6 +1063,8 @@ namespace QuickFAST{
             if(!source.getByte(byte)) // byte 2
             {
               context.reportFatal("[ERR D2]", "Unexpected EOF in integer field.", name);
+              value = 0;
+              return;
             }
             if(0 == (byte & stopBit))
             {
@@ -960,6 +1073,8 @@ namespace QuickFAST{
               if(!source.getByte(byte)) // byte 3
               {
                 context.reportFatal("[ERR D2]", "Unexpected EOF in integer field.", name);
+                value = 0;
+                return;
               }
               if(0 == (byte & stopBit))
               {
@@ -968,6 +1083,8 @@ namespace QuickFAST{
                 if(!source.getByte(byte)) // byte 4
                 {
                   context.reportFatal("[ERR D2]", "Unexpected EOF in integer field.", name);
+                  value = 0;
+                  return;
                 }
                 if(0 == (byte & stopBit))
                 {
@@ -976,6 +1093,8 @@ namespace QuickFAST{
                   if(!source.getByte(byte)) // byte 5
                   {
                     context.reportFatal("[ERR D2]", "Unexpected EOF in integer field.", name);
+                    value = 0;
+                    return;
                   }
                   if(0 == (byte & stopBit)) // overflow
                   {
@@ -989,6 +1108,8 @@ namespace QuickFAST{
                       if(!source.getByte(trash))
                       {
                         context.reportFatal("[ERR D2]", "Unexpected EOF in integer field.", name);
+                        value = 0;
+                        return;
                       }
                     } // overflow
                   } // byte 5
@@ -1014,10 +1135,26 @@ namespace QuickFAST{
       bool ignoreOverflow)
     {
       PROFILE_POINT("decodeUnsignedInteger");
+      const uchar * buffer = 0;
+      if(source.hasContiguous(sizeof(uint64), buffer))
+      {
+        size_t byteCount = 0;
+        uint64 bits = gatherStopBitInteger(buffer, byteCount);
+        // Only take the short cut when the overflow checks below can't fail.
+        if(byteCount != 0 && byteCount <= (sizeof(UnsignedIntType) * byteSize) / dataShift + 1)
+        {
+          value = UnsignedIntType(bits);
+          source.skipContiguous(byteCount);
+          return;
+        }
+      }
+
       uchar byte = 0;
       if(!source.getByte(byte))
       {
         context.reportFatal("[ERR U03]", "Unexpected end of data decoding unsigned integer", name);
+        value = 0;
+        return;
       }
 
       value = 0;
@@ -1040,6 +1177,8 @@ namespace QuickFAST{
         if(!source.getByte(byte))
         {
           context.reportFatal("[ERR U03]", "End of file without stop bit decoding unsigned integer.", name);
+          value = 0;
+          return;
         }
       }
       if(!ignoreOverflow && (value & overflowMask) != overflowCheck)
@@ -217,27 +217,34 @@ FieldInstructionAscii::decodeDelta(
       return;
     }
   }
-  std::string deltaValue;
+  const uchar * delta = 0;
+  size_t deltaSize = 0;
   WorkingBuffer & buffer = decoder.getWorkingBuffer();
   if(decodeAsciiFromSource(source, true, buffer))
   {
-    deltaValue = std::string(
-      reinterpret_cast<const char *>(buffer.begin()),
-      buffer.size());
+    delta = buffer.begin();
+    deltaSize = buffer.size();
   }
 
-
-  std::string previousValue;
-  Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
-  if(previousStatus == Context::UNDEFINED_VALUE)
+  // The new value is built in place in the dictionary entry, so be sure
+  // the entry holds the previous value.
+  const uchar * previous = 0;
+  size_t previousLength = 0;
+  Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previous, previousLength);
+  if(previousStatus != Context::OK_VALUE)
   {
-    if(fieldOp_->hasValue())
+    if(previousStatus == Context::UNDEFINED_VALUE && fieldOp_->hasValue())
     {
-      previousValue = fieldOp_->getValue();
+      fieldOp_->setDictionaryValue(decoder, fieldOp_->getValue());
+      previousLength = fieldOp_->getValue().size();
+    }
+    else
+    {
+      fieldOp_->setDictionaryValue(decoder, "");
+      previousLength = 0;
     }
   }
 
-  size_t previousLength = previousValue.length();
   if( deltaLength < 0)
   {
     // operate on front of string
@@ -249,13 +256,7 @@ FieldInstructionAscii::decodeDelta(
       decoder.reportError("[ERR D7]", "ASCII tail delta front length exceeds length of previous string.", *identity_);
       deltaLength = QuickFAST::int32(previousLength);
     }
-    std::string value = deltaValue + previousValue.substr(deltaLength);
-    builder.addValue(
-      identity_,
-      ValueType::ASCII,
-      reinterpret_cast<const uchar *>(value.c_str()),
-      value.size());
-    fieldOp_->setDictionaryValue(decoder, value);
+    fieldOp_->replaceDictionaryStringFront(decoder, deltaLength, delta, deltaSize);
   }
   else
   { // operate on end of string
@@ -268,14 +269,16 @@ FieldInstructionAscii::decodeDelta(
       decoder.reportError("[ERR D7]", "ASCII tail delta back length exceeds length of previous string.", *identity_);
       deltaLength = QuickFAST::uint32(previousLength);
     }
-    std::string value = previousValue.substr(0, previousLength - deltaLength) + deltaValue;
-    builder.addValue(
-      identity_,
-      ValueType::ASCII,
-      reinterpret_cast<const uchar *>(value.c_str()),
-      value.size());
-    fieldOp_->setDictionaryValue(decoder, value);
+    fieldOp_->replaceDictionaryStringBack(decoder, deltaLength, delta, deltaSize);
   }
+  const uchar * value = 0;
+  size_t valueSize = 0;
+  fieldOp_->getDictionaryValue(decoder, value, valueSize);
+  builder.addValue(
+    identity_,
+    ValueType::ASCII,
+    value,
+    valueSize);
 }
 
 void
@@ -292,30 +295,40 @@ FieldInstructionAscii::decodeTail(
     WorkingBuffer & buffer = decoder.getWorkingBuffer();
     if(decodeAsciiFromSource(source, isMandatory(), buffer))
     {
-      const std::string tailValue(reinterpret_cast<const char *>(buffer.begin()), buffer.size());
-      size_t tailLength = tailValue.length();
-      std::string previousValue;
-      Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
-      if(previousStatus == Context::UNDEFINED_VALUE)
+      const uchar * tail = buffer.begin();
+      size_t tailLength = buffer.size();
+      // The new value is built in place in the dictionary entry, so be sure
+      // the entry holds the previous value.
+      const uchar * previous = 0;
+      size_t previousLength = 0;
+      Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previous, previousLength);
+      if(previousStatus != Context::OK_VALUE)
       {
-        if(fieldOp_->hasValue())
+        if(previousStatus == Context::UNDEFINED_VALUE && fieldOp_->hasValue())
+        {
+          fieldOp_->setDictionaryValue(decoder, fieldOp_->getValue());
+          previousLength = fieldOp_->getValue().size();
+        }
+        else
         {
-          previousValue = fieldOp_->getValue();
-          fieldOp_->setDictionaryValue(decoder, previousValue);
+          fieldOp_->setDictionaryValue(decoder, "");
+          previousLength = 0;
         }
       }
-      size_t previousLength = previousValue.length();
-      if(tailLength > previousLength)
+      size_t replaceLength = tailLength;
+      if(replaceLength > previousLength)
       {
-        tailLength = previousLength;
+        replaceLength = previousLength;
       }
-      std::string value(previousValue.substr(0, previousLength - tailLength) + tailValue);
+      fieldOp_->replaceDictionaryStringBack(decoder, replaceLength, tail, tailLength);
+      const uchar * value = 0;
+      size_t valueSize = 0;
+      fieldOp_->getDictionaryValue(decoder, value, valueSize);
       builder.addValue(
         identity_,
         ValueType::ASCII,
-        reinterpret_cast<const uchar *>(value.c_str()),
-        value.size());
-      fieldOp_->setDictionaryValue(decoder, value);
+        value,
+        valueSize);
     }
     else // null
     {
@@ -324,15 +337,15 @@ FieldInstructionAscii::decodeTail(
   }
   else // pmap says not in stream
   {
-    std::string previousValue;
-    Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
+    const uchar * previous = 0;
+    size_t previousLength = 0;
+    Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previous, previousLength);
     if(previousStatus == Context::OK_VALUE)
     {
-      Messages::FieldCPtr field = Messages::FieldAscii::create(previousValue);
       builder.addValue(identity_,
         ValueType::ASCII,
-        reinterpret_cast<const uchar *>(previousValue.c_str()),
-        previousValue.size());
+        previous,
+        previousLength);
     }
     else if(fieldOp_->hasValue())
     {
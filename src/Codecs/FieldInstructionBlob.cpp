@@ -35,7 +35,9 @@ FieldInstructionBlob::decodeBlobFromSource(
   Codecs::DataSource & source,
   Codecs::Context & context,
   bool mandatory,
-  WorkingBuffer & buffer) const
+  WorkingBuffer & buffer,
+  const uchar *& value,
+  size_t & valueSize) const
 {
   PROFILE_POINT("blob::decodeBlobFromSource");
   uint32 length;
@@ -48,7 +50,17 @@ FieldInstructionBlob::decodeBlobFromSource(
       return false;
     }
   }
-  decodeByteVector(context, source, identity_->name(), buffer, length);
+  valueSize = length;
+  if(source.hasContiguous(length, value))
+  {
+    // use the data in place rather than copying it.
+    source.skipContiguous(length);
+  }
+  else
+  {
+    decodeByteVector(context, source, identity_->name(), buffer, length);
+    value = buffer.begin();
+  }
   return true;
 }
 
@@ -63,10 +75,10 @@ FieldInstructionBlob::decodeNop(
   // note NOP never uses pmap.  It uses a null value instead for optional fields
   // so it's always safe to do the basic decode.
   WorkingBuffer& buffer = decoder.getWorkingBuffer();
-  if(decodeBlobFromSource(source, decoder, isMandatory(), buffer))
+  const uchar * value = 0;
+  size_t valueSize = 0;
+  if(decodeBlobFromSource(source, decoder, isMandatory(), buffer, value, valueSize))
   {
-    const uchar * value = buffer.begin();
-    size_t valueSize = buffer.size();
     builder.addValue(identity_, type_, value, valueSize);
   }
 }
@@ -115,10 +127,10 @@ FieldInstructionBlob::decodeDefault(
   if(pmap.checkNextField())
   {
     WorkingBuffer& buffer = decoder.getWorkingBuffer();
-    if(decodeBlobFromSource(source, decoder, isMandatory(), buffer))
+    const uchar * value = 0;
+    size_t valueSize = 0;
+    if(decodeBlobFromSource(source, decoder, isMandatory(), buffer, value, valueSize))
     {
-      const uchar * value = buffer.begin();
-      size_t valueSize = buffer.size();
       builder.addValue(
         identity_,
         type_,
@@ -155,11 +167,11 @@ FieldInstructionBlob::decodeCopy(
   if(pmap.checkNextField())
   {
     // field is in the stream, use it
-  WorkingBuffer& buffer = decoder.getWorkingBuffer();
-  if(decodeBlobFromSource(source, decoder, isMandatory(), buffer))
-  {
-    const uchar * value = buffer.begin();
-    size_t valueSize = buffer.size();
+    WorkingBuffer& buffer = decoder.getWorkingBuffer();
+    const uchar * value = 0;
+    size_t valueSize = 0;
+    if(decodeBlobFromSource(source, decoder, isMandatory(), buffer, value, valueSize))
+    {
       builder.addValue(
         identity_,
         type_,
@@ -220,25 +232,29 @@ FieldInstructionBlob::decodeDelta(
     }
   }
 
-  std::string deltaValue;
   WorkingBuffer& buffer = decoder.getWorkingBuffer();
-  if(decodeBlobFromSource(source, decoder, true /*isMandatory()*/, buffer))
-  {
-    const uchar * value = buffer.begin();
-    size_t valueSize = buffer.size();
-    deltaValue = std::string(reinterpret_cast<const char *>(value), valueSize);
-  }
-
-  std::string previousValue;
-  Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
-  if(previousStatus == Context::UNDEFINED_VALUE)
+  const uchar * delta = 0;
+  size_t deltaSize = 0;
+  decodeBlobFromSource(source, decoder, true /*isMandatory()*/, buffer, delta, deltaSize);
+
+  // The new value is built in place in the dictionary entry, so be sure
+  // the entry holds the previous value.
+  const uchar * previous = 0;
+  size_t previousLength = 0;
+  Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previous, previousLength);
+  if(previousStatus != Context::OK_VALUE)
   {
-    if(fieldOp_->hasValue())
+    if(previousStatus == Context::UNDEFINED_VALUE && fieldOp_->hasValue())
     {
-      previousValue = fieldOp_->getValue();
+      fieldOp_->setDictionaryValue(decoder, fieldOp_->getValue());
+      previousLength = fieldOp_->getValue().size();
+    }
+    else
+    {
+      fieldOp_->setDictionaryValue(decoder, "");
+      previousLength = 0;
     }
   }
-  size_t previousLength = previousValue.size();
 
   if( deltaLength < 0)
   {
@@ -251,13 +267,7 @@ FieldInstructionBlob::decodeDelta(
       decoder.reportError("[ERR D7]", "String tail delta front length exceeds length of previous string.", *identity_);
       deltaLength = QuickFAST::int32(previousLength);
     }
-    std::string value = deltaValue + previousValue.substr(deltaLength);
-    builder.addValue(
-      identity_,
-      type_,
-      reinterpret_cast<const uchar *>(value.c_str()),
-      value.size());
-    fieldOp_->setDictionaryValue(decoder, value);
+    fieldOp_->replaceDictionaryStringFront(decoder, deltaLength, delta, deltaSize);
   }
   else
   { // operate on end of string
@@ -271,14 +281,16 @@ FieldInstructionBlob::decodeDelta(
       deltaLength = QuickFAST::uint32(previousLength);
     }
 
-    std::string value = previousValue.substr(0, previousLength - deltaLength) + deltaValue;
-    builder.addValue(
-      identity_,
-      type_,
-      reinterpret_cast<const uchar *>(value.c_str()),
-      value.size());
-    fieldOp_->setDictionaryValue(decoder, value);
+    fieldOp_->replaceDictionaryStringBack(decoder, deltaLength, delta, deltaSize);
   }
+  const uchar * value = 0;
+  size_t valueSize = 0;
+  fieldOp_->getDictionaryValue(decoder, value, valueSize);
+  builder.addValue(
+    identity_,
+    type_,
+    value,
+    valueSize);
 }
 
 void
@@ -293,33 +305,42 @@ FieldInstructionBlob::decodeTail(
   {
     // field is in the stream, use it
     WorkingBuffer& buffer = decoder.getWorkingBuffer();
-    if(decodeBlobFromSource(source, decoder, isMandatory(), buffer))
-    {
-      size_t tailLength = buffer.size();
-      std::string tailValue(reinterpret_cast<const char *>(buffer.begin()), tailLength);
-
-      std::string previousValue;
-      Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
-      if(previousStatus == Context::UNDEFINED_VALUE)
+    const uchar * tail = 0;
+    size_t tailLength = 0;
+    if(decodeBlobFromSource(source, decoder, isMandatory(), buffer, tail, tailLength))
+    {
+      // The new value is built in place in the dictionary entry, so be sure
+      // the entry holds the previous value.
+      const uchar * previous = 0;
+      size_t previousLength = 0;
+      Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previous, previousLength);
+      if(previousStatus != Context::OK_VALUE)
       {
-        if(fieldOp_->hasValue())
+        if(previousStatus == Context::UNDEFINED_VALUE && fieldOp_->hasValue())
         {
-          previousValue = fieldOp_->getValue();
-          fieldOp_->setDictionaryValue(decoder, previousValue);
+          fieldOp_->setDictionaryValue(decoder, fieldOp_->getValue());
+          previousLength = fieldOp_->getValue().size();
+        }
+        else
+        {
+          fieldOp_->setDictionaryValue(decoder, "");
+          previousLength = 0;
         }
       }
-      size_t previousLength = previousValue.length();
-      if(tailLength > previousLength)
+      size_t replaceLength = tailLength;
+      if(replaceLength > previousLength)
       {
-        tailLength = previousLength;
+        replaceLength = previousLength;
       }
-      std::string value(previousValue.substr(0, previousLength - tailLength) + tailValue);
+      fieldOp_->replaceDictionaryStringBack(decoder, replaceLength, tail, tailLength);
+      const uchar * value = 0;
+      size_t valueSize = 0;
+      fieldOp_->getDictionaryValue(decoder, value, valueSize);
       builder.addValue(
         identity_,
         type_,
-        reinterpret_cast<const uchar *>(value.c_str()),
-        value.size());
-      fieldOp_->setDictionaryValue(decoder, value);
+        value,
+        valueSize);
     }
     else // null
     {
@@ -328,16 +349,16 @@ FieldInstructionBlob::decodeTail(
   }
   else // pmap says not in stream
   {
-    std::string previousValue;
-    Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previousValue);
+    const uchar * previous = 0;
+    size_t previousLength = 0;
+    Context::DictionaryStatus previousStatus = fieldOp_->getDictionaryValue(decoder, previous, previousLength);
     if(previousStatus == Context::OK_VALUE)
     {
-
       builder.addValue(
         identity_,
         type_,
-        reinterpret_cast<const uchar *>(previousValue.c_str()),
-        previousValue.size());
+        previous,
+        previousLength);
     }
     else if(fieldOp_->hasValue())
     {
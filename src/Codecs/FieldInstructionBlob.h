@@ -127,12 +127,25 @@ namespace QuickFAST{
       void interpretValue(const std::string & value);
 
       /// @brief helper routine to decode the blob data
+      ///
+      /// If the data is contiguous in the source's buffer, value points
+      /// into that buffer and no copy is made.  Otherwise the data is
+      /// collected in buffer.
+      /// @param source supplies the encoded data
+      /// @param context in which the decoding occurs.
+      /// @param mandatory is false if the field is nullable
+      /// @param buffer is used only if the data is not contiguous.
+      /// @param[out] value points to the decoded data
+      /// @param[out] valueSize is the length of the decoded data
+      /// @returns false if the field was null.
       bool
       decodeBlobFromSource(
         Codecs::DataSource & source,
         Codecs::Context & context,
         bool mandatory,
-        WorkingBuffer & buffer) const;
+        WorkingBuffer & buffer,
+        const uchar *& value,
+        size_t & valueSize) const;
 
       /// @brief helper routine to encode a nullable, but not null value
       void encodeNullableBlob(
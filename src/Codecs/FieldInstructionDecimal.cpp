@@ -608,6 +608,17 @@ FieldInstructionDecimal::indexDictionaries(
   }
 }
 
+void
+FieldInstructionDecimal::validateDictionaryIndexes(size_t numericSize, size_t stringSize) const
+{
+  FieldInstruction::validateDictionaryIndexes(numericSize, stringSize);
+  if(bool(exponentInstruction_))
+  {
+    exponentInstruction_->validateDictionaryIndexes(numericSize, stringSize);
+    mantissaInstruction_->validateDictionaryIndexes(numericSize, stringSize);
+  }
+}
+
 void
 FieldInstructionDecimal::finalize(TemplateRegistry & templateRegistry)
 {
@@ -153,6 +153,8 @@ namespace QuickFAST{
         const std::string & typeName,
         const std::string & typeNamespace);
 
+      virtual void validateDictionaryIndexes(size_t numericSize, size_t stringSize) const;
+
       virtual void finalize(TemplateRegistry & registry);
       virtual ValueType::Type fieldInstructionType()const;
       virtual void displayBody(std::ostream & output, size_t indent)const;
@@ -58,6 +58,7 @@ FieldInstructionGroup::decodeNop(
     if(!segmentBody_)
     {
       decoder.reportFatal("[ERR U08}", "Segment not defined for Group instruction.");
+      return;
     }
     if(messageBuilder.getApplicationType() != segmentBody_->getApplicationType())
     {
@@ -69,7 +70,7 @@ FieldInstructionGroup::decodeNop(
           segmentBody_->getApplicationTypeNamespace(),
           segmentBody_->fieldCount()));
 
-      decoder.decodeGroup(source, segmentBody_, groupBuilder);
+      decoder.decodeGroup(source, *segmentBody_, groupBuilder);
       messageBuilder.endGroup(
         identity_,
         groupBuilder);
@@ -86,7 +87,7 @@ FieldInstructionGroup::decodeNop(
       // encoded.  In fact, the same message encoded with different
       // templates could be transmitted with different sets of fields
       // in groups.
-      decoder.decodeGroup(source, segmentBody_, messageBuilder);
+      decoder.decodeGroup(source, *segmentBody_, messageBuilder);
     }
   }
 }
@@ -161,6 +162,15 @@ FieldInstructionGroup::indexDictionaries(
   }
 }
 
+void
+FieldInstructionGroup::validateDictionaryIndexes(size_t numericSize, size_t stringSize) const
+{
+  if(segmentBody_)
+  {
+    segmentBody_->validateDictionaryIndexes(numericSize, stringSize);
+  }
+}
+
 ValueType::Type
 FieldInstructionGroup::fieldInstructionType()const
 {
@@ -11,6 +11,7 @@
 #include <Codecs/Encoder.h>
 #include <Codecs/DataSource.h>
 #include <Codecs/DataDestination.h>
+#include <Codecs/DecodePlan.h>
 #include <Messages/ValueMessageBuilder.h>
 #include <Messages/MessageAccessor.h>
 #include <Messages/Field.h>
@@ -55,6 +56,8 @@ namespace QuickFAST{
         typedValueIsDefined_ = true;
       }
 
+      virtual bool compileDecodeStep(DecodeStep & step) const;
+
       virtual void decodeNop(
         Codecs::DataSource & source,
         Codecs::PresenceMap & pmap,
@@ -210,6 +213,41 @@ namespace QuickFAST{
       }
     }
 
+    template<typename INTEGER_TYPE, ValueType::Type VALUE_TYPE, bool SIGNED>
+    bool
+    FieldInstructionInteger<INTEGER_TYPE, VALUE_TYPE, SIGNED>::
+    compileDecodeStep(DecodeStep & step) const
+    {
+      DecodeStep::IntegerKind kind;
+      if(sizeof(INTEGER_TYPE) == sizeof(int32))
+      {
+        kind = SIGNED ? DecodeStep::INT32_KIND : DecodeStep::UINT32_KIND;
+      }
+      else if(sizeof(INTEGER_TYPE) == sizeof(int64))
+      {
+        kind = SIGNED ? DecodeStep::INT64_KIND : DecodeStep::UINT64_KIND;
+      }
+      else
+      {
+        // 8 and 16 bit integers are rare enough to leave them GENERIC
+        return false;
+      }
+
+      FieldOp::OpType opType = fieldOp_->opType();
+      if(opType == FieldOp::TAIL || opType == FieldOp::UNKNOWN || fieldOp_->hasPMapBit())
+      {
+        return false;
+      }
+
+      step.opCode_ = DecodeStep::integerOpCode(kind, opType, isMandatory());
+      step.valueType_ = VALUE_TYPE;
+      step.dictionaryIndex_ = fieldOp_->getDictionaryIndex();
+      step.initialValue_ = uint64(typedValue_);
+      step.hasInitialValue_ = fieldOp_->hasValue();
+      step.ignoreOverflow_ = ignoreOverflow_;
+      return true;
+    }
+
     template<typename INTEGER_TYPE, ValueType::Type VALUE_TYPE, bool SIGNED>
     void
     FieldInstructionInteger<INTEGER_TYPE, VALUE_TYPE, SIGNED>::
@@ -62,6 +62,7 @@ FieldInstructionSequence::decodeNop(
   if(!segment_)
   {
     decoder.reportFatal("[ERR U07]", "SegmentBody not defined for Sequence instruction.");
+    return;
   }
   size_t length = 0;
   Codecs::FieldInstructionCPtr lengthInstruction;
@@ -77,7 +78,7 @@ FieldInstructionSequence::decodeNop(
     defaultLengthInstruction.setPresence(isMandatory());
     defaultLengthInstruction.decode(source, pmap, decoder, lengthSet);
   }
-  if(lengthSet.isSet())
+  if(lengthSet.isSet() && !decoder.hasError())
   {
     length = lengthSet.value();
 
@@ -103,8 +104,13 @@ FieldInstructionSequence::decodeNop(
           segment_->getApplicationType(),
           segment_->getApplicationTypeNamespace(),
           segment_->fieldCount()));
-      decoder.decodeGroup(source, segment_, entrySet);
+      decoder.decodeGroup(source, *segment_, entrySet);
       sequenceBuilder.endSequenceEntry(entrySet);
+      if(decoder.hasError())
+      {
+        // don't trust the length of a sequence in a corrupt message.
+        break;
+      }
     }
     builder.endSequence(identity_, sequenceBuilder);
   }
@@ -211,6 +217,12 @@ FieldInstructionSequence::indexDictionaries(
   segment_->indexDictionaries(indexer, dictionaryName,typeName, typeNamespace);
 }
 
+void
+FieldInstructionSequence::validateDictionaryIndexes(size_t numericSize, size_t stringSize) const
+{
+  segment_->validateDictionaryIndexes(numericSize, stringSize);
+}
+
 ValueType::Type
 FieldInstructionSequence::fieldInstructionType()const
 {
@@ -68,6 +68,8 @@ namespace QuickFAST{
         const std::string & typeName,
         const std::string & typeNamespace);
 
+      virtual void validateDictionaryIndexes(size_t numericSize, size_t stringSize) const;
+
       virtual void finalize(TemplateRegistry & templateRegistry);
 
       virtual ValueType::Type fieldInstructionType()const;
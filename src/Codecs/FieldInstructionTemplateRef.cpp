@@ -68,6 +68,7 @@ FieldInstructionStaticTemplateRef::decodeNop(
   if(!decoder.findTemplate(templateName_, templateNamespace_, target))
   {
     decoder.reportFatal("[ERR D9]", "Unknown template name for static templateref.", *identity_);
+    return;
   }
 
   if(messageBuilder.getApplicationType() != target->getApplicationType())
@@ -79,7 +80,7 @@ FieldInstructionStaticTemplateRef::decodeNop(
         target->getApplicationTypeNamespace(),
         target->fieldCount()));
 
-    decoder.decodeSegmentBody(source, pmap, target, groupBuilder);
+    decoder.decodeSegmentBody(source, pmap, *target, groupBuilder);
     messageBuilder.endGroup(
       identity_,
       groupBuilder);
@@ -95,7 +96,7 @@ FieldInstructionStaticTemplateRef::decodeNop(
     // templates could be transmitted with different sets of fields defined
     // by templateRefs, but the underlying application type should not reflect
     // the technique used to encode/decode it.
-    decoder.decodeSegmentBody(source, pmap, target, messageBuilder);
+    decoder.decodeSegmentBody(source, pmap, *target, messageBuilder);
   }
 }
 
@@ -14,6 +14,7 @@ FieldOp::FieldOp()
 : valueIsDefined_(false)
 , dictionaryIndex_(0)
 , dictionaryIndexValid_(false)
+, dictionaryIsString_(false)
 , pmapBit_(0)
 , pmapBitValid_(false)
 {
@@ -26,7 +27,8 @@ FieldOp::indexDictionaries(
   const std::string & typeName,
   const std::string & typeNamespace,
   const std::string & fieldName,
-  const std::string & fieldNamespace)
+  const std::string & fieldNamespace,
+  bool isString)
 {
   if(usesDictionary())
   {
@@ -47,8 +49,23 @@ FieldOp::indexDictionaries(
       typeName,
       typeNamespace,
       key,
-      keyNamespace);
+      keyNamespace,
+      isString);
     dictionaryIndexValid_ = true;
+    dictionaryIsString_ = isString;
+  }
+}
+
+void
+FieldOp::validateDictionaryIndex(size_t numericSize, size_t stringSize) const
+{
+  if(usesDictionary())
+  {
+    size_t size = dictionaryIsString_ ? stringSize : numericSize;
+    if(!dictionaryIndexValid_ || dictionaryIndex_ >= size)
+    {
+      throw TemplateDefinitionError("Illegal dictionary index.");
+    }
   }
 }
 
@@ -113,6 +113,20 @@ namespace QuickFAST{
         valueIsDefined_ = true;
       }
 
+      /// @brief Has a specific pmap bit been assigned to this field?
+      /// @returns true if setPMapBit() was called.
+      bool hasPMapBit()const
+      {
+        return pmapBitValid_;
+      }
+
+      /// @brief Access the dictionary index assigned by indexDictionaries()
+      /// @returns the index; only meaningful if usesDictionary() is true.
+      size_t getDictionaryIndex()const
+      {
+        return dictionaryIndex_;
+      }
+
       /// @brief Set the pmap bit to be used for this field
       ///
       /// This is not a part of the FAST spec. It is here to support
@@ -152,26 +166,48 @@ namespace QuickFAST{
       /// @param typeNamespace is the namespace to qualify the application type.
       /// @param fieldName is the name of this field.
       /// @param fieldNamespace qualifies fieldName
+      /// @param isString is true if the field's value is a string (ascii, utf8, or byte vector)
       void indexDictionaries(
         DictionaryIndexer & indexer,
         const std::string & dictionaryName,
         const std::string & typeName,
         const std::string & typeNamespace,
         const std::string & fieldName,
-        const std::string & fieldNamespace);
+        const std::string & fieldNamespace,
+        bool isString);
+
+      /// @brief Verify that the index assigned by indexDictionaries() fits the dictionary.
+      /// @param numericSize is the number of numeric entries in the dictionary
+      /// @param stringSize is the number of string entries in the dictionary
+      /// @throws TemplateDefinitionError if the index is missing or out of range
+      void validateDictionaryIndex(size_t numericSize, size_t stringSize) const;
 
       /// @brief set the value of the dictionary entry for this field to be undefined
       /// @param context holds the dictionary
       void setDictionaryValueUndefined(Context & context)
       {
-        context.setDictionaryValueUndefined(dictionaryIndex_);
+        if(dictionaryIsString_)
+        {
+          context.setDictionaryStringUndefined(dictionaryIndex_);
+        }
+        else
+        {
+          context.setDictionaryValueUndefined(dictionaryIndex_);
+        }
       }
 
       /// @brief set the value of the dictionary entry for this field to be null
       /// @param context holds the dictionary
       void setDictionaryValueNull(Context & context)
       {
-        context.setDictionaryValueNull(dictionaryIndex_);
+        if(dictionaryIsString_)
+        {
+          context.setDictionaryStringNull(dictionaryIndex_);
+        }
+        else
+        {
+          context.setDictionaryValueNull(dictionaryIndex_);
+        }
       }
 
       /// @brief set the value of the dictionary entry for this field
@@ -271,6 +307,26 @@ namespace QuickFAST{
         context.setDictionaryValue(dictionaryIndex_, value);
       }
 
+      /// @brief edit the front of the string in the dictionary entry for this field
+      /// @param context holds the dictionary
+      /// @param removeLength is how many bytes to remove from the front of the string
+      /// @param value points to the bytes to be inserted in their place
+      /// @param length is the number of bytes pointed to by value
+      void replaceDictionaryStringFront(Context & context, size_t removeLength, const unsigned char * value, size_t length)
+      {
+        context.replaceDictionaryStringFront(dictionaryIndex_, removeLength, value, length);
+      }
+
+      /// @brief edit the end of the string in the dictionary entry for this field
+      /// @param context holds the dictionary
+      /// @param removeLength is how many bytes to remove from the end of the string
+      /// @param value points to the bytes to be appended in their place
+      /// @param length is the number of bytes pointed to by value
+      void replaceDictionaryStringBack(Context & context, size_t removeLength, const unsigned char * value, size_t length)
+      {
+        context.replaceDictionaryStringBack(dictionaryIndex_, removeLength, value, length);
+      }
+
       /// @brief retrieve the value of the dictionary entry for this field
       /// @param context holds the dictionary
       /// @param value is the value that was found
@@ -320,6 +376,8 @@ namespace QuickFAST{
       size_t dictionaryIndex_;
       /// true if dictionaryIndex_ is valid;
       bool dictionaryIndexValid_;
+      /// true if dictionaryIndex_ refers to a string entry
+      bool dictionaryIsString_;
 
       /// For non-conforming implmentations that assign specific pmap bits....
       size_t pmapBit_;
@@ -5,7 +5,6 @@
 #include "FixedSizeHeaderAnalyzer.h"
 #include <Common/Types.h>
 #include <Codecs/DataSource.h>
-#include <Common/ByteSwapper.h>
 
 using namespace ::QuickFAST;
 using namespace ::QuickFAST::Codecs;
@@ -19,7 +18,11 @@ FixedSizeHeaderAnalyzer::FixedSizeHeaderAnalyzer(
 : prefixBytes_(prefixBytes)
 , sizeBytes_(sizeBytes)
 , suffixBytes_(suffixBytes)
-, swapNeeded_(ByteSwapper::isBigEndian() ? !bigEndian : bigEndian)
+, littleEndian_(!bigEndian)
+, sequenceOffset_(0)
+, sequenceBytes_(0)
+, sequence_(0)
+, sequenceValid_(false)
 , state_(ParsingIdle)
 , blockSize_(0)
 , byteCount_(0)
@@ -46,6 +49,8 @@ FixedSizeHeaderAnalyzer::analyzeHeader(DataSource & source, size_t & blockSize,
         source.beginField("FIXED_SIZE_HEADER");
         state_ = ParsingPrefix;
         byteCount_ = 0;
+        sequence_ = 0;
+        sequenceValid_ = false;
         break;
       }
     case ParsingPrefix:
@@ -57,6 +62,17 @@ FixedSizeHeaderAnalyzer::analyzeHeader(DataSource & source, size_t & blockSize,
           {
             return false;
           }
+          if(byteCount_ >= sequenceOffset_ && byteCount_ < sequenceOffset_ + sequenceBytes_)
+          {
+            if(littleEndian_)
+            {
+              sequence_ |= uint64(next & 0xFF) << ((byteCount_ - sequenceOffset_) * 8);
+            }
+            else
+            {
+              sequence_ = (sequence_ << 8) | (next & 0xFF);
+            }
+          }
           ++byteCount_;
         }
         state_ = ParsingBlockSize;
@@ -73,9 +89,10 @@ FixedSizeHeaderAnalyzer::analyzeHeader(DataSource & source, size_t & blockSize,
           {
             return false;
           }
-          if(swapNeeded_)
+          // The bytes arrive one at a time, so the host's byte order does not matter.
+          if(littleEndian_)
           {
-            blockSize |= (next & 0xFF) << (byteCount_ * 8);
+            blockSize_ |= size_t(next & 0xFF) << (byteCount_ * 8);
           }
           else
           {
@@ -110,6 +127,7 @@ FixedSizeHeaderAnalyzer::analyzeHeader(DataSource & source, size_t & blockSize,
     }
   }
   state_ = ParsingIdle;
+  sequenceValid_ = sequenceBytes_ != 0 && sequenceOffset_ + sequenceBytes_ <= prefixBytes_;
   blockSize = blockSize_;
   blockSize_ = 0;
   byteCount_ = 0;
@@ -127,4 +145,16 @@ FixedSizeHeaderAnalyzer::reset()
   state_ = ParsingIdle;
   blockSize_ = 0;
   byteCount_ = 0;
+  sequence_ = 0;
+  sequenceValid_ = false;
+}
+
+bool
+FixedSizeHeaderAnalyzer::getSequenceNumber(uint64 & sequenceNumber)const
+{
+  if(sequenceValid_)
+  {
+    sequenceNumber = sequence_;
+  }
+  return sequenceValid_;
 }
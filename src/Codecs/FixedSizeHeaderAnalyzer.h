@@ -42,15 +42,32 @@ namespace QuickFAST{
         testSkip_ = testSkip;
       }
 
+      /// @brief Find a packet sequence number in the prefix.
+      ///
+      /// It is read in the same byte order as the block size.
+      /// @param offset is where the sequence number starts, counting from the start of the header.
+      /// @param bytes is the size of the sequence number; at most 8.  Zero means there is none.
+      void setSequenceNumber(size_t offset, size_t bytes)
+      {
+        sequenceOffset_ = offset;
+        sequenceBytes_ = std::min(bytes, sizeof(uint64));
+      }
+
       ////////////////////////
       // Implement HeaderAnalyzer
       virtual bool analyzeHeader(DataSource & source, size_t & blockSize, bool & skip);
       virtual void reset();
+      virtual bool getSequenceNumber(uint64 & sequenceNumber)const;
     private:
       size_t prefixBytes_;
       size_t sizeBytes_;
       size_t suffixBytes_;
-      bool swapNeeded_;
+      bool littleEndian_;
+      size_t sequenceOffset_;
+      size_t sequenceBytes_;
+      uint64 sequence_;
+      // sequence_ came from a complete header
+      bool sequenceValid_;
 
       enum
       {
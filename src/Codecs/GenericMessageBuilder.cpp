@@ -9,15 +9,33 @@
 #include <Messages/FieldSequence.h>
 #include <Messages/FieldGroup.h>
 #include <Common/Exceptions.h>
+#include <boost/make_shared.hpp>
 
 using namespace QuickFAST;
 using namespace Codecs;
 
+namespace
+{
+  Messages::FieldSetPtr
+  createFieldSet(Arena * arena, size_t size)
+  {
+    if(arena == 0)
+    {
+      return Messages::FieldSetPtr(new Messages::FieldSet(size));
+    }
+    return boost::allocate_shared<Messages::FieldSet>(
+      ArenaAllocator<Messages::FieldSet>(*arena),
+      size,
+      boost::ref(*arena));
+  }
+}
+
 //////////////////////////
 // GenericSequenceBuilder
 
 GenericSequenceBuilder::GenericSequenceBuilder(MessageBuilder * parent)
 : parent_(parent)
+, arena_(0)
 {
 }
 
@@ -45,7 +63,17 @@ GenericSequenceBuilder::initialize(
   size_t length
   )
 {
-  this->sequence_.reset(new Messages::Sequence(lengthIdentity, length));
+  if(arena_ == 0)
+  {
+    this->sequence_.reset(new Messages::Sequence(lengthIdentity, length));
+  }
+  else
+  {
+    this->sequence_ = boost::allocate_shared<Messages::Sequence>(
+      ArenaAllocator<Messages::Sequence>(*arena_),
+      boost::ref(lengthIdentity),
+      length);
+  }
 }
 
 const std::string &
@@ -105,6 +133,7 @@ GenericSequenceBuilder::startSequence(
   if(!sequenceBuilder_)
   {
     sequenceBuilder_.reset(new GenericSequenceBuilder(this));
+    sequenceBuilder_->setArena(arena_);
   }
   sequenceBuilder_->initialize(
     identity,
@@ -142,7 +171,7 @@ GenericSequenceBuilder::startSequenceEntry(
   const std::string & applicationTypeNamespace,
   size_t size)
 {
-  fieldSet_.reset(new Messages::FieldSet(size));
+  fieldSet_ = createFieldSet(arena_, size);
   fieldSet_->setApplicationType(
     applicationType,
     applicationTypeNamespace);
@@ -170,6 +199,7 @@ GenericSequenceBuilder::startGroup(
   if(!groupBuilder_)
   {
     groupBuilder_.reset(new GenericGroupBuilder(this));
+    groupBuilder_->setArena(arena_);
   }
   groupBuilder_->initialize(
     identity,
@@ -201,7 +231,30 @@ GenericSequenceBuilder::getSequence()const
 void
 GenericSequenceBuilder::reset()
 {
+  fieldSet_.reset();
   sequence_.reset();
+  if(sequenceBuilder_)
+  {
+    sequenceBuilder_->reset();
+  }
+  if(groupBuilder_)
+  {
+    groupBuilder_->reset();
+  }
+}
+
+void
+GenericSequenceBuilder::setArena(Arena * arena)
+{
+  arena_ = arena;
+  if(sequenceBuilder_)
+  {
+    sequenceBuilder_->setArena(arena);
+  }
+  if(groupBuilder_)
+  {
+    groupBuilder_->setArena(arena);
+  }
 }
 
 bool
@@ -234,6 +287,7 @@ GenericSequenceBuilder::reportCommunicationError(const std::string & errorMessag
 
 GenericGroupBuilder::GenericGroupBuilder(MessageBuilder * parent)
 : parent_(parent)
+, arena_(0)
 {
 }
 
@@ -258,7 +312,7 @@ GenericGroupBuilder::initialize(
   const std::string & applicationTypeNamespace,
   size_t size)
 {
-  group_.reset(new Messages::FieldSet(size));
+  group_ = createFieldSet(arena_, size);
   group_->setApplicationType(applicationType, applicationTypeNamespace);
 }
 
@@ -318,6 +372,7 @@ GenericGroupBuilder::startSequence(
   if(!sequenceBuilder_)
   {
     sequenceBuilder_.reset(new GenericSequenceBuilder(this));
+    sequenceBuilder_->setArena(arena_);
   }
   sequenceBuilder_->initialize(
     identity,
@@ -377,6 +432,7 @@ GenericGroupBuilder::startGroup(
   if(!groupBuilder_)
   {
     groupBuilder_.reset(new GenericGroupBuilder(this));
+    groupBuilder_->setArena(arena_);
   }
   groupBuilder_->initialize(
     identity,
@@ -409,6 +465,28 @@ void
 GenericGroupBuilder::reset()
 {
   group_.reset();
+  if(sequenceBuilder_)
+  {
+    sequenceBuilder_->reset();
+  }
+  if(groupBuilder_)
+  {
+    groupBuilder_->reset();
+  }
+}
+
+void
+GenericGroupBuilder::setArena(Arena * arena)
+{
+  arena_ = arena;
+  if(sequenceBuilder_)
+  {
+    sequenceBuilder_->setArena(arena);
+  }
+  if(groupBuilder_)
+  {
+    groupBuilder_->setArena(arena);
+  }
 }
 
 bool
@@ -444,6 +522,7 @@ GenericGroupBuilder::reportCommunicationError(const std::string & errorMessage)
 
 GenericMessageBuilder::GenericMessageBuilder(MessageConsumer & consumer)
 : consumer_(consumer)
+, receiveTime_(0)
 , sequenceBuilder_(this)
 , groupBuilder_(this)
 {
@@ -456,6 +535,29 @@ GenericMessageBuilder::GenericMessageBuilder(MessageConsumer & consumer)
 
 GenericMessageBuilder::~GenericMessageBuilder()
 {
+  releaseMessage();
+}
+
+void
+GenericMessageBuilder::useArena(size_t blockSize)
+{
+  releaseMessage();
+  arena_.reset(new Arena(blockSize));
+  sequenceBuilder_.setArena(arena_.get());
+  groupBuilder_.setArena(arena_.get());
+}
+
+void
+GenericMessageBuilder::releaseMessage()
+{
+  // Everything that might live in the arena must be destroyed before it is rewound.
+  message_.reset();
+  sequenceBuilder_.reset();
+  groupBuilder_.reset();
+  if(arena_)
+  {
+    arena_->reset();
+  }
 }
 
 const std::string &
@@ -484,11 +586,30 @@ GenericMessageBuilder::startMessage(
   const std::string & applicationTypeNamespace,
   size_t size)
 {
-  message_.reset(new Messages::Message(size));
+  // discard any partial message abandoned by a decoding error
+  releaseMessage();
+  if(arena_)
+  {
+    message_ = boost::allocate_shared<Messages::Message>(
+      ArenaAllocator<Messages::Message>(*arena_),
+      size,
+      boost::ref(*arena_));
+  }
+  else
+  {
+    message_.reset(new Messages::Message(size));
+  }
   message_->setApplicationType(applicationType, applicationTypeNamespace);
+  message_->setReceiveTime(receiveTime_);
   return *this;
 }
 
+void
+GenericMessageBuilder::setReceiveTime(uint64 nanoseconds)
+{
+  receiveTime_ = nanoseconds;
+}
+
 bool
 GenericMessageBuilder::endMessage(Messages::ValueMessageBuilder &)
 {
@@ -498,13 +619,14 @@ GenericMessageBuilder::endMessage(Messages::ValueMessageBuilder &)
   bool more = consumer_.consumeMessage(*message());
 
   // Once it's consumed, the message is no longer needed.
-  message_.reset();
+  releaseMessage();
   return more;
 }
 
 bool
 GenericMessageBuilder::ignoreMessage(Messages::ValueMessageBuilder & /*messageBuilder*/)
 {
+  releaseMessage();
   return true;
 }
 
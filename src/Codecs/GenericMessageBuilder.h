@@ -7,6 +7,7 @@
 #ifndef GENERICMESSAGEBUILDER_H
 #define GENERICMESSAGEBUILDER_H
 #include <Common/QuickFAST_Export.h>
+#include <Common/Arena.h>
 #include <Codecs/MessageConsumer.h>
 #include <Messages/MessageBuilder.h>
 #include <Messages/Message_fwd.h>
@@ -52,8 +53,14 @@ namespace QuickFAST{
       const Messages::SequencePtr & getSequence()const;
 
       /// @brief start over on a new sequence
+      ///
+      /// Also discards anything left over from a partially built entry.
       void reset();
 
+      /// @brief Build sequences and their entries in an arena.
+      /// @param arena supplies the memory, or null to use the heap.
+      void setArena(Arena * arena);
+
       //////////////////////////
       // Implement MessageBuilder
 
@@ -112,6 +119,7 @@ namespace QuickFAST{
 
     private:
       Messages::MessageBuilder * parent_;
+      Arena * arena_;
       Messages::FieldSetPtr fieldSet_;
       Messages::SequencePtr sequence_;
       boost::scoped_ptr<GenericSequenceBuilder> sequenceBuilder_;
@@ -150,8 +158,14 @@ namespace QuickFAST{
       const Messages::GroupPtr & getGroup()const;
 
       /// @brief prepare to start over with a new group
+      ///
+      /// Also discards any partially built nested groups or sequences.
       void reset();
 
+      /// @brief Build groups in an arena.
+      /// @param arena supplies the memory, or null to use the heap.
+      void setArena(Arena * arena);
+
       //////////////////////////
       // Implement MessageBuilder
 
@@ -205,6 +219,7 @@ namespace QuickFAST{
       const Messages::GroupPtr & groupPtr()const;
     private:
       Messages::MessageBuilder * parent_;
+      Arena * arena_;
       Messages::FieldSetPtr fieldSetx_;
       Messages::GroupPtr group_;
 
@@ -224,6 +239,19 @@ namespace QuickFAST{
       /// @brief Virtual destructor
       virtual ~GenericMessageBuilder();
 
+      /// @brief Build each message in an arena that is reset after the message is consumed.
+      ///
+      /// The Message, its groups, sequences and sequence entries are all
+      /// allocated from a single arena.  Once MessageConsumer::consumeMessage
+      /// returns, the whole graph is released and the arena is rewound in one
+      /// step, so a steady stream of messages stops allocating from the heap.
+      ///
+      /// With this option the consumer must not keep the Message, or any
+      /// FieldSet, Group or Sequence obtained from it, after consumeMessage returns.
+      /// Scalar Field values may be kept; they do not live in the arena.
+      /// @param blockSize is the size of each block of memory in the arena.
+      void useArena(size_t blockSize = 64 * 1024);
+
       //////////////////////////
       // Implement MessageBuilder
       virtual const std::string & getApplicationType()const;
@@ -238,6 +266,7 @@ namespace QuickFAST{
         size_t size);
       virtual bool endMessage(Messages::ValueMessageBuilder & messageBuilder);
       virtual bool ignoreMessage(Messages::ValueMessageBuilder & messageBuilder);
+      virtual void setReceiveTime(uint64 nanoseconds);
 
       virtual Messages::MessageBuilder & startSequence(
         Messages::FieldIdentityCPtr & identity,
@@ -276,9 +305,12 @@ namespace QuickFAST{
 
     private:
       const Messages::MessagePtr & message()const;
+      void releaseMessage();
     private:
       MessageConsumer & consumer_;
+      boost::scoped_ptr<Arena> arena_;
       Messages::MessagePtr message_;
+      uint64 receiveTime_;
       GenericSequenceBuilder sequenceBuilder_;
       GenericGroupBuilder groupBuilder_;
     };
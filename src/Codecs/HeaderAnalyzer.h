@@ -8,6 +8,7 @@
 #define HEADERANALYZER_H
 #include "HeaderAnalyzer_fwd.h"
 #include <Codecs/DataSource_fwd.h>
+#include <Common/Types.h>
 namespace QuickFAST{
   namespace Codecs{
     /// An interface to be used to adapt to various styles of block or message header
@@ -50,6 +51,17 @@ namespace QuickFAST{
       virtual void reset()
       {
       }
+
+      /// @brief Get the sequence number from the most recently analyzed header.
+      ///
+      /// Headers that number their packets let duplicate feeds be arbitrated
+      /// and gaps be detected.  See ArbitratingAssembler.
+      /// @param[out] sequenceNumber from the header, if it has one.
+      /// @returns false if this analyzer does not know of a sequence number.
+      virtual bool getSequenceNumber(uint64 & /*sequenceNumber*/)const
+      {
+        return false;
+      }
     };
   }
 }
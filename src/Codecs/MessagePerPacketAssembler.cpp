@@ -21,6 +21,7 @@ MessagePerPacketAssembler::MessagePerPacketAssembler(
   , messageHeaderAnalyzer_(messageHeaderAnalyzer)
   , builder_(builder)
   , messageCount_(0)
+  , decodedMessageCount_(0)
   , byteCount_(0)
   , messageLimit_(0)
 {
@@ -39,7 +40,7 @@ MessagePerPacketAssembler::serviceQueue(Communication::Receiver & receiver)
   {
     try
     {
-      result = consumeBuffer(buffer->get(), buffer->used());
+      result = consumeBuffer(buffer->get(), buffer->used(), buffer->receiveTime());
     }
     catch(const std::exception &ex)
     {
@@ -57,7 +58,7 @@ MessagePerPacketAssembler::serviceQueue(Communication::Receiver & receiver)
 }
 
 bool
-MessagePerPacketAssembler::consumeBuffer(const unsigned char * buffer, size_t size)
+MessagePerPacketAssembler::consumeBuffer(const unsigned char * buffer, size_t size, uint64 receiveTime)
 {
   bool result = true;
   ++messageCount_;
@@ -129,7 +130,21 @@ MessagePerPacketAssembler::consumeBuffer(const unsigned char * buffer, size_t si
           }
           else
           {
-            decoder_.decodeMessage(*this, builder_);
+            uint64 decodeStart = startDecoding(receiveTime, builder_);
+            bool decoded = decoder_.decodeMessage(*this, builder_);
+            finishDecoding(decodeStart);
+            if(decoded)
+            {
+              ++decodedMessageCount_;
+            }
+            else
+            {
+              // the rest of the packet can't be trusted.
+              result = builder_.reportDecodingError(decoder_.getErrorMessage());
+              DataSource::reset();
+              currentSize_ = 0;
+              currentBuffer_ = 0;
+            }
           }
         }
       }
@@ -154,6 +169,7 @@ void
 MessagePerPacketAssembler::receiverStarted(Communication::Receiver & /*receiver*/)
 {
   decoder_.setStrict(strict_);
+  decoder_.setThrowOnError(throwOnError_);
   if(builder_.wantLog(Common::Logger::QF_LOG_INFO))
   {
     builder_.logMessage(Common::Logger::QF_LOG_INFO, "Receiver started");
@@ -60,13 +60,22 @@ namespace QuickFAST
         return decoder_;
       }
 
-      /// @brief How many messages have been processed
-      /// @returns the message count
+      /// @brief How many packets have been processed
+      ///
+      /// A packet may carry several messages; see decodedMessageCount().
+      /// @returns the packet count
       size_t messageCount()const
       {
         return messageCount_;
       }
 
+      /// @brief How many messages have been decoded successfully
+      /// @returns the decoded message count
+      size_t decodedMessageCount()const
+      {
+        return decodedMessageCount_;
+      }
+
       /// @brief How many bytes have been processed
       /// @returns the byte count
       size_t byteCount()const
@@ -84,8 +93,13 @@ namespace QuickFAST
       // Implement DataSource
       virtual bool getBuffer(const uchar *& buffer, size_t & size);
 
-    private:
-      bool consumeBuffer(const unsigned char * buffer, size_t size);
+    protected:
+      /// @brief Decode the contents of one packet.
+      /// @param buffer holds the packet, starting with its header.
+      /// @param size is the number of bytes in the packet.
+      /// @param receiveTime is when the packet arrived.
+      /// @returns false to stop decoding.
+      bool consumeBuffer(const unsigned char * buffer, size_t size, uint64 receiveTime);
     private:
       MessagePerPacketAssembler & operator = (const MessagePerPacketAssembler &);
       MessagePerPacketAssembler(const MessagePerPacketAssembler &);
@@ -100,6 +114,7 @@ namespace QuickFAST
       size_t currentSize_;
 
       size_t messageCount_;
+      size_t decodedMessageCount_;
       size_t byteCount_;
       size_t messageLimit_;
     };
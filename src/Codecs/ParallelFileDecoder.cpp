@@ -0,0 +1,391 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "ParallelFileDecoder.h"
+#include <Codecs/DataSourceBuffer.h>
+#include <Codecs/Decoder.h>
+#include <Codecs/HeaderAnalyzer.h>
+#include <Codecs/Template.h>
+#include <Codecs/TemplateRegistry.h>
+#include <Common/Constants.h>
+#include <Common/Exceptions.h>
+#include <Messages/RecordingMessageBuilder.h>
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Codecs;
+
+/// Collects the messages and errors of one chunk until they can be delivered.
+class ParallelFileDecoder::Slot : public Messages::RecordingMessageBuilder
+{
+public:
+  explicit Slot(Common::Logger & logger)
+    : Messages::RecordingMessageBuilder(logger)
+    , chunk_(0)
+    , ready_(false)
+  {
+  }
+
+  ~Slot()
+  {
+    for(size_t nRecording = 0; nRecording < owned_.size(); ++nRecording)
+    {
+      delete owned_[nRecording];
+    }
+  }
+
+  /// An error that follows the first n messages of the chunk.
+  void addError(const std::string & error)
+  {
+    errors_.push_back(Error(messages_.size(), error));
+  }
+
+  /// Make the slot ready for another chunk, keeping the recordings for reuse.
+  void recycle()
+  {
+    for(size_t nMessage = 0; nMessage < messages_.size(); ++nMessage)
+    {
+      messages_[nMessage]->clear();
+      spare_.push_back(messages_[nMessage]);
+    }
+    messages_.clear();
+    errors_.clear();
+  }
+
+  typedef std::pair<size_t, std::string> Error;
+
+  // Protected by the decoder's mutex
+  size_t chunk_;
+  bool ready_;
+
+  // Written by a worker, then read by the delivering thread, never both at once.
+  std::vector<Messages::RecordedMessage *> messages_;
+  std::vector<Error> errors_;
+
+protected:
+  virtual Messages::RecordedMessage * nextRecording()
+  {
+    if(spare_.empty())
+    {
+      owned_.push_back(0);
+      owned_.back() = new Messages::RecordedMessage;
+      return owned_.back();
+    }
+    Messages::RecordedMessage * recording = spare_.back();
+    spare_.pop_back();
+    return recording;
+  }
+
+  virtual bool messageRecorded(Messages::RecordedMessage & recording)
+  {
+    messages_.push_back(&recording);
+    return true;
+  }
+
+private:
+  std::vector<Messages::RecordedMessage *> owned_;
+  std::vector<Messages::RecordedMessage *> spare_;
+};
+
+ParallelFileDecoder::ParallelFileDecoder(
+  TemplateRegistryPtr templateRegistry,
+  HeaderAnalyzer & blockHeaderAnalyzer)
+: templateRegistry_(templateRegistry)
+, blockHeaderAnalyzer_(blockHeaderAnalyzer)
+, threadCount_(0)
+, resetOnMessage_(false)
+, chunkSize_(defaultChunkSize)
+, lookAhead_(0)
+, strict_(true)
+, useDecodePlans_(false)
+, data_(0)
+, size_(0)
+, messageCount_(0)
+, nextChunk_(0)
+, delivered_(0)
+, stopping_(false)
+{
+}
+
+ParallelFileDecoder::~ParallelFileDecoder()
+{
+  stopWorkers();
+}
+
+void
+ParallelFileDecoder::decode(
+  const unsigned char * data,
+  size_t size,
+  Messages::ValueMessageBuilder & builder)
+{
+  data_ = data;
+  size_ = size;
+  messageCount_ = 0;
+  bool ok = findChunks(builder);
+  if(!ok || chunks_.empty())
+  {
+    return;
+  }
+
+  size_t threadCount = threadCount_;
+  if(threadCount == 0)
+  {
+    threadCount = std::max(size_t(boost::thread::hardware_concurrency()), size_t(1));
+  }
+  threadCount = std::min(threadCount, chunks_.size());
+  size_t slotCount = lookAhead_ != 0 ? lookAhead_ : 2 * threadCount;
+  slotCount = std::min(slotCount, chunks_.size());
+  for(size_t nSlot = 0; nSlot < slotCount; ++nSlot)
+  {
+    slots_.push_back(0);
+    slots_.back() = new Slot(builder);
+  }
+  nextChunk_ = 0;
+  delivered_ = 0;
+  stopping_ = false;
+
+  try
+  {
+    for(size_t nThread = 0; nThread < threadCount; ++nThread)
+    {
+      threads_.push_back(ThreadPtr(
+        new boost::thread(boost::bind(&ParallelFileDecoder::decodeChunks, this, nThread, &builder))));
+    }
+    for(size_t nChunk = 0; ok && nChunk < chunks_.size(); ++nChunk)
+    {
+      Slot & slot = *slots_[nChunk % slots_.size()];
+      {
+        boost::mutex::scoped_lock lock(mutex_);
+        while(!slot.ready_ || slot.chunk_ != nChunk)
+        {
+          condition_.wait(lock);
+        }
+      }
+      ok = deliver(slot, builder);
+      slot.recycle();
+      {
+        boost::mutex::scoped_lock lock(mutex_);
+        slot.ready_ = false;
+        ++delivered_;
+      }
+      condition_.notify_all();
+    }
+  }
+  catch (...)
+  {
+    stopWorkers();
+    throw;
+  }
+  stopWorkers();
+}
+
+bool
+ParallelFileDecoder::findChunks(Messages::ValueMessageBuilder & builder)
+{
+  blocks_.clear();
+  chunks_.clear();
+  bool result = true;
+  size_t position = 0;
+  while(position < size_)
+  {
+    DataSourceBuffer source(data_ + position, size_ - position);
+    // Load the buffer now so the header's length can be measured afterwards.
+    (void)source.bytesAvailable();
+    size_t blockSize = 0;
+    bool skip = false;
+    if(!blockHeaderAnalyzer_.analyzeHeader(source, blockSize, skip))
+    {
+      blockHeaderAnalyzer_.reset();
+      result = builder.reportDecodingError("Incomplete block header at end of file.  Ignoring the remainder.");
+      break;
+    }
+    if(blockSize == 0)
+    {
+      throw UsageError("Coding Error", "ParallelFileDecoder needs block headers that give the block size.");
+    }
+    Block block;
+    block.begin_ = size_ - source.currentBytesAvailable();
+    block.end_ = block.begin_ + blockSize;
+    if(block.end_ > size_)
+    {
+      result = builder.reportDecodingError("Incomplete block at end of file.  Ignoring it.");
+      break;
+    }
+    if(!skip)
+    {
+      blocks_.push_back(block);
+    }
+    position = block.end_;
+  }
+
+  size_t chunkBytes = 0;
+  for(size_t nBlock = 0; nBlock < blocks_.size(); ++nBlock)
+  {
+    const Block & block = blocks_[nBlock];
+    if(chunks_.empty() || (chunkBytes >= chunkSize_ && startsAtReset(block)))
+    {
+      Chunk chunk;
+      chunk.firstBlock_ = nBlock;
+      chunk.endBlock_ = nBlock;
+      chunks_.push_back(chunk);
+      chunkBytes = 0;
+    }
+    chunks_.back().endBlock_ = nBlock + 1;
+    chunkBytes += block.end_ - block.begin_;
+  }
+  return result;
+}
+
+bool
+ParallelFileDecoder::startsAtReset(const Block & block)const
+{
+  if(resetOnMessage_)
+  {
+    return true;
+  }
+  const unsigned char * byte = data_ + block.begin_;
+  const unsigned char * end = data_ + block.end_;
+  if(byte == end)
+  {
+    return false;
+  }
+  // The first bit of the presence map says whether the template ID is present.
+  bool hasTemplateId = (*byte & 0x40) != 0;
+  while(byte != end && (*byte & stopBit) == 0)
+  {
+    ++byte;
+  }
+  if(byte == end || !hasTemplateId)
+  {
+    return false;
+  }
+  ++byte;
+  template_id_t templateId = 0;
+  while(byte != end)
+  {
+    templateId = (templateId << dataShift) | (*byte & dataBits);
+    if((*byte++ & stopBit) != 0)
+    {
+      // As in Decoder::decodeMessage, a registered template takes precedence over the SCP reset.
+      const Template * templatePtr = templateRegistry_->findTemplate(templateId);
+      if(templatePtr != 0)
+      {
+        return templatePtr->getReset();
+      }
+      return templateId == Context::SCPResetTemplateId;
+    }
+  }
+  return false;
+}
+
+void
+ParallelFileDecoder::decodeChunks(size_t worker, Common::Logger * logger)
+{
+  ThreadOptions::select(threadOptions_, worker).applyToCurrentThread(logger);
+  Decoder decoder(templateRegistry_);
+  decoder.setStrict(strict_);
+  decoder.setUseDecodePlans(useDecodePlans_);
+  for(;;)
+  {
+    Slot * slot = 0;
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      while(!stopping_ && nextChunk_ < chunks_.size() && nextChunk_ >= delivered_ + slots_.size())
+      {
+        condition_.wait(lock);
+      }
+      if(stopping_ || nextChunk_ >= chunks_.size())
+      {
+        return;
+      }
+      slot = slots_[nextChunk_ % slots_.size()];
+      slot->chunk_ = nextChunk_;
+      ++nextChunk_;
+    }
+    decodeChunk(decoder, *slot);
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      slot->ready_ = true;
+    }
+    condition_.notify_all();
+  }
+}
+
+void
+ParallelFileDecoder::decodeChunk(Decoder & decoder, Slot & slot)
+{
+  // Every chunk starts at a reset point, so it starts with a fresh dictionary.
+  decoder.reset();
+  const Chunk & chunk = chunks_[slot.chunk_];
+  for(size_t nBlock = chunk.firstBlock_; nBlock < chunk.endBlock_; ++nBlock)
+  {
+    const Block & block = blocks_[nBlock];
+    if(resetOnMessage_)
+    {
+      decoder.reset();
+    }
+    DataSourceBuffer source(data_ + block.begin_, block.end_ - block.begin_);
+    try
+    {
+      while(source.bytesAvailable() > 0)
+      {
+        if(!decoder.decodeMessage(source, slot))
+        {
+          // the rest of the block can't be trusted.
+          slot.addError(decoder.getErrorMessage());
+          break;
+        }
+      }
+    }
+    catch (const std::exception & ex)
+    {
+      slot.addError(ex.what());
+    }
+  }
+}
+
+bool
+ParallelFileDecoder::deliver(Slot & slot, Messages::ValueMessageBuilder & builder)
+{
+  size_t nError = 0;
+  for(size_t nMessage = 0; nMessage <= slot.messages_.size(); ++nMessage)
+  {
+    while(nError < slot.errors_.size() && slot.errors_[nError].first == nMessage)
+    {
+      if(!builder.reportDecodingError(slot.errors_[nError].second))
+      {
+        return false;
+      }
+      ++nError;
+    }
+    if(nMessage < slot.messages_.size())
+    {
+      ++messageCount_;
+      if(!slot.messages_[nMessage]->replay(builder))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void
+ParallelFileDecoder::stopWorkers()
+{
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    stopping_ = true;
+  }
+  condition_.notify_all();
+  for(size_t nThread = 0; nThread < threads_.size(); ++nThread)
+  {
+    threads_[nThread]->join();
+  }
+  threads_.clear();
+  for(size_t nSlot = 0; nSlot < slots_.size(); ++nSlot)
+  {
+    delete slots_[nSlot];
+  }
+  slots_.clear();
+}
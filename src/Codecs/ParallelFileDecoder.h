@@ -0,0 +1,203 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef PARALLELFILEDECODER_H
+#define PARALLELFILEDECODER_H
+#include "ParallelFileDecoder_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Common/ThreadOptions.h>
+#include <Codecs/Decoder_fwd.h>
+#include <Codecs/HeaderAnalyzer_fwd.h>
+#include <Codecs/TemplateRegistry_fwd.h>
+#include <Messages/ValueMessageBuilder_fwd.h>
+
+namespace QuickFAST{
+  namespace Codecs{
+    /// @brief Decode a file of FAST blocks on several threads at once.
+    ///
+    /// The SynchronousDecoder must work through a file in order because each
+    /// message may depend on dictionary values left by the ones before it.
+    /// Many recorded feeds, however, start over at known points: either
+    /// every block is decoded from a reset dictionary (see setResetOnMessage)
+    /// or the stream contains SCP reset messages (template 120) or templates
+    /// marked reset="yes".  Everything between two such points can be decoded
+    /// independently of everything else.
+    ///
+    /// decode() first walks the block headers with the HeaderAnalyzer.  The
+    /// headers must carry the block size so the blocks can be found without
+    /// decoding them.  Blocks are grouped into chunks of roughly
+    /// setChunkSize() bytes, breaking only where a block begins at a reset
+    /// point.  Worker threads then decode chunks with Decoders of their own
+    /// while the calling thread delivers the results to the application's
+    /// builder strictly in file order.
+    ///
+    /// Only the first message of a block is examined for a reset, so a file
+    /// without reset-on-every-block that resets in mid block still decodes
+    /// correctly, only with less parallelism.  A file with no reset points at
+    /// all decodes as one chunk.
+    ///
+    /// The application's builder sees its messages from the calling thread,
+    /// but its Logger methods (wantLog and logMessage, and
+    /// reportCommunicationError if a worker can't be placed) may be called
+    /// from the workers, so they must be thread safe.  Decoding errors are delivered
+    /// in order through reportDecodingError().
+    class QuickFAST_Export ParallelFileDecoder
+    {
+    public:
+      /// @brief How many bytes a chunk should hold unless told otherwise.
+      static const size_t defaultChunkSize = 1024 * 1024;
+
+      /// @brief Construct
+      /// @param templateRegistry contains the templates to be used during decoding.
+      /// @param blockHeaderAnalyzer finds the blocks in the file.  It must report block sizes.
+      ParallelFileDecoder(
+        TemplateRegistryPtr templateRegistry,
+        HeaderAnalyzer & blockHeaderAnalyzer);
+
+      ~ParallelFileDecoder();
+
+      /// @brief Set the number of decoding threads.
+      /// @param threadCount zero means one per processor.
+      void setThreadCount(size_t threadCount)
+      {
+        threadCount_ = threadCount;
+      }
+
+      /// @brief Place the decoding threads.  See ThreadOptions::select().
+      /// @param threadOptions for each worker.
+      void setThreadOptions(const ThreadOptionsList & threadOptions)
+      {
+        threadOptions_ = threadOptions;
+      }
+
+      /// @brief Decode every block from a reset dictionary.
+      ///
+      /// Corresponds to the -reset option of the decoder applications.
+      /// Every block is then a reset point.
+      /// @param reset true if the stream resets for each block; default false
+      void setResetOnMessage(bool reset)
+      {
+        resetOnMessage_ = reset;
+      }
+
+      /// @brief Set how much of the file a worker decodes at a time.
+      ///
+      /// Larger chunks mean less coordination; smaller ones spread the work
+      /// more evenly and hold fewer decoded messages in memory.
+      /// @param chunkSize in bytes.
+      void setChunkSize(size_t chunkSize)
+      {
+        chunkSize_ = chunkSize == 0 ? 1 : chunkSize;
+      }
+
+      /// @brief Limit how far decoding may run ahead of delivery.
+      /// @param lookAhead is the most chunks decoded but not yet delivered.  Zero means twice the thread count.
+      void setLookAhead(size_t lookAhead)
+      {
+        lookAhead_ = lookAhead;
+      }
+
+      /// @brief Enable/disable strict checking of conformance to the FAST standard
+      /// @param strict true to enable; false to disable strict checking
+      void setStrict(bool strict)
+      {
+        strict_ = strict;
+      }
+
+      /// @brief Decode using the compiled DecodePlans rather than the FieldInstructions
+      /// @param useDecodePlans true to use the plans; @see Decoder::setUseDecodePlans()
+      void setUseDecodePlans(bool useDecodePlans)
+      {
+        useDecodePlans_ = useDecodePlans;
+      }
+
+      /// @brief Decode a file that is already in memory, typically a MappedFile.
+      ///
+      /// Returns when every message has been delivered, when the builder
+      /// asks to stop, or when the file ends in a partial block.
+      /// @param data is the start of the file.
+      /// @param size is the length of the file.
+      /// @param builder receives the messages in file order.
+      /// @throws UsageError if the header analyzer does not report block sizes.
+      void decode(
+        const unsigned char * data,
+        size_t size,
+        Messages::ValueMessageBuilder & builder);
+
+      /// @brief Statistic: How many blocks did the last decode() find?
+      size_t blockCount()const
+      {
+        return blocks_.size();
+      }
+
+      /// @brief Statistic: How many independent chunks were they grouped into?
+      size_t chunkCount()const
+      {
+        return chunks_.size();
+      }
+
+      /// @brief Statistic: How many messages were delivered?
+      size_t messageCount()const
+      {
+        return messageCount_;
+      }
+
+    private:
+      ParallelFileDecoder(const ParallelFileDecoder &);
+      ParallelFileDecoder & operator=(const ParallelFileDecoder &);
+
+      class Slot;
+      typedef boost::shared_ptr<boost::thread> ThreadPtr;
+      /// A block's FAST data, not counting its header.
+      struct Block
+      {
+        size_t begin_;
+        size_t end_;
+      };
+      /// The blocks in [firstBlock_, endBlock_) decode independently of the others.
+      struct Chunk
+      {
+        size_t firstBlock_;
+        size_t endBlock_;
+      };
+
+      bool findChunks(Messages::ValueMessageBuilder & builder);
+      bool startsAtReset(const Block & block)const;
+      bool deliver(Slot & slot, Messages::ValueMessageBuilder & builder);
+      void decodeChunks(size_t worker, Common::Logger * logger);
+      void decodeChunk(Decoder & decoder, Slot & slot);
+      void stopWorkers();
+
+    private:
+      TemplateRegistryPtr templateRegistry_;
+      HeaderAnalyzer & blockHeaderAnalyzer_;
+      size_t threadCount_;
+      ThreadOptionsList threadOptions_;
+      bool resetOnMessage_;
+      size_t chunkSize_;
+      size_t lookAhead_;
+      bool strict_;
+      bool useDecodePlans_;
+
+      const unsigned char * data_;
+      size_t size_;
+      std::vector<Block> blocks_;
+      std::vector<Chunk> chunks_;
+      size_t messageCount_;
+
+      // Chunk n is decoded into slots_[n % slots_.size()].
+      std::vector<Slot *> slots_;
+      std::vector<ThreadPtr> threads_;
+      boost::mutex mutex_;
+      boost::condition_variable condition_;
+      // Protected by mutex_
+      size_t nextChunk_;
+      size_t delivered_;
+      bool stopping_;
+    };
+  }
+}
+#endif // PARALLELFILEDECODER_H
@@ -0,0 +1,13 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifndef PARALLELFILEDECODER_FWD_H
+#define PARALLELFILEDECODER_FWD_H
+
+namespace QuickFAST{
+  namespace Codecs{
+    class ParallelFileDecoder;
+  }
+}
+#endif // PARALLELFILEDECODER_FWD_H
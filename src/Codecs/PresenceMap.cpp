@@ -7,6 +7,7 @@
 #include <Common/Constants.h>
 #include <Codecs/DataSource.h>
 #include <Codecs/DataDestination.h>
+#include <Codecs/FieldInstruction.h>
 
 using namespace ::QuickFAST;
 using namespace ::QuickFAST::Codecs;
@@ -25,7 +26,11 @@ PresenceMap::maskToBitNumber(uchar bitMask)
 
 
 PresenceMap::PresenceMap(size_t bits)
-  : bitMask_(startByteMask)
+  : register_(0)
+  , registerPosition_(0)
+  , registerByteCount_(0)
+  , inRegister_(false)
+  , bitMask_(startByteMask)
   , bytePosition_(0)
   , byteCapacity_(defaultByteCapacity_)
   , bits_(&internalBuffer_[0])
@@ -44,6 +49,21 @@ PresenceMap::PresenceMap(size_t bits)
 void
 PresenceMap::decode(const unsigned char * buffer, size_t &offset)
 {
+  if(vout_ == 0)
+  {
+    size_t byteCount = 1;
+    while(byteCount <= registerBytes_ && (buffer[offset + byteCount - 1] & stopBit) == 0)
+    {
+      ++byteCount;
+    }
+    if(byteCount <= registerBytes_)
+    {
+      loadRegister(buffer + offset, byteCount);
+      offset += byteCount;
+      return;
+    }
+  }
+  inRegister_ = false;
   memset(bits_, 0, byteCapacity_);
   uchar byte = buffer[offset++];
   size_t pos = 0;
@@ -59,6 +79,7 @@ PresenceMap::decode(const unsigned char * buffer, size_t &offset)
 void
 PresenceMap::setRaw(const uchar * buffer, size_t byteLength)
 {
+  inRegister_ = false;
   if(byteLength > byteCapacity_)
   {
     byteCapacity_ = byteLength;
@@ -73,6 +94,10 @@ PresenceMap::setRaw(const uchar * buffer, size_t byteLength)
 void
 PresenceMap::getRaw(const uchar *& buffer, size_t &byteLength)const
 {
+  if(inRegister_)
+  {
+    unpackRegister();
+  }
   buffer = &bits_[0];
   byteLength = byteCapacity_;
 }
@@ -100,17 +125,71 @@ PresenceMap::appendByte(size_t & pos, uchar byte)
   bits_[pos++] = byte;
 }
 
+void
+PresenceMap::loadRegister(const uchar * bytes, size_t byteCount)
+{
+  register_ = 0;
+  for(size_t pos = 0; pos < byteCount; ++pos)
+  {
+    register_ <<= dataShift;
+    register_ |= bytes[pos] & dataBits;
+  }
+  register_ <<= (sizeof(uint64) * byteSize) - byteCount * dataShift;
+  registerByteCount_ = byteCount;
+  registerPosition_ = 0;
+  inRegister_ = true;
+}
+
+void
+PresenceMap::unpackRegister()const
+{
+  // bits_ points to non-const storage, so the wire format can be
+  // recreated for the (const) debugging and comparison methods.
+  memset(bits_, 0, byteCapacity_);
+  for(size_t pos = 0; pos < registerByteCount_; ++pos)
+  {
+    bits_[pos] = uchar(register_ >> (registerEnd_ - dataShift * (pos + 1) + 1)) & dataBits;
+  }
+  bits_[registerByteCount_ - 1] |= stopBit;
+}
+
+void
+PresenceMap::currentPosition(size_t & bytePosition, uchar & bitMask)const
+{
+  if(inRegister_)
+  {
+    unpackRegister();
+    bytePosition = registerPosition_ / dataShift;
+    bitMask = uchar(startByteMask >> (registerPosition_ % dataShift));
+  }
+  else
+  {
+    bytePosition = bytePosition_;
+    bitMask = bitMask_;
+  }
+}
+
+void
+PresenceMap::leaveRegister()
+{
+  currentPosition(bytePosition_, bitMask_);
+  inRegister_ = false;
+}
+
 size_t
 PresenceMap::encodeBytesNeeded()const
 {
+  size_t bytePosition = 0;
+  uchar bitMask = 0;
+  currentPosition(bytePosition, bitMask);
   // if no bits have been written
-  if(bytePosition_ == 0 && bitMask_ == startByteMask)
+  if(bytePosition == 0 && bitMask == startByteMask)
   {
     return 0;
   }
-  size_t bpos = bytePosition_;
+  size_t bpos = bytePosition;
   // if the last byte is unused, don't write it.
-  if(bitMask_ == startByteMask)
+  if(bitMask == startByteMask)
   {
     bpos -= 1;
   }
@@ -124,6 +203,10 @@ PresenceMap::encodeBytesNeeded()const
 void
 PresenceMap::encode(DataDestination & destination)
 {
+  if(inRegister_)
+  {
+    leaveRegister();
+  }
   if(bytePosition_ == 0 && bitMask_ == startByteMask)
   {
     return;
@@ -164,15 +247,31 @@ PresenceMap::encode(DataDestination & destination)
   }
 }
 
-void
+bool
 PresenceMap::decode(Codecs::DataSource & source)
 {
+  const uchar * buffer = 0;
+  if(vout_ == 0 && source.hasContiguous(sizeof(uint64), buffer))
+  {
+    size_t byteCount = 0;
+    uint64 bits = FieldInstruction::gatherStopBitInteger(buffer, byteCount);
+    if(byteCount != 0)
+    {
+      register_ = bits << ((sizeof(uint64) * byteSize) - byteCount * dataShift);
+      registerByteCount_ = byteCount;
+      registerPosition_ = 0;
+      inRegister_ = true;
+      source.skipContiguous(byteCount);
+      return true;
+    }
+  }
+
   reset();
 
   uchar byte = 0;
   if(!source.getByte(byte))
   {
-    throw EncodingError("[ERR U03] EOF while decoding presence map.");
+    return false;
   }
   size_t pos = 0;
   while((byte & stopBit) == 0)
@@ -180,12 +279,16 @@ PresenceMap::decode(Codecs::DataSource & source)
     appendByte(pos, byte);
     if(!source.getByte(byte))
     {
-      throw EncodingError("[ERR U03] EOF while decoding presence map.");
+      return false;
     }
   }
   appendByte(pos, byte);
 
-  if(vout_)
+  if(vout_ == 0 && pos <= registerBytes_)
+  {
+    loadRegister(bits_, pos);
+  }
+  else if(vout_)
   {
     (*vout_) << "pmap["  <<  byteCapacity_ << "]<-" << std::hex;
     for(size_t iter = 0; iter < pos; ++iter)
@@ -194,11 +297,13 @@ PresenceMap::decode(Codecs::DataSource & source)
     }
     (*vout_) << std::dec << std::endl;
   }
+  return true;
 }
 
 void
 PresenceMap::rewind()
 {
+  registerPosition_ = 0;
   bytePosition_ = 0;
   bitMask_ = startByteMask;
 }
@@ -229,6 +334,7 @@ PresenceMap::verboseCheckSpecificField(size_t bit, size_t byte, uchar bitmask, b
 void
 PresenceMap::reset(size_t bitCount)
 {
+  inRegister_ = false;
   if(bitCount > 0)
   {
     size_t bytes = (bitCount + 7)/8;
@@ -260,14 +366,20 @@ PresenceMap::verboseSetNext(bool present)
 bool
 PresenceMap::operator == (const PresenceMap &  rhs)const
 {
-  if(bytePosition_ != rhs.bytePosition_) return false;
-  if(bitMask_ != rhs.bitMask_) return false;
-  for(size_t pos = 0; pos < bytePosition_; ++pos)
+  size_t bytePosition = 0;
+  uchar bitMask = 0;
+  currentPosition(bytePosition, bitMask);
+  size_t rhsBytePosition = 0;
+  uchar rhsBitMask = 0;
+  rhs.currentPosition(rhsBytePosition, rhsBitMask);
+  if(bytePosition != rhsBytePosition) return false;
+  if(bitMask != rhsBitMask) return false;
+  for(size_t pos = 0; pos < bytePosition; ++pos)
   {
     if(bits_[pos] != rhs.bits_[pos]) return false;
   }
-  uchar mask = ((- bitMask_) << 1) & dataBits; // a bit of binary magic here ;-)
-  if(((bits_[bytePosition_] ^ rhs.bits_[bytePosition_]) & mask) != 0) return false;
+  uchar mask = ((- bitMask) << 1) & dataBits; // a bit of binary magic here ;-)
+  if(((bits_[bytePosition] ^ rhs.bits_[bytePosition]) & mask) != 0) return false;
   return true;
 }
 
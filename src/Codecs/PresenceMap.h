@@ -18,6 +18,10 @@ namespace QuickFAST{
     /// protocol documentation available from:
     /// http://www.fixprotocol.org/fast
     /// for details on when a presence map bit is used for a field.
+    ///
+    /// A decoded presence map that fits in 64 bits is held in a register and
+    /// checkNextField() is a shift-and-test.  Longer presence maps, maps being
+    /// built by the encoder, and verbose decoding use a byte buffer.
     class QuickFAST_Export PresenceMap{
       /// How many bytes can be stored in this object without allocating additional memory
       /// Consider ways to optimize this after parsing templates.
@@ -32,7 +36,8 @@ namespace QuickFAST{
 
       /// @brief Read a presence map from a data source.
       /// @param source provides the data.
-      void decode(DataSource & source);
+      /// @returns false if the source ran out of data before the end of the presence map.
+      bool decode(DataSource & source);
 
       /// @brief Decode directly from a buffer which must be complete in memory.
       ///
@@ -104,6 +109,11 @@ namespace QuickFAST{
     private:
       void appendByte(size_t & pos, uchar byte);
       void grow();
+      bool checkNextBufferedField();
+      void loadRegister(const uchar * bytes, size_t byteCount);
+      void unpackRegister()const;
+      void currentPosition(size_t & bytePosition, uchar & bitMask)const;
+      void leaveRegister();
       void verboseSetNext(bool present);
       void verboseCheckNextField(bool result);
       void verboseCheckSpecificField(size_t bit, size_t byte, uchar bitMask, bool result);
@@ -118,6 +128,18 @@ namespace QuickFAST{
 
     private:
       static const uchar startByteMask = '\x40';
+      /// Presence maps up to this many bytes (7 bits each) are held in register_
+      static const size_t registerBytes_ = 9;
+      /// The last usable bit position in register_; bit 0 is never set.
+      static const size_t registerEnd_ = 63;
+      /// The decoded presence map bits, first field in the most significant bit.
+      uint64 register_;
+      /// The next bit to be checked in register_.  Stops at registerEnd_.
+      size_t registerPosition_;
+      /// How many encoded bytes were loaded into register_
+      size_t registerByteCount_;
+      /// True if the presence map is in register_ rather than bits_
+      bool inRegister_;
       uchar bitMask_;
       size_t bytePosition_;
       size_t byteCapacity_;
@@ -131,6 +153,10 @@ namespace QuickFAST{
     void
     PresenceMap::setNextField(bool present)
     {
+      if(inRegister_)
+      {
+        leaveRegister();
+      }
       if(bytePosition_ >= byteCapacity_)
       {
         grow();
@@ -158,6 +184,22 @@ namespace QuickFAST{
     inline
     bool
     PresenceMap::checkNextField()
+    {
+      if(inRegister_)
+      {
+        bool result = ((register_ >> (registerEnd_ - registerPosition_)) & 1) != 0;
+        if(registerPosition_ < registerEnd_)
+        {
+          ++registerPosition_;
+        }
+        return result;
+      }
+      return checkNextBufferedField();
+    }
+
+    inline
+    bool
+    PresenceMap::checkNextBufferedField()
     {
       if(bytePosition_ >= byteCapacity_)
       {
@@ -182,6 +224,10 @@ namespace QuickFAST{
     bool
     PresenceMap::checkSpecificField(size_t bit)
     {
+      if(inRegister_)
+      {
+        return bit < registerEnd_ && ((register_ >> (registerEnd_ - bit)) & 1) != 0;
+      }
       size_t byte = bit / 7;
       if(byte >= byteCapacity_)
       {
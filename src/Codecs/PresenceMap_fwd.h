@@ -11,6 +11,8 @@
 namespace QuickFAST{
   namespace Codecs{
     class PresenceMap;
+    /// @brief A smart pointer to a PresenceMap.
+    typedef boost::shared_ptr<PresenceMap> PresenceMapPtr;
   }
 }
 #endif // PRESENCEMAP_FWD_H
@@ -4,6 +4,7 @@
 #include <Common/QuickFASTPch.h>
 #include "SegmentBody.h"
 #include <Codecs/FieldInstruction.h>
+#include <Codecs/DecodePlan.h>
 #include <Common/Exceptions.h>
 using namespace ::QuickFAST;
 using namespace ::QuickFAST::Codecs;
@@ -86,6 +87,15 @@ SegmentBody::finalize(TemplateRegistry & templateRegistry)
       fieldCount_ += instructions_[pos]->fieldCount(*this);
     }
   }
+
+  // Number the fields in the order they appear in a FieldSet, so
+  // lookups can start at the expected position.
+  size_t ordinal = 0;
+  for (size_t pos = 0; pos < instructions_.size(); ++pos)
+  {
+    mutableInstructions_[pos]->setFieldOrdinal(ordinal);
+    ordinal += instructions_[pos]->fieldCount(*this);
+  }
   isFinalizing_ = false;
   isFinalized_ = true;
 }
@@ -210,6 +220,43 @@ SegmentBody::indexDictionaries(
   }
 }
 
+void
+SegmentBody::validateDictionaryIndexes(size_t numericSize, size_t stringSize) const
+{
+  if(bool(lengthInstruction_))
+  {
+    lengthInstruction_->validateDictionaryIndexes(numericSize, stringSize);
+  }
+  for(MutableInstructionVector::const_iterator it = mutableInstructions_.begin();
+    it != mutableInstructions_.end();
+    ++it)
+  {
+    (*it)->validateDictionaryIndexes(numericSize, stringSize);
+  }
+}
+
+void
+SegmentBody::compileDecodePlan()
+{
+  if(bool(decodePlan_))
+  {
+    return;
+  }
+  decodePlan_.reset(new DecodePlan(*this));
+
+  // Groups and sequences are decoded via Decoder::decodeGroup which will use their plans.
+  for(MutableInstructionVector::iterator it = mutableInstructions_.begin();
+    it != mutableInstructions_.end();
+    ++it)
+  {
+    SegmentBodyPtr nested;
+    if((*it)->getSegmentBody(nested) && bool(nested))
+    {
+      nested->compileDecodePlan();
+    }
+  }
+}
+
 void
 SegmentBody::display(std::ostream & output, size_t indent) const
 {
@@ -9,6 +9,7 @@
 #include "SegmentBody_fwd.h"
 #include <Codecs/FieldInstruction_fwd.h>
 #include <Codecs/DictionaryIndexer_fwd.h>
+#include <Codecs/DecodePlan_fwd.h>
 #include <Codecs/SchemaElement.h>
 #include <Common/QuickFAST_Export.h>
 
@@ -141,6 +142,24 @@ namespace QuickFAST{
         const std::string & typeName,
         const std::string & typeNamespace);
 
+      /// @brief Verify the dictionary indexes used by the fields in this segment
+      /// @param numericSize is the number of numeric entries in the dictionary
+      /// @param stringSize is the number of string entries in the dictionary
+      /// @throws TemplateDefinitionError if an index is out of range
+      void validateDictionaryIndexes(size_t numericSize, size_t stringSize) const;
+
+      /// @brief Build a DecodePlan for this segment and any nested segments.
+      ///
+      /// Must be called after finalize() and indexDictionaries().
+      void compileDecodePlan();
+
+      /// @brief Access the compiled DecodePlan.
+      /// @returns a pointer to the plan or zero if compileDecodePlan() has not been called.
+      const DecodePlan * getDecodePlan()const
+      {
+        return decodePlan_.get();
+      }
+
       /// @brief Write the contents of the segment in human readable form.
       ///
       /// @param output is the stream to which the display will be written
@@ -182,6 +201,8 @@ namespace QuickFAST{
       bool mandatoryLength_;
       /// @brief the field instruction for sequence length if this is the body of a sequence
       FieldInstructionPtr lengthInstruction_;
+      /// @brief the compiled alternative to dispatching through instructions_
+      DecodePlanPtr decodePlan_;
     };
   }
 }
@@ -88,19 +88,28 @@ StreamingAssembler::serviceQueue(
           {
             decoder_.reset();
           }
-          decoder_.decodeMessage(*this, builder_);
+          // messageAvailable() made sure the buffer holding the start of the message is current.
+          uint64 decodeStart = startDecoding(
+            currentBuffer_ == 0 ? 0 : currentBuffer_->receiveTime(),
+            builder_);
+          bool decoded = decoder_.decodeMessage(*this, builder_);
+          finishDecoding(decodeStart);
+          if(!decoded)
+          {
+            more = builder_.reportDecodingError(decoder_.getErrorMessage());
+          }
         }
         catch(std::exception & ex)
         {
           more = builder_.reportDecodingError(ex.what());
-          if(!more)
+        }
+        if(!more)
+        {
+          stopping_ = true;
+          if(currentBuffer_ != 0)
           {
-            stopping_ = true;
-            if(currentBuffer_ != 0)
-            {
-              receiver.releaseBuffer(currentBuffer_);
-              currentBuffer_ = 0;
-            }
+            receiver.releaseBuffer(currentBuffer_);
+            currentBuffer_ = 0;
           }
         }
         inDecoder_ = false;
@@ -119,6 +128,7 @@ void
 StreamingAssembler::receiverStarted(Communication::Receiver & /*receiver*/)
 {
   decoder_.setStrict(strict_);
+  decoder_.setThrowOnError(throwOnError_);
   if(builder_.wantLog(Common::Logger::QF_LOG_INFO))
   {
     builder_.logMessage(Common::Logger::QF_LOG_INFO, "Start receiver.");
@@ -81,6 +81,20 @@ namespace QuickFAST{
         return decoder_.getStrict();
       }
 
+      /// @brief Report decoding errors to the builder rather than throwing them.
+      /// @param throwOnError false to report by status; @see Context::setThrowOnError()
+      void setThrowOnError(bool throwOnError)
+      {
+        decoder_.setThrowOnError(throwOnError);
+      }
+
+      /// @brief Decode using the compiled DecodePlans rather than the FieldInstructions
+      /// @param useDecodePlans true to use the plans; @see Decoder::setUseDecodePlans()
+      void setUseDecodePlans(bool useDecodePlans)
+      {
+        decoder_.setUseDecodePlans(useDecodePlans);
+      }
+
       /// @brief Get the id of the template driving the decoding
       template_id_t getTemplateId()const
       {
@@ -136,8 +150,14 @@ namespace QuickFAST{
             }
 //            std::cout << ']' << std::endl;
 //          }
-          decoder_.decodeMessage(source, builder);
-          messageCount_ += 1;
+          if(decoder_.decodeMessage(source, builder))
+          {
+            messageCount_ += 1;
+          }
+          else if(!builder.reportDecodingError(decoder_.getErrorMessage()))
+          {
+            return;
+          }
         }
       }
 
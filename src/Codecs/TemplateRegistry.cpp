@@ -5,14 +5,78 @@
 #include "TemplateRegistry.h"
 #include <Codecs/Template.h>
 #include <Codecs/DictionaryIndexer.h>
+#include <Codecs/FieldInstruction.h>
+#include <Messages/IdentityKeeper.h>
+#include <set>
 
 using namespace ::QuickFAST;
 using namespace ::QuickFAST::Codecs;
 
+namespace
+{
+  size_t nestingDepth(const SegmentBody & segment)
+  {
+    size_t depth = 0;
+    for(size_t nInstruction = 0; nInstruction < segment.size(); ++nInstruction)
+    {
+      SegmentBodyPtr nested;
+      if(segment.getInstruction(nInstruction)->getSegmentBody(nested) && nested)
+      {
+        size_t nestedDepth = nestingDepth(*nested) + 1;
+        if(nestedDepth > depth)
+        {
+          depth = nestedDepth;
+        }
+      }
+    }
+    return depth;
+  }
+
+  void collectIdentities(const SegmentBody & segment, Messages::IdentityKeeper & identities)
+  {
+    FieldInstructionCPtr lengthInstruction;
+    if(segment.getLengthInstruction(lengthInstruction))
+    {
+      identities.keep(lengthInstruction->getIdentity());
+    }
+    for(size_t nInstruction = 0; nInstruction < segment.size(); ++nInstruction)
+    {
+      const FieldInstructionCPtr & instruction = segment.getInstruction(nInstruction);
+      identities.keep(instruction->getIdentity());
+      SegmentBodyPtr nested;
+      if(instruction->getSegmentBody(nested) && nested)
+      {
+        collectIdentities(*nested, identities);
+      }
+    }
+  }
+
+  /// Keeps the templates too, so their references to the identities are
+  /// released only after the identities are counted again.
+  class TemplateKeeper : public Messages::IdentityKeeper
+  {
+  public:
+    ~TemplateKeeper()
+    {
+      release();
+    }
+
+    void keepTemplate(const TemplateCPtr & templ)
+    {
+      templates_.insert(templ);
+    }
+
+  private:
+    std::set<TemplateCPtr> templates_;
+  };
+}
+
 TemplateRegistry::TemplateRegistry()
 : presenceMapBits_(1) // every template requires 1 bit for the template ID
-, dictionarySize_(0)
+, numericDictionarySize_(0)
+, stringDictionarySize_(0)
 , maxFieldCount_(0)
+, maxNestingDepth_(0)
 {
 }
 
@@ -21,12 +85,26 @@ TemplateRegistry::TemplateRegistry(
   size_t fieldCount,
   size_t dictionarySize)
 : presenceMapBits_(pmapBits)
-, dictionarySize_(dictionarySize)
+, numericDictionarySize_(dictionarySize)
+, stringDictionarySize_(dictionarySize)
 , maxFieldCount_(fieldCount)
+, maxNestingDepth_(0)
 {
 
 }
 
+TemplateRegistry::~TemplateRegistry()
+{
+  // Decoded messages may still hold the keeper and with it the identities
+  // and templates.  Whoever releases it last frees them.
+  keeper_.reset();
+}
+
+size_t
+TemplateRegistry::immortalIdentityCount()const
+{
+  return keeper_ ? keeper_->size() : 0;
+}
 
 void
 TemplateRegistry::finalize()
@@ -50,10 +128,40 @@ TemplateRegistry::finalize()
       "", // typeref n/a at <templates> level
       ""); // typeNs
   }
-  dictionarySize_ = indexer.size();
+  numericDictionarySize_ = indexer.numericSize();
+  stringDictionarySize_ = indexer.stringSize();
+
+  // Check the indexes once here so the Context need not check them on every access.
+  for(MutableTemplates::iterator mit = mutableTemplates_.begin();
+    mit != mutableTemplates_.end();
+    ++mit)
+  {
+    (*mit)->validateDictionaryIndexes(numericDictionarySize_, stringDictionarySize_);
+  }
+
+  // Now that dictionary indexes are known, compile the decode plans.
+  for(MutableTemplates::iterator mit = mutableTemplates_.begin();
+    mit != mutableTemplates_.end();
+    ++mit)
+  {
+    (*mit)->compileDecodePlan();
+  }
+
+  if(!keeper_)
+  {
+    keeper_ = new TemplateKeeper;
+  }
+  TemplateKeeper & keeper = static_cast<TemplateKeeper &>(*keeper_);
+  for(MutableTemplates::iterator mit = mutableTemplates_.begin();
+    mit != mutableTemplates_.end();
+    ++mit)
+  {
+    keeper.keepTemplate(*mit);
+  }
 
   presenceMapBits_ = 1;
   maxFieldCount_ = 0;
+  maxNestingDepth_ = 0;
   for(TemplateIdMap::const_iterator it = templates_.begin();
     it != templates_.end();
     ++it)
@@ -68,6 +176,13 @@ TemplateRegistry::finalize()
     {
       maxFieldCount_ = fieldCount;
     }
+    size_t depth = nestingDepth(*it->second);
+    if(depth > maxNestingDepth_)
+    {
+      maxNestingDepth_ = depth;
+    }
+    // From now on the identities are shared by every decoded message.
+    collectIdentities(*it->second, keeper);
   }
 }
 
@@ -80,6 +195,14 @@ TemplateRegistry::addTemplate(TemplatePtr value)
   if(id != 0)
   {
     templates_[id] = value;
+    if(id < maxTableTemplateId)
+    {
+      if(id >= templateTable_.size())
+      {
+        templateTable_.resize(id + 1, 0);
+      }
+      templateTable_[id] = value.get();
+    }
   }
   std::string name;
   value->qualifyName(name);
@@ -115,6 +238,17 @@ TemplateRegistry::getTemplate(template_id_t templateId, TemplateCPtr & valueFoun
   return bool(valueFound);
 }
 
+const Template *
+TemplateRegistry::findSparseTemplate(template_id_t templateId)const
+{
+  TemplateIdMap::const_iterator it = templates_.find(templateId);
+  if(it == templates_.end())
+  {
+    return 0;
+  }
+  return it->second.get();
+}
+
 bool
 TemplateRegistry::findNamedTemplate(
   const std::string & templateName,
@@ -13,6 +13,7 @@
 #include <Common/Types.h>
 #include <Codecs/SchemaElement.h>
 #include <Codecs/Template_fwd.h>
+#include <Messages/IdentityKeeper_fwd.h>
 
 namespace QuickFAST{
   namespace Codecs{
@@ -25,6 +26,12 @@ namespace QuickFAST{
     ///
     /// Normally the Template Registry will be initialized by reading an
     /// XML templates file. This is done by a QuickFAST::Util::XMLTemplateParser object.
+    ///
+    /// Once finalized, the field identities used by the templates are immortal
+    /// (see FieldIdentity::makeImmortal()) so decoded messages can share them
+    /// without reference counting.  Each message counts the registry's
+    /// Messages::IdentityKeeper instead, so messages may outlive the registry;
+    /// the identities and templates are freed with the last of them.
     class QuickFAST_Export TemplateRegistry : public SchemaElement
     {
     public:
@@ -45,15 +52,17 @@ namespace QuickFAST{
       /// @param pmapBits how many pmap bits are needed by the largest template
       /// @param fieldCount how many fields are defined by the largest template
       /// @param dictionarySize how many slots are needed in the dictionary
+      ///        (used for both the numeric and the string entries)
       TemplateRegistry(
         size_t pmapBits,
         size_t fieldCount,
         size_t dictionarySize);
 
       /// @brief Virtual destructor.
-      virtual ~TemplateRegistry()
-      {
-      }
+      virtual ~TemplateRegistry();
+
+      /// @brief How many field identities were made immortal by finalize()?
+      size_t immortalIdentityCount()const;
 
       /// @brief Add a definition to the registry
       /// @param value smart pointer to the template to be added
@@ -74,10 +83,28 @@ namespace QuickFAST{
       }
 
       /// @brief How many entries are needed in the dictionaries associated with this registry
-      /// @brief returns an count of dictionary indexes used.
+      ///
+      /// Numeric and string entries are indexed separately, so this is the total of
+      /// numericDictionarySize() and stringDictionarySize().  It is large enough for
+      /// either kind of entry.
+      /// @returns a count of dictionary entries.
       size_t dictionarySize() const
       {
-        return dictionarySize_;
+        return numericDictionarySize_ + stringDictionarySize_;
+      }
+
+      /// @brief How many numeric (integer and decimal) entries are needed in the dictionaries
+      /// @returns a count of numeric dictionary indexes used.
+      size_t numericDictionarySize() const
+      {
+        return numericDictionarySize_;
+      }
+
+      /// @brief How many string entries are needed in the dictionaries associated with this registry
+      /// @returns a count of string dictionary indexes used.
+      size_t stringDictionarySize() const
+      {
+        return stringDictionarySize_;
       }
 
       /// @brief Returns the maximum number of fields that will be produced by any template in the registry.
@@ -89,12 +116,37 @@ namespace QuickFAST{
         return maxFieldCount_;
       }
 
+      /// @brief How deeply are groups and sequences nested within any template?
+      ///
+      /// A template with no groups or sequences has a nesting depth of zero.
+      /// Dynamic template references are not counted because they are not known until decoding.
+      /// @returns the deepest level of nesting.
+      size_t maxNestingDepth()const
+      {
+        return maxNestingDepth_;
+      }
+
       /// @brief Use Template ID to find a template.
       /// @param[in] templateId the desired template
       /// @param[out] valueFound is the result of the search if return is true
       /// @returns true if the template was found.
       bool getTemplate(uint32 templateId, TemplateCPtr & valueFound)const;
 
+      /// @brief Use Template ID to find a template without touching its reference count.
+      ///
+      /// Small IDs are found by direct indexing; larger ones fall back to a search.
+      /// The pointer remains valid as long as this registry exists.
+      /// @param templateId the desired template
+      /// @returns a pointer to the template, or zero if it is not defined.
+      const Template * findTemplate(template_id_t templateId)const
+      {
+        if(templateId < templateTable_.size())
+        {
+          return templateTable_[templateId];
+        }
+        return findSparseTemplate(templateId);
+      }
+
       /// @brief Find a template by name.
       /// @param[in] name the desired template
       /// @param[in] templateNamespace in which name is defined.
@@ -204,15 +256,29 @@ namespace QuickFAST{
       TemplateRegistry & operator =(const TemplateRegistry &);
 
     private:
+      const Template * findSparseTemplate(template_id_t templateId)const;
+
+    private:
+      /// Keeps the identities immortal, and the templates alive, as long as
+      /// the registry or any message decoded with it.
+      Messages::IdentityKeeperPtr keeper_;
+
+      /// Template IDs below this limit are found by indexing templateTable_
+      static const template_id_t maxTableTemplateId = 4096;
+
       TemplateIdMap templates_;
+      /// Direct lookup by template ID; sized to the largest ID below maxTableTemplateId.
+      std::vector<const Template *> templateTable_;
 
       TemplateNameMap namedTemplates_;
 
       typedef std::vector<TemplatePtr> MutableTemplates;
       MutableTemplates mutableTemplates_;
       size_t presenceMapBits_;
-      size_t dictionarySize_;
+      size_t numericDictionarySize_;
+      size_t stringDictionarySize_;
       size_t maxFieldCount_;
+      size_t maxNestingDepth_;
       std::string name_;
       std::string namespace_;
       std::string templateNamespace_;
@@ -0,0 +1,61 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "Arena.h"
+
+using namespace ::QuickFAST;
+
+const size_t Arena::alignment;
+
+Arena::Arena(size_t blockSize)
+: blockSize_(blockSize)
+, current_(0)
+, used_(0)
+, allocated_(0)
+{
+}
+
+Arena::~Arena()
+{
+  for(size_t nBlock = 0; nBlock < blocks_.size(); ++nBlock)
+  {
+    ::operator delete(blocks_[nBlock].memory_);
+  }
+}
+
+size_t
+Arena::capacity()const
+{
+  size_t result = 0;
+  for(size_t nBlock = 0; nBlock < blocks_.size(); ++nBlock)
+  {
+    result += blocks_[nBlock].size_;
+  }
+  return result;
+}
+
+void *
+Arena::allocateSlow(size_t size)
+{
+  // Move on to the next block kept from an earlier cycle that is big enough.
+  // Skipped blocks are wasted only until the next reset().
+  if(current_ < blocks_.size())
+  {
+    ++current_;
+  }
+  while(current_ < blocks_.size() && blocks_[current_].size_ < size)
+  {
+    ++current_;
+  }
+  if(current_ == blocks_.size())
+  {
+    Block block;
+    block.size_ = (size > blockSize_) ? size : blockSize_;
+    block.memory_ = static_cast<unsigned char *>(::operator new(block.size_));
+    blocks_.push_back(block);
+  }
+  used_ = size;
+  allocated_ += size;
+  return blocks_[current_].memory_;
+}
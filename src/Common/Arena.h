@@ -0,0 +1,200 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef ARENA_H
+#define ARENA_H
+#include <Common/QuickFAST_Export.h>
+#include <Common/Types.h>
+
+namespace QuickFAST{
+  /// @brief A bump allocator whose memory is released all at once.
+  ///
+  /// Memory is carved sequentially out of large blocks.  Individual
+  /// allocations are never freed; instead reset() makes all of the memory
+  /// available again in one step.  The blocks themselves are kept, so once
+  /// the arena has grown to fit the largest message it stops touching the heap.
+  ///
+  /// The arena does not run destructors.  Anything built in it must be
+  /// destroyed (or be trivially destructible) before reset() is called.
+  ///
+  /// Not thread safe.  Each arena belongs to a single decoding thread.
+  class QuickFAST_Export Arena
+  {
+    Arena(const Arena &);
+    Arena & operator=(const Arena &);
+  public:
+    /// @brief Every allocation is aligned to this many bytes.
+    static const size_t alignment = 16;
+
+    /// @brief Construct an empty arena.
+    /// @param blockSize is the size of each block obtained from the heap.
+    explicit Arena(size_t blockSize = 64 * 1024);
+
+    /// @brief Release all blocks back to the heap.
+    ~Arena();
+
+    /// @brief Get memory from the arena.
+    /// @param size is the number of bytes needed.
+    /// @returns suitably aligned memory that remains valid until reset().
+    void * allocate(size_t size)
+    {
+      size = (size + alignment - 1) & ~(alignment - 1);
+      if(current_ < blocks_.size() && size <= blocks_[current_].size_ - used_)
+      {
+        void * result = blocks_[current_].memory_ + used_;
+        used_ += size;
+        allocated_ += size;
+        return result;
+      }
+      return allocateSlow(size);
+    }
+
+    /// @brief Make all memory in the arena available for reuse.
+    ///
+    /// Invalidates every pointer previously returned by allocate().
+    void reset()
+    {
+      current_ = 0;
+      used_ = 0;
+      allocated_ = 0;
+    }
+
+    /// @brief How many bytes have been allocated since the last reset()?
+    size_t allocated()const
+    {
+      return allocated_;
+    }
+
+    /// @brief How many bytes have been obtained from the heap?
+    size_t capacity()const;
+
+  private:
+    void * allocateSlow(size_t size);
+
+  private:
+    struct Block
+    {
+      unsigned char * memory_;
+      size_t size_;
+    };
+    std::vector<Block> blocks_;
+    size_t blockSize_;
+    size_t current_;
+    size_t used_;
+    size_t allocated_;
+  };
+
+  /// @brief A standard allocator that gets its memory from an Arena.
+  ///
+  /// deallocate() does nothing; the memory is recovered by Arena::reset().
+  /// Useful with boost::allocate_shared so both an object and its reference
+  /// count live in the arena.
+  template<typename T>
+  class ArenaAllocator
+  {
+  public:
+    /// @brief standard allocator type
+    typedef T value_type;
+    /// @brief standard allocator type
+    typedef T * pointer;
+    /// @brief standard allocator type
+    typedef const T * const_pointer;
+    /// @brief standard allocator type
+    typedef T & reference;
+    /// @brief standard allocator type
+    typedef const T & const_reference;
+    /// @brief standard allocator type
+    typedef size_t size_type;
+    /// @brief standard allocator type
+    typedef ptrdiff_t difference_type;
+
+    /// @brief Rebind to allocate a different type from the same arena.
+    template<typename U>
+    struct rebind
+    {
+      /// @brief the rebound allocator
+      typedef ArenaAllocator<U> other;
+    };
+
+    /// @brief Construct an allocator that uses the given arena.
+    explicit ArenaAllocator(Arena & arena)
+      : arena_(&arena)
+    {
+    }
+
+    /// @brief Converting copy constructor required by rebind.
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U> & rhs)
+      : arena_(&rhs.arena())
+    {
+    }
+
+    /// @brief Access the arena that supplies memory.
+    Arena & arena()const
+    {
+      return *arena_;
+    }
+
+    /// @brief standard allocator method
+    pointer address(reference value)const
+    {
+      return &value;
+    }
+
+    /// @brief standard allocator method
+    const_pointer address(const_reference value)const
+    {
+      return &value;
+    }
+
+    /// @brief standard allocator method
+    pointer allocate(size_type count, const void * = 0)
+    {
+      return static_cast<pointer>(arena_->allocate(count * sizeof(T)));
+    }
+
+    /// @brief standard allocator method: a no-op.
+    void deallocate(pointer, size_type)
+    {
+    }
+
+    /// @brief standard allocator method
+    size_type max_size()const
+    {
+      return size_type(-1) / sizeof(T);
+    }
+
+    /// @brief standard allocator method
+    void construct(pointer p, const T & value)
+    {
+      new(p) T(value);
+    }
+
+    /// @brief standard allocator method
+    void destroy(pointer p)
+    {
+      p->~T();
+    }
+
+    /// @brief Allocators are equal if they share an arena.
+    template<typename U>
+    bool operator==(const ArenaAllocator<U> & rhs)const
+    {
+      return arena_ == &rhs.arena();
+    }
+
+    /// @brief Allocators are equal if they share an arena.
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U> & rhs)const
+    {
+      return arena_ != &rhs.arena();
+    }
+
+  private:
+    Arena * arena_;
+  };
+}
+#endif // ARENA_H
@@ -154,5 +154,71 @@ namespace QuickFAST
 #endif
   }
 
+  /// @brief A full memory barrier.
+  ///
+  /// Neither the compiler nor the processor may move loads or stores across this call.
+  inline
+  void memoryBarrier()
+  {
+#if defined(_WIN32)
+    MemoryBarrier();
+#elif defined(__GNUC__)
+    __sync_synchronize();
+#else
+    membar_enter();
+#endif
+  }
+
+  /// @brief Read a long integer with acquire semantics.
+  ///
+  /// Loads and stores that follow this call will not be moved ahead of it.
+  /// @param source points to the long to be read
+  inline
+  long atomicLoadAcquire(const volatile long * source)
+  {
+#if defined(_WIN32)
+    // MSVC gives volatile reads acquire semantics.
+    return *source;
+#elif defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+    return __atomic_load_n(source, __ATOMIC_ACQUIRE);
+#else
+    long result = *source;
+    memoryBarrier();
+    return result;
+#endif
+  }
+
+  /// @brief Write a long integer with release semantics.
+  ///
+  /// Loads and stores that precede this call will not be moved after it.
+  /// @param target points to the long to be written
+  /// @param value is the value to store
+  inline
+  void atomicStoreRelease(volatile long * target, long value)
+  {
+#if defined(_WIN32)
+    // MSVC gives volatile writes release semantics.
+    *target = value;
+#elif defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+    __atomic_store_n(target, value, __ATOMIC_RELEASE);
+#else
+    memoryBarrier();
+    *target = value;
+#endif
+  }
+
+  /// @brief Tell the processor this thread is spinning.
+  ///
+  /// Eases the cost of a busy-wait loop on hyperthreaded processors.
+  inline
+  void spinPause()
+  {
+#if defined(_WIN32)
+    YieldProcessor();
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    __builtin_ia32_pause();
+#endif
+  }
+
 }
 #endif // ATOMICOPS_H
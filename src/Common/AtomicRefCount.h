@@ -0,0 +1,53 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifndef ATOMICREFCOUNT_H
+#define ATOMICREFCOUNT_H
+
+// Atomic increment and decrement for reference counts kept in public headers.
+// Unlike AtomicOps.h this does not include <windows.h>.
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+# pragma intrinsic(_InterlockedIncrement)
+# pragma intrinsic(_InterlockedDecrement)
+#elif !defined(__GNUC__)
+# include <Common/AtomicOps.h>
+#endif
+
+namespace QuickFAST
+{
+  /// @brief Increment a reference count atomically
+  ///
+  /// @param target points to the count to be updated
+  /// @returns the new count
+  inline
+  long atomicRefCountIncrement(volatile long * target)
+  {
+#if defined(_MSC_VER)
+    return _InterlockedIncrement(target);
+#elif defined(__GNUC__)
+    return __sync_add_and_fetch(target, long(1));
+#else
+    return atomic_increment_long(target);
+#endif
+  }
+
+  /// @brief Decrement a reference count atomically
+  ///
+  /// @param target points to the count to be updated
+  /// @returns the new count
+  inline
+  long atomicRefCountDecrement(volatile long * target)
+  {
+#if defined(_MSC_VER)
+    return _InterlockedDecrement(target);
+#elif defined(__GNUC__)
+    return __sync_sub_and_fetch(target, long(1));
+#else
+    return atomic_decrement_long(target);
+#endif
+  }
+}
+#endif // ATOMICREFCOUNT_H
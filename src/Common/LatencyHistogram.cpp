@@ -0,0 +1,106 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "LatencyHistogram.h"
+#ifdef _WIN32
+# include <boost/date_time/posix_time/posix_time.hpp>
+#else // _WIN32
+# include <time.h>
+#endif // _WIN32
+
+using namespace ::QuickFAST;
+
+const size_t LatencyHistogram::bucketCount;
+
+LatencyHistogram::LatencyHistogram()
+{
+  reset();
+}
+
+uint64
+LatencyHistogram::now()
+{
+#ifdef _WIN32
+  static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+  boost::posix_time::time_duration sinceEpoch =
+    boost::posix_time::microsec_clock::universal_time() - epoch;
+  return uint64(sinceEpoch.total_microseconds()) * 1000;
+#else // _WIN32
+  struct timespec time;
+  ::clock_gettime(CLOCK_REALTIME, &time);
+  return uint64(time.tv_sec) * 1000000000 + uint64(time.tv_nsec);
+#endif // _WIN32
+}
+
+void
+LatencyHistogram::reset()
+{
+  for(size_t nBucket = 0; nBucket < bucketCount; ++nBucket)
+  {
+    buckets_[nBucket] = 0;
+  }
+  count_ = 0;
+  total_ = 0;
+  minimum_ = 0;
+  maximum_ = 0;
+}
+
+uint64
+LatencyHistogram::bucketLimit(size_t bucket)
+{
+  if(bucket == 0)
+  {
+    return 0;
+  }
+  if(bucket >= bucketCount - 1)
+  {
+    return ~uint64(0);
+  }
+  return (uint64(1) << bucket) - 1;
+}
+
+uint64
+LatencyHistogram::percentile(double fraction)const
+{
+  if(count_ == 0)
+  {
+    return 0;
+  }
+  // the rank of the latency being sought, counting from one.
+  size_t rank = size_t(fraction * double(count_) + 0.5);
+  if(rank < 1)
+  {
+    rank = 1;
+  }
+  size_t seen = 0;
+  for(size_t nBucket = 0; nBucket < bucketCount; ++nBucket)
+  {
+    seen += buckets_[nBucket];
+    if(seen >= rank)
+    {
+      return std::min(bucketLimit(nBucket), maximum_);
+    }
+  }
+  return maximum_;
+}
+
+void
+LatencyHistogram::print(std::ostream & out)const
+{
+  out << "count " << count_
+    << " min " << minimum_
+    << " mean " << mean()
+    << " p50 " << percentile(.50)
+    << " p99 " << percentile(.99)
+    << " p99.9 " << percentile(.999)
+    << " max " << maximum_
+    << " (nsec)" << std::endl;
+  for(size_t nBucket = 0; nBucket < bucketCount; ++nBucket)
+  {
+    if(buckets_[nBucket] != 0)
+    {
+      out << "  <= " << bucketLimit(nBucket) << ": " << buckets_[nBucket] << std::endl;
+    }
+  }
+}
@@ -0,0 +1,131 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+#include <Common/QuickFAST_Export.h>
+#include <Common/Types.h>
+
+namespace QuickFAST{
+  /// @brief Count latencies in buckets whose bounds are powers of two nanoseconds.
+  ///
+  /// Bucket zero counts zero latencies.  Bucket n (n > 0) counts latencies
+  /// from 2^(n-1) up to, but not including, 2^n nanoseconds.  That keeps
+  /// record() to a handful of instructions while still covering everything
+  /// from a few nanoseconds to several minutes with about 50% resolution.
+  ///
+  /// Not thread safe.  A histogram is normally updated by one thread; other
+  /// threads may read it as an approximate statistic.
+  class QuickFAST_Export LatencyHistogram
+  {
+  public:
+    /// @brief The number of buckets.
+    static const size_t bucketCount = 65;
+
+    LatencyHistogram();
+
+    /// @brief The current time in nanoseconds since the epoch.
+    ///
+    /// Uses the same clock as kernel packet timestamps (SO_TIMESTAMPNS)
+    /// so the two may be subtracted.
+    static uint64 now();
+
+    /// @brief Count one latency.
+    /// @param nanoseconds is the latency to be counted.
+    void record(uint64 nanoseconds)
+    {
+      ++buckets_[bucketFor(nanoseconds)];
+      ++count_;
+      total_ += nanoseconds;
+      if(nanoseconds < minimum_ || count_ == 1)
+      {
+        minimum_ = nanoseconds;
+      }
+      if(nanoseconds > maximum_)
+      {
+        maximum_ = nanoseconds;
+      }
+    }
+
+    /// @brief Count the time from start until now.
+    ///
+    /// Clock differences that run backwards are counted as zero.
+    /// @param start is a time obtained from now() or a kernel timestamp.
+    /// @param finish is the end of the interval, normally now().
+    void recordInterval(uint64 start, uint64 finish)
+    {
+      record(finish > start ? finish - start : 0);
+    }
+
+    /// @brief Forget everything recorded so far.
+    void reset();
+
+    /// @brief How many latencies have been recorded?
+    size_t count()const
+    {
+      return count_;
+    }
+
+    /// @brief How many latencies fell into a particular bucket?
+    /// @param bucket is an index less than bucketCount.
+    size_t bucket(size_t bucket)const
+    {
+      return buckets_[bucket];
+    }
+
+    /// @brief The largest latency counted by a bucket.
+    /// @param bucket is an index less than bucketCount.
+    static uint64 bucketLimit(size_t bucket);
+
+    /// @brief Which bucket counts this latency?
+    static size_t bucketFor(uint64 nanoseconds)
+    {
+      size_t bucket = 0;
+      while(nanoseconds != 0)
+      {
+        ++bucket;
+        nanoseconds >>= 1;
+      }
+      return bucket;
+    }
+
+    /// @brief The smallest latency recorded (zero if none)
+    uint64 minimum()const
+    {
+      return minimum_;
+    }
+
+    /// @brief The largest latency recorded.
+    uint64 maximum()const
+    {
+      return maximum_;
+    }
+
+    /// @brief The average latency (zero if none)
+    uint64 mean()const
+    {
+      return count_ == 0 ? 0 : total_ / count_;
+    }
+
+    /// @brief Estimate a percentile.
+    ///
+    /// The result is the upper limit of the bucket that contains the
+    /// requested fraction of the recorded latencies, capped at maximum().
+    /// @param fraction is between 0.0 and 1.0; for example .99 for the 99th percentile.
+    uint64 percentile(double fraction)const;
+
+    /// @brief Write a summary followed by one line per non-empty bucket.
+    void print(std::ostream & out)const;
+
+  private:
+    size_t buckets_[bucketCount];
+    size_t count_;
+    uint64 total_;
+    uint64 minimum_;
+    uint64 maximum_;
+  };
+}
+#endif // LATENCYHISTOGRAM_H
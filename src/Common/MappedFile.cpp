@@ -0,0 +1,269 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "MappedFile.h"
+#include <Common/Types.h>
+#ifndef _WIN32
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include <cerrno>
+# include <cstring>
+#endif // _WIN32
+
+using namespace ::QuickFAST;
+
+MappedFile::MappedFile()
+: data_(0)
+, size_(0)
+, isOpen_(false)
+, pageSize_(4096)
+#ifdef _WIN32
+, file_(INVALID_HANDLE_VALUE)
+, mapping_(0)
+#endif // _WIN32
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  ::GetSystemInfo(&info);
+  pageSize_ = info.dwPageSize;
+#else // _WIN32
+  long pageSize = ::sysconf(_SC_PAGESIZE);
+  if(pageSize > 0)
+  {
+    pageSize_ = size_t(pageSize);
+  }
+#endif // _WIN32
+}
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+#ifdef _WIN32
+bool
+MappedFile::open(const char * filename)
+{
+  close();
+  error_.clear();
+  file_ = ::CreateFileA(
+    filename,
+    GENERIC_READ,
+    FILE_SHARE_READ,
+    0,
+    OPEN_EXISTING,
+    FILE_FLAG_SEQUENTIAL_SCAN,
+    0);
+  if(file_ == INVALID_HANDLE_VALUE)
+  {
+    error_ = std::string("Can't open ") + filename;
+    return false;
+  }
+  LARGE_INTEGER fileSize;
+  if(!::GetFileSizeEx(file_, &fileSize))
+  {
+    error_ = std::string("Can't determine the size of ") + filename;
+    close();
+    return false;
+  }
+  if(uint64(fileSize.QuadPart) > uint64(size_t(-1)))
+  {
+    error_ = std::string("Too large to map into memory: ") + filename;
+    close();
+    return false;
+  }
+  size_ = size_t(fileSize.QuadPart);
+  if(size_ != 0)
+  {
+    mapping_ = ::CreateFileMapping(file_, 0, PAGE_READONLY, 0, 0, 0);
+    if(mapping_ != 0)
+    {
+      data_ = static_cast<const unsigned char *>(::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    }
+    if(data_ == 0)
+    {
+      error_ = std::string("Can't map ") + filename;
+      close();
+      return false;
+    }
+  }
+  isOpen_ = true;
+  return true;
+}
+
+void
+MappedFile::close()
+{
+  if(data_ != 0)
+  {
+    ::UnmapViewOfFile(data_);
+    data_ = 0;
+  }
+  if(mapping_ != 0)
+  {
+    ::CloseHandle(mapping_);
+    mapping_ = 0;
+  }
+  if(file_ != INVALID_HANDLE_VALUE)
+  {
+    ::CloseHandle(file_);
+    file_ = INVALID_HANDLE_VALUE;
+  }
+  size_ = 0;
+  isOpen_ = false;
+}
+
+void
+MappedFile::adviseSequential()
+{
+  // FILE_FLAG_SEQUENTIAL_SCAN was given to CreateFile.
+}
+
+bool
+MappedFile::adviseHugePages()
+{
+  // Large pages are only available for memory backed by the paging file.
+  return false;
+}
+
+void
+MappedFile::prefetch(size_t /*offset*/, size_t /*length*/)
+{
+  // PrefetchVirtualMemory would do this, but it needs Windows 8.
+}
+
+void
+MappedFile::release(size_t offset, size_t length)
+{
+  if(pageRange(offset, length))
+  {
+    // Unlocking pages that are not locked removes them from the working set.
+    ::VirtualUnlock(const_cast<unsigned char *>(data_ + offset), length);
+  }
+}
+
+#else // _WIN32
+
+bool
+MappedFile::open(const char * filename)
+{
+  close();
+  error_.clear();
+  int fd = ::open(filename, O_RDONLY);
+  if(fd < 0)
+  {
+    error_ = std::string("Can't open ") + filename + ": " + std::strerror(errno);
+    return false;
+  }
+  struct stat status;
+  if(::fstat(fd, &status) != 0)
+  {
+    error_ = std::string("Can't determine the size of ") + filename + ": " + std::strerror(errno);
+    ::close(fd);
+    return false;
+  }
+  if(uint64(status.st_size) > uint64(size_t(-1)))
+  {
+    error_ = std::string("Too large to map into memory: ") + filename;
+    ::close(fd);
+    return false;
+  }
+  size_ = size_t(status.st_size);
+  if(size_ != 0)
+  {
+    void * mapped = ::mmap(0, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(mapped == MAP_FAILED)
+    {
+      error_ = std::string("Can't map ") + filename + ": " + std::strerror(errno);
+      size_ = 0;
+      ::close(fd);
+      return false;
+    }
+    data_ = static_cast<const unsigned char *>(mapped);
+  }
+  // the mapping keeps its own reference to the file.
+  ::close(fd);
+  isOpen_ = true;
+  return true;
+}
+
+void
+MappedFile::close()
+{
+  if(data_ != 0)
+  {
+    ::munmap(const_cast<unsigned char *>(data_), size_);
+    data_ = 0;
+  }
+  size_ = 0;
+  isOpen_ = false;
+}
+
+void
+MappedFile::adviseSequential()
+{
+  if(data_ != 0)
+  {
+    ::madvise(const_cast<unsigned char *>(data_), size_, MADV_SEQUENTIAL);
+  }
+}
+
+bool
+MappedFile::adviseHugePages()
+{
+#ifdef MADV_HUGEPAGE
+  return data_ != 0
+    && ::madvise(const_cast<unsigned char *>(data_), size_, MADV_HUGEPAGE) == 0;
+#else // MADV_HUGEPAGE
+  return false;
+#endif // MADV_HUGEPAGE
+}
+
+void
+MappedFile::prefetch(size_t offset, size_t length)
+{
+  if(data_ == 0 || offset >= size_)
+  {
+    return;
+  }
+  // widen the range to whole pages
+  size_t start = offset - offset % pageSize_;
+  size_t end = std::min(size_, offset + length);
+  ::madvise(const_cast<unsigned char *>(data_ + start), end - start, MADV_WILLNEED);
+}
+
+void
+MappedFile::release(size_t offset, size_t length)
+{
+  if(pageRange(offset, length))
+  {
+    ::madvise(const_cast<unsigned char *>(data_ + offset), length, MADV_DONTNEED);
+  }
+}
+#endif // _WIN32
+
+bool
+MappedFile::pageRange(size_t & offset, size_t & length)const
+{
+  if(data_ == 0 || offset >= size_)
+  {
+    return false;
+  }
+  size_t end = std::min(size_, offset + length);
+  // a partial page at the end of the file is still a whole page in memory.
+  if(end < size_)
+  {
+    end -= end % pageSize_;
+  }
+  size_t start = offset + (pageSize_ - offset % pageSize_) % pageSize_;
+  if(start >= end)
+  {
+    return false;
+  }
+  offset = start;
+  length = end - start;
+  return true;
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+#include <Common/QuickFAST_Export.h>
+
+namespace QuickFAST{
+  /// @brief Read-only view of a whole file mapped into memory.
+  ///
+  /// The operating system pages the file in as it is touched, so opening even
+  /// a very large file costs almost nothing and the data never has to fit in RAM.
+  /// The only limit is address space: on a 32 bit system files over a couple of
+  /// gigabytes cannot be mapped.
+  ///
+  /// Pointers into the data remain valid until the file is closed.
+  class QuickFAST_Export MappedFile
+  {
+  public:
+    MappedFile();
+    ~MappedFile();
+
+    /// @brief Map a file, closing any file that is already mapped.
+    /// @param filename names the file to map.
+    /// @returns true if the file was mapped.  If not, error() says why.
+    bool open(const char * filename);
+
+    /// @brief Unmap the file.  Safe to call if nothing is mapped.
+    void close();
+
+    /// @brief Is a file mapped?
+    bool isOpen()const
+    {
+      return isOpen_;
+    }
+
+    /// @brief The first byte of the file.  Zero if the file is empty or not open.
+    const unsigned char * data()const
+    {
+      return data_;
+    }
+
+    /// @brief The number of bytes in the file.
+    size_t size()const
+    {
+      return size_;
+    }
+
+    /// @brief Why the most recent open() failed.
+    const std::string & error()const
+    {
+      return error_;
+    }
+
+    /// @brief Tell the operating system the file will be read from front to back.
+    ///
+    /// That lets it read ahead aggressively and discard pages soon after they are used.
+    void adviseSequential();
+
+    /// @brief Ask the operating system to start reading part of the file now.
+    /// @param offset of the first byte wanted.
+    /// @param length of the range wanted.
+    void prefetch(size_t offset, size_t length);
+
+    /// @brief Ask for the mapping to be backed by huge pages where possible.
+    ///
+    /// Fewer, larger pages mean fewer TLB misses while scanning a large file.
+    /// Linux honors this for file mappings only on filesystems that support
+    /// transparent huge pages for the page cache.
+    /// @returns false if the request was refused.
+    bool adviseHugePages();
+
+    /// @brief Say that part of the file will not be needed again soon.
+    ///
+    /// The memory can be reclaimed right away instead of pushing other data out.
+    /// The data remains readable; touching it again simply pages it back in.
+    /// @param offset of the first byte no longer needed.
+    /// @param length of the range no longer needed.
+    void release(size_t offset, size_t length);
+
+  private:
+    MappedFile(const MappedFile &);
+    MappedFile & operator=(const MappedFile &);
+
+    /// Shrink a range to the whole pages it contains.
+    bool pageRange(size_t & offset, size_t & length)const;
+
+  private:
+    const unsigned char * data_;
+    size_t size_;
+    bool isOpen_;
+    std::string error_;
+    size_t pageSize_;
+#ifdef _WIN32
+    void * file_;
+    void * mapping_;
+#endif // _WIN32
+  };
+}
+#endif // MAPPEDFILE_H
@@ -0,0 +1,341 @@
+// Copyright (c) 2009, 2010, 2011, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef POINTERRING_H
+#define POINTERRING_H
+// All inline, do not export.
+//#include <Common/QuickFAST_Export.h>
+#include <Common/AtomicOps.h>
+
+namespace QuickFAST
+{
+  ///@brief A bounded, lock-free FIFO of pointers with a single consumer.
+  ///
+  /// Each slot carries a sequence number that tells producers and the consumer
+  /// whether it is free or full, so neither side needs a lock.  With
+  /// SINGLE_PRODUCER, push() is a plain store; with MULTIPLE_PRODUCERS producers
+  /// claim slots with a compare-and-swap.  Only one thread may pop() at a time.
+  ///
+  /// The producer's and the consumer's indexes live on separate cache lines
+  /// so the two sides do not invalidate each other's caches on every operation.
+  ///
+  /// When the ring is empty popWait() either spins (BUSY_POLL) or sleeps
+  /// until a producer wakes it (BLOCK).  Producers only touch the mutex when
+  /// the consumer is actually asleep.
+  ///
+  /// This object does not manage the lifetimes of the entries.  It assumes
+  /// that they outlive the ring.
+  ///
+  /// Communication::BufferRing carries LinkedBuffers from receivers to decoders.
+  template<typename Entry>
+  class PointerRing
+  {
+  public:
+    /// @brief How many threads may call push() concurrently?
+    enum Producers
+    {
+      SINGLE_PRODUCER,
+      MULTIPLE_PRODUCERS
+    };
+
+    /// @brief What should popWait() do while the ring is empty?
+    enum WaitStrategy
+    {
+      /// Spin on the processor.  Lowest latency; burns a core.
+      BUSY_POLL,
+      /// Sleep until a producer signals.
+      BLOCK
+    };
+
+    /// @brief Construct an empty ring.
+    /// @param capacity is the minimum number of entries the ring can hold. Rounded up to a power of two.
+    /// @param producers says whether push() must be safe for concurrent callers.
+    /// @param strategy determines how popWait() waits.
+    explicit PointerRing(
+      size_t capacity = 1024,
+      Producers producers = SINGLE_PRODUCER,
+      WaitStrategy strategy = BLOCK)
+      : slots_(0)
+      , mask_(0)
+      , producers_(producers)
+      , strategy_(strategy)
+      , tail_(0)
+      , pushes_(0)
+      , full_(0)
+      , head_(0)
+      , pops_(0)
+      , waits_(0)
+      , waiting_(0)
+      , interrupted_(0)
+    {
+      allocate(capacity);
+    }
+
+    ~PointerRing()
+    {
+      delete [] slots_;
+    }
+
+    /// @brief Insure the ring can hold at least this many entries.
+    ///
+    /// Not thread safe.  Has no effect unless the ring is empty.
+    /// @param capacity is the minimum number of entries the ring can hold.
+    void reserve(size_t capacity)
+    {
+      if(capacity > this->capacity() && tail_ == head_)
+      {
+        delete [] slots_;
+        allocate(capacity);
+      }
+    }
+
+    /// @brief How many entries can the ring hold?
+    size_t capacity()const
+    {
+      return size_t(mask_) + 1;
+    }
+
+    /// @brief Change the way popWait() waits.
+    ///
+    /// Not thread safe.  Call before the consumer starts.
+    void setWaitStrategy(WaitStrategy strategy)
+    {
+      strategy_ = strategy;
+    }
+
+    /// @brief Add an entry to the ring.
+    /// @param entry is the entry to be added
+    /// @returns false if the ring is full.
+    bool push(Entry * entry)
+    {
+      long position = 0;
+      Slot * slot = 0;
+      if(producers_ == SINGLE_PRODUCER)
+      {
+        position = tail_;
+        slot = &slots_[position & mask_];
+        if(atomicLoadAcquire(&slot->sequence_) != position)
+        {
+          ++full_;
+          return false;
+        }
+        tail_ = position + 1;
+        ++pushes_;
+      }
+      else
+      {
+        for(;;)
+        {
+          position = atomicLoadAcquire(&tail_);
+          slot = &slots_[position & mask_];
+          long difference = atomicLoadAcquire(&slot->sequence_) - position;
+          if(difference == 0)
+          {
+            if(CASLong(&tail_, position, position + 1))
+            {
+              break;
+            }
+          }
+          else if(difference < 0)
+          {
+            atomic_increment_long(&full_);
+            return false;
+          }
+          // otherwise another producer claimed this slot.  Try the next one.
+        }
+        atomic_increment_long(&pushes_);
+      }
+      slot->entry_ = entry;
+      atomicStoreRelease(&slot->sequence_, position + 1);
+      if(strategy_ == BLOCK)
+      {
+        // pairs with the barrier in block()
+        memoryBarrier();
+        if(waiting_ != 0)
+        {
+          boost::mutex::scoped_lock lock(waitMutex_);
+          condition_.notify_one();
+        }
+      }
+      return true;
+    }
+
+    /// @brief Remove the oldest entry from the ring.  Consumer only.
+    /// @returns the entry or zero if the ring is empty.
+    Entry * pop()
+    {
+      Slot & slot = slots_[head_ & mask_];
+      if(atomicLoadAcquire(&slot.sequence_) != head_ + 1)
+      {
+        return 0;
+      }
+      Entry * entry = slot.entry_;
+      atomicStoreRelease(&slot.sequence_, head_ + mask_ + 1);
+      ++head_;
+      ++pops_;
+      return entry;
+    }
+
+    /// @brief Remove the oldest entry, waiting if necessary.  Consumer only.
+    /// @returns the entry or zero if interrupt() was called.
+    Entry * popWait()
+    {
+      Entry * entry = pop();
+      if(entry == 0)
+      {
+        ++waits_;
+        while(entry == 0 && atomicLoadAcquire(&interrupted_) == 0)
+        {
+          if(strategy_ == BUSY_POLL)
+          {
+            spinPause();
+          }
+          else
+          {
+            block();
+          }
+          entry = pop();
+        }
+      }
+      return entry;
+    }
+
+    /// @brief Look at an entry without removing it.  Consumer only.
+    /// @param offset is the position relative to the oldest entry.
+    /// @returns the entry or zero if there is none at that position.
+    Entry * peek(size_t offset = 0)const
+    {
+      if(offset > size_t(mask_))
+      {
+        return 0;
+      }
+      long position = head_ + long(offset);
+      const Slot & slot = slots_[position & mask_];
+      if(atomicLoadAcquire(&slot.sequence_) != position + 1)
+      {
+        return 0;
+      }
+      return slot.entry_;
+    }
+
+    /// @brief Is the ring empty? Consumer only.
+    bool isEmpty()const
+    {
+      return peek() == 0;
+    }
+
+    /// @brief Release a consumer waiting in popWait()
+    ///
+    /// popWait() continues to return immediately until clearInterrupt().
+    void interrupt()
+    {
+      atomicStoreRelease(&interrupted_, 1);
+      memoryBarrier();
+      boost::mutex::scoped_lock lock(waitMutex_);
+      condition_.notify_all();
+    }
+
+    /// @brief Allow popWait() to wait again after interrupt()
+    void clearInterrupt()
+    {
+      atomicStoreRelease(&interrupted_, 0);
+    }
+
+    /// @brief Statistic: How many entries have been pushed?
+    size_t pushes()const
+    {
+      return size_t(pushes_);
+    }
+
+    /// @brief Statistic: How many pushes failed because the ring was full?
+    size_t fullCount()const
+    {
+      return size_t(full_);
+    }
+
+    /// @brief Statistic: How many entries have been popped?
+    size_t pops()const
+    {
+      return size_t(pops_);
+    }
+
+    /// @brief Statistic: How many times did popWait() find the ring empty?
+    size_t waits()const
+    {
+      return size_t(waits_);
+    }
+
+  private:
+    PointerRing(const PointerRing &);
+    PointerRing & operator=(const PointerRing &);
+
+    void allocate(size_t capacity)
+    {
+      size_t size = 2;
+      while(size < capacity)
+      {
+        size <<= 1;
+      }
+      slots_ = new Slot[size];
+      mask_ = long(size - 1);
+      for(size_t nSlot = 0; nSlot < size; ++nSlot)
+      {
+        slots_[nSlot].sequence_ = long(nSlot);
+        slots_[nSlot].entry_ = 0;
+      }
+      head_ = 0;
+      tail_ = 0;
+    }
+
+    void block()
+    {
+      boost::mutex::scoped_lock lock(waitMutex_);
+      waiting_ = 1;
+      // pairs with the barrier in push()
+      memoryBarrier();
+      while(isEmpty() && atomicLoadAcquire(&interrupted_) == 0)
+      {
+        condition_.wait(lock);
+      }
+      waiting_ = 0;
+    }
+
+  private:
+    static const size_t cacheLineSize = 64;
+
+    struct Slot
+    {
+      volatile long sequence_;
+      Entry * entry_;
+    };
+
+    // Fixed after construction
+    Slot * slots_;
+    long mask_;
+    Producers producers_;
+    WaitStrategy strategy_;
+    char padConfiguration_[cacheLineSize];
+
+    // Written by producers
+    volatile long tail_;
+    volatile long pushes_;
+    volatile long full_;
+    char padProducer_[cacheLineSize];
+
+    // Written by the consumer
+    long head_;
+    long pops_;
+    long waits_;
+    char padConsumer_[cacheLineSize];
+
+    volatile long waiting_;
+    volatile long interrupted_;
+    boost::mutex waitMutex_;
+    boost::condition_variable condition_;
+  };
+}
+#endif // POINTERRING_H
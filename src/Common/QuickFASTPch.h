@@ -113,8 +113,10 @@
 /// be done by starting with one of the applications described above.
 ///
 /// For details on this lower level support see: <ul>
-/// <li>QuickFAST::Codecs::SynchronousDecoder, and</li>
-/// <li>QuickFAST::Codecs::MulticastDecoder.</li>
+/// <li>QuickFAST::Codecs::SynchronousDecoder,</li>
+/// <li>QuickFAST::Codecs::MulticastDecoder,</li>
+/// <li>QuickFAST::Codecs::ChannelGroup, which decodes many multicast channels with a few threads, and</li>
+/// <li>QuickFAST::Codecs::ParallelFileDecoder, which decodes a recorded file on several threads.</li>
 /// </ul>
 ///
 /// <h3>Using QuickFAST in an application that sends FAST data.</h3>
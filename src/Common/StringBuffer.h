@@ -408,6 +408,55 @@ namespace QuickFAST
       return *this;
     }
 
+    /// @brief replace the first removeLength bytes with the contents of a character buffer.
+    ///
+    /// The existing buffer is reused if it is large enough.
+    /// rhs must not point into this StringBufferT.
+    StringBufferT& replaceFront(
+      size_t removeLength,
+      const unsigned char* rhs,
+      size_t length
+      )
+    {
+      size_t oldSize = size();
+      if(removeLength > oldSize)
+      {
+        removeLength = oldSize;
+      }
+      size_t newSize = oldSize - removeLength + length;
+      reserve(newSize);
+      unsigned char* buf = getBuffer();
+      std::memmove(buf + length, buf + removeLength, oldSize - removeLength);
+      if(length > 0)
+      {
+        std::memcpy(buf, rhs, length);
+      }
+      buf[newSize] = 0;
+      size_ = newSize;
+      return *this;
+    }
+
+    /// @brief replace the last removeLength bytes with the contents of a character buffer.
+    ///
+    /// The existing buffer is reused if it is large enough.
+    /// rhs must not point into this StringBufferT.
+    StringBufferT& replaceBack(
+      size_t removeLength,
+      const unsigned char* rhs,
+      size_t length
+      )
+    {
+      size_t oldSize = size();
+      if(removeLength > oldSize)
+      {
+        removeLength = oldSize;
+      }
+      unsigned char* buf = getBuffer();
+      size_ = oldSize - removeLength;
+      buf[size_] = 0;
+      return append(rhs, length);
+    }
+
     /// @brief test for empty StringBufferT
     bool empty() const
     {
@@ -0,0 +1,347 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "ThreadOptions.h"
+#include <Common/Exceptions.h>
+#include <Common/Logger.h>
+#if !defined(_WIN32)
+# include <pthread.h>
+# include <sched.h>
+# include <cstring>
+#endif // _WIN32
+
+using namespace ::QuickFAST;
+
+ThreadOptions::ThreadOptions()
+: priority_(0)
+{
+}
+
+ThreadOptions::ThreadOptions(const std::string & specification)
+: priority_(0)
+{
+  std::string::size_type colon = specification.find(':');
+  parseCpus(specification.substr(0, colon));
+  if(colon != std::string::npos)
+  {
+    std::string rest = specification.substr(colon + 1);
+    colon = rest.find(':');
+    std::string priority = rest.substr(0, colon);
+    if(!priority.empty())
+    {
+      try
+      {
+        setPriority(boost::lexical_cast<int>(priority));
+      }
+      catch(const boost::bad_lexical_cast &)
+      {
+        throw UsageError("Thread options", ("Invalid priority: " + specification).c_str());
+      }
+    }
+    if(colon != std::string::npos)
+    {
+      name_ = rest.substr(colon + 1);
+    }
+  }
+}
+
+void
+ThreadOptions::parseCpus(const std::string & cpus)
+{
+  if(cpus.empty() || cpus == "*")
+  {
+    return;
+  }
+  std::string::size_type pos = 0;
+  while(pos <= cpus.size())
+  {
+    std::string::size_type comma = cpus.find(',', pos);
+    if(comma == std::string::npos)
+    {
+      comma = cpus.size();
+    }
+    std::string range = cpus.substr(pos, comma - pos);
+    std::string::size_type dash = range.find('-');
+    try
+    {
+      unsigned int first = boost::lexical_cast<unsigned int>(range.substr(0, dash));
+      unsigned int last = first;
+      if(dash != std::string::npos)
+      {
+        last = boost::lexical_cast<unsigned int>(range.substr(dash + 1));
+      }
+      if(last < first)
+      {
+        throw UsageError("Thread options", ("Invalid processor range: " + range).c_str());
+      }
+      for(unsigned int cpu = first; cpu <= last; ++cpu)
+      {
+        addCpu(cpu);
+      }
+    }
+    catch(const boost::bad_lexical_cast &)
+    {
+      throw UsageError("Thread options", ("Invalid processor list: " + cpus).c_str());
+    }
+    pos = comma + 1;
+  }
+}
+
+void
+ThreadOptions::setPriority(int priority)
+{
+  if(priority < 0 || priority > 99)
+  {
+    throw UsageError("Thread options", "Real-time priority must be between 0 and 99.");
+  }
+  priority_ = priority;
+}
+
+ThreadOptions
+ThreadOptions::select(const std::vector<ThreadOptions> & options, size_t threadNumber)
+{
+  if(options.empty())
+  {
+    return ThreadOptions();
+  }
+  if(threadNumber < options.size())
+  {
+    return options[threadNumber];
+  }
+  ThreadOptions result = options.back();
+  if(!result.name_.empty())
+  {
+    result.name_ += boost::lexical_cast<std::string>(threadNumber);
+  }
+  return result;
+}
+
+bool
+ThreadOptions::applyToCurrentThread(std::string & error)const
+{
+  std::ostringstream problems;
+#if defined(_WIN32)
+  if(!cpus_.empty())
+  {
+    DWORD_PTR mask = 0;
+    for(size_t nCpu = 0; nCpu < cpus_.size(); ++nCpu)
+    {
+      if(cpus_[nCpu] < sizeof(mask) * CHAR_BIT)
+      {
+        mask |= DWORD_PTR(1) << cpus_[nCpu];
+      }
+    }
+    if(mask == 0 || ::SetThreadAffinityMask(::GetCurrentThread(), mask) == 0)
+    {
+      problems << "Can't set processor affinity. ";
+    }
+  }
+  if(priority_ != 0 && !::SetThreadPriority(::GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL))
+  {
+    problems << "Can't set thread priority. ";
+  }
+#else // _WIN32
+# if defined(__linux__)
+  if(!cpus_.empty())
+  {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for(size_t nCpu = 0; nCpu < cpus_.size(); ++nCpu)
+    {
+      if(cpus_[nCpu] < CPU_SETSIZE)
+      {
+        CPU_SET(cpus_[nCpu], &cpuSet);
+      }
+    }
+    int result = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpuSet), &cpuSet);
+    if(result != 0)
+    {
+      problems << "Can't set processor affinity: " << std::strerror(result) << ". ";
+    }
+  }
+  if(!name_.empty())
+  {
+    // the kernel limits names to 15 characters plus the terminating null
+    std::string name = name_.substr(0, 15);
+    int result = ::pthread_setname_np(::pthread_self(), name.c_str());
+    if(result != 0)
+    {
+      problems << "Can't set thread name: " << std::strerror(result) << ". ";
+    }
+  }
+# else // __linux__
+  if(!cpus_.empty())
+  {
+    problems << "Processor affinity is not supported on this platform. ";
+  }
+# endif // __linux__
+  if(priority_ != 0)
+  {
+    struct sched_param parameters;
+    std::memset(&parameters, 0, sizeof(parameters));
+    parameters.sched_priority = priority_;
+    int result = ::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &parameters);
+    if(result != 0)
+    {
+      problems << "Can't set real-time priority " << priority_ << ": " << std::strerror(result) << ". ";
+    }
+  }
+#endif // _WIN32
+  error = problems.str();
+  return error.empty();
+}
+
+bool
+ThreadOptions::applyToCurrentThread(Common::Logger * logger)const
+{
+  std::string error;
+  if(!applyToCurrentThread(error))
+  {
+    reportError(logger, error);
+    return false;
+  }
+  return true;
+}
+
+void
+ThreadOptions::reportError(Common::Logger * logger, const std::string & error)
+{
+  if(logger != 0)
+  {
+    logger->reportCommunicationError(error);
+  }
+  else
+  {
+    std::cerr << error << std::endl;
+  }
+}
+
+ScopedThreadOptions::ScopedThreadOptions(const ThreadOptions & options)
+: options_(options)
+, applied_(false)
+, affinityMask_(0)
+, policy_(0)
+, priority_(0)
+{
+}
+
+ScopedThreadOptions::~ScopedThreadOptions()
+{
+  if(applied_)
+  {
+    restore();
+  }
+}
+
+bool
+ScopedThreadOptions::apply(std::string & error)
+{
+  if(!applied_)
+  {
+    save();
+    applied_ = true;
+  }
+  return options_.applyToCurrentThread(error);
+}
+
+bool
+ScopedThreadOptions::apply(Common::Logger * logger)
+{
+  std::string error;
+  if(!apply(error))
+  {
+    ThreadOptions::reportError(logger, error);
+    return false;
+  }
+  return true;
+}
+
+void
+ScopedThreadOptions::save()
+{
+#if defined(_WIN32)
+  if(!options_.cpus().empty())
+  {
+    // Windows can only read a thread's affinity by replacing it.
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+    if(::GetProcessAffinityMask(::GetCurrentProcess(), &processMask, &systemMask))
+    {
+      affinityMask_ = ::SetThreadAffinityMask(::GetCurrentThread(), processMask);
+      if(affinityMask_ != 0)
+      {
+        ::SetThreadAffinityMask(::GetCurrentThread(), affinityMask_);
+      }
+    }
+  }
+  priority_ = ::GetThreadPriority(::GetCurrentThread());
+#else // _WIN32
+# if defined(__linux__)
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  if(::pthread_getaffinity_np(::pthread_self(), sizeof(cpuSet), &cpuSet) == 0)
+  {
+    for(unsigned int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+      if(CPU_ISSET(cpu, &cpuSet))
+      {
+        cpus_.push_back(cpu);
+      }
+    }
+  }
+  char name[16] = {0};
+  if(::pthread_getname_np(::pthread_self(), name, sizeof(name)) == 0)
+  {
+    name_ = name;
+  }
+# endif // __linux__
+  struct sched_param parameters;
+  std::memset(&parameters, 0, sizeof(parameters));
+  if(::pthread_getschedparam(::pthread_self(), &policy_, &parameters) == 0)
+  {
+    priority_ = parameters.sched_priority;
+  }
+#endif // _WIN32
+}
+
+void
+ScopedThreadOptions::restore()
+{
+  // Put back only what the options changed.  Failures are ignored: the
+  // thread is no worse off than it was while the options were in effect.
+#if defined(_WIN32)
+  if(!options_.cpus().empty() && affinityMask_ != 0)
+  {
+    ::SetThreadAffinityMask(::GetCurrentThread(), affinityMask_);
+  }
+  if(options_.priority() != 0 && priority_ != THREAD_PRIORITY_ERROR_RETURN)
+  {
+    ::SetThreadPriority(::GetCurrentThread(), priority_);
+  }
+#else // _WIN32
+# if defined(__linux__)
+  if(!options_.cpus().empty() && !cpus_.empty())
+  {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for(size_t nCpu = 0; nCpu < cpus_.size(); ++nCpu)
+    {
+      CPU_SET(cpus_[nCpu], &cpuSet);
+    }
+    ::pthread_setaffinity_np(::pthread_self(), sizeof(cpuSet), &cpuSet);
+  }
+  if(!options_.name().empty())
+  {
+    ::pthread_setname_np(::pthread_self(), name_.c_str());
+  }
+# endif // __linux__
+  if(options_.priority() != 0)
+  {
+    struct sched_param parameters;
+    std::memset(&parameters, 0, sizeof(parameters));
+    parameters.sched_priority = priority_;
+    ::pthread_setschedparam(::pthread_self(), policy_, &parameters);
+  }
+#endif // _WIN32
+}
@@ -0,0 +1,172 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef THREADOPTIONS_H
+#define THREADOPTIONS_H
+#include <Common/QuickFAST_Export.h>
+#include <Common/Logger_fwd.h>
+
+namespace QuickFAST{
+  /// @brief Where and how a service thread should run.
+  ///
+  /// Describes the processors a thread may run on, an optional real-time
+  /// (SCHED_FIFO) priority and a name to show in debuggers and tools like top.
+  /// Default-constructed options leave the thread exactly as the system created it.
+  ///
+  /// On Linux every option is supported, although real-time priority usually
+  /// needs privileges (root or CAP_SYS_NICE).  On Windows a nonzero priority
+  /// selects THREAD_PRIORITY_TIME_CRITICAL and names are ignored.  Other POSIX
+  /// systems support only the priority.
+  class QuickFAST_Export ThreadOptions
+  {
+  public:
+    /// @brief Construct options that change nothing.
+    ThreadOptions();
+
+    /// @brief Construct from a text specification: cpus[:priority[:name]]
+    ///
+    /// cpus is a comma separated list of processor numbers or ranges
+    /// such as "2", "2,3" or "4-7,12".  An empty list or "*" means any processor.
+    /// priority is a SCHED_FIFO priority (1 to 99) or 0 for normal scheduling.
+    /// Examples: "3", "3:80", "3:80:decode", "*:0:receive".
+    /// @param specification is the text to be parsed.
+    /// @throws UsageError if the specification is not valid.
+    explicit ThreadOptions(const std::string & specification);
+
+    /// @brief Allow the thread to run on this processor.
+    ///
+    /// Once any processor is added the thread is restricted to the added processors.
+    /// @param cpu is the processor number as counted by the operating system.
+    void addCpu(unsigned int cpu)
+    {
+      cpus_.push_back(cpu);
+    }
+
+    /// @brief The processors the thread may use.  Empty means any.
+    const std::vector<unsigned int> & cpus()const
+    {
+      return cpus_;
+    }
+
+    /// @brief Run the thread with the SCHED_FIFO real-time policy.
+    /// @param priority is from 1 to 99.  0 means normal scheduling.
+    /// @throws UsageError if priority is out of range.
+    void setPriority(int priority);
+
+    /// @brief The SCHED_FIFO priority, or 0 for normal scheduling.
+    int priority()const
+    {
+      return priority_;
+    }
+
+    /// @brief Name the thread.
+    ///
+    /// Linux truncates names to 15 characters.
+    void setName(const std::string & name)
+    {
+      name_ = name;
+    }
+
+    /// @brief The thread's name.  Empty means leave it unnamed.
+    const std::string & name()const
+    {
+      return name_;
+    }
+
+    /// @brief True if these options would leave a thread unchanged.
+    bool isDefault()const
+    {
+      return cpus_.empty() && priority_ == 0 && name_.empty();
+    }
+
+    /// @brief Apply these options to the calling thread.
+    ///
+    /// Every option is attempted even if an earlier one fails.
+    /// @param[out] error describes what could not be applied.
+    /// @returns true if all options were applied.
+    bool applyToCurrentThread(std::string & error)const;
+
+    /// @brief Apply these options to the calling thread and report any failure.
+    ///
+    /// A failure is reported through logger->reportCommunicationError(),
+    /// or written to std::cerr if there is no logger.  The thread runs
+    /// either way.
+    /// @param logger receives the error.  May be null.
+    /// @returns true if all options were applied.
+    bool applyToCurrentThread(Common::Logger * logger)const;
+
+    /// @brief Report a failure to apply thread options.
+    /// @param logger receives the error.  If null the error goes to std::cerr.
+    /// @param error describes what could not be applied.
+    static void reportError(Common::Logger * logger, const std::string & error);
+
+    /// @brief Choose the options for one of a group of threads.
+    ///
+    /// Thread n uses entry n.  Threads past the end of the list share the
+    /// last entry and get their number appended to its name, so they can
+    /// still be told apart.
+    /// @param options for the group.  May be empty.
+    /// @param threadNumber counts from zero.
+    /// @returns the options for this thread.
+    static ThreadOptions select(const std::vector<ThreadOptions> & options, size_t threadNumber);
+
+  private:
+    void parseCpus(const std::string & cpus);
+
+  private:
+    std::vector<unsigned int> cpus_;
+    int priority_;
+    std::string name_;
+  };
+
+  /// @brief Apply ThreadOptions to the calling thread until this object is destroyed.
+  ///
+  /// Whatever apply() changes -- processors, scheduling or name -- is saved
+  /// first and put back by the destructor.  Use it when a caller lends its own
+  /// thread to a service and expects the thread back as it was.
+  /// Create and destroy it on the same thread.
+  class QuickFAST_Export ScopedThreadOptions
+  {
+  public:
+    /// @brief Prepare to apply options.  Nothing changes until apply().
+    /// @param options for the calling thread.
+    explicit ScopedThreadOptions(const ThreadOptions & options);
+
+    /// @brief Restore the calling thread if apply() was called.
+    ~ScopedThreadOptions();
+
+    /// @brief Save the calling thread's settings, then apply the options.
+    /// @param[out] error describes what could not be applied.
+    /// @returns true if all options were applied.
+    bool apply(std::string & error);
+
+    /// @brief Save the calling thread's settings, apply the options and report any failure.
+    /// @param logger receives the error.  See ThreadOptions::reportError().
+    /// @returns true if all options were applied.
+    bool apply(Common::Logger * logger);
+
+  private:
+    ScopedThreadOptions(const ScopedThreadOptions &);
+    ScopedThreadOptions & operator=(const ScopedThreadOptions &);
+    void save();
+    void restore();
+
+  private:
+    ThreadOptions options_;
+    bool applied_;
+    std::vector<unsigned int> cpus_;
+    size_t affinityMask_;
+    int policy_;
+    int priority_;
+    std::string name_;
+  };
+
+  /// @brief Options for each of a group of threads.
+  ///
+  /// See ThreadOptions::select() for how entries are matched to threads.
+  typedef std::vector<ThreadOptions> ThreadOptionsList;
+}
+#endif // THREADOPTIONS_H
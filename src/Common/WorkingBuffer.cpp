@@ -170,6 +170,29 @@ WorkingBuffer::append(const WorkingBuffer & rhs)
   }
 }
 
+void
+WorkingBuffer::append(const uchar * data, size_t length)
+{
+  if(reverse_)
+  {
+    if(startPos_ < length)
+    {
+      grow(capacity_ + length);
+    }
+    std::memcpy(buffer_.get() + startPos_ - length, data, length);
+    startPos_ -= length;
+  }
+  else
+  {
+    if(endPos_ + length > capacity_)
+    {
+      grow(endPos_ + length);
+    }
+    std::memcpy(buffer_.get() + endPos_, data, length);
+    endPos_ += length;
+  }
+}
+
 void
 WorkingBuffer::toString(std::string & result) const
 {
@@ -100,6 +100,15 @@ namespace QuickFAST{
     /// @param rhs the buffer to be appended
     void append(const WorkingBuffer & rhs);
 
+    ///@brief Append a block of bytes to the buffer
+    ///
+    /// if reverse append to the front of this buffer else append to the back
+    /// The bytes are copied as a block; their order is not reversed.
+    ///
+    /// @param data points to the bytes to be appended
+    /// @param length is the number of bytes to append
+    void append(const uchar * data, size_t length);
+
     /// @brief A convenience method: copy contents to a std::string
     void toString(std::string & result) const;
 
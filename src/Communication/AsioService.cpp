@@ -79,16 +79,27 @@ AsioService::runThreads(size_t threadCount /*= 0*/, bool useThisThread /* = true
   while(threadCount_ < threadCount)
   {
     threads_[threadCount_].reset(
-      new boost::thread(boost::bind(&AsioService::run, this)));
+      new boost::thread(boost::bind(&AsioService::runThread, this, threadCount_)));
     ++threadCount_;
   }
   if(useThisThread)
   {
+    // The caller gets its thread back as it was.
+    ScopedThreadOptions placement(ThreadOptions::select(threadOptions_, threadCount));
+    placement.apply(logger_);
     run();
     joinThreads();
   }
 }
 
+void
+AsioService::runThread(size_t threadNumber)
+{
+  ScopedThreadOptions placement(ThreadOptions::select(threadOptions_, threadNumber));
+  placement.apply(logger_);
+  run();
+}
+
 void
 AsioService::run()
 {
@@ -8,6 +8,7 @@
 #include <Common/QuickFAST_Export.h>
 #include <Common/Logger_fwd.h>
 #include <Common/AtomicCounter.h>
+#include <Common/ThreadOptions.h>
 
 // In gcc including asio.hpp in precompiled headers causes problems
 #include <boost/asio.hpp>
@@ -36,6 +37,20 @@ namespace QuickFAST
       /// @param logger to which messages will be written
       void setLogger(Common::Logger & logger);
 
+      /// @brief Place the threads started by runThreads().
+      ///
+      /// The additional threads are numbered from zero in the order they are
+      /// started; when useThisThread is true the calling thread comes last,
+      /// and its own settings are restored when runThreads() returns.
+      /// See ThreadOptions::select() for how entries are matched to threads.
+      /// Options that cannot be applied are reported to the logger, and the
+      /// thread runs anyway.
+      /// @param options for each thread.  An empty list leaves threads alone.
+      void setThreadOptions(const ThreadOptionsList & options)
+      {
+        threadOptions_ = options;
+      }
+
       /// @brief Run the event loop with this threads and threadCount additional threads.
       void runThreads(size_t threadCount = 0, bool useThisThread = true);
 
@@ -116,6 +131,9 @@ namespace QuickFAST
         return runningThreadCount_;
       }
 
+    private:
+      void runThread(size_t threadNumber);
+
     private:
       // if no io_service is specified, this one
       // will be used (shared among all users)
@@ -133,6 +151,7 @@ namespace QuickFAST
       boost::asio::io_service & ioService_;
       bool usingSharedService_;
       Common::Logger * logger_;
+      ThreadOptionsList threadOptions_;
     };
   }
 }
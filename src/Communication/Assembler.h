@@ -13,6 +13,8 @@
 #include <Codecs/Decoder.h>
 #include <Communication/LinkedBuffer.h>
 #include <Common/Logger.h>
+#include <Common/LatencyHistogram.h>
+#include <Messages/ValueMessageBuilder.h>
 
 namespace QuickFAST{
   namespace Communication
@@ -36,6 +38,9 @@ namespace QuickFAST{
         , logger_(logger)
         , strict_(true)
         , reset_(false)
+        , throwOnError_(true)
+        , wireToDecode_(0)
+        , decodeAndConsume_(0)
       {
       }
 
@@ -93,12 +98,68 @@ namespace QuickFAST{
         strict_ = strict;
       }
 
+      /// @brief Choose whether decoding errors are thrown or returned as status.
+      ///
+      /// Either way the error is passed to reportDecodingError() and the assembler
+      /// moves on, but status reporting avoids unwinding the stack for each corrupt message.
+      /// The default is to throw, as the assemblers always have.
+      /// @param throwOnError is true to have the decoder throw EncodingError
+      void setThrowOnError(bool throwOnError = true)
+      {
+        throwOnError_ = throwOnError;
+      }
+
       /// @brief Provide direct access to the decoder.
       Codecs::Decoder & decoder()
       {
         return decoder_;
       }
 
+      /// @brief Count the latency of each message in these histograms.
+      ///
+      /// Receiver::start() supplies its own histograms when latency tracking is enabled.
+      /// @param wireToDecode counts the time from the arrival of a packet until
+      ///        decoding of a message from it begins. Zero disables tracking.
+      /// @param decodeAndConsume counts the time to decode a message plus the time
+      ///        the builder and its consumer spend with it.  Consuming happens
+      ///        inside the decoder's call to the builder, so the two are not separable.
+      void setLatencyHistograms(
+        LatencyHistogram * wireToDecode,
+        LatencyHistogram * decodeAndConsume)
+      {
+        wireToDecode_ = wireToDecode;
+        decodeAndConsume_ = decodeAndConsume;
+      }
+
+    protected:
+      /// @brief Call just before decoding each message.
+      ///
+      /// Tells the builder when the data arrived and counts the wire-to-decode latency.
+      /// @param receiveTime is the LinkedBuffer::receiveTime() of the message's data.
+      /// @param builder will receive the decoded message.
+      /// @returns the time decoding started for finishDecoding(), or zero if not tracking.
+      uint64 startDecoding(uint64 receiveTime, Messages::ValueMessageBuilder & builder)
+      {
+        builder.setReceiveTime(receiveTime);
+        if(wireToDecode_ == 0 || receiveTime == 0)
+        {
+          return 0;
+        }
+        uint64 now = LatencyHistogram::now();
+        wireToDecode_->recordInterval(receiveTime, now);
+        return now;
+      }
+
+      /// @brief Call after the decoder returns from decoding a message.
+      /// @param decodeStart is the value returned by startDecoding().
+      void finishDecoding(uint64 decodeStart)
+      {
+        if(decodeStart != 0 && decodeAndConsume_ != 0)
+        {
+          decodeAndConsume_->recordInterval(decodeStart, LatencyHistogram::now());
+        }
+      }
+
     protected:
       /// The decoder that does the work.
       Codecs::Decoder decoder_;
@@ -109,6 +170,12 @@ namespace QuickFAST{
       bool strict_;
       /// Reset the decoder for every message
       bool reset_;
+      /// Decoding errors throw rather than being returned as status
+      bool throwOnError_;
+      /// Latency from packet arrival to start of decoding (zero if not tracking)
+      LatencyHistogram * wireToDecode_;
+      /// Time to decode a message plus the time its consumer takes (zero if not tracking)
+      LatencyHistogram * decodeAndConsume_;
 
 
     };
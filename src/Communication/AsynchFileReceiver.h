@@ -10,6 +10,12 @@
 #include <Communication/AsynchReceiver.h>
 #include <Common/Types.h>
 #include <Common/Exceptions.h>
+#include <Communication/UringFileReader.h>
+#if defined(QUICKFAST_HAS_IO_URING)
+# include <fcntl.h>
+# include <unistd.h>
+# include <cstdlib>
+#endif // QUICKFAST_HAS_IO_URING
 namespace QuickFAST
 {
   namespace Communication
@@ -160,7 +166,340 @@ namespace QuickFAST
       boost::uint64_t offset_;
     };
 
-#else // not _WIN32
+#elif defined(QUICKFAST_HAS_IO_URING)
+    /// @brief Read stream of FAST-encoded data from a file using asynchronous I/O
+    ///
+    /// The Linux implementation uses io_uring to keep several reads in flight,
+    /// so the disk stays busy while earlier buffers are being decoded.  Reads
+    /// may finish in any order, but buffers reach the assembler in file order.
+    ///
+    /// The receiver's buffers are carved out of one block of memory that is
+    /// registered with the kernel so each read skips pinning its pages.  If
+    /// registration is refused (see RLIMIT_MEMLOCK) reads proceed normally.
+    ///
+    /// additionalAttributes are open(2) flags.  With O_DIRECT the page cache
+    /// is bypassed; buffer sizes are then rounded up to a multiple of 4096.
+    class AsynchFileReceiver
+      : public AsynchReceiver
+    {
+    public:
+      /// @brief How many reads are in flight unless setReadDepth() says otherwise.
+      static const size_t defaultReadDepth = 4;
+
+      /// @brief Construct given file name, and extra attributes
+      /// @param fileName the file to read
+      /// @param additionalAttributes flags for open(2), such as O_DIRECT
+      AsynchFileReceiver(
+        const std::string & fileName,
+        uint32 additionalAttributes = 0
+        )
+        : AsynchReceiver()
+        , fileName_(fileName)
+        , additionalAttributes_(additionalAttributes)
+        , completions_(ioService_)
+        , readDepth_(defaultReadDepth)
+        , offset_(0)
+        , endOfFile_(false)
+        , waiting_(false)
+        , arena_(0)
+        , blockSize_(0)
+      {
+      }
+
+      /// @brief Construct given ioservice, file name, and extra attributes
+      /// @param ioService an ioService to be shared with other objects
+      /// @param fileName the file to read
+      /// @param additionalAttributes flags for open(2), such as O_DIRECT
+      AsynchFileReceiver(
+        boost::asio::io_service & ioService,
+        const std::string & fileName,
+        uint32 additionalAttributes = 0
+        )
+        : AsynchReceiver(ioService)
+        , fileName_(fileName)
+        , additionalAttributes_(additionalAttributes)
+        , completions_(ioService_)
+        , readDepth_(defaultReadDepth)
+        , offset_(0)
+        , endOfFile_(false)
+        , waiting_(false)
+        , arena_(0)
+        , blockSize_(0)
+      {
+      }
+
+      ~AsynchFileReceiver()
+      {
+        // The reader waits for reads still writing into the arena.
+        close();
+        // buffers pointing into the arena die with the receiver.
+        ::free(arena_);
+      }
+
+      /// @brief Set the most reads to keep in flight.
+      ///
+      /// Call before start().  Each read holds a buffer, so start the
+      /// receiver with more buffers than this to leave some for decoding.
+      /// @param readDepth is the number of concurrent reads.
+      void setReadDepth(size_t readDepth)
+      {
+        readDepth_ = readDepth == 0 ? 1 : readDepth;
+      }
+
+      // Implement Receiver method
+      virtual bool initializeReceiver()
+      {
+        if(assembler_->wantLog(Common::Logger::QF_LOG_INFO))
+        {
+          std::stringstream msg;
+          msg << "Opening file: " << fileName_;
+          assembler_->logMessage(Common::Logger::QF_LOG_INFO, msg.str());
+        }
+        if(!reader_.open(fileName_, int(additionalAttributes_), unsigned(readDepth_)))
+        {
+          assembler_->reportCommunicationError(reader_.error());
+          return false;
+        }
+        // asio closes its descriptor, and so does the reader.
+        completions_.assign(::dup(reader_.eventFd()));
+        return true;
+      }
+
+      // Implement Receiver method
+      virtual void close()
+      {
+        if(completions_.is_open())
+        {
+          boost::system::error_code ignored;
+          completions_.cancel(ignored);
+          completions_.close(ignored);
+        }
+        reader_.close();
+      }
+
+      // Implement Receiver method
+      virtual void stop()
+      {
+        // The ring itself is released by the completion handler or the
+        // destructor; either way no other thread can be reading it then.
+        if(completions_.is_open())
+        {
+          boost::system::error_code ignored;
+          completions_.cancel(ignored);
+        }
+        // and then shut everything down for good.
+        Receiver::stop();
+      }
+
+    private:
+      /// A read that has been submitted but not yet delivered.
+      struct PendingRead
+      {
+        PendingRead(LinkedBuffer * buffer, size_t requested)
+          : buffer_(buffer)
+          , requested_(requested)
+          , result_(0)
+          , done_(false)
+        {
+        }
+        LinkedBuffer * buffer_;
+        size_t requested_;
+        int result_;
+        bool done_;
+      };
+
+      // Give every buffer a slice of one aligned block and register the block.
+      void prepareBuffers()
+      {
+        const size_t alignment = 4096;
+        bool direct = (additionalAttributes_ & O_DIRECT) != 0;
+        blockSize_ = bufferSize_;
+        if(direct)
+        {
+          blockSize_ = (bufferSize_ + alignment - 1) / alignment * alignment;
+        }
+        size_t total = blockSize_ * bufferLifetimes_.size();
+        void * arena = 0;
+        if(::posix_memalign(&arena, alignment, total) != 0)
+        {
+          // keep the buffers as they are.
+          return;
+        }
+        arena_ = static_cast<unsigned char *>(arena);
+        for(size_t nBuffer = 0; nBuffer < bufferLifetimes_.size(); ++nBuffer)
+        {
+          bufferLifetimes_[nBuffer]->setExternal(arena_ + nBuffer * blockSize_, 0);
+        }
+        if(!reader_.registerBuffers(arena_, total)
+          && assembler_->wantLog(Common::Logger::QF_LOG_INFO))
+        {
+          assembler_->logMessage(Common::Logger::QF_LOG_INFO, reader_.error());
+        }
+      }
+
+      // Queue one read at the next position in the file.
+      bool queueRead(LinkedBuffer * buffer)
+      {
+        // buffers in the arena have no capacity of their own.
+        size_t size = buffer->capacity() != 0 ? buffer->capacity() : blockSize_;
+        if(!reader_.read(buffer->get(), size, offset_, reinterpret_cast<uint64>(buffer)))
+        {
+          return false;
+        }
+        pending_.push_back(PendingRead(buffer, size));
+        offset_ += size;
+        return true;
+      }
+
+      // Wait in the io_service for reads to complete.
+      void waitForCompletions()
+      {
+        waiting_ = true;
+        completions_.async_read_some(
+          boost::asio::null_buffers(),
+          boost::bind(&AsynchFileReceiver::handleCompletions,
+            this,
+            boost::asio::placeholders::error));
+      }
+
+      void handleCompletions(const boost::system::error_code& error)
+      {
+        std::vector<LinkedBuffer *> ready;
+        boost::system::error_code readError;
+        { // Scope for lock
+          boost::mutex::scoped_lock lock(bufferMutex_);
+          if(error || stopping_ || !reader_.isOpen())
+          {
+            // cancelled by stop()
+            waiting_ = false;
+            close();
+            return;
+          }
+          reader_.clearEvent();
+          uint64 userData;
+          int result;
+          while(reader_.complete(userData, result))
+          {
+            for(std::deque<PendingRead>::iterator it = pending_.begin(); it != pending_.end(); ++it)
+            {
+              if(reinterpret_cast<uint64>(it->buffer_) == userData)
+              {
+                it->result_ = result;
+                it->done_ = true;
+                break;
+              }
+            }
+          }
+          // deliver in file order
+          while(!pending_.empty() && pending_.front().done_)
+          {
+            PendingRead read = pending_.front();
+            pending_.pop_front();
+            size_t used = 0;
+            if(read.result_ < 0)
+            {
+              readError = boost::system::error_code(-read.result_, boost::system::system_category());
+              endOfFile_ = true;
+            }
+            else if(!endOfFile_)
+            {
+              used = size_t(read.result_);
+              endOfFile_ = endOfFile_ || used < read.requested_;
+            }
+            read.buffer_->setUsed(used);
+            ready.push_back(read.buffer_);
+          }
+        }
+
+        // Waiting stays true until these buffers are queued so that no other
+        // thread can deliver later buffers ahead of them.
+        if(!ready.empty() || readError)
+        {
+          handleReceiveBatch(readError, ready.empty() ? 0 : &ready[0], ready.size(), ready.size());
+        }
+
+        boost::mutex::scoped_lock lock(bufferMutex_);
+        waiting_ = false;
+        if(reader_.isOpen())
+        {
+          if(reader_.inFlight() > 0)
+          {
+            waitForCompletions();
+          }
+          else if(endOfFile_)
+          {
+            // Nothing more to read.  Let the io_service go idle.
+            close();
+          }
+        }
+      }
+
+      bool fillBuffer(LinkedBuffer * buffer, boost::mutex::scoped_lock& lock)
+      {
+        if(endOfFile_ || !reader_.isOpen())
+        {
+          // nothing more is coming; keep the buffer for whoever needs it.
+          idleBufferPool_.push(buffer);
+          readInProgress_ = false;
+          return true;
+        }
+        if(arena_ == 0 && blockSize_ == 0)
+        {
+          prepareBuffers();
+        }
+        if(!queueRead(buffer))
+        {
+          // every read slot is busy; try again when one completes.
+          idleBufferPool_.push(buffer);
+          readInProgress_ = false;
+          return true;
+        }
+        // keep the pipeline full
+        LinkedBuffer * extra = 0;
+        while(reader_.inFlight() < readDepth_ && (extra = idleBufferPool_.pop()) != 0)
+        {
+          if(!queueRead(extra))
+          {
+            idleBufferPool_.push(extra);
+            break;
+          }
+        }
+        if(!reader_.submit())
+        {
+          assembler_->reportCommunicationError(reader_.error());
+          close();
+          while(!pending_.empty())
+          {
+            if(pending_.front().buffer_ != buffer)
+            {
+              idleBufferPool_.push(pending_.front().buffer_);
+            }
+            pending_.pop_front();
+          }
+          return false;
+        }
+        if(!waiting_)
+        {
+          waitForCompletions();
+        }
+        return true;
+      }
+
+    private:
+      std::string fileName_;
+      uint32 additionalAttributes_;
+      UringFileReader reader_;
+      boost::asio::posix::stream_descriptor completions_;
+      size_t readDepth_;
+      uint64 offset_;
+      bool endOfFile_;
+      bool waiting_;
+      std::deque<PendingRead> pending_;
+      unsigned char * arena_;
+      size_t blockSize_;
+    };
+
+#else // neither Windows nor io_uring
     /// @brief Read stream of FAST-encoded data from a file using asynchronous I/O
     class AsynchFileReceiver
       : public AsynchReceiver
@@ -175,7 +514,7 @@ namespace QuickFAST
         )
         : AsynchReceiver()
       {
-        throw UsageError("Platform Error", "Asynchronous File I/O is only supported on Windows.");
+        throw UsageError("Platform Error", "Asynchronous File I/O is only supported on Windows and Linux.");
       }
 
       /// @brief Construct given ioservice, file name, and extra attributes
@@ -189,7 +528,7 @@ namespace QuickFAST
         )
         : AsynchReceiver()
       {
-        throw UsageError("Platform Error", "Asynchronous File I/O is only supported on Windows.");
+        throw UsageError("Platform Error", "Asynchronous File I/O is only supported on Windows and Linux.");
       }
 
 
@@ -211,7 +550,7 @@ namespace QuickFAST
       }
     };
 
-#endif // _WIN32
+#endif // _WIN32, QUICKFAST_HAS_IO_URING
   }
 }
 #endif // ASYNCHFILERECEIVER_H
@@ -39,6 +39,7 @@ namespace QuickFAST
 
       virtual void runThreads(size_t threadCount = 0, bool useThisThread = true)
       {
+        ioService_.setThreadOptions(threadOptions_);
         ioService_.runThreads(threadCount, useThisThread);
       }
 
@@ -169,19 +170,12 @@ namespace QuickFAST
               ++pausedPackets_;
               idleBufferPool_.push(buffer);
             }
-            else
+            else if(queueReceived(buffer, bytesReceived, lock))
             {
-              ++packetsQueued_;
-              bytesReceived_ += bytesReceived;
-              largestPacket_ = std::max(largestPacket_, bytesReceived);
-              buffer->setUsed(bytesReceived);
-              if(queue_.push(buffer, lock))
-              {
-                // A true return from push means that no one is servicing the queue
-                // Volunteer to service it. If it returns true, then the offer was
-                // accepted.  We'll service the queue after releasing the lock.
-                service = queue_.startService(lock);
-              }
+              // A true return means that no one is servicing the queue
+              // Volunteer to service it. If it returns true, then the offer was
+              // accepted.  We'll service the queue after releasing the lock.
+              service = queue_.startService(lock);
             }
           }
           else
@@ -210,6 +204,87 @@ namespace QuickFAST
         }
       }
 
+      /// @brief handle completion of a read that filled several buffers at once
+      ///
+      /// The batch equivalent of handleReceive(): every filled buffer is queued
+      /// under a single acquisition of the lock, then the queue is serviced once.
+      ///
+      /// @param error indicates status of the receive
+      /// @param buffers that were offered to the read. Filled buffers come first
+      ///        and their used() sizes have already been set.
+      /// @param filled how many of the buffers received a packet
+      /// @param count how many buffers were offered. Unfilled ones return to the idle pool.
+      void handleReceiveBatch(
+        const boost::system::error_code& error,
+        LinkedBuffer * const * buffers,
+        size_t filled,
+        size_t count)
+      {
+        bool service = false;
+        { // Scope for lock
+          boost::mutex::scoped_lock lock(bufferMutex_);
+          readInProgress_ = false;
+          bool queued = false;
+          for(size_t nBuffer = 0; nBuffer < filled; ++nBuffer)
+          {
+            LinkedBuffer * buffer = buffers[nBuffer];
+            ++packetsReceived_;
+            if(buffer->used() == 0)
+            {
+              ++emptyPackets_;
+              idleBufferPool_.push(buffer);
+            }
+            else if(paused_)
+            {
+              ++pausedPackets_;
+              idleBufferPool_.push(buffer);
+            }
+            else
+            {
+              queued = queueReceived(buffer, buffer->used(), lock) || queued;
+            }
+          }
+          for(size_t nBuffer = filled; nBuffer < count; ++nBuffer)
+          {
+            idleBufferPool_.push(buffers[nBuffer]);
+          }
+          if(queued)
+          {
+            service = queue_.startService(lock);
+          }
+          if(error && !paused_ && !stopping_)
+          {
+            ++errorPackets_;
+            if(!assembler_->reportCommunicationError(error.message()))
+            {
+              stop();
+            }
+          }
+          startReceive(lock);
+        }
+
+        while(service)
+        {
+          service = serviceQueue();
+        }
+      }
+
+    private:
+      /// @brief Account for a packet and hand it to the decoder.
+      /// @returns true if the queue was idle before the push.
+      bool queueReceived(
+        LinkedBuffer * buffer,
+        size_t bytesReceived,
+        boost::mutex::scoped_lock & lock)
+      {
+        ++packetsQueued_;
+        bytesReceived_ += bytesReceived;
+        largestPacket_ = std::max(largestPacket_, bytesReceived);
+        buffer->setUsed(bytesReceived);
+        stampBuffer(buffer);
+        return queue_.push(buffer, lock);
+      }
+
     protected:
       /// @brief a manager for the boost::io_service object
       AsioService ioService_;
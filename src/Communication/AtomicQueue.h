@@ -12,7 +12,9 @@
 // All inline, do not export.
 //#include <Common/QuickFAST_Export.h>
 #include "AtomicQueue_fwd.h"
+#include <Communication/LinkedBuffer.h>
 #include <Common/AtomicPointer.h>
+#include <Common/AtomicOps.h>
 namespace QuickFAST
 {
   namespace Communication
@@ -70,7 +72,7 @@ namespace QuickFAST
         {
           buffer->link(incomingHead_);
           first = buffer->link() == 0;
-          incomingHead_.CAS(buffer->link(), buffer);
+          ok = incomingHead_.CAS(buffer->link(), buffer);
         }
         bool wasIdle = CASLong(&busy_, IDLE, BUSY);
         if(!wasIdle && first)
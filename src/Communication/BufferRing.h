@@ -0,0 +1,238 @@
+// Copyright (c) 2009, 2010, 2011, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifndef BUFFERRING_H
+#define BUFFERRING_H
+// All inline, do not export.
+//#include <Common/QuickFAST_Export.h>
+#include "BufferRing_fwd.h"
+#include <Communication/LinkedBuffer.h>
+#include <Common/PointerRing.h>
+
+namespace QuickFAST
+{
+  namespace Communication
+  {
+    ///@brief A lock-free ring of LinkedBuffers.  See PointerRing.
+    class BufferRing : public PointerRing<LinkedBuffer>
+    {
+    public:
+      /// @brief Construct an empty ring.
+      /// @param capacity is the minimum number of buffers the ring can hold. Rounded up to a power of two.
+      /// @param producers says whether push() must be safe for concurrent callers.
+      /// @param strategy determines how popWait() waits.
+      explicit BufferRing(
+        size_t capacity = 1024,
+        Producers producers = SINGLE_PRODUCER,
+        WaitStrategy strategy = BLOCK)
+        : PointerRing<LinkedBuffer>(capacity, producers, strategy)
+      {
+      }
+    };
+
+    ///@brief A SingleServerBufferQueue whose service thread takes buffers without a lock.
+    ///
+    /// The protocol is the same as SingleServerBufferQueue: producers call
+    /// push() with an external mutex locked, and the thread that wins
+    /// startService() is the only one that may call serviceNext() until it calls
+    /// endService().
+    ///
+    /// The difference is that serviceNext() pops directly from a lock-free
+    /// BufferRing, so buffers that arrive while the queue is being serviced are
+    /// picked up without going back to the mutex.  There are no batches:
+    /// serviceNext() returns zero only when the queue is actually empty.
+    ///
+    /// If the ring fills up, further buffers wait in an overflow queue
+    /// (in order) until refresh() moves them into the ring.
+    class SingleServerBufferRing
+    {
+    public:
+      /// @brief Construct an empty queue.
+      /// @param capacity is the number of buffers that fit in the ring.
+      explicit SingleServerBufferRing(size_t capacity = 1024)
+        : ring_(capacity, BufferRing::SINGLE_PRODUCER, BufferRing::BUSY_POLL)
+        , strategy_(BufferRing::BLOCK)
+        , busy_(false)
+        , waiting_(false)
+        , overflows_(0)
+      {
+      }
+
+      /// @brief Insure the ring can hold at least this many buffers.
+      ///
+      /// Call before any buffers are pushed.
+      void reserve(size_t capacity)
+      {
+        ring_.reserve(capacity);
+      }
+
+      /// @brief Choose how refresh() waits for buffers to arrive.
+      ///
+      /// BUSY_POLL releases the mutex and spins; BLOCK sleeps on a condition.
+      void setWaitStrategy(BufferRing::WaitStrategy strategy)
+      {
+        strategy_ = strategy;
+      }
+
+      /// @brief Push a buffer onto the queue.
+      ///
+      /// The unused scoped lock parameter indicates this method should be protected.
+      /// @param buffer is the buffer to be added to the queue
+      /// @returns true if if the queue needs to be serviced
+      bool push(LinkedBuffer * buffer, boost::mutex::scoped_lock &)
+      {
+        // once anything overflows, later buffers must queue behind it.
+        if(!overflow_.isEmpty() || !ring_.push(buffer))
+        {
+          ++overflows_;
+          overflow_.push(buffer);
+        }
+        if(waiting_)
+        {
+          condition_.notify_one();
+        }
+        return !busy_;
+      }
+
+      /// @brief Prepare to service this queue
+      ///
+      /// If this method returns true, the calling thread MUST completely
+      /// service the queue.
+      ///
+      /// The unused scoped lock parameter indicates this method should be protected.
+      /// @returns true if if the queue is now ready to be serviced
+      bool startService(boost::mutex::scoped_lock &)
+      {
+        if(busy_)
+        {
+          return false;
+        }
+        promoteOverflow();
+        busy_ = !ring_.isEmpty();
+        return busy_;
+      }
+
+      /// @brief Service the next entry without locking.
+      ///
+      /// Only the thread that won startService() may call this.
+      /// @returns the entry to be processed or zero if the queue is empty.
+      LinkedBuffer * serviceNext()
+      {
+        return ring_.pop();
+      }
+
+      /// @brief Relinquish responsibility for servicing the queue
+      ///
+      /// The unused scoped lock parameter indicates this method should be protected.
+      /// @param recheck should normally be true indicating that this thread is
+      ///        willing to continue servicing the queue.
+      /// @param lock unused parameter to be sure the mutex is locked.
+      /// @returns true if there are more entries to be serviced.
+      bool endService(bool recheck, boost::mutex::scoped_lock & lock)
+      {
+        busy_ = false;
+        if(recheck)
+        {
+          return startService(lock);
+        }
+        return false;
+      }
+
+      /// @brief Make overflowed buffers visible to serviceNext(); optionally wait for buffers.
+      ///
+      /// This method should be called only by the service thread with the
+      /// external mutex locked.
+      /// @param lock is used for the wait.  It also confirms that the caller has locked the mutex.
+      /// @param wait is true if this call should wait for incoming buffers to be available.
+      /// @returns true if buffers are available to serviceNext()
+      bool refresh(boost::mutex::scoped_lock & lock, bool wait)
+      {
+        promoteOverflow();
+        while(wait && ring_.isEmpty())
+        {
+          if(strategy_ == BufferRing::BUSY_POLL)
+          {
+            lock.unlock();
+            for(size_t spin = 0; spin < spinLimit && ring_.isEmpty(); ++spin)
+            {
+              spinPause();
+            }
+            lock.lock();
+          }
+          else
+          {
+            waiting_ = true;
+            condition_.wait(lock);
+            waiting_ = false;
+          }
+          promoteOverflow();
+        }
+        return !ring_.isEmpty();
+      }
+
+      /// @brief A nondestructive peek at the buffers waiting to be serviced.
+      ///
+      /// Service thread only.
+      /// @param index is the position relative to the next buffer to be serviced
+      const LinkedBuffer * peekOutgoing(size_t index = 0)const
+      {
+        return ring_.peek(index);
+      }
+
+      /// @brief Apply a function to every buffer in the queue
+      ///
+      /// Call only while the queue is not being serviced.
+      /// @param f is the function to apply
+      void apply(boost::function<void (LinkedBuffer *)> f, boost::mutex::scoped_lock &)
+      {
+        for(size_t index = 0; ring_.peek(index) != 0; ++index)
+        {
+          f(ring_.peek(index));
+        }
+        LinkedBuffer * buffer = overflow_.begin();
+        while(buffer != 0)
+        {
+          f(buffer);
+          buffer = buffer->link();
+        }
+      }
+
+      /// @brief Access the ring for its statistics.
+      const BufferRing & ring()const
+      {
+        return ring_;
+      }
+
+      /// @brief Statistic: How many buffers did not fit in the ring?
+      size_t overflows()const
+      {
+        return overflows_;
+      }
+
+    private:
+      void promoteOverflow()
+      {
+        LinkedBuffer * buffer = overflow_.begin();
+        while(buffer != 0 && ring_.push(buffer))
+        {
+          overflow_.pop();
+          buffer = overflow_.begin();
+        }
+      }
+
+    private:
+      /// When busy polling, how often to retake the mutex to check the overflow queue.
+      static const size_t spinLimit = 4096;
+
+      BufferRing ring_;
+      BufferQueue overflow_;
+      boost::condition_variable condition_;
+      BufferRing::WaitStrategy strategy_;
+      bool busy_;
+      bool waiting_;
+      size_t overflows_;
+    };
+  }
+}
+#endif // BUFFERRING_H
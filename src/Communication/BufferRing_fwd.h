@@ -0,0 +1,16 @@
+// Copyright (c) 2009, 2010, 2011, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifndef BUFFERRING_FWD_H
+#define BUFFERRING_FWD_H
+
+namespace QuickFAST
+{
+  namespace Communication
+  {
+    class BufferRing;
+    class SingleServerBufferRing;
+  }
+}
+#endif // BUFFERRING_FWD_H
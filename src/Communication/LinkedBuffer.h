@@ -7,6 +7,7 @@
 // All inline, do not export.
 //#include <Common/QuickFAST_Export.h>
 #include "LinkedBuffer_fwd.h"
+#include <Common/Types.h>
 
 namespace QuickFAST
 {
@@ -24,6 +25,7 @@ namespace QuickFAST
         , capacity_(capacity)
         , used_(0)
         , extra_(0)
+        , receiveTime_(0)
       {
       }
 
@@ -37,6 +39,7 @@ namespace QuickFAST
         , capacity_(0)
         , used_(0)
         , extra_(0)
+        , receiveTime_(0)
       {
       }
 
@@ -143,12 +146,28 @@ namespace QuickFAST
         return extra_;
       }
 
+      /// @brief Record when the data in this buffer arrived.
+      /// @param nanoseconds since the epoch as reported by LatencyHistogram::now()
+      ///        or by the kernel.  Zero means unknown.
+      void setReceiveTime(uint64 nanoseconds)
+      {
+        receiveTime_ = nanoseconds;
+      }
+
+      /// @brief When did the data in this buffer arrive?
+      /// @returns nanoseconds since the epoch, or zero if unknown.
+      uint64 receiveTime() const
+      {
+        return receiveTime_;
+      }
+
     private:
       LinkedBuffer * link_;
       unsigned char * buffer_;
       size_t capacity_;
       size_t used_;
       void * extra_;
+      uint64 receiveTime_;
     };
 
     /// @brief No frills ordered collection of buffers: FIFO
@@ -192,7 +211,7 @@ namespace QuickFAST
       {
         bool first = isEmpty();
         assert(buffer != 0);
-        buffer->link(&head_);
+        buffer->link(head_.link());
         head_.link(buffer);
         if(first)
         {
@@ -0,0 +1,145 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifndef MAPPEDFILERECEIVER_H
+#define MAPPEDFILERECEIVER_H
+// All inline, do not export.
+//#include <Common/QuickFAST_Export.h>
+#include "MappedFileReceiver_fwd.h"
+#include <Communication/SynchReceiver.h>
+#include <Common/MappedFile.h>
+
+namespace QuickFAST
+{
+  namespace Communication
+  {
+    /// @brief A Receiver that decodes a file of raw FAST records in place.
+    ///
+    /// The file is mapped into memory and handed to the assembler one chunk
+    /// at a time as external LinkedBuffers, so nothing is read up front and
+    /// nothing is copied.  The operating system pages the file in as decoding
+    /// reaches it.
+    ///
+    /// Chunk boundaries fall wherever they fall, so use a StreamingAssembler.
+    class MappedFileReceiver
+      : public SynchReceiver
+    {
+    public:
+      /// @brief How much of the file each buffer covers unless told otherwise.
+      static const size_t defaultChunkSize = 1024 * 1024;
+
+      /// @brief Prepare to map a file.  It is not opened until the receiver starts.
+      ///
+      /// @param filename names the file of FAST records.
+      /// @param chunkSize is how much of the file each buffer delivers.
+      /// @param prefetch is how far beyond the current chunk to ask the
+      ///        operating system to read ahead. Zero leaves read-ahead to the
+      ///        operating system's sequential access heuristics.
+      /// @param hugePages requests huge pages for the mapping.  Ignored where
+      ///        not supported.
+      MappedFileReceiver(
+        const std::string & filename,
+        size_t chunkSize = defaultChunkSize,
+        size_t prefetch = 0,
+        bool hugePages = false
+        )
+        : filename_(filename)
+        , chunkSize_(chunkSize)
+        , prefetch_(prefetch)
+        , hugePages_(hugePages)
+        , position_(0)
+        , prefetched_(0)
+        , released_(0)
+      {
+        if(chunkSize_ == 0)
+        {
+          chunkSize_ = defaultChunkSize;
+        }
+      }
+
+      ~MappedFileReceiver()
+      {
+      }
+
+      /// @brief How many bytes of the file have been handed to the assembler.
+      size_t position()const
+      {
+        return position_;
+      }
+
+    private:
+
+      // Implement Receiver method
+      virtual bool initializeReceiver()
+      {
+        if(!file_.open(filename_.c_str()))
+        {
+          assembler_->reportCommunicationError(file_.error());
+          return false;
+        }
+        file_.adviseSequential();
+        if(hugePages_ && !file_.adviseHugePages())
+        {
+          assembler_->reportCommunicationError("Huge pages are not available for " + filename_);
+        }
+        position_ = 0;
+        prefetched_ = 0;
+        released_ = 0;
+        return file_.size() > 0;
+      }
+
+      // Implement Receiver method
+      bool fillBuffer(LinkedBuffer * buffer, boost::mutex::scoped_lock& lock)
+      {
+        if(stopping_ || position_ >= file_.size())
+        {
+          return false;
+        }
+        size_t bytes = std::min(chunkSize_, file_.size() - position_);
+        buffer->setExternal(file_.data() + position_, bytes);
+        position_ += bytes;
+        if(prefetch_ != 0 && position_ + prefetch_ > prefetched_)
+        {
+          // ask in big steps rather than once per chunk
+          size_t from = std::max(position_, prefetched_);
+          file_.prefetch(from, position_ + 2 * prefetch_ - from);
+          prefetched_ = position_ + 2 * prefetch_;
+        }
+        releaseBehind();
+        acceptFullBuffer(buffer, bytes, lock);
+        return true;
+      }
+
+      // Give back memory for chunks the assembler has surely finished with.
+      void releaseBehind()
+      {
+        // every idle buffer could still be queued, so allow for plenty of them.
+        size_t keep = std::max(chunkSize_ * 16, size_t(16 * 1024 * 1024));
+        if(position_ > released_ + 2 * keep)
+        {
+          size_t releaseTo = position_ - keep;
+          file_.release(released_, releaseTo - released_);
+          released_ = releaseTo;
+        }
+      }
+
+      // Implement Receiver method
+      virtual void resetService()
+      {
+        ;
+      }
+
+    private:
+      std::string filename_;
+      size_t chunkSize_;
+      size_t prefetch_;
+      bool hugePages_;
+      MappedFile file_;
+      size_t position_;
+      size_t prefetched_;
+      size_t released_;
+    };
+  }
+}
+#endif // MAPPEDFILERECEIVER_H
@@ -0,0 +1,15 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifndef MAPPEDFILERECEIVER_FWD_H
+#define MAPPEDFILERECEIVER_FWD_H
+
+namespace QuickFAST{
+  namespace Communication{
+    class MappedFileReceiver;
+    /// @brief smart pointer to a MappedFileReceiver
+    typedef boost::shared_ptr<MappedFileReceiver> MappedFileReceiverPtr;
+  }
+}
+#endif // MAPPEDFILERECEIVER_FWD_H
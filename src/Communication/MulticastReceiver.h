@@ -8,12 +8,27 @@
 //#include <Common/QuickFAST_Export.h>
 #include "MulticastReceiver_fwd.h"
 #include <Communication/AsynchReceiver.h>
+#include <Common/AtomicOps.h>
+
+#if defined(__linux__)
+// recvmmsg() accepts several datagrams in one system call.
+# define QUICKFAST_HAS_RECVMMSG
+# include <sys/socket.h>
+# include <cerrno>
+# include <cstring>
+#endif
 
 namespace QuickFAST
 {
   namespace Communication
   {
     /// @brief Receive Multicast Packets and pass them to a packet handler
+    ///
+    /// By default each buffer is filled by its own asynchronous read.  On Linux
+    /// setBatchReceive() switches to recvmmsg() so one system call can fill a
+    /// whole batch of buffers when packets arrive in bursts.
+    /// Batches also carry the kernel's arrival time for each packet when
+    /// latency tracking is enabled.
     class MulticastReceiver
       : public AsynchReceiver
     {
@@ -39,6 +54,12 @@ namespace QuickFAST
         , endpoint_(listenInterface_, portNumber)
         , socket_(ioService_)
         , joined_(false)
+        , batchSize_(1)
+        , busyPoll_(false)
+        , batchCount_(0)
+        , batchPending_(0)
+        , polling_(0)
+        , batchesReceived_(0)
       {
       }
 
@@ -63,11 +84,57 @@ namespace QuickFAST
         , endpoint_(listenInterface_, portNumber)
         , socket_(ioService_.ioService())
         , joined_(false)
+        , batchSize_(1)
+        , busyPoll_(false)
+        , batchCount_(0)
+        , batchPending_(0)
+        , polling_(0)
+        , batchesReceived_(0)
       {
       }
 
       ~MulticastReceiver()
       {
+        stopPolling();
+      }
+
+      /// @brief Fill up to batchSize buffers with each read.
+      ///
+      /// Uses recvmmsg() so it is only available on Linux.  Call before start(),
+      /// and give start() at least batchSize buffers or the batches will be short.
+      ///
+      /// @param batchSize is the most packets accepted by one system call.
+      ///        One restores the normal buffer-at-a-time reads.
+      /// @param busyPoll if true a dedicated thread polls the socket continuously
+      ///        instead of waiting for the io_service to report that it is readable.
+      ///        This costs a processor core but removes the reactor's wakeup latency.
+      void setBatchReceive(size_t batchSize, bool busyPoll = false)
+      {
+        if(batchSize == 0)
+        {
+          batchSize = 1;
+        }
+#ifndef QUICKFAST_HAS_RECVMMSG
+        if(batchSize > 1 || busyPoll)
+        {
+          throw UsageError("Coding Error", "Batch receive is not supported on this platform.");
+        }
+#else // QUICKFAST_HAS_RECVMMSG
+        batch_.resize(batchSize);
+        messages_.resize(batchSize);
+        iovecs_.resize(batchSize);
+        control_.resize(batchSize * CMSG_SPACE(sizeof(struct timespec)));
+#endif // QUICKFAST_HAS_RECVMMSG
+        batchSize_ = batchSize;
+        busyPoll_ = busyPoll && batchSize > 1;
+      }
+
+      /// @brief Statistic: How many reads delivered at least one packet in batch mode.
+      ///
+      /// Compare to packetsReceived() to find the average batch size.
+      size_t batchesReceived() const
+      {
+        return batchesReceived_;
       }
 
       // Implement Receiver method
@@ -93,6 +160,19 @@ namespace QuickFAST
           listenInterface_.to_v4());
         socket_.set_option(joinRequest);
         joined_ = true;
+#ifdef QUICKFAST_HAS_RECVMMSG
+        if(trackLatency_ && batchSize_ > 1)
+        {
+          // have the kernel report when each packet arrived.
+          int enable = 1;
+          ::setsockopt(socket_.native_handle(), SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable));
+        }
+        if(busyPoll_)
+        {
+          atomicStoreRelease(&polling_, 1);
+          pollThread_.reset(new boost::thread(boost::bind(&MulticastReceiver::pollLoop, this)));
+        }
+#endif // QUICKFAST_HAS_RECVMMSG
         return true;
       }
 
@@ -117,10 +197,24 @@ namespace QuickFAST
         catch(...)
         {
         }
+        stopPolling();
         // and then shut everything down for good.
         AsynchReceiver::stop();
       }
 
+      /// @brief Join the io_service threads and, once stopped, the busy polling thread.
+      ///
+      /// When stop() is called by the polling thread itself (for example because
+      /// the assembler asked to stop) that thread cannot be joined until now.
+      virtual void joinThreads()
+      {
+        AsynchReceiver::joinThreads();
+        if(stopping_)
+        {
+          stopPolling();
+        }
+      }
+
       virtual void pause()
       {
         // Temporarily leave the group
@@ -160,6 +254,12 @@ namespace QuickFAST
 
       bool fillBuffer(LinkedBuffer * buffer, boost::mutex::scoped_lock& lock)
       {
+#ifdef QUICKFAST_HAS_RECVMMSG
+        if(batchSize_ > 1)
+        {
+          return fillBatch(buffer, lock);
+        }
+#endif // QUICKFAST_HAS_RECVMMSG
         socket_.async_receive_from(
           boost::asio::buffer(buffer->get(), buffer->capacity()),
           senderEndpoint_,
@@ -172,6 +272,177 @@ namespace QuickFAST
         return true;
       }
 
+      /// Make pollLoop() exit, and wait for it unless this is the polling thread.
+      void stopPolling()
+      {
+        atomicStoreRelease(&polling_, 0);
+        if(pollThread_ && pollThread_->get_id() != boost::this_thread::get_id())
+        {
+          pollThread_->join();
+          pollThread_.reset();
+        }
+      }
+
+#ifdef QUICKFAST_HAS_RECVMMSG
+      /// Offer the buffer plus as many idle ones as the batch allows to a single read.
+      bool fillBatch(LinkedBuffer * buffer, boost::mutex::scoped_lock& lock)
+      {
+        batch_[0] = buffer;
+        batchCount_ = 1;
+        while(batchCount_ < batchSize_)
+        {
+          LinkedBuffer * more = idleBufferPool_.pop();
+          if(more == 0)
+          {
+            break;
+          }
+          batch_[batchCount_++] = more;
+        }
+        if(busyPoll_)
+        {
+          // hand the batch to pollLoop()
+          atomicStoreRelease(&batchPending_, 1);
+        }
+        else
+        {
+          waitReadable();
+        }
+        return true;
+      }
+
+      /// Ask the io_service to tell us when a packet is waiting.
+      void waitReadable()
+      {
+        socket_.async_receive(
+          boost::asio::null_buffers(),
+          boost::bind(&MulticastReceiver::handleReadable,
+            this,
+            boost::asio::placeholders::error)
+          );
+      }
+
+      void handleReadable(const boost::system::error_code& error)
+      {
+        size_t filled = 0;
+        boost::system::error_code readError(error);
+        if(!error && !receiveBatch(readError, filled))
+        {
+          // Someone else drained the socket.  Wait again with the same batch.
+          waitReadable();
+          return;
+        }
+        handleReceiveBatch(readError, &batch_[0], filled, batchCount_);
+      }
+
+      /// Body of the busy polling thread.
+      void pollLoop()
+      {
+        while(atomicLoadAcquire(&polling_) != 0)
+        {
+          if(atomicLoadAcquire(&batchPending_) == 0)
+          {
+            spinPause();
+            continue;
+          }
+          size_t filled = 0;
+          boost::system::error_code error;
+          if(receiveBatch(error, filled))
+          {
+            // handleReceiveBatch may start the next batch in this thread.
+            atomicStoreRelease(&batchPending_, 0);
+            handleReceiveBatch(error, &batch_[0], filled, batchCount_);
+          }
+          else
+          {
+            spinPause();
+          }
+        }
+        releasePendingBatch();
+      }
+
+      /// Return the buffers of a batch that pollLoop() will never read to the idle pool.
+      void releasePendingBatch()
+      {
+        boost::mutex::scoped_lock lock(bufferMutex_);
+        if(atomicLoadAcquire(&batchPending_) != 0)
+        {
+          atomicStoreRelease(&batchPending_, 0);
+          for(size_t nBuffer = 0; nBuffer < batchCount_; ++nBuffer)
+          {
+            idleBufferPool_.push(batch_[nBuffer]);
+          }
+          batchCount_ = 0;
+          readInProgress_ = false;
+        }
+      }
+
+      /// @brief Read every waiting packet that fits in the batch without blocking.
+      ///
+      /// When latency is being tracked each filled buffer gets the kernel's arrival time.
+      /// @param error is set if the read failed.
+      /// @param filled is set to the number of buffers that received a packet.
+      /// @returns false if nothing was waiting.
+      bool receiveBatch(boost::system::error_code & error, size_t & filled)
+      {
+        for(size_t nBuffer = 0; nBuffer < batchCount_; ++nBuffer)
+        {
+          iovecs_[nBuffer].iov_base = batch_[nBuffer]->get();
+          iovecs_[nBuffer].iov_len = batch_[nBuffer]->capacity();
+          std::memset(&messages_[nBuffer], 0, sizeof(mmsghdr));
+          messages_[nBuffer].msg_hdr.msg_iov = &iovecs_[nBuffer];
+          messages_[nBuffer].msg_hdr.msg_iovlen = 1;
+          if(trackLatency_)
+          {
+            const size_t controlSize = CMSG_SPACE(sizeof(struct timespec));
+            messages_[nBuffer].msg_hdr.msg_control = &control_[nBuffer * controlSize];
+            messages_[nBuffer].msg_hdr.msg_controllen = controlSize;
+          }
+        }
+        int received = ::recvmmsg(
+          socket_.native_handle(),
+          &messages_[0],
+          static_cast<unsigned int>(batchCount_),
+          MSG_DONTWAIT,
+          0);
+        filled = 0;
+        if(received < 0)
+        {
+          if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+          {
+            return false;
+          }
+          error = boost::system::error_code(errno, boost::system::system_category());
+          return true;
+        }
+        filled = static_cast<size_t>(received);
+        for(size_t nBuffer = 0; nBuffer < filled; ++nBuffer)
+        {
+          batch_[nBuffer]->setUsed(messages_[nBuffer].msg_len);
+          batch_[nBuffer]->setReceiveTime(kernelTimestamp(messages_[nBuffer].msg_hdr));
+        }
+        ++batchesReceived_;
+        return true;
+      }
+
+      /// @brief Find the arrival time the kernel attached to a packet.
+      /// @returns nanoseconds since the epoch, or zero if there is none.
+      static uint64 kernelTimestamp(struct msghdr & header)
+      {
+        for(struct cmsghdr * control = CMSG_FIRSTHDR(&header);
+          control != 0;
+          control = CMSG_NXTHDR(&header, control))
+        {
+          if(control->cmsg_level == SOL_SOCKET && control->cmsg_type == SCM_TIMESTAMPNS)
+          {
+            struct timespec stamp;
+            std::memcpy(&stamp, CMSG_DATA(control), sizeof(stamp));
+            return uint64(stamp.tv_sec) * 1000000000 + uint64(stamp.tv_nsec);
+          }
+        }
+        return 0;
+      }
+#endif // QUICKFAST_HAS_RECVMMSG
+
     private:
       boost::asio::ip::address listenInterface_;
       unsigned short portNumber_;
@@ -181,6 +452,24 @@ namespace QuickFAST
       boost::asio::ip::udp::endpoint senderEndpoint_;
       boost::asio::ip::udp::socket socket_;
       bool joined_;
+
+      size_t batchSize_;
+      bool busyPoll_;
+      /// Buffers offered to the read in progress
+      std::vector<LinkedBuffer *> batch_;
+      size_t batchCount_;
+#ifdef QUICKFAST_HAS_RECVMMSG
+      std::vector<mmsghdr> messages_;
+      std::vector<iovec> iovecs_;
+      /// Room for one timestamp per message
+      std::vector<char> control_;
+#endif // QUICKFAST_HAS_RECVMMSG
+      /// Set when batch_ is waiting for pollLoop()
+      volatile long batchPending_;
+      /// Cleared to make pollLoop() exit
+      volatile long polling_;
+      boost::scoped_ptr<boost::thread> pollThread_;
+      size_t batchesReceived_;
     };
   }
 }
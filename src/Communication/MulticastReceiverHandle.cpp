@@ -117,6 +117,24 @@ MulticastReceiverHandle::largestPacket() const
   return pImpl_->ptr_->largestPacket();
 }
 
+void
+MulticastReceiverHandle::setLatencyTracking(bool trackLatency)
+{
+  pImpl_->ptr_->setLatencyTracking(trackLatency);
+}
+
+const LatencyHistogram &
+MulticastReceiverHandle::wireToDecodeLatency() const
+{
+  return pImpl_->ptr_->wireToDecodeLatency();
+}
+
+const LatencyHistogram &
+MulticastReceiverHandle::decodeAndConsumeLatency() const
+{
+  return pImpl_->ptr_->decodeAndConsumeLatency();
+}
+
 
 void
 MulticastReceiverHandle::start(
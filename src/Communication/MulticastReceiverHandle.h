@@ -6,6 +6,7 @@
 #define MULTICASTRECEIVERHANDLE_H
 #include <Common/QuickFAST_Export.h>
 #include <Communication/Assembler_fwd.h>
+#include <Common/LatencyHistogram.h>
 
 namespace QuickFAST{
   namespace Communication {
@@ -75,6 +76,16 @@ namespace QuickFAST{
       /// @returns the number of bytes in the largest packet
       size_t largestPacket() const;
 
+      /// @brief Time stamp packets and count latencies.  Call before start().
+      /// @param trackLatency true to enable tracking
+      void setLatencyTracking(bool trackLatency = true);
+
+      /// @brief Time from packet arrival until decoding of a message begins
+      const LatencyHistogram & wireToDecodeLatency() const;
+
+      /// @brief Time to decode a message plus the time its consumer takes
+      const LatencyHistogram & decodeAndConsumeLatency() const;
+
       /// @brief Start accepting packets.  Returns immediately
       /// @param assembler accepts and processes the filled buffers
       /// @param bufferSize determines the maximum size of an incoming packet
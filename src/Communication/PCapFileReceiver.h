@@ -14,7 +14,10 @@ namespace QuickFAST
 {
   namespace Communication
   {
-    /// A Receiver that reads input from an istream.
+    /// @brief A Receiver that replays the UDP packets in a PCap (or pcapng) file.
+    ///
+    /// Packets are delivered in place from the memory mapped capture without
+    /// being copied, so the buffer size does not limit the packet size.
     class PCapFileReceiver
       : public SynchReceiver
     {
@@ -62,12 +65,9 @@ namespace QuickFAST
         bool result = reader_.read(pcapBuffer, pcapSize);
         if(result)
         {
-          if(pcapSize <= buffer->capacity())
-          {
-            memcpy(buffer->get(), pcapBuffer, pcapSize);
-            acceptFullBuffer(buffer, pcapSize, lock);
-            result = true;
-          }
+          // The reader maps the file, so the packet can be decoded where it lies.
+          buffer->setExternal(pcapBuffer, pcapSize);
+          acceptFullBuffer(buffer, pcapSize, lock);
         }
         return result;
       }
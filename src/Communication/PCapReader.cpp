@@ -207,18 +207,60 @@ namespace
 
   static const uint32 nativeMagic = 0xa1b2c3d4;
   static const uint32 swappedMagic = 0xd4c3b2a1;
+  // same format but with nanosecond time stamps
+  static const uint32 nativeNanoMagic = 0xa1b23c4d;
+  static const uint32 swappedNanoMagic = 0x4d3cb2a1;
+
+  /*
+   * pcapng is a sequence of blocks.  Every block starts with its type and total
+   * length and ends with a repeat of the length.  The section header block's type
+   * reads the same in either byte order; the byte order magic that follows it
+   * says whether the rest of the section needs swapping.
+   * See http://www.winpcap.org/ntar/draft/PCAP-DumpFileFormat.html
+   */
+  enum pcapngBlockType
+  {
+    PCAPNG_SECTION_HEADER = 0x0A0D0D0A,
+    PCAPNG_INTERFACE_DESCRIPTION = 0x00000001,
+    PCAPNG_PACKET = 0x00000002, /* obsolete */
+    PCAPNG_SIMPLE_PACKET = 0x00000003,
+    PCAPNG_ENHANCED_PACKET = 0x00000006
+  };
+  static const uint32 pcapngByteOrderMagic = 0x1A2B3C4D;
+  static const size_t pcapngBlockHeaderSize = 8;  // type + length
+  static const size_t pcapngBlockTrailerSize = 4; // length
+
+  // offsets of fields from the start of the block
+  static const size_t sectionByteOrderOffset = 8;
+  static const size_t interfaceLinkTypeOffset = 8;
+  static const size_t interfaceSnapLengthOffset = 12;
+  static const size_t enhancedInterfaceOffset = 8;
+  static const size_t enhancedCapturedOffset = 20;
+  static const size_t enhancedOriginalOffset = 24;
+  static const size_t enhancedDataOffset = 28;
+  static const size_t obsoleteInterfaceOffset = 8; // 16 bits
+  static const size_t obsoleteCapturedOffset = 20;
+  static const size_t obsoleteOriginalOffset = 24;
+  static const size_t obsoleteDataOffset = 28;
+  static const size_t simpleOriginalOffset = 8;
+  static const size_t simpleDataOffset = 12;
 
 #pragma pack(pop)
 
+  // How much already-replayed data may stay resident before it is released.
+  static const size_t releaseInterval = 64 * 1024 * 1024;
 }
 
 PCapReader::PCapReader()
-: fileSize_(0)
+: buffer_(0)
+, fileSize_(0)
 , pos_(0)
 , ok_(false)
 , usetv32_(false)
 , usetv64_(false)
 , linktype_(DLT_NULL)
+, pcapng_(false)
+, releasedTo_(0)
 , swap(false)
 , verbose_(false)
 {
@@ -227,21 +269,22 @@ PCapReader::PCapReader()
 bool
 PCapReader::open(const char * filename, std::ostream * dumpFile)
 {
-  ok_ = true;
-  FILE * file = fopen(filename, "rb");
-  ok_ = file != 0;
+  ok_ = file_.open(filename);
+  if(!ok_)
+  {
+    std::cerr << "PCapReader: " << file_.error() << std::endl;
+    buffer_ = 0;
+    fileSize_ = 0;
+  }
   if(ok_)
   {
-    fseek(file, 0, SEEK_END);
-    fileSize_ = ftell(file);
-    buffer_.reset(new unsigned char[fileSize_]);
-    fseek(file, 0, SEEK_SET);
-    unsigned char * rawBuffer = buffer_.get();
-    size_t byteCount = fread(rawBuffer, 1, fileSize_, file);
-    fclose(file);
-    ok_ = byteCount == fileSize_;
+    buffer_ = file_.data();
+    fileSize_ = file_.size();
+    file_.adviseSequential();
     if(dumpFile != 0)
     {
+      const unsigned char * rawBuffer = buffer_;
+      size_t byteCount = fileSize_;
       *dumpFile << std::hex << std::setfill('0') <<std::endl;
       for(size_t pos = 0; pos < byteCount;)
       {
@@ -263,11 +306,46 @@ PCapReader::open(const char * filename, std::ostream * dumpFile)
   return ok_;
 }
 
+void
+PCapReader::close()
+{
+  file_.close();
+  buffer_ = 0;
+  fileSize_ = 0;
+  pos_ = 0;
+  ok_ = false;
+}
+
+uint32
+PCapReader::get32(size_t pos)const
+{
+  uint32 value;
+  memcpy(&value, buffer_ + pos, sizeof(value));
+  return swap(value);
+}
+
+uint16
+PCapReader::get16(size_t pos)const
+{
+  uint16 value;
+  memcpy(&value, buffer_ + pos, sizeof(value));
+  return swap(value);
+}
+
 bool
 PCapReader::rewind()
 {
   ok_ = true;
   pos_ = 0;
+  pcapng_ = false;
+  interfaceLinkTypes_.clear();
+  interfaceSnapLengths_.clear();
+  if(releasedTo_ != 0)
+  {
+    // start reading ahead again.
+    file_.adviseSequential();
+    releasedTo_ = 0;
+  }
 
   //////////////////////////
   // Process the file header
@@ -278,21 +356,37 @@ PCapReader::rewind()
   }
   if(ok_)
   {
-    pcap_file_header * fileHeader = reinterpret_cast<pcap_file_header *>(buffer_.get() + pos_);
+    uint32 magic;
+    memcpy(&magic, buffer_ + pos_, sizeof(magic));
+    if(magic == PCAPNG_SECTION_HEADER)
+    {
+      pcapng_ = true;
+      ok_ = beginSection(pos_);
+      if(verbose_)
+      {
+        std::cout << "PCapReader: pcapng file. Setting swap to : "
+          << (swap(pcapngByteOrderMagic) != pcapngByteOrderMagic) << std::endl;
+      }
+      // the section header block is left for nextPcapNgPacket to step over.
+      return ok_;
+    }
+
+    const pcap_file_header * fileHeader = reinterpret_cast<const pcap_file_header *>(buffer_ + pos_);
     pos_ += sizeof(pcap_file_header);
 
-    if(fileHeader->magic != nativeMagic && fileHeader->magic != swappedMagic)
+    if(magic != nativeMagic && magic != swappedMagic
+      && magic != nativeNanoMagic && magic != swappedNanoMagic)
     {
       std::cerr << "Invalid pcap file: missing magic." << std::endl;
       ok_ = false;
     }
     if(ok_)
     {
-      swap.setSwap(fileHeader->magic == swappedMagic);
-      assert(swap(fileHeader->magic) == nativeMagic);
+      swap.setSwap(magic == swappedMagic || magic == swappedNanoMagic);
       if(verbose_)
       {
-        std::cout << "PCapReader: Setting swap to : " << (fileHeader->magic == swappedMagic) << std::endl;
+        std::cout << "PCapReader: Setting swap to : "
+          << (magic == swappedMagic || magic == swappedNanoMagic) << std::endl;
       }
     }
     linktype_ = swap(fileHeader->linktype);
@@ -300,6 +394,31 @@ PCapReader::rewind()
   return ok_;
 }
 
+bool
+PCapReader::beginSection(size_t blockPos)
+{
+  if(fileSize_ - blockPos < sectionByteOrderOffset + sizeof(uint32))
+  {
+    std::cerr << "Invalid pcapng file: truncated section header." << std::endl;
+    return false;
+  }
+  uint32 byteOrder;
+  memcpy(&byteOrder, buffer_ + blockPos + sectionByteOrderOffset, sizeof(byteOrder));
+  swap.setSwap(false);
+  if(byteOrder != pcapngByteOrderMagic)
+  {
+    swap.setSwap(true);
+    if(swap(byteOrder) != pcapngByteOrderMagic)
+    {
+      std::cerr << "Invalid pcapng file: missing byte order magic." << std::endl;
+      return false;
+    }
+  }
+  interfaceLinkTypes_.clear();
+  interfaceSnapLengths_.clear();
+  return true;
+}
+
 bool
 PCapReader::good()const
 {
@@ -313,21 +432,15 @@ PCapReader::read(const unsigned char *& buffer, size_t & size)
   {
     ok_ = false;
     size_t skipped = 0;
-    size_t minBytes = sizeof(pcap_pkthdr) + sizeof(ip_header) + sizeof(udp_header);
-    if(usetv32_)
-    {
-      minBytes = sizeof(pcap_pkthdr32) + sizeof(ip_header) + sizeof(udp_header);
-    }
-    if(usetv64_)
-    {
-      minBytes = sizeof(pcap_pkthdr64) + sizeof(ip_header) + sizeof(udp_header);
-    }
 
     if(verbose_)
     {
-      std::cout << "PCapReader: Starting read position: " << pos_ << " file size: " << fileSize_ 
-                << " minimum packet size: " << minBytes << std::endl;
-      if(usetv32_)
+      std::cout << "PCapReader: Starting read position: " << pos_ << " file size: " << fileSize_ << std::endl;
+      if(pcapng_)
+      {
+        std::cout << "PCapReader: reading from pcapng capture" << std::endl;
+      }
+      else if(usetv32_)
       {
         std::cout << "PCapReader: reading from 32 bit packet capture" << std::endl;
       }
@@ -341,156 +454,319 @@ PCapReader::read(const unsigned char *& buffer, size_t & size)
       }
     }
 
-    while(!ok_ && (pos_ + minBytes < fileSize_))
+    const unsigned char * packet = 0;
+    size_t captured = 0;
+    size_t original = 0;
+    uint32 linkType = linktype_;
+    bool more = true;
+    while(!ok_ && more)
     {
-      ////////////////////////////
-      // process the packet header
-      size_t headerPos = pos_;
-      size_t datalen = 0;
-      size_t expectlen = 0;
-      bool truncate = false;
-      unsigned int dataLinkType = 0;
-
-      if(usetv32_)
-      {
-        pcap_pkthdr32 * packetHeader = reinterpret_cast<pcap_pkthdr32 *>(buffer_.get() + pos_);
-        pos_ += sizeof(pcap_pkthdr32);
-        datalen = swap(packetHeader->caplen);
-        expectlen = swap(packetHeader->len);
-        truncate = (packetHeader->caplen != packetHeader->len);
-      }
-      else if(usetv64_)
+      if(pcapng_)
       {
-        pcap_pkthdr64 * packetHeader = reinterpret_cast<pcap_pkthdr64 *>(buffer_.get() + pos_);
-        pos_ += sizeof(pcap_pkthdr64);
-        datalen = swap(packetHeader->caplen);
-        expectlen = swap(packetHeader->len);
-        truncate = (packetHeader->caplen != packetHeader->len);
+        more = nextPcapNgPacket(packet, captured, original, linkType);
       }
       else
       {
-        pcap_pkthdr * packetHeader = reinterpret_cast<pcap_pkthdr *>(buffer_.get() + pos_);
-        pos_ += sizeof(pcap_pkthdr);
-        datalen = swap(packetHeader->caplen);
-        expectlen = swap(packetHeader->len);
-        truncate = (packetHeader->caplen != packetHeader->len);
+        more = nextPcapPacket(packet, captured, original);
       }
-      if(verbose_)
+      if(!more)
       {
-        std::cout << "PCapReader: after header position: " << pos_ << " data length: " << datalen;
+        // end of data
       }
-      if(truncate)
+      else if(captured != original)
       {
-        pos_ += datalen;
-        skipped+= 1;
+        skipped += 1;
         if(verbose_)
         {
-          std::cout << "  Truncated. received 0x"  << std::hex << datalen
-                    << " expected 0x" << expectlen << std::dec << std::endl;
+          std::cout << "  Truncated. received 0x"  << std::hex << captured
+                    << " expected 0x" << original << std::dec << std::endl;
         }
       }
+      else if(findUdpPayload(packet, captured, linkType, buffer, size))
+      {
+        ok_ = true;
+      }
       else
       {
-        if(verbose_)
+        skipped += 1;
+      }
+    }
+    if(skipped != 0)
+    {
+      std::cerr << "Warning: ignoring " << skipped << " truncated packets." << std::endl;
+    }
+    releaseBehind();
+  }
+  return ok_;
+}
+
+bool
+PCapReader::nextPcapPacket(const unsigned char *& packet, size_t & captured, size_t & original)
+{
+  size_t headerSize = sizeof(pcap_pkthdr);
+  if(usetv32_)
+  {
+    headerSize = sizeof(pcap_pkthdr32);
+  }
+  else if(usetv64_)
+  {
+    headerSize = sizeof(pcap_pkthdr64);
+  }
+  if(pos_ + headerSize > fileSize_)
+  {
+    return false;
+  }
+
+  ////////////////////////////
+  // process the packet header
+  // caplen and len are the last two fields of every header layout.
+  size_t headerPos = pos_;
+  captured = get32(pos_ + headerSize - 2 * sizeof(uint32));
+  original = get32(pos_ + headerSize - sizeof(uint32));
+  pos_ += headerSize;
+  if(verbose_)
+  {
+    std::cout << "PCapReader: " << headerPos << " after header position: " << pos_
+      << " data length: " << captured << std::endl;
+  }
+  if(captured > fileSize_ - pos_)
+  {
+    std::cerr << "PCapReader: packet at " << headerPos << " runs past the end of the file." << std::endl;
+    pos_ = fileSize_;
+    return false;
+  }
+  packet = buffer_ + pos_;
+  pos_ += captured;
+  return true;
+}
+
+bool
+PCapReader::nextPcapNgPacket(const unsigned char *& packet, size_t & captured, size_t & original, uint32 & linkType)
+{
+  while(pos_ + pcapngBlockHeaderSize + pcapngBlockTrailerSize <= fileSize_)
+  {
+    size_t blockPos = pos_;
+    uint32 blockType;
+    memcpy(&blockType, buffer_ + blockPos, sizeof(blockType));
+    if(blockType == PCAPNG_SECTION_HEADER)
+    {
+      if(!beginSection(blockPos))
+      {
+        return false;
+      }
+    }
+    else
+    {
+      blockType = swap(blockType);
+    }
+    size_t blockLength = get32(blockPos + sizeof(uint32));
+    if(blockLength < pcapngBlockHeaderSize + pcapngBlockTrailerSize
+      || blockLength > fileSize_ - blockPos
+      || blockLength % 4 != 0)
+    {
+      std::cerr << "PCapReader: invalid pcapng block length " << blockLength
+        << " at " << blockPos << std::endl;
+      pos_ = fileSize_;
+      return false;
+    }
+    pos_ += blockLength;
+    // the end of the block body
+    size_t bodyEnd = blockPos + blockLength - pcapngBlockTrailerSize;
+
+    if(verbose_)
+    {
+      std::cout << "PCapReader: pcapng block type " << blockType << " length " << blockLength
+        << " at " << blockPos << std::endl;
+    }
+
+    size_t dataPos = 0;
+    uint32 interfaceId = 0;
+    switch(blockType)
+    {
+    case PCAPNG_INTERFACE_DESCRIPTION:
+      {
+        if(blockPos + interfaceSnapLengthOffset + sizeof(uint32) <= bodyEnd)
         {
-          std::cout << std::endl;
+          interfaceLinkTypes_.push_back(get16(blockPos + interfaceLinkTypeOffset));
+          interfaceSnapLengths_.push_back(get32(blockPos + interfaceSnapLengthOffset));
         }
-        bool found = false;
-        switch(linktype_)
+        continue;
+      }
+    case PCAPNG_ENHANCED_PACKET:
+      {
+        if(blockPos + enhancedDataOffset > bodyEnd)
         {
-        case DLT_EN10MB:
-          {
-            if(verbose_)
-            {
-              std::cout << "PCapReader: Ethernet packet." << std::endl;
-            }
-            pos_ += sizeof(ethernetIIHeader);
-            datalen -= sizeof(ethernetIIHeader);
-            found = true;
-            break;
-          }
-        case DLT_LINUX_SLL:
-          {
-            if(verbose_)
-            {
-              std::cout << "PCapReader: Linux cooked socket packet." << std::endl;
-            }
-            pos_ += sizeof(linuxCookedCaptureHeader);
-            datalen -= sizeof(linuxCookedCaptureHeader);
-            found = true;
-            break;
-          }
-        default:
-          {
-            if(verbose_)
-            {
-              std::cout << "PCapReader: Other type of packet.  Checking for IP protocol flag." << std::endl;
-            }
-            // HACK!look for the IP protocol flag to mark the end of the the link layer header
-            static unsigned short IPProtocol = 0x0008;
-            while(!found && datalen > 2)
-            {
-              unsigned short protocol = *(unsigned short *)(buffer_.get() + pos_);
-              if(swap(protocol) == IPProtocol)
-              {
-                found = true;
-                pos_ += 2;
-                datalen -= 2;
-              }
-              else
-              {
-                pos_ += 1;
-                datalen -= 1;
-              }
-            }
-            break;
-          }
+          continue;
         }
-        if(found)
+        interfaceId = get32(blockPos + enhancedInterfaceOffset);
+        captured = get32(blockPos + enhancedCapturedOffset);
+        original = get32(blockPos + enhancedOriginalOffset);
+        dataPos = blockPos + enhancedDataOffset;
+        break;
+      }
+    case PCAPNG_PACKET:
+      {
+        if(blockPos + obsoleteDataOffset > bodyEnd)
         {
-          ip_header * ipHeader = reinterpret_cast<ip_header *>(buffer_.get() + pos_);
-          // IP header contains its own length expressed in 4 byte units.
-          size_t ipLen = (ipHeader->ver_ihl & 0xF) * 4;
-          pos_ += ipLen;
-          datalen -= ipLen;
-          udp_header * udpHeader = reinterpret_cast<udp_header*>(buffer_.get() + pos_);
-          pos_ += sizeof(udp_header);
-          datalen -= sizeof(udp_header);
-          
-          // udplen includes udp header + cargo
-          // udplen is stored in network byte order
-          size_t udplen = ntohs(udpHeader->len);
-
-          buffer = buffer_.get() + pos_;
-          // trust the udp header for actual cargo size
-          // but continue to trust pos_ and datalen (originates in pcap header) for position in buffer.
-          size = udplen - sizeof(udp_header);
-          if(verbose_)
-          {
-            std::cout << "PCapReader: " << headerPos << ": " << pos_ << ' ' << size
-              << "=== 0x" << std::hex  << headerPos << ": 0x" << pos_ << " 0x" << size << std::dec << std::endl;
-          }
-          ok_ = true;
-          pos_ += datalen;
+          continue;
         }
-        else
+        interfaceId = get16(blockPos + obsoleteInterfaceOffset);
+        captured = get32(blockPos + obsoleteCapturedOffset);
+        original = get32(blockPos + obsoleteOriginalOffset);
+        dataPos = blockPos + obsoleteDataOffset;
+        break;
+      }
+    case PCAPNG_SIMPLE_PACKET:
+      {
+        if(blockPos + simpleDataOffset > bodyEnd)
         {
-          if(verbose_)
-          {
-            std::cout << "PCapReader: could not find packet. Skipping " << datalen << " bytes." << std::endl;
-          }
-          pos_ += datalen;
-          skipped += 1;
+          continue;
         }
+        // a simple packet has no captured length.  It is whatever fits in the block,
+        // limited by the first interface's snapshot length.
+        original = get32(blockPos + simpleOriginalOffset);
+        dataPos = blockPos + simpleDataOffset;
+        captured = std::min(original, bodyEnd - dataPos);
+        if(!interfaceSnapLengths_.empty() && interfaceSnapLengths_[0] != 0)
+        {
+          captured = std::min(captured, size_t(interfaceSnapLengths_[0]));
+        }
+        break;
+      }
+    default:
+      {
+        // statistics, name resolution, custom blocks, etc. are of no interest.
+        continue;
+      }
+    }
+    if(interfaceId >= interfaceLinkTypes_.size())
+    {
+      std::cerr << "PCapReader: pcapng packet at " << blockPos
+        << " refers to undefined interface " << interfaceId << std::endl;
+      continue;
+    }
+    if(captured > bodyEnd - dataPos)
+    {
+      std::cerr << "PCapReader: pcapng packet at " << blockPos << " overruns its block." << std::endl;
+      continue;
+    }
+    linkType = interfaceLinkTypes_[interfaceId];
+    packet = buffer_ + dataPos;
+    return true;
+  }
+  return false;
+}
 
+bool
+PCapReader::findUdpPayload(
+  const unsigned char * packet,
+  size_t datalen,
+  uint32 linkType,
+  const unsigned char *& payload,
+  size_t & size)
+{
+  size_t pos = 0;
+  bool found = false;
+  switch(linkType)
+  {
+  case DLT_EN10MB:
+    {
+      if(verbose_)
+      {
+        std::cout << "PCapReader: Ethernet packet." << std::endl;
       }
+      pos += sizeof(ethernetIIHeader);
+      found = datalen >= pos;
+      break;
     }
-    if(skipped != 0)
+  case DLT_LINUX_SLL:
     {
-      std::cerr << "Warning: ignoring " << skipped << " truncated packets." << std::endl;
+      if(verbose_)
+      {
+        std::cout << "PCapReader: Linux cooked socket packet." << std::endl;
+      }
+      pos += sizeof(linuxCookedCaptureHeader);
+      found = datalen >= pos;
+      break;
+    }
+  default:
+    {
+      if(verbose_)
+      {
+        std::cout << "PCapReader: Other type of packet.  Checking for IP protocol flag." << std::endl;
+      }
+      // HACK!look for the IP protocol flag to mark the end of the the link layer header
+      static unsigned short IPProtocol = 0x0008;
+      while(!found && datalen - pos > 2)
+      {
+        unsigned short protocol;
+        memcpy(&protocol, packet + pos, sizeof(protocol));
+        if(swap(protocol) == IPProtocol)
+        {
+          found = true;
+          pos += 2;
+        }
+        else
+        {
+          pos += 1;
+        }
+      }
+      break;
     }
   }
-  return ok_;
+  if(found)
+  {
+    // IP header contains its own length expressed in 4 byte units.
+    size_t ipLen = 0;
+    if(pos < datalen)
+    {
+      const ip_header * ipHeader = reinterpret_cast<const ip_header *>(packet + pos);
+      ipLen = (ipHeader->ver_ihl & 0xF) * 4;
+    }
+    found = ipLen != 0 && datalen - pos >= ipLen + sizeof(udp_header);
+    if(found)
+    {
+      pos += ipLen;
+      const udp_header * udpHeader = reinterpret_cast<const udp_header*>(packet + pos);
+      pos += sizeof(udp_header);
+
+      // udplen includes udp header + cargo
+      // udplen is stored in network byte order
+      size_t udplen = ntohs(udpHeader->len);
+
+      // trust the udp header for actual cargo size
+      // but the pcap header for position in the file.
+      found = udplen >= sizeof(udp_header) && udplen - sizeof(udp_header) <= datalen - pos;
+      if(found)
+      {
+        payload = packet + pos;
+        size = udplen - sizeof(udp_header);
+        if(verbose_)
+        {
+          std::cout << "PCapReader: " << (payload - buffer_) << ' ' << size
+            << "=== 0x" << std::hex << (payload - buffer_) << " 0x" << size << std::dec << std::endl;
+        }
+      }
+    }
+  }
+  if(!found && verbose_)
+  {
+    std::cout << "PCapReader: could not find packet. Skipping " << datalen << " bytes." << std::endl;
+  }
+  return found;
+}
+
+void
+PCapReader::releaseBehind()
+{
+  // Keep the most recent interval resident: packets handed out
+  // recently may still be waiting to be decoded.
+  if(pos_ > releasedTo_ + 2 * releaseInterval)
+  {
+    size_t releaseTo = pos_ - releaseInterval;
+    file_.release(releasedTo_, releaseTo - releasedTo_);
+    releasedTo_ = releaseTo;
+  }
 }
 
 void
@@ -504,4 +780,3 @@ PCapReader::seek(size_t address)
 {
   pos_ = address;
 }
-
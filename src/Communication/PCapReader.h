@@ -9,6 +9,7 @@
 #include <Common/QuickFAST_Export.h>
 #include <Common/Types.h>
 #include <Common/ByteSwapper.h>
+#include <Common/MappedFile.h>
 
 
 namespace QuickFAST
@@ -21,7 +22,13 @@ namespace QuickFAST
     /// For more power, see tcpdump and/or winpcap open source projects.
     ///
     /// PCap is the format used by many communication utility data capture packages
-    /// including Wireshark (aka Ethereal) and tcpdump.
+    /// including Wireshark (aka Ethereal) and tcpdump.  Both the original pcap format
+    /// and pcapng (the default for newer versions of Wireshark) are recognized.
+    ///
+    /// The file is mapped into memory rather than read, so opening a capture takes
+    /// the same time regardless of its size, and captures larger than physical memory
+    /// can be replayed.  Packets are returned in place: the pointers from read() point
+    /// into the mapped file and remain valid until the reader is closed or destroyed.
     class QuickFAST_Export PCapReader
     {
     public:
@@ -33,6 +40,17 @@ namespace QuickFAST
       /// @returns true if the open was successful
       bool open(const char * filename, std::ostream * dumpFile = 0);
 
+      /// @brief Release the file.
+      ///
+      /// Invalidates every packet pointer returned by read().
+      void close();
+
+      /// @brief Is the open file in pcapng format?
+      bool isPcapNg()const
+      {
+        return pcapng_;
+      }
+
       /// @brief enable noisy operation for debugging purposes
       ///
       /// @param verbose true turns on the noise.
@@ -50,7 +68,8 @@ namespace QuickFAST
 
       /// @brief Read the next record in the file.
       ///
-      /// @param[out] buffer end up pointing to the user data in the packet (headers are bypassed)
+      /// @param[out] buffer end up pointing to the user data in the packet (headers are bypassed).
+      ///             This points into the file itself; nothing is copied.
       /// @param[out] size contains the number of bytes of user data in the packet (zero is possible and legal!)
       /// @returns true if the read was successful.  False usually means end of data
       bool read(const unsigned char *& buffer, size_t & size);
@@ -64,6 +83,8 @@ namespace QuickFAST
 
       /// @brief force the reader to expect 64 bit headers even on a 32 bit system.
       ///
+      /// Ignored for pcapng files which have a portable header layout.
+      ///
       /// Only one of 64bit and 32bit should be set.
       /// @param state turns the 64bit state on or off (default is off)
       void set64bit(bool state = true)
@@ -81,7 +102,28 @@ namespace QuickFAST
       }
 
     private:
-      boost::scoped_array<unsigned char> buffer_;
+      // Find the next packet record in an original pcap file.
+      bool nextPcapPacket(const unsigned char *& packet, size_t & captured, size_t & original);
+      // Find the next packet block in a pcapng file.
+      bool nextPcapNgPacket(const unsigned char *& packet, size_t & captured, size_t & original, uint32 & linkType);
+      // Start a new pcapng section.  Sets the byte order and forgets the old interfaces.
+      bool beginSection(size_t blockPos);
+      // Strip link, IP and UDP headers from a captured packet.
+      bool findUdpPayload(
+        const unsigned char * packet,
+        size_t captured,
+        uint32 linkType,
+        const unsigned char *& payload,
+        size_t & size);
+      // Let the operating system reclaim memory for packets that are long gone.
+      void releaseBehind();
+
+      uint32 get32(size_t pos)const;
+      uint16 get16(size_t pos)const;
+
+    private:
+      MappedFile file_;
+      const unsigned char * buffer_;
       size_t fileSize_;
       size_t pos_;
       bool ok_;
@@ -91,6 +133,13 @@ namespace QuickFAST
                       // both is an (undetected) error.
       uint32 linktype_;
 
+      bool pcapng_;
+      // link type and snapshot length of each interface in the current pcapng section
+      std::vector<uint32> interfaceLinkTypes_;
+      std::vector<uint32> interfaceSnapLengths_;
+      // file_.release() has been called for everything before this offset.
+      size_t releasedTo_;
+
       // Important note: swap applies to pcap hader info.  It does NOT apply to
       // network ordered bytes within the message body.
       // For actual captured data, use ntohl or ntohs rather than swap.
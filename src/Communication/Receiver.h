@@ -9,8 +9,10 @@
 #include "Receiver_fwd.h"
 #include <Communication/Assembler.h>
 #include <Communication/LinkedBuffer.h>
-//#include <Communication/AtomicQueue.h>
+#include <Communication/BufferRing.h>
 #include <Common/Exceptions.h>
+#include <Common/LatencyHistogram.h>
+#include <Common/ThreadOptions.h>
 
 namespace QuickFAST
 {
@@ -25,6 +27,7 @@ namespace QuickFAST
         , paused_(false)
         , stopping_(false)
         , readInProgress_(false)
+        , trackLatency_(false)
         , noBufferAvailable_(0)
         , packetsReceived_(0)
         , bytesReceived_(0)
@@ -56,12 +59,19 @@ namespace QuickFAST
         bool result = false;
         assembler_ = & assembler;
         bufferSize_ = bufferSize;
+        if(trackLatency_)
+        {
+          assembler_->setLatencyHistograms(&wireToDecode_, &decodeAndConsume_);
+        }
         if(initializeReceiver())
         {
           assembler_->receiverStarted(*this);
 
           // Allocate initial set of buffers
           boost::mutex::scoped_lock lock(bufferMutex_);
+          // Room for every buffer so the hand-offs never overflow.
+          queue_.reserve(bufferCount);
+          idleRing_.reserve(bufferCount);
 
           for(size_t nBuffer = 0; nBuffer < bufferCount; ++nBuffer)
           {
@@ -93,6 +103,33 @@ namespace QuickFAST
         }
       }
 
+      /// @brief Choose how the decoding thread waits for a buffer to arrive.
+      ///
+      /// Busy polling spins on the processor rather than sleeping, trading a core
+      /// for lower latency.  Set before start().
+      /// @param busyPoll true to spin; false to sleep until a buffer arrives.
+      void setBusyPoll(bool busyPoll)
+      {
+        queue_.setWaitStrategy(busyPoll ? BufferRing::BUSY_POLL : BufferRing::BLOCK);
+      }
+
+      /// @brief Time stamp incoming packets and count per-message latencies.
+      ///
+      /// Receivers that can get the kernel's arrival time for a packet use it;
+      /// the others stamp each buffer as soon as the read completes.
+      /// See wireToDecodeLatency() and decodeAndConsumeLatency().  Set before start().
+      /// @param trackLatency true to enable tracking.
+      void setLatencyTracking(bool trackLatency = true)
+      {
+        trackLatency_ = trackLatency;
+      }
+
+      /// @brief Is latency being tracked?
+      bool latencyTracking()const
+      {
+        return trackLatency_;
+      }
+
       ////////////////////////////////////////////////////////////////////
       // public methods to be implemented by specific types of receiver
 
@@ -146,6 +183,18 @@ namespace QuickFAST
       /// @brief execute at most one ready event handler than return.
       virtual size_t poll_one() = 0;
 
+      /// @brief Choose processors, priority and names for the threads that service this receiver.
+      ///
+      /// Applies to threads started by later calls to runThreads(), including the
+      /// calling thread when it is used.  Additional threads are numbered from zero
+      /// and the calling thread comes last.  The calling thread's own settings
+      /// are restored when runThreads() returns.  See ThreadOptions::select().
+      /// @param options for each thread.
+      void setThreadOptions(const ThreadOptionsList & options)
+      {
+        threadOptions_ = options;
+      }
+
       /// @brief create additional threads to run the event loop
       virtual void runThreads(size_t threadCount = 0, bool useThisThread = true) = 0;
 
@@ -218,11 +267,12 @@ namespace QuickFAST
         bool more = true;
         while(available < needed && more)
         {
-          const LinkedBuffer *next = queue_.peekOutgoing();
+          size_t index = 0;
+          const LinkedBuffer *next = queue_.peekOutgoing(index);
           while(available < needed && next != 0)
           {
             available += next->used();
-            next = next->link();
+            next = queue_.peekOutgoing(++index);
           }
           if(available < needed && wait)
           {
@@ -250,13 +300,31 @@ namespace QuickFAST
         //std::ostringstream msg;
         //msg << "{" << (void *)this << "} Release buffer " << (void *)buffer << std::endl;
         //std::cout << msg.str();
-        idleBuffers_.push(buffer);
+        // forget the old arrival time so it is not mistaken for the next one.
+        buffer->setReceiveTime(0);
+        // Hand it straight back to the receiving side if there's room.
+        if(!idleRing_.push(buffer))
+        {
+          idleBuffers_.push(buffer);
+        }
       }
       // Assembler support routines
       /////////////////////////////
 
 
     protected:
+      /// @brief Note the arrival time of a newly filled buffer.
+      ///
+      /// Does nothing if latency is not being tracked or the buffer
+      /// already has a more accurate time from the kernel.
+      void stampBuffer(LinkedBuffer * buffer)
+      {
+        if(trackLatency_ && buffer->receiveTime() == 0)
+        {
+          buffer->setReceiveTime(LatencyHistogram::now());
+        }
+      }
+
       /// @brief Enter the startReceive method without a lock
       void startReceiveUnlocked()
       {
@@ -268,6 +336,11 @@ namespace QuickFAST
       /// scoped_lock parameter means a mutex must be locked
       void startReceive(boost::mutex::scoped_lock& lock)
       {
+        // collect buffers released by the decoding thread
+        for(LinkedBuffer * idle = idleRing_.pop(); idle != 0; idle = idleRing_.pop())
+        {
+          idleBufferPool_.push(idle);
+        }
         if( !readInProgress_ && !stopping_)
         {
           LinkedBuffer *buffer = idleBufferPool_.pop();
@@ -323,6 +396,12 @@ namespace QuickFAST
       /////////////
       // Statistics
     public:
+      /// @brief Statistic: How many full buffers did not fit in the hand-off ring?
+      size_t queueOverflows() const
+      {
+        return queue_.overflows();
+      }
+
       /// @brief Statistic: How many times were all buffers busy?
       /// @returns the number of times no buffers were available to receive packets.
       size_t noBufferAvailable() const
@@ -401,6 +480,25 @@ namespace QuickFAST
         return largestPacket_;
       }
 
+      /// @brief Statistic: Time from packet arrival until decoding of a message begins.
+      ///
+      /// This is the time spent in the socket and the queue of full buffers,
+      /// so it grows when the decoder falls behind or there are too few buffers.
+      /// Empty unless setLatencyTracking() was called before start().
+      const LatencyHistogram & wireToDecodeLatency() const
+      {
+        return wireToDecode_;
+      }
+
+      /// @brief Statistic: Time to decode a message plus the time its consumer takes.
+      ///
+      /// The consumer runs inside decoding, so a slow consumer shows up here.
+      /// Empty unless setLatencyTracking() was called before start().
+      const LatencyHistogram & decodeAndConsumeLatency() const
+      {
+        return decodeAndConsume_;
+      }
+
       /// @brief Approximately how many bytes are waiting to be decoded
       size_t bytesReadable() const
       {
@@ -451,19 +549,23 @@ namespace QuickFAST
       /// Manage the buffers' lifetimes
       BufferLifetimeManager bufferLifetimes_;
 
-      /// Protect access to the SingleServerBufferQueue
+      /// Protect the receiving side: idle pool, read state, and pushes to queue_
       boost::mutex bufferMutex_;
 
       /// @brief Accept buffers from multiple threads and deliver them to a single thread.
       ///
-      /// See the documentation of SingleServerBufferQueue for details.
-      SingleServerBufferQueue queue_;
+      /// The decoding thread takes buffers without locking.
+      /// See the documentation of SingleServerBufferRing for details.
+      SingleServerBufferRing queue_;
+
+      /// @brief Buffers released by the decoding thread on their way back to idleBufferPool_
+      ///
+      /// Filled without locking by releaseBuffer(); emptied by startReceive().
+      BufferRing idleRing_;
 
-      /// @brief accumulate idle buffers while we process the queue
+      /// @brief idle buffers that did not fit in idleRing_
       ///
-      /// Don't add them back to idle pool until we're done
-      /// this avoids extra locking, and applies some backpressure to the
-      /// incoming communication stream (which of course is ignored for multicast)
+      /// Returned to the idle pool the next time the decoding thread takes the lock.
       BufferCollection idleBuffers_;
 
       /// @brief Buffers waiting to be filled
@@ -481,6 +583,12 @@ namespace QuickFAST
       /// @brief True when a buffer is being filled.
       bool readInProgress_;
 
+      /// @brief True to stamp buffers and count latencies.
+      bool trackLatency_;
+
+      /// @brief Placement of the threads started by runThreads()
+      ThreadOptionsList threadOptions_;
+
       /////////////
       // Statistics
       /// No buffers avaliable when we could have started a read
@@ -505,6 +613,10 @@ namespace QuickFAST
       size_t bytesProcessed_;
       /// Largest single packet received
       size_t largestPacket_;
+      /// Packet arrival to start of decoding
+      LatencyHistogram wireToDecode_;
+      /// Decoding and consuming a message
+      LatencyHistogram decodeAndConsume_;
     };
   }
 }
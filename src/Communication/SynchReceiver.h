@@ -56,6 +56,7 @@ namespace QuickFAST
           ++packetsQueued_;
           largestPacket_ = std::max(largestPacket_, bytesReceived);
           buffer->setUsed(bytesReceived);
+          stampBuffer(buffer);
           needService = queue_.push(buffer, lock);
         }
         else
@@ -131,7 +132,7 @@ namespace QuickFAST
         {
           // If we're using this thread, that's all that is needed.
           // so ignore threadCount
-          run();
+          runPlaced();
         }
         else
         {
@@ -139,7 +140,7 @@ namespace QuickFAST
           // more than one thread servicing a synchronous data source,
           // so only start the one.
           thread_.reset(
-            new boost::thread(boost::bind(&SynchReceiver::run, this)));
+            new boost::thread(boost::bind(&SynchReceiver::runPlaced, this)));
         }
       }
 
@@ -157,6 +158,16 @@ namespace QuickFAST
         return true;
       }
 
+    private:
+      /// Apply the thread options for the only servicing thread, then run.
+      /// A calling thread is restored when the run ends.
+      void runPlaced()
+      {
+        ScopedThreadOptions placement(ThreadOptions::select(threadOptions_, 0));
+        placement.apply(assembler_);
+        run();
+      }
+
     private:
       boost::scoped_ptr<boost::thread> thread_;
     };
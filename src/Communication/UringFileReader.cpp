@@ -0,0 +1,386 @@
+// Copyright (c) 2011, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#include <Common/QuickFASTPch.h>
+#include "UringFileReader.h"
+
+#if defined(QUICKFAST_HAS_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+// Older C libraries do not name the io_uring system calls.
+#ifndef __NR_io_uring_setup
+# define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+# define __NR_io_uring_enter 426
+#endif
+#ifndef __NR_io_uring_register
+# define __NR_io_uring_register 427
+#endif
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Communication;
+
+namespace
+{
+  int uringSetup(unsigned int entries, struct io_uring_params * params)
+  {
+    return int(::syscall(__NR_io_uring_setup, entries, params));
+  }
+
+  int uringEnter(int ringFd, unsigned int toSubmit, unsigned int minComplete, unsigned int flags)
+  {
+    return int(::syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, 0, 0));
+  }
+
+  int uringRegister(int ringFd, unsigned int opcode, const void * arg, unsigned int count)
+  {
+    return int(::syscall(__NR_io_uring_register, ringFd, opcode, arg, count));
+  }
+
+  // The kernel updates the ring indexes from another context.
+  unsigned int loadAcquire(const unsigned int * index)
+  {
+    return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+  }
+
+  void storeRelease(unsigned int * index, unsigned int value)
+  {
+    __atomic_store_n(index, value, __ATOMIC_RELEASE);
+  }
+
+  template<typename T>
+  T * at(void * base, size_t offset)
+  {
+    return reinterpret_cast<T *>(static_cast<unsigned char *>(base) + offset);
+  }
+
+  // Ask the kernel whether the ring supports plain reads.  Kernels that
+  // cannot answer (before 5.6) do not have them either.
+  bool supportsRead(int ringFd)
+  {
+    const unsigned int opCount = 256;
+    std::vector<unsigned char> memory(
+      sizeof(struct io_uring_probe) + opCount * sizeof(struct io_uring_probe_op), 0);
+    struct io_uring_probe * probe = reinterpret_cast<struct io_uring_probe *>(&memory[0]);
+    if(uringRegister(ringFd, IORING_REGISTER_PROBE, probe, opCount) < 0)
+    {
+      return false;
+    }
+    return IORING_OP_READ <= probe->last_op
+      && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) != 0;
+  }
+}
+
+UringFileReader::UringFileReader()
+: fileFd_(-1)
+, ringFd_(-1)
+, eventFd_(-1)
+, sqRing_(0)
+, sqRingSize_(0)
+, sqHead_(0)
+, sqTail_(0)
+, sqMask_(0)
+, sqArray_(0)
+, sqes_(0)
+, sqesSize_(0)
+, sqEntries_(0)
+, toSubmit_(0)
+, cqRing_(0)
+, cqRingSize_(0)
+, cqHead_(0)
+, cqTail_(0)
+, cqMask_(0)
+, cqes_(0)
+, fixedBase_(0)
+, fixedSize_(0)
+, depth_(0)
+, inFlight_(0)
+{
+}
+
+UringFileReader::~UringFileReader()
+{
+  close();
+}
+
+bool
+UringFileReader::fail(const std::string & what, int errorNumber)
+{
+  error_ = what + ": " + std::strerror(errorNumber);
+  close();
+  return false;
+}
+
+bool
+UringFileReader::open(const std::string & fileName, int extraFlags, unsigned int depth)
+{
+  close();
+  error_.clear();
+  depth_ = depth == 0 ? 1 : depth;
+
+  fileFd_ = ::open(fileName.c_str(), O_RDONLY | extraFlags);
+  if(fileFd_ < 0)
+  {
+    return fail("Can't open " + fileName, errno);
+  }
+
+  struct io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  ringFd_ = uringSetup(depth_, &params);
+  if(ringFd_ < 0)
+  {
+    return fail("Can't create io_uring", errno);
+  }
+  sqEntries_ = params.sq_entries;
+  if(!supportsRead(ringFd_))
+  {
+    return fail("io_uring cannot read files on this kernel", ENOSYS);
+  }
+
+  sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+  cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if(singleMap)
+  {
+    sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+  }
+  sqRing_ = ::mmap(0, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+    ringFd_, IORING_OFF_SQ_RING);
+  if(sqRing_ == MAP_FAILED)
+  {
+    sqRing_ = 0;
+    return fail("Can't map io_uring submission ring", errno);
+  }
+  if(singleMap)
+  {
+    cqRing_ = sqRing_;
+  }
+  else
+  {
+    cqRing_ = ::mmap(0, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+      ringFd_, IORING_OFF_CQ_RING);
+    if(cqRing_ == MAP_FAILED)
+    {
+      cqRing_ = 0;
+      return fail("Can't map io_uring completion ring", errno);
+    }
+  }
+  sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  sqes_ = ::mmap(0, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+    ringFd_, IORING_OFF_SQES);
+  if(sqes_ == MAP_FAILED)
+  {
+    sqes_ = 0;
+    return fail("Can't map io_uring submission entries", errno);
+  }
+
+  sqHead_ = at<unsigned int>(sqRing_, params.sq_off.head);
+  sqTail_ = at<unsigned int>(sqRing_, params.sq_off.tail);
+  sqMask_ = at<unsigned int>(sqRing_, params.sq_off.ring_mask);
+  sqArray_ = at<unsigned int>(sqRing_, params.sq_off.array);
+  cqHead_ = at<unsigned int>(cqRing_, params.cq_off.head);
+  cqTail_ = at<unsigned int>(cqRing_, params.cq_off.tail);
+  cqMask_ = at<unsigned int>(cqRing_, params.cq_off.ring_mask);
+  cqes_ = at<void>(cqRing_, params.cq_off.cqes);
+
+  eventFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if(eventFd_ < 0)
+  {
+    return fail("Can't create eventfd", errno);
+  }
+  if(uringRegister(ringFd_, IORING_REGISTER_EVENTFD, &eventFd_, 1) < 0)
+  {
+    return fail("Can't register eventfd with io_uring", errno);
+  }
+  return true;
+}
+
+void
+UringFileReader::close()
+{
+  waitForReads();
+  if(sqes_ != 0)
+  {
+    ::munmap(sqes_, sqesSize_);
+    sqes_ = 0;
+  }
+  if(cqRing_ != 0 && cqRing_ != sqRing_)
+  {
+    ::munmap(cqRing_, cqRingSize_);
+  }
+  cqRing_ = 0;
+  if(sqRing_ != 0)
+  {
+    ::munmap(sqRing_, sqRingSize_);
+    sqRing_ = 0;
+  }
+  if(ringFd_ >= 0)
+  {
+    ::close(ringFd_);
+    ringFd_ = -1;
+  }
+  if(eventFd_ >= 0)
+  {
+    ::close(eventFd_);
+    eventFd_ = -1;
+  }
+  if(fileFd_ >= 0)
+  {
+    ::close(fileFd_);
+    fileFd_ = -1;
+  }
+  fixedBase_ = 0;
+  fixedSize_ = 0;
+  toSubmit_ = 0;
+  inFlight_ = 0;
+}
+
+void
+UringFileReader::clearEvent()
+{
+  eventfd_t value;
+  (void)::eventfd_read(eventFd_, &value);
+}
+
+bool
+UringFileReader::registerBuffers(unsigned char * base, size_t size)
+{
+  struct iovec block;
+  block.iov_base = base;
+  block.iov_len = size;
+  if(uringRegister(ringFd_, IORING_REGISTER_BUFFERS, &block, 1) < 0)
+  {
+    error_ = std::string("Can't register buffers with io_uring: ") + std::strerror(errno);
+    return false;
+  }
+  fixedBase_ = base;
+  fixedSize_ = size;
+  return true;
+}
+
+bool
+UringFileReader::read(unsigned char * buffer, size_t size, uint64 offset, uint64 userData)
+{
+  // Only this thread writes the tail, so it needs no special load.
+  unsigned int tail = *sqTail_;
+  if(inFlight_ >= depth_ || tail - loadAcquire(sqHead_) >= sqEntries_)
+  {
+    return false;
+  }
+  unsigned int index = tail & *sqMask_;
+  struct io_uring_sqe * sqe = static_cast<struct io_uring_sqe *>(sqes_) + index;
+  std::memset(sqe, 0, sizeof(*sqe));
+  bool fixed = fixedBase_ != 0
+    && buffer >= fixedBase_
+    && buffer + size <= fixedBase_ + fixedSize_;
+  sqe->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+  sqe->fd = fileFd_;
+  sqe->off = offset;
+  sqe->addr = reinterpret_cast<unsigned long>(buffer);
+  sqe->len = unsigned(size);
+  sqe->buf_index = 0;
+  sqe->user_data = userData;
+  sqArray_[index] = index;
+  storeRelease(sqTail_, tail + 1);
+  ++toSubmit_;
+  ++inFlight_;
+  return true;
+}
+
+bool
+UringFileReader::submit()
+{
+  while(toSubmit_ > 0)
+  {
+    int submitted = uringEnter(ringFd_, toSubmit_, 0, 0);
+    if(submitted < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+      if(errno == EAGAIN || errno == EBUSY)
+      {
+        // out of resources until some completions are collected
+        return true;
+      }
+      error_ = std::string("io_uring submit failed: ") + std::strerror(errno);
+      return false;
+    }
+    if(submitted == 0)
+    {
+      // The kernel took none; the rest stay queued for the next call.
+      return true;
+    }
+    toSubmit_ -= std::min(toSubmit_, unsigned(submitted));
+  }
+  return true;
+}
+
+bool
+UringFileReader::complete(uint64 & userData, int & result)
+{
+  unsigned int head = *cqHead_;
+  if(head == loadAcquire(cqTail_))
+  {
+    return false;
+  }
+  const struct io_uring_cqe * cqe = static_cast<const struct io_uring_cqe *>(cqes_) + (head & *cqMask_);
+  userData = cqe->user_data;
+  result = cqe->res;
+  storeRelease(cqHead_, head + 1);
+  --inFlight_;
+  return true;
+}
+
+void
+UringFileReader::waitForReads()
+{
+  if(cqRing_ == 0 || ringFd_ < 0)
+  {
+    return;
+  }
+  // Closing the ring does not wait for the kernel to finish writing
+  // into the buffers, so collect every read it has accepted.
+  size_t accepted = inFlight_ - std::min(inFlight_, size_t(toSubmit_));
+  while(accepted > 0)
+  {
+    uint64 userData;
+    int result;
+    if(complete(userData, result))
+    {
+      --accepted;
+    }
+    else if(uringEnter(ringFd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+    {
+      break;
+    }
+  }
+}
+
+bool
+UringFileReader::isSupported()
+{
+  struct io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  int ringFd = uringSetup(1, &params);
+  if(ringFd < 0)
+  {
+    return false;
+  }
+  bool supported = supportsRead(ringFd);
+  ::close(ringFd);
+  return supported;
+}
+
+#endif // QUICKFAST_HAS_IO_URING
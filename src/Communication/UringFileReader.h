@@ -0,0 +1,165 @@
+// Copyright (c) 2011, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+//
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef URINGFILEREADER_H
+#define URINGFILEREADER_H
+#include <Common/QuickFAST_Export.h>
+#include <Common/Types.h>
+
+// The reader needs IORING_OP_READ, which Linux kernels have from 5.6 on;
+// UringFileReader::isSupported() checks at run time.  Define
+// QUICKFAST_NO_IO_URING to build on systems whose kernel headers predate it.
+#if defined(__linux__) && !defined(QUICKFAST_NO_IO_URING)
+# define QUICKFAST_HAS_IO_URING
+#endif
+
+namespace QuickFAST
+{
+  namespace Communication
+  {
+#if defined(QUICKFAST_HAS_IO_URING)
+    /// @brief Keep several reads from one file in flight using Linux io_uring.
+    ///
+    /// This is the low level machinery behind the Linux AsynchFileReceiver.
+    /// It talks to the kernel directly rather than through liburing so
+    /// QuickFAST picks up no new dependency.
+    ///
+    /// Reads are queued with read(), handed to the kernel with submit(),
+    /// and collected with complete().  Completions may arrive in any order;
+    /// each carries the userData given to read().  An eventfd is signaled
+    /// whenever a completion arrives so the caller can wait with select,
+    /// poll, or boost::asio.
+    ///
+    /// Not thread safe.  The caller serializes access.
+    class QuickFAST_Export UringFileReader
+    {
+    public:
+      UringFileReader();
+      ~UringFileReader();
+
+      /// @brief Open the file and create the ring.
+      /// @param fileName names the file to read.
+      /// @param extraFlags are added to O_RDONLY when the file is opened.  O_DIRECT is the useful one.
+      /// @param depth is the most reads that may be in flight at once.
+      /// @returns true if all is well.  If not error() explains.
+      bool open(const std::string & fileName, int extraFlags, unsigned int depth);
+
+      /// @brief Release the ring and the file.
+      ///
+      /// Waits for reads the kernel has already accepted, so their buffers
+      /// may be freed as soon as this returns.  Reads queued but not yet
+      /// submitted are abandoned.
+      void close();
+
+      /// @brief Is the reader open?
+      bool isOpen()const
+      {
+        return ringFd_ >= 0;
+      }
+
+      /// @brief Describe the most recent failure.
+      const std::string & error()const
+      {
+        return error_;
+      }
+
+      /// @brief A file descriptor that becomes readable when reads complete.
+      int eventFd()const
+      {
+        return eventFd_;
+      }
+
+      /// @brief Clear the eventfd after it has signaled.
+      void clearEvent();
+
+      /// @brief Pin a block of memory so reads into it skip per-read page mapping.
+      ///
+      /// Only one block may be registered.  Reads whose buffers lie entirely
+      /// inside it use the kernel's fixed-buffer path automatically.
+      /// @param base is the start of the block.
+      /// @param size is the block's length.
+      /// @returns false if the kernel refused (commonly RLIMIT_MEMLOCK). Reads still work.
+      bool registerBuffers(unsigned char * base, size_t size);
+
+      /// @brief Queue a read.  Nothing happens until submit().
+      /// @param buffer receives the data.
+      /// @param size is the most bytes to read.
+      /// @param offset is the position in the file.
+      /// @param userData identifies this read when it completes.
+      /// @returns false if depth reads are already in flight.
+      bool read(unsigned char * buffer, size_t size, uint64 offset, uint64 userData);
+
+      /// @brief Hand queued reads to the kernel.
+      ///
+      /// The kernel may take fewer than were queued when it is short of
+      /// resources.  The rest stay queued; collect some completions and
+      /// call submit() again.
+      /// @returns false if the kernel refused; error() explains.
+      bool submit();
+
+      /// @brief Collect one completed read.
+      /// @param[out] userData identifies the read.
+      /// @param[out] result is the number of bytes read, zero at end of file, or -errno.
+      /// @returns false if no read has completed.
+      bool complete(uint64 & userData, int & result);
+
+      /// @brief How many reads are queued or in flight.
+      size_t inFlight()const
+      {
+        return inFlight_;
+      }
+
+      /// @brief Can this kernel and process use io_uring for reading files?
+      ///
+      /// io_uring may be missing from old kernels or disabled by seccomp or
+      /// sysctl, and kernels before 5.6 lack the plain read operation.
+      static bool isSupported();
+
+    private:
+      UringFileReader(const UringFileReader &);
+      UringFileReader & operator=(const UringFileReader &);
+
+      bool fail(const std::string & what, int errorNumber);
+      void waitForReads();
+
+    private:
+      int fileFd_;
+      int ringFd_;
+      int eventFd_;
+      std::string error_;
+
+      // submission ring
+      void * sqRing_;
+      size_t sqRingSize_;
+      unsigned int * sqHead_;
+      unsigned int * sqTail_;
+      unsigned int * sqMask_;
+      unsigned int * sqArray_;
+      void * sqes_;
+      size_t sqesSize_;
+      unsigned int sqEntries_;
+      unsigned int toSubmit_;
+
+      // completion ring; may share sqRing_'s mapping
+      void * cqRing_;
+      size_t cqRingSize_;
+      unsigned int * cqHead_;
+      unsigned int * cqTail_;
+      unsigned int * cqMask_;
+      void * cqes_;
+
+      // the registered buffer, if any
+      unsigned char * fixedBase_;
+      size_t fixedSize_;
+
+      unsigned int depth_;
+      size_t inFlight_;
+    };
+#endif // QUICKFAST_HAS_IO_URING
+  }
+}
+#endif // URINGFILEREADER_H
@@ -24,6 +24,7 @@ PerformanceTest::PerformanceTest()
   : resetOnMessage_(false)
   , strict_(true)
   , useNullMessage_(false)
+  , useDecodePlans_(false)
   , performanceFile_(0)
   , profileFile_(0)
   , head_(0)
@@ -92,6 +93,11 @@ PerformanceTest::parseSingleArg(int argc, char * argv[])
       useNullMessage_ = true;
       consumed = 1;
     }
+    else if(opt == "-plan")
+    {
+      useDecodePlans_ = !useDecodePlans_;
+      consumed = 1;
+    }
     else if(opt == "-head" && argc > 1)
     {
       head_ = boost::lexical_cast<size_t>(argv[1]);
@@ -134,6 +140,7 @@ PerformanceTest::usage(std::ostream & out) const
   out << "  -r          : Toggle 'reset decoder on every message' (default false)." << std::endl;
   out << "  -null       : Use null message to receive fields." << std::endl;
   out << "  -s          : Toggle 'strict decoding rules' (default true)." << std::endl;
+  out << "  -plan       : Toggle 'decode using compiled template plans' (default false)." << std::endl;
   out << "  -hfix n     : Skip n byte header before each message" << std::endl;
   out << std::endl;
   out << " THE FOLLOWING INVALIDATES THE PERFORMANCE TEST NUMBERS, OF COURSE." << std::endl;
@@ -267,6 +274,7 @@ PerformanceTest::run()
       Codecs::SynchronousDecoder decoder(templateRegistry);
       decoder.setResetOnMessage(resetOnMessage_);
       decoder.setStrict(strict_);
+      decoder.setUseDecodePlans(useDecodePlans_);
       decoder.setLimit(head_);
       decoder.setHeaderBytes(headerBytes_);
       StopWatch decodeTimer;
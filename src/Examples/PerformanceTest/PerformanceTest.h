@@ -41,6 +41,7 @@ namespace QuickFAST{
       bool resetOnMessage_;
       bool strict_;
       bool useNullMessage_;
+      bool useDecodePlans_;
       std::string templateFileName_;
       std::ifstream templateFile_;
       std::string fastFileName_;
@@ -3,6 +3,8 @@
 // See the file license.txt for licensing information.
 #include <Common/QuickFASTPch.h>
 #include "Field.h"
+#include <Messages/Group.h>
+#include <Messages/Sequence.h>
 #include <Common/Exceptions.h>
 
 using namespace ::QuickFAST;
@@ -12,6 +14,7 @@ Field::Field(ValueType::Type type, bool valid)
 : type_(type)
 , valid_(valid)
 , refcount_(0)
+, published_(false)
 {
 }
 
@@ -184,6 +187,24 @@ Field::toSequence() const
   throw ex;
 }
 
+void
+Field::publish()const
+{
+  published_ = true;
+  if(type_ == ValueType::GROUP)
+  {
+    toGroup()->publish();
+  }
+  else if(type_ == ValueType::SEQUENCE)
+  {
+    const Messages::SequenceCPtr & sequence = toSequence();
+    for(Sequence::const_iterator it = sequence->begin(); it != sequence->end(); ++it)
+    {
+      (*it)->publish();
+    }
+  }
+}
+
 void
 Field::freeField()const
 {
@@ -13,6 +13,8 @@
 #include <Common/StringBuffer.h>
 #include <Messages/Group_fwd.h>
 #include <Messages/Sequence_fwd.h>
+#include <Messages/FieldPool.h>
+#include <Common/AtomicRefCount.h>
 namespace QuickFAST{
   namespace Messages{
     /// @brief The value of a field -- for use in Message and Dictionary.
@@ -27,6 +29,38 @@ namespace QuickFAST{
       /// @brief a typical virtual destructor.
       virtual ~Field() = 0;
 
+      /// @brief Fields of every type are allocated from the FieldPool.
+      /// @param size is the size of the most-derived type.
+      static void * operator new(size_t size)
+      {
+        return FieldPool::allocate(size);
+      }
+
+      /// @brief Return the memory to the FieldPool when a Field is deleted.
+      /// @param memory is the Field being deleted.
+      /// @param size is the size of the most-derived type.
+      static void operator delete(void * memory, size_t size)
+      {
+        FieldPool::release(memory, size);
+      }
+
+      /// @brief Prepare this field to be shared by more than one thread.
+      ///
+      /// Reference counts are normally updated with plain arithmetic which
+      /// is only safe while every reference belongs to one thread.  Once
+      /// published, this field's count is maintained atomically.  The
+      /// contents of a group or sequence are published too.
+      ///
+      /// Call this before the field is handed to another thread.  Building
+      /// with QUICKFAST_ATOMIC_REFCOUNTS defined makes every count atomic.
+      void publish()const;
+
+      /// @brief Has this field been published to other threads?
+      bool isPublished()const
+      {
+        return published_;
+      }
+
       /// @brief compare to field for type and value
       ///
       /// The default implementation handles all string, integer, and decimal types.
@@ -339,21 +373,38 @@ namespace QuickFAST{
       friend void QuickFAST_Export intrusive_ptr_add_ref(const Field * ptr);
       friend void QuickFAST_Export intrusive_ptr_release(const Field * ptr);
       virtual void freeField()const;
-      mutable unsigned long refcount_;
+      mutable long refcount_;
+      mutable bool published_;
     };
 
     inline
     void
     intrusive_ptr_add_ref(const Field * ptr)
     {
-      ++ptr->refcount_;
+#if defined(QUICKFAST_ATOMIC_REFCOUNTS)
+      atomicRefCountIncrement(&ptr->refcount_);
+#else
+      if(ptr->published_)
+      {
+        atomicRefCountIncrement(&ptr->refcount_);
+      }
+      else
+      {
+        ++ptr->refcount_;
+      }
+#endif
     }
 
     inline
     void
     intrusive_ptr_release(const Field * ptr)
     {
-      if(--ptr->refcount_ == 0)
+#if defined(QUICKFAST_ATOMIC_REFCOUNTS)
+      long count = atomicRefCountDecrement(&ptr->refcount_);
+#else
+      long count = ptr->published_ ? atomicRefCountDecrement(&ptr->refcount_) : --ptr->refcount_;
+#endif
+      if(count == 0)
       {
         ptr->freeField();
       }
@@ -10,6 +10,8 @@
 using namespace QuickFAST;
 using namespace Messages;
 
+const size_t FieldIdentity::noOrdinal;
+
 static
 std::string anonName(void * address)
 {
@@ -18,7 +20,10 @@ std::string anonName(void * address)
 
 FieldIdentity::FieldIdentity()
   : localName_(anonName(this))
+  , ordinal_(noOrdinal)
   , refcount_(0)
+  , published_(false)
+  , keeper_(0)
 {
   qualifyName();
 }
@@ -30,7 +35,10 @@ FieldIdentity::FieldIdentity(
   : localName_(name)
   , fieldNamespace_(fieldNamespace)
   , id_(id)
+  , ordinal_(noOrdinal)
   , refcount_(0)
+  , published_(false)
+  , keeper_(0)
 {
   qualifyName();
 }
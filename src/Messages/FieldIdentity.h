@@ -7,7 +7,9 @@
 #ifndef FIELDIDENTITY_H
 #define FIELDIDENTITY_H
 #include "FieldIdentity_fwd.h"
+#include <Messages/IdentityKeeper_fwd.h>
 #include <Common/Types.h>
+#include <Common/AtomicRefCount.h>
 
 namespace QuickFAST{
   namespace Messages{
@@ -54,7 +56,10 @@ namespace QuickFAST{
         , fieldNamespace_(rhs.fieldNamespace_)
         , fullName_(rhs.fullName_)
         , id_(rhs.id_)
+        , ordinal_(rhs.ordinal_)
         , refcount_(0)
+        , published_(false)
+        , keeper_(0)
       {
       }
 
@@ -65,6 +70,81 @@ namespace QuickFAST{
         id_ = id;
       }
 
+      /// @brief Record where this field is expected to appear in a FieldSet.
+      ///
+      /// Assigned when the template containing the field is finalized.
+      /// @param ordinal the position of the field when all fields are present.
+      void setOrdinal(size_t ordinal)
+      {
+        ordinal_ = ordinal;
+      }
+
+      /// @brief Where is this field expected to appear in a FieldSet?
+      ///
+      /// This is only a hint. Absent optional fields and merged groups move
+      /// the actual position.
+      /// @returns the ordinal, or noOrdinal if none has been assigned.
+      size_t ordinal()const
+      {
+        return ordinal_;
+      }
+
+      /// @brief The ordinal of an identity that is not part of a finalized template.
+      static const size_t noOrdinal = ~size_t(0);
+
+      /// @brief Stop reference counting this identity.
+      ///
+      /// The identities used by a finalized TemplateRegistry are shared by
+      /// every message it decodes, so their counts would be the busiest in
+      /// the system.  While immortal, copying or releasing a pointer to the
+      /// identity does not touch the count, so it can be shared by any number
+      /// of threads at no cost.  The keeper is counted instead, by each
+      /// FieldSet, Sequence and RecordedMessage holding the identity.
+      ///
+      /// Pointers copied out of those objects must not outlive them.
+      /// References taken before makeImmortal() must not be released until
+      /// after makeMortal(), or the count is left wrong.
+      /// Not thread safe: call only while the identity is being configured.
+      /// @param keeper keeps this identity alive.  See IdentityKeeper::keep().
+      void makeImmortal(const IdentityKeeper & keeper)const
+      {
+        keeper_ = &keeper;
+      }
+
+      /// @brief Count references to this identity again.
+      void makeMortal()const
+      {
+        keeper_ = 0;
+      }
+
+      /// @brief Is this identity exempt from reference counting?
+      bool isImmortal()const
+      {
+        return keeper_ != 0;
+      }
+
+      /// @brief What keeps this identity alive while it is immortal?
+      /// @returns the keeper, or null if the identity is counted.
+      const IdentityKeeper * keeper()const
+      {
+        return keeper_;
+      }
+
+      /// @brief Debug: how many counted references are there to this identity?
+      long useCount()const
+      {
+        return refcount_;
+      }
+
+      /// @brief Prepare this identity to be shared by more than one thread.
+      ///
+      /// Has no effect on immortal identities.  Otherwise the reference
+      /// count is maintained atomically from now on.  See Field::publish()
+      void publish()const
+      {
+        published_ = true;
+      }
+
       /// @brief get the fully qualified name of the field.
       /// @returns the name qualified by the namespace (from the cached value)
       const std::string & name()const
@@ -104,7 +184,7 @@ namespace QuickFAST{
       /// @param rhs is the identity to be compared to this.
       bool operator == (const FieldIdentity & rhs) const
       {
-        return(
+        return(this == &rhs) || (
           (fieldNamespace_ == rhs.fieldNamespace_) &&
           (fullName_ == rhs.fullName_) &&
           (id_.empty() || rhs.id_.empty() || id_ == rhs.id_));
@@ -134,29 +214,52 @@ namespace QuickFAST{
       std::string fieldNamespace_;
       std::string fullName_; // cached for performance
       field_id_t id_;
+      size_t ordinal_;
     private:
       friend void QuickFAST_Export intrusive_ptr_add_ref(const FieldIdentity * ptr);
       friend void QuickFAST_Export intrusive_ptr_release(const FieldIdentity * ptr);
-      friend void QuickFAST_Export intrusive_ptr_add_ref(FieldIdentity * ptr);
-      friend void QuickFAST_Export intrusive_ptr_release(FieldIdentity * ptr);
       void freeFieldIdentity()const;
-      mutable unsigned long refcount_;
+      mutable long refcount_;
+      mutable bool published_;
+      mutable const IdentityKeeper * keeper_;
     };
 
     inline
     void QuickFAST_Export
     intrusive_ptr_add_ref(const Messages::FieldIdentity * ptr)
     {
-      ++ptr->refcount_;
-//      std::cout << "Identity @" << std::hex << ptr << std::dec << "++[" << ptr->refcount_ << " ]: " << ptr->localName_ << ' ' << ptr->id_ << std::endl;
+      if(ptr->keeper_ != 0)
+      {
+        return;
+      }
+#if defined(QUICKFAST_ATOMIC_REFCOUNTS)
+      atomicRefCountIncrement(&ptr->refcount_);
+#else
+      if(ptr->published_)
+      {
+        atomicRefCountIncrement(&ptr->refcount_);
+      }
+      else
+      {
+        ++ptr->refcount_;
+      }
+#endif
     }
 
     inline
     void QuickFAST_Export
     intrusive_ptr_release(const Messages::FieldIdentity * ptr)
     {
-//      std::cout << "Identity @" << std::hex << ptr << std::dec << "--[" << ptr->refcount_ << " ]: " << ptr->localName_ << ' ' << ptr->id_ << std::endl;
-      if(--ptr->refcount_ == 0)
+      if(ptr->keeper_ != 0)
+      {
+        return;
+      }
+#if defined(QUICKFAST_ATOMIC_REFCOUNTS)
+      long count = atomicRefCountDecrement(&ptr->refcount_);
+#else
+      long count = ptr->published_ ? atomicRefCountDecrement(&ptr->refcount_) : --ptr->refcount_;
+#endif
+      if(count == 0)
       {
         ptr->freeFieldIdentity();
       }
@@ -166,19 +269,14 @@ namespace QuickFAST{
     void QuickFAST_Export
     intrusive_ptr_add_ref(Messages::FieldIdentity * ptr)
     {
-      ++ptr->refcount_;
-//      std::cout << "Identity @" << std::hex << ptr << std::dec << "++[" << ptr->refcount_ << " ]: " << ptr->localName_ << ' ' << ptr->id_ << std::endl;
+      intrusive_ptr_add_ref(static_cast<const Messages::FieldIdentity *>(ptr));
     }
 
     inline
     void QuickFAST_Export
     intrusive_ptr_release(Messages::FieldIdentity * ptr)
     {
-//      std::cout << "Identity @" << std::hex << ptr << std::dec << "--[" << ptr->refcount_ << " ]: " << ptr->localName_ << ' ' << ptr->id_ << std::endl;
-      if(--ptr->refcount_ == 0)
-      {
-        ptr->freeFieldIdentity();
-      }
+      intrusive_ptr_release(static_cast<const Messages::FieldIdentity *>(ptr));
     }
   }
 }
@@ -0,0 +1,126 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "FieldPool.h"
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Messages;
+
+const size_t FieldPool::maxPooledSize;
+const size_t FieldPool::maxPooledBlocks;
+
+namespace
+{
+  const size_t granularity = 16;
+  const size_t sizeClasses = FieldPool::maxPooledSize / granularity;
+
+  /// A block waiting to be reused.  It overlays the recycled memory.
+  struct FreeBlock
+  {
+    FreeBlock * next_;
+  };
+
+  /// The free lists belonging to one thread.
+  struct FreeLists
+  {
+    FreeLists()
+    {
+      for(size_t nClass = 0; nClass < sizeClasses; ++nClass)
+      {
+        head_[nClass] = 0;
+        count_[nClass] = 0;
+      }
+    }
+
+    ~FreeLists()
+    {
+      for(size_t nClass = 0; nClass < sizeClasses; ++nClass)
+      {
+        while(head_[nClass] != 0)
+        {
+          FreeBlock * block = head_[nClass];
+          head_[nClass] = block->next_;
+          ::operator delete(block);
+        }
+      }
+    }
+
+    FreeBlock * head_[sizeClasses];
+    size_t count_[sizeClasses];
+  };
+
+  size_t sizeClass(size_t size)
+  {
+    return (size + granularity - 1) / granularity - 1;
+  }
+
+  FreeLists & freeLists()
+  {
+    // Deliberately never deleted: Fields in static storage may be
+    // released after function-local statics have been destroyed.
+    static boost::thread_specific_ptr<FreeLists> * lists = new boost::thread_specific_ptr<FreeLists>;
+    FreeLists * result = lists->get();
+    if(result == 0)
+    {
+      result = new FreeLists;
+      lists->reset(result);
+    }
+    return *result;
+  }
+}
+
+void *
+FieldPool::allocate(size_t size)
+{
+  if(size == 0 || size > maxPooledSize)
+  {
+    return ::operator new(size);
+  }
+  size_t nClass = sizeClass(size);
+  FreeLists & lists = freeLists();
+  FreeBlock * block = lists.head_[nClass];
+  if(block == 0)
+  {
+    // allocate the whole size class so any block in it can be reused.
+    return ::operator new((nClass + 1) * granularity);
+  }
+  lists.head_[nClass] = block->next_;
+  --lists.count_[nClass];
+  return block;
+}
+
+void
+FieldPool::release(void * memory, size_t size)
+{
+  if(memory == 0)
+  {
+    return;
+  }
+  if(size == 0 || size > maxPooledSize)
+  {
+    ::operator delete(memory);
+    return;
+  }
+  size_t nClass = sizeClass(size);
+  FreeLists & lists = freeLists();
+  if(lists.count_[nClass] >= maxPooledBlocks)
+  {
+    ::operator delete(memory);
+    return;
+  }
+  FreeBlock * block = static_cast<FreeBlock *>(memory);
+  block->next_ = lists.head_[nClass];
+  lists.head_[nClass] = block;
+  ++lists.count_[nClass];
+}
+
+size_t
+FieldPool::available(size_t size)
+{
+  if(size == 0 || size > maxPooledSize)
+  {
+    return 0;
+  }
+  return freeLists().count_[sizeClass(size)];
+}
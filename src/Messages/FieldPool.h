@@ -0,0 +1,49 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef FIELDPOOL_H
+#define FIELDPOOL_H
+#include <Common/QuickFAST_Export.h>
+
+namespace QuickFAST{
+  namespace Messages{
+    /// @brief Recycle the memory used by Field objects.
+    ///
+    /// Decoding a message creates a Field for every value, and the Fields
+    /// are released when the application is done with the message.  Rather
+    /// than returning that memory to the heap, keep it on a free list so the
+    /// next message can reuse it.
+    ///
+    /// Each thread has its own free lists (one per size class) so no locking is
+    /// needed.  Memory released by one thread is reused only by that thread.
+    /// The lists are bounded, so a thread that releases more Fields than it
+    /// creates returns the excess to the heap.
+    class QuickFAST_Export FieldPool
+    {
+    public:
+      /// @brief Get memory for a Field.
+      /// @param size is the number of bytes needed.
+      /// @returns the memory, either recycled or from the heap.
+      static void * allocate(size_t size);
+
+      /// @brief Return memory obtained from allocate().
+      /// @param memory is the memory to be recycled.
+      /// @param size must match the size passed to allocate().
+      static void release(void * memory, size_t size);
+
+      /// @brief How many blocks of this size are waiting to be reused by this thread?
+      /// @param size is a size that might be passed to allocate().
+      /// @returns the number of blocks on the free list.
+      static size_t available(size_t size);
+
+      /// @brief The largest block that is pooled.  Larger requests go directly to the heap.
+      static const size_t maxPooledSize = 512;
+      /// @brief The most blocks of each size kept per thread.
+      static const size_t maxPooledBlocks = 4096;
+    };
+  }
+}
+#endif // FIELDPOOL_H
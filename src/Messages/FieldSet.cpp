@@ -12,17 +12,59 @@ using namespace ::QuickFAST;
 using namespace ::QuickFAST::Messages;
 
 FieldSet::FieldSet(size_t res)
-: fields_(reinterpret_cast<MessageField *>(new unsigned char[sizeof(MessageField) * res]))
+: fields_(0)
+, positions_(0)
+, arena_(0)
 , capacity_(res)
 , used_(0)
 {
-  memset(fields_, 0, sizeof(MessageField) * capacity_);
+  fields_ = allocateFields(res);
+  positions_ = positionsFor(fields_, capacity_);
+  memset(fields_, 0, (sizeof(MessageField) + sizeof(size_t)) * capacity_);
+}
+
+FieldSet::FieldSet(size_t res, Arena & arena)
+: fields_(0)
+, positions_(0)
+, arena_(&arena)
+, capacity_(res)
+, used_(0)
+{
+  fields_ = allocateFields(res);
+  positions_ = positionsFor(fields_, capacity_);
+  memset(fields_, 0, (sizeof(MessageField) + sizeof(size_t)) * capacity_);
 }
 
 FieldSet::~FieldSet()
 {
   clear();
-  delete [] reinterpret_cast<unsigned char *>(fields_);
+  releaseFields(fields_);
+}
+
+MessageField *
+FieldSet::allocateFields(size_t capacity)
+{
+  if(arena_ != 0)
+  {
+    return static_cast<MessageField *>(arena_->allocate((sizeof(MessageField) + sizeof(size_t)) * capacity));
+  }
+  return reinterpret_cast<MessageField *>(new unsigned char[(sizeof(MessageField) + sizeof(size_t)) * capacity]);
+}
+
+size_t *
+FieldSet::positionsFor(MessageField * fields, size_t capacity)
+{
+  // The positions follow the fields in the same allocation.
+  return reinterpret_cast<size_t *>(fields + capacity);
+}
+
+void
+FieldSet::releaseFields(MessageField * fields)
+{
+  if(arena_ == 0)
+  {
+    delete [] reinterpret_cast<unsigned char *>(fields);
+  }
 }
 
 void
@@ -30,16 +72,19 @@ FieldSet::reserve(size_t capacity)
 {
   if(capacity > capacity_)
   {
-    MessageField * buffer = reinterpret_cast<MessageField *>(new unsigned char[sizeof(MessageField) * capacity]);
-    memset(buffer, 0, sizeof(MessageField) * capacity);
+    MessageField * buffer = allocateFields(capacity);
+    memset(buffer, 0, (sizeof(MessageField) + sizeof(size_t)) * capacity);
     for(size_t nField = 0; nField < used_; ++nField)
     {
       new(&buffer[nField]) MessageField(fields_[nField]);
     }
+    size_t * positions = positionsFor(buffer, capacity);
+    memcpy(positions, positions_, sizeof(size_t) * capacity_);
 
     MessageField * oldBuffer = fields_;
     size_t oldUsed = used_;
     fields_ = buffer;
+    positions_ = positions;
     capacity_ = capacity;
 
     while (oldUsed > 0)
@@ -47,7 +92,7 @@ FieldSet::reserve(size_t capacity)
       --oldUsed;
       oldBuffer[oldUsed].~MessageField();
     }
-    delete[] reinterpret_cast<unsigned char *>(oldBuffer);
+    releaseFields(oldBuffer);
   }
 }
 
@@ -63,7 +108,7 @@ FieldSet::clear(size_t capacity)
   {
     reserve(capacity);
   }
-  memset(fields_, 0, sizeof(MessageField) * capacity_);
+  memset(fields_, 0, (sizeof(MessageField) + sizeof(size_t)) * capacity_);
 }
 
 const MessageField &
@@ -77,15 +122,51 @@ FieldSet::operator[](size_t index)const
 }
 
 bool
-FieldSet::isPresent(const FieldIdentity & identity) const
+FieldSet::findField(const FieldIdentity & identity, size_t & index) const
 {
-  for(size_t index = 0; index < used_; ++index)
+  size_t ordinal = identity.ordinal();
+  if(ordinal < capacity_ && positions_[ordinal] != 0)
+  {
+    const MessageField & field = fields_[positions_[ordinal] - 1];
+    if(field.getIdentity().get() == &identity || identity == *field.getIdentity())
+    {
+      index = positions_[ordinal] - 1;
+      return true;
+    }
+  }
+  // No ordinal, an absent field, an identity shared by merged templates
+  // whose ordinal belongs to another template, or a set built from other
+  // identities (by an application for the encoder, say).  Fields added in
+  // template order sit at their ordinal or, if optional fields before them
+  // are absent, a little ahead of it, so search backward from there first.
+  size_t start = ordinal < used_ ? ordinal + 1 : used_;
+  for(size_t pos = start; pos > 0; --pos)
   {
-    if(identity == *(fields_[index].getIdentity()))
+    if(identity == *(fields_[pos - 1].getIdentity()))
     {
-      return fields_[index].getField()->isDefined();
+      index = pos - 1;
+      return true;
     }
   }
+  for(size_t pos = start; pos < used_; ++pos)
+  {
+    if(identity == *(fields_[pos].getIdentity()))
+    {
+      index = pos;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+FieldSet::isPresent(const FieldIdentity & identity) const
+{
+  size_t index = 0;
+  if(findField(identity, index))
+  {
+    return fields_[index].getField()->isDefined();
+  }
   return false;
 }
 
@@ -98,21 +179,26 @@ FieldSet::addField(const FieldIdentityCPtr & identity, const FieldCPtr & value)
     PROFILE_POINT("FieldSet::grow");
     reserve(((used_ + 1) * 3) / 2);
   }
+  keepers_.hold(*identity);
   new (fields_ + used_) MessageField(identity, value);
   ++used_;
+  size_t ordinal = identity->ordinal();
+  // The first field claims the ordinal; any other is found by searching.
+  if(ordinal < capacity_ && positions_[ordinal] == 0)
+  {
+    positions_[ordinal] = used_;
+  }
 }
 
 bool
 FieldSet::getField(const Messages::FieldIdentity & identity, FieldCPtr & value) const
 {
   PROFILE_POINT("FieldSet::getField");
-  for(size_t index = 0; index < used_; ++index)
+  size_t index = 0;
+  if(findField(identity, index))
   {
-    if(identity == *(fields_[index].getIdentity()))
-    {
-      value = fields_[index].getField();
-      return value->isDefined();
-    }
+    value = fields_[index].getField();
+    return value->isDefined();
   }
   return false;
 }
@@ -125,6 +211,16 @@ FieldSet::getFieldInfo(size_t index, std::string & name, ValueType::Type & type,
   fieldPtr = fields_[index].getField();
 }
 
+void
+FieldSet::publish()const
+{
+  for(size_t nField = 0; nField < used_; ++nField)
+  {
+    fields_[nField].getIdentity()->publish();
+    fields_[nField].getField()->publish();
+  }
+}
+
 bool
 FieldSet::equals (const FieldSet & rhs, std::ostream & reason) const
 {
@@ -8,8 +8,10 @@
 #define FIELDSET_H
 #include "FieldSet_fwd.h"
 #include <Common/QuickFAST_Export.h>
+#include <Common/Arena.h>
 #include <Messages/MessageAccessor.h>
 #include <Messages/MessageField.h>
+#include <Messages/IdentityKeeper.h>
 
 namespace QuickFAST{
   namespace Messages{
@@ -27,6 +29,14 @@ namespace QuickFAST{
       /// @brief Construct an empty FieldSet
       explicit FieldSet(size_t res);
 
+      /// @brief Construct an empty FieldSet that keeps its fields in an Arena.
+      ///
+      /// The storage is never returned to the heap; it is recovered
+      /// when the arena is reset.  The FieldSet must be destroyed first.
+      /// @param res is the expected number of fields
+      /// @param arena supplies the storage for the fields.
+      FieldSet(size_t res, Arena & arena);
+
       /// @brief Virtual destructor
       virtual ~FieldSet();
 
@@ -87,6 +97,12 @@ namespace QuickFAST{
       }
 
       /// @brief Get the value of the specified field.
+      ///
+      /// Fields are found directly when the set was built with the identities
+      /// of a finalized template, as the decoder does.  A set built from other
+      /// identities is searched, starting at the position the ordinal of the
+      /// requested identity predicts, so a set filled in template order is
+      /// still found in a few comparisons.
       /// @param[in] identity Identifies the desired field
       /// @param[out] value is the value that was found.
       /// @returns true if the field was found and has a value;
@@ -133,8 +149,11 @@ namespace QuickFAST{
         applicationType_.swap(rhs.applicationType_);
         applicationTypeNs_.swap(rhs.applicationTypeNs_);
         swap_i(fields_, rhs.fields_);
+        swap_i(positions_, rhs.positions_);
+        swap_i(arena_, rhs.arena_);
         swap_i(capacity_, rhs.capacity_);
         swap_i(used_, rhs.used_);
+        keepers_.swap(rhs.keepers_);
       }
 
       ///// @brief access the field set
@@ -153,6 +172,11 @@ namespace QuickFAST{
         ValueType::Type & type,
         FieldCPtr & fieldPtr)const;
 
+      /// @brief Prepare every field and identity in this set to be shared by more than one thread.
+      ///
+      /// Nested groups and sequences are included.  See Field::publish()
+      void publish()const;
+
       /// @brief compare two field sets for equality
       /// @param rhs the target of the comparison
       /// @param reason a discription of the cause of the mismatch is written to this stream
@@ -160,6 +184,20 @@ namespace QuickFAST{
       bool equals(const FieldSet & rhs, std::ostream & reason) const;
 
     private:
+      /// @brief Find the position of a field in this set.
+      ///
+      /// A field added with an ordinal is found directly.  Otherwise, or when
+      /// the ordinal leads elsewhere, the fields are searched starting where
+      /// the ordinal says the field should be.
+      /// @param identity identifies the field.
+      /// @param[out] index is the position of the field if it was found
+      /// @returns true if the field was found.
+      bool findField(const FieldIdentity & identity, size_t & index)const;
+
+      MessageField * allocateFields(size_t capacity);
+      void releaseFields(MessageField * fields);
+      static size_t * positionsFor(MessageField * fields, size_t capacity);
+
       template<typename T>
       void swap_i(T & l, T & r)
       {
@@ -175,8 +213,15 @@ namespace QuickFAST{
     private:
       /// The collection of fields
       MessageField * fields_;
+      /// Indexed by ordinal: one more than the position of the field in fields_, or zero.
+      /// Shares the allocation with fields_.
+      size_t * positions_;
+      /// If not null, fields_ lives here rather than on the heap.
+      Arena * arena_;
       size_t capacity_;
       size_t used_;
+      /// Keeps immortal identities alive as long as the fields that use them.
+      IdentityKeeperSet keepers_;
     };
   }
 }
@@ -0,0 +1,65 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "IdentityKeeper.h"
+#include <algorithm>
+
+using namespace QuickFAST;
+using namespace Messages;
+
+IdentityKeeper::IdentityKeeper()
+  : refcount_(0)
+{
+}
+
+IdentityKeeper::~IdentityKeeper()
+{
+  release();
+}
+
+void
+IdentityKeeper::keep(const FieldIdentityCPtr & identity)
+{
+  const IdentityKeeper * keeper = identity->keeper();
+  if(keeper == this)
+  {
+    return;
+  }
+  if(keeper != 0)
+  {
+    if(std::find(keepers_.begin(), keepers_.end(), keeper) == keepers_.end())
+    {
+      keepers_.push_back(keeper);
+    }
+    return;
+  }
+  // The reference was taken while the identity was counted.
+  identities_.push_back(identity);
+  identity->makeImmortal(*this);
+}
+
+void
+IdentityKeeper::release()
+{
+  for(size_t nIdentity = 0; nIdentity < identities_.size(); ++nIdentity)
+  {
+    identities_[nIdentity]->makeMortal();
+  }
+  // and now our references are counted again.
+  identities_.clear();
+  keepers_.clear();
+}
+
+void
+IdentityKeeperSet::holdKeeper(const IdentityKeeper * keeper)
+{
+  if(keeper_ == 0)
+  {
+    keeper_ = keeper;
+  }
+  else if(std::find(others_.begin(), others_.end(), keeper) == others_.end())
+  {
+    others_.push_back(keeper);
+  }
+}
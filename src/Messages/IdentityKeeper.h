@@ -0,0 +1,125 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef IDENTITYKEEPER_H
+#define IDENTITYKEEPER_H
+#include "IdentityKeeper_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Common/AtomicRefCount.h>
+#include <Messages/FieldIdentity.h>
+
+namespace QuickFAST{
+  namespace Messages{
+    /// @brief Keeps immortal field identities alive until nothing can use them.
+    ///
+    /// Pointers to an immortal identity (see FieldIdentity::makeImmortal())
+    /// are not counted, so its keeper is counted instead.  Every FieldSet,
+    /// Sequence and RecordedMessage that holds immortal identities also holds
+    /// their keeper, one count per object rather than one per field.
+    ///
+    /// A TemplateRegistry keeps the identities of its templates this way, so
+    /// decoded messages may outlive the registry.  The identities are made
+    /// mortal and released when the last of them is gone.
+    ///
+    /// A derived class that holds other counted references to the identities
+    /// must call release() from its own destructor, so those references are
+    /// released while the identities are counted again.
+    class QuickFAST_Export IdentityKeeper
+    {
+    public:
+      IdentityKeeper();
+
+      /// @brief Make the identities mortal again and release them.
+      virtual ~IdentityKeeper();
+
+      /// @brief Make an identity immortal and keep it alive.
+      ///
+      /// Take the reference before calling this, while the identity is counted.
+      /// An identity that is already immortal stays with its own keeper, and
+      /// this keeper keeps that one alive instead.
+      /// Not thread safe: call only while the identity is being configured.
+      /// @param identity to be kept.
+      void keep(const FieldIdentityCPtr & identity);
+
+      /// @brief How many identities has this keeper made immortal?
+      size_t size()const
+      {
+        return identities_.size();
+      }
+
+    protected:
+      /// @brief Make every identity mortal again and release this keeper's references.
+      void release();
+
+    private:
+      IdentityKeeper(const IdentityKeeper &);
+      IdentityKeeper & operator=(const IdentityKeeper &);
+
+      friend void intrusive_ptr_add_ref(const IdentityKeeper * ptr);
+      friend void intrusive_ptr_release(const IdentityKeeper * ptr);
+
+    private:
+      std::vector<FieldIdentityCPtr> identities_;
+      std::vector<IdentityKeeperCPtr> keepers_;
+      mutable volatile long refcount_;
+    };
+
+    inline
+    void
+    intrusive_ptr_add_ref(const IdentityKeeper * ptr)
+    {
+      // Messages holding the keeper may be released on any thread.
+      atomicRefCountIncrement(&ptr->refcount_);
+    }
+
+    inline
+    void
+    intrusive_ptr_release(const IdentityKeeper * ptr)
+    {
+      if(atomicRefCountDecrement(&ptr->refcount_) == 0)
+      {
+        delete ptr;
+      }
+    }
+
+    /// @brief The keepers of the immortal identities held by one object.
+    ///
+    /// Call hold() for each identity before keeping a pointer to it.
+    /// Identities from one registry share a keeper, so this is usually a
+    /// single pointer comparison.
+    class QuickFAST_Export IdentityKeeperSet
+    {
+    public:
+      /// @brief Keep the identity's keeper, if it has one, as long as this set.
+      /// @param identity is about to be held by the owner of this set.
+      void hold(const FieldIdentity & identity)
+      {
+        const IdentityKeeper * keeper = identity.keeper();
+        if(keeper != 0 && keeper != keeper_.get())
+        {
+          holdKeeper(keeper);
+        }
+      }
+
+      /// @brief Exchange contents with another set.
+      /// @param rhs is the set to exchange with.
+      void swap(IdentityKeeperSet & rhs)
+      {
+        keeper_.swap(rhs.keeper_);
+        others_.swap(rhs.others_);
+      }
+
+    private:
+      void holdKeeper(const IdentityKeeper * keeper);
+
+    private:
+      IdentityKeeperCPtr keeper_;
+      /// Keepers of identities from other registries.  Rarely used.
+      std::vector<IdentityKeeperCPtr> others_;
+    };
+  }
+}
+#endif // IDENTITYKEEPER_H
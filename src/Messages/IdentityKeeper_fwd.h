@@ -0,0 +1,28 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef IDENTITYKEEPER_FWD_H
+#define IDENTITYKEEPER_FWD_H
+#include <Common/QuickFAST_Export.h>
+#include <boost/intrusive_ptr.hpp>
+
+namespace QuickFAST{
+  namespace Messages{
+    class IdentityKeeper;
+    /// @brief An intrusive smart pointer to a const IdentityKeeper
+    typedef boost::intrusive_ptr<const IdentityKeeper> IdentityKeeperCPtr;
+    /// @brief An intrusive smart pointer to a non-const IdentityKeeper
+    typedef boost::intrusive_ptr<IdentityKeeper> IdentityKeeperPtr;
+    /// @brief Support for intrusive_ptr -- add a reference
+    /// @param ptr points to the object managed by the pointer.
+    void intrusive_ptr_add_ref(const IdentityKeeper * ptr);
+    /// @brief Support for intrusive_ptr -- release a reference
+    /// @param ptr points to the object managed by the pointer.
+    void intrusive_ptr_release(const IdentityKeeper * ptr);
+    class IdentityKeeperSet;
+  }
+}
+#endif // IDENTITYKEEPER_FWD_H
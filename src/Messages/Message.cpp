@@ -10,6 +10,14 @@ using namespace ::QuickFAST::Messages;
 
 Message::Message(size_t expectedNumberOfFields)
 : FieldSet(expectedNumberOfFields)
+, receiveTime_(0)
+{
+  applicationType_ = "any";
+}
+
+Message::Message(size_t expectedNumberOfFields, Arena & arena)
+: FieldSet(expectedNumberOfFields, arena)
+, receiveTime_(0)
 {
   applicationType_ = "any";
 }
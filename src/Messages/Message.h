@@ -23,6 +23,30 @@ namespace QuickFAST{
       /// @brief Construct an empty Message
       Message(size_t expectedNumberOfFields);
 
+      /// @brief Construct an empty Message that keeps its fields in an Arena
+      /// @param expectedNumberOfFields is used to preallocate space
+      /// @param arena supplies the storage for the fields.
+      Message(size_t expectedNumberOfFields, Arena & arena);
+
+      /// @brief Record when the data for this message arrived.
+      /// @param nanoseconds since the epoch, or zero if unknown.
+      void setReceiveTime(uint64 nanoseconds)
+      {
+        receiveTime_ = nanoseconds;
+      }
+
+      /// @brief When did the data for this message arrive?
+      ///
+      /// Compare to LatencyHistogram::now() to measure latency.
+      /// @returns nanoseconds since the epoch, or zero if unknown.
+      uint64 receiveTime()const
+      {
+        return receiveTime_;
+      }
+
+    private:
+      uint64 receiveTime_;
+
     };
   }
 }
@@ -0,0 +1,141 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "PipelinedMessageBuilder.h"
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Messages;
+
+PipelinedMessageBuilder::PipelinedMessageBuilder(
+  ValueMessageBuilder & consumer,
+  size_t capacity,
+  Backpressure backpressure,
+  MessageRing::WaitStrategy strategy)
+: RecordingMessageBuilder(consumer)
+, consumer_(consumer)
+, messages_(new RecordedMessage[capacity == 0 ? 1 : capacity])
+, backpressure_(backpressure)
+, batchLimit_(64)
+, publishedRing_(capacity, MessageRing::SINGLE_PRODUCER, strategy)
+, recycledRing_(capacity, MessageRing::SINGLE_PRODUCER, MessageRing::BLOCK)
+, published_(0)
+, stalls_(0)
+, batches_(0)
+, largestBatch_(0)
+, consumed_(0)
+, stopDecoding_(0)
+{
+  for(size_t nMessage = 0; nMessage < (capacity == 0 ? 1 : capacity); ++nMessage)
+  {
+    recycledRing_.push(&messages_[nMessage]);
+  }
+}
+
+PipelinedMessageBuilder::~PipelinedMessageBuilder()
+{
+  stop();
+}
+
+void
+PipelinedMessageBuilder::start(const ThreadOptions & options)
+{
+  if(thread_)
+  {
+    return;
+  }
+  publishedRing_.clearInterrupt();
+  recycledRing_.clearInterrupt();
+  batch_.reserve(batchLimit_);
+  thread_.reset(new boost::thread(boost::bind(&PipelinedMessageBuilder::consume, this, options)));
+}
+
+void
+PipelinedMessageBuilder::stop()
+{
+  if(thread_)
+  {
+    // The consumer drains the ring before it honors the interrupt.
+    publishedRing_.interrupt();
+    recycledRing_.interrupt();
+    thread_->join();
+    thread_.reset();
+  }
+}
+
+void
+PipelinedMessageBuilder::flush()
+{
+  while(thread_ && size_t(atomicLoadAcquire(&consumed_)) != published_)
+  {
+    boost::this_thread::yield();
+  }
+}
+
+void
+PipelinedMessageBuilder::consume(ThreadOptions options)
+{
+  options.applyToCurrentThread(&consumer_);
+  for(;;)
+  {
+    RecordedMessage * message = publishedRing_.popWait();
+    if(message == 0)
+    {
+      // interrupted, but finish whatever was published first.
+      message = publishedRing_.pop();
+      if(message == 0)
+      {
+        break;
+      }
+    }
+    batch_.clear();
+    batch_.push_back(message);
+    while(batch_.size() < batchLimit_ && (message = publishedRing_.pop()) != 0)
+    {
+      batch_.push_back(message);
+    }
+    for(size_t nMessage = 0; nMessage < batch_.size(); ++nMessage)
+    {
+      RecordedMessage & recorded = *batch_[nMessage];
+      if(atomicLoadAcquire(&stopDecoding_) == 0 && !recorded.replay(consumer_))
+      {
+        atomicStoreRelease(&stopDecoding_, 1);
+      }
+      recorded.clear();
+    }
+    for(size_t nMessage = 0; nMessage < batch_.size(); ++nMessage)
+    {
+      recycledRing_.push(batch_[nMessage]);
+    }
+    ++batches_;
+    largestBatch_ = std::max(largestBatch_, batch_.size());
+    atomicStoreRelease(&consumed_, consumed_ + long(batch_.size()));
+  }
+}
+
+RecordedMessage *
+PipelinedMessageBuilder::nextRecording()
+{
+  RecordedMessage * recording = recycledRing_.pop();
+  if(recording == 0 && backpressure_ == WAIT && thread_)
+  {
+    ++stalls_;
+    recording = recycledRing_.popWait();
+  }
+  return recording;
+}
+
+bool
+PipelinedMessageBuilder::messageRecorded(RecordedMessage & recording)
+{
+  // There is a slot for every recording, so this cannot fail.
+  publishedRing_.push(&recording);
+  ++published_;
+  return keepDecoding();
+}
+
+bool
+PipelinedMessageBuilder::keepDecoding()
+{
+  return atomicLoadAcquire(&stopDecoding_) == 0;
+}
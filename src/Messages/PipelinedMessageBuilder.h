@@ -0,0 +1,166 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef PIPELINEDMESSAGEBUILDER_H
+#define PIPELINEDMESSAGEBUILDER_H
+#include "PipelinedMessageBuilder_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Common/PointerRing.h>
+#include <Common/ThreadOptions.h>
+#include <Messages/RecordingMessageBuilder.h>
+
+namespace QuickFAST{
+  namespace Messages{
+    /// @brief Decouple decoding from the application's builder with a consumer thread.
+    ///
+    /// Give this builder to the assembler in place of the application's builder.
+    /// The decoding thread records each message into a RecordedMessage and
+    /// publishes it through a lock-free ring.  A consumer thread replays the
+    /// messages, in order, into the application's builder and returns the
+    /// recordings to a second ring for reuse.  A slow builder now delays only
+    /// the consumer thread; the decoder, and therefore the receiver, keep up
+    /// with the feed as long as there are recordings to spare.
+    ///
+    /// The consumer takes every message that is ready, up to a batch limit,
+    /// before handing any recordings back, so a busy pipeline crosses between
+    /// threads once per batch rather than once per message.
+    ///
+    /// When every recording is waiting to be consumed the decoder either waits
+    /// for one (WAIT) or drops the message (DISCARD).  The statistics show how
+    /// often that happens.
+    ///
+    /// The Logger methods (wantLog, logMessage, and the error reports) are
+    /// forwarded directly to the application's builder from the decoding
+    /// thread, so they must be safe to call concurrently with the builder's
+    /// other methods.
+    class QuickFAST_Export PipelinedMessageBuilder : public RecordingMessageBuilder
+    {
+    public:
+      /// @brief What the decoder does when the consumer is too far behind.
+      enum Backpressure
+      {
+        /// Wait for the consumer to return a recording.  No message is lost.
+        WAIT,
+        /// Drop the message and count it.  The decoder never waits.
+        DISCARD
+      };
+
+      /// @brief The rings that carry recordings between the threads.
+      typedef PointerRing<RecordedMessage> MessageRing;
+
+      /// @brief Construct the pipeline.  Call start() before decoding.
+      /// @param consumer is the application's builder.  It is called only from the consumer thread.
+      /// @param capacity is how many messages can be decoded but not yet consumed.
+      /// @param backpressure says what to do when all of them are.
+      /// @param strategy says how the consumer waits for messages.
+      PipelinedMessageBuilder(
+        ValueMessageBuilder & consumer,
+        size_t capacity = 1024,
+        Backpressure backpressure = WAIT,
+        MessageRing::WaitStrategy strategy = MessageRing::BLOCK);
+
+      /// @brief Stops the consumer thread after it delivers every published message.
+      virtual ~PipelinedMessageBuilder();
+
+      /// @brief Limit how many messages the consumer takes at a time.
+      ///
+      /// Call before start().
+      /// @param batchLimit is the most messages delivered before recordings are returned.
+      void setBatchLimit(size_t batchLimit)
+      {
+        batchLimit_ = batchLimit == 0 ? 1 : batchLimit;
+      }
+
+      /// @brief Start the consumer thread.
+      /// @param options place the consumer thread.  The default leaves it alone.
+      void start(const ThreadOptions & options = ThreadOptions());
+
+      /// @brief Deliver every published message, then stop the consumer thread.
+      ///
+      /// Call only after decoding has stopped.
+      void stop();
+
+      /// @brief Wait until the consumer has delivered every published message.
+      ///
+      /// Call only after decoding has stopped.  The consumer thread keeps running.
+      void flush();
+
+      /// @brief Statistic: How many messages were handed to the consumer thread?
+      size_t published()const
+      {
+        return published_;
+      }
+
+      /// @brief Statistic: How many times did the decoder wait for the consumer?
+      size_t stalls()const
+      {
+        return stalls_;
+      }
+
+      /// @brief Statistic: How many messages has the consumer delivered?
+      size_t consumed()const
+      {
+        return size_t(consumed_);
+      }
+
+      /// @brief Statistic: How many batches has the consumer taken?
+      size_t batches()const
+      {
+        return batches_;
+      }
+
+      /// @brief Statistic: How many messages were in the largest batch?
+      size_t largestBatch()const
+      {
+        return largestBatch_;
+      }
+
+      /// @brief Statistic: How many times did the consumer find nothing to do?
+      size_t consumerWaits()const
+      {
+        return publishedRing_.waits();
+      }
+
+    protected:
+      ///////////////////////////
+      // Implement RecordingMessageBuilder
+      virtual RecordedMessage * nextRecording();
+      virtual bool messageRecorded(RecordedMessage & recording);
+      virtual bool keepDecoding();
+
+    private:
+      PipelinedMessageBuilder(const PipelinedMessageBuilder &);
+      PipelinedMessageBuilder & operator=(const PipelinedMessageBuilder &);
+
+      void consume(ThreadOptions options);
+
+    private:
+      ValueMessageBuilder & consumer_;
+      boost::scoped_array<RecordedMessage> messages_;
+      Backpressure backpressure_;
+      size_t batchLimit_;
+      boost::scoped_ptr<boost::thread> thread_;
+
+      // decoded messages, decoding thread to consumer thread
+      MessageRing publishedRing_;
+      // recordings for reuse, consumer thread to decoding thread
+      MessageRing recycledRing_;
+
+      // Used by the decoding thread
+      size_t published_;
+      size_t stalls_;
+
+      // Used by the consumer thread
+      std::vector<RecordedMessage *> batch_;
+      size_t batches_;
+      size_t largestBatch_;
+      volatile long consumed_;
+      // set when the application's builder asks to stop decoding
+      volatile long stopDecoding_;
+    };
+  }
+}
+#endif // PIPELINEDMESSAGEBUILDER_H
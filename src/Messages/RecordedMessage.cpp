@@ -0,0 +1,257 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "RecordedMessage.h"
+#include <Messages/ValueMessageBuilder.h>
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Messages;
+
+namespace
+{
+  FieldIdentityCPtr noIdentity;
+}
+
+RecordedMessage::RecordedMessage()
+: namesUsed_(0)
+, receiveTime_(0)
+{
+}
+
+RecordedMessage::~RecordedMessage()
+{
+}
+
+void
+RecordedMessage::clear()
+{
+  entries_.clear();
+  bytes_.clear();
+  // keep the strings themselves so their memory is reused.
+  namesUsed_ = 0;
+  receiveTime_ = 0;
+}
+
+size_t
+RecordedMessage::keepName(const std::string & name)
+{
+  if(namesUsed_ == names_.size())
+  {
+    names_.push_back(name);
+  }
+  else
+  {
+    names_[namesUsed_] = name;
+  }
+  return namesUsed_++;
+}
+
+void
+RecordedMessage::addScope(
+  Operation operation,
+  const std::string & applicationType,
+  const std::string & applicationTypeNamespace,
+  size_t size)
+{
+  Entry & entry = add(operation, noIdentity, ValueType::UNDEFINED);
+  entry.applicationType_ = keepName(applicationType);
+  entry.applicationTypeNamespace_ = keepName(applicationTypeNamespace);
+  entry.size_ = size;
+}
+
+void
+RecordedMessage::startMessage(
+  const std::string & applicationType,
+  const std::string & applicationTypeNamespace,
+  size_t size)
+{
+  addScope(START_MESSAGE, applicationType, applicationTypeNamespace, size);
+}
+
+void
+RecordedMessage::endMessage(bool ignored)
+{
+  add(ignored ? IGNORE_MESSAGE : END_MESSAGE, noIdentity, ValueType::UNDEFINED);
+}
+
+void
+RecordedMessage::startSequence(
+  FieldIdentityCPtr & identity,
+  const std::string & applicationType,
+  const std::string & applicationTypeNamespace,
+  size_t fieldCount,
+  FieldIdentityCPtr & lengthIdentity,
+  size_t length)
+{
+  addScope(START_SEQUENCE, applicationType, applicationTypeNamespace, fieldCount);
+  entries_.back().identity_ = identity;
+  add(SEQUENCE_LENGTH, lengthIdentity, ValueType::UNDEFINED).size_ = length;
+}
+
+void
+RecordedMessage::endSequence(FieldIdentityCPtr & identity)
+{
+  add(END_SEQUENCE, identity, ValueType::UNDEFINED);
+}
+
+void
+RecordedMessage::startSequenceEntry(
+  const std::string & applicationType,
+  const std::string & applicationTypeNamespace,
+  size_t size)
+{
+  addScope(START_ENTRY, applicationType, applicationTypeNamespace, size);
+}
+
+void
+RecordedMessage::endSequenceEntry()
+{
+  add(END_ENTRY, noIdentity, ValueType::UNDEFINED);
+}
+
+void
+RecordedMessage::startGroup(
+  FieldIdentityCPtr & identity,
+  const std::string & applicationType,
+  const std::string & applicationTypeNamespace,
+  size_t size)
+{
+  addScope(START_GROUP, applicationType, applicationTypeNamespace, size);
+  entries_.back().identity_ = identity;
+}
+
+void
+RecordedMessage::endGroup(FieldIdentityCPtr & identity)
+{
+  add(END_GROUP, identity, ValueType::UNDEFINED);
+}
+
+void
+RecordedMessage::addValue(
+  FieldIdentityCPtr & identity,
+  ValueType::Type type,
+  const unsigned char * value,
+  size_t length)
+{
+  Entry & entry = add(BYTES, identity, type);
+  entry.offset_ = bytes_.size();
+  entry.size_ = length;
+  bytes_.insert(bytes_.end(), value, value + length);
+}
+
+bool
+RecordedMessage::replay(ValueMessageBuilder & target)
+{
+  if(receiveTime_ != 0)
+  {
+    target.setReceiveTime(receiveTime_);
+  }
+  bool result = true;
+  // builders_[0] is the target; each start pushes the builder it returns.
+  builders_.clear();
+  builders_.push_back(&target);
+  for(size_t nEntry = 0; nEntry < entries_.size(); ++nEntry)
+  {
+    Entry & entry = entries_[nEntry];
+    ValueMessageBuilder & builder = *builders_.back();
+    bool closing = entry.operation_ == END_MESSAGE
+      || entry.operation_ == IGNORE_MESSAGE
+      || entry.operation_ == END_SEQUENCE
+      || entry.operation_ == END_ENTRY
+      || entry.operation_ == END_GROUP;
+    if(closing && builders_.size() < 2)
+    {
+      // unbalanced; never let the target see it.
+      continue;
+    }
+    switch(entry.operation_)
+    {
+    case INT64:
+      builder.addValue(entry.identity_, entry.type_, int64(entry.signed_));
+      break;
+    case UINT64:
+      builder.addValue(entry.identity_, entry.type_, uint64(entry.unsigned_));
+      break;
+    case INT32:
+      builder.addValue(entry.identity_, entry.type_, int32(entry.signed_));
+      break;
+    case UINT32:
+      builder.addValue(entry.identity_, entry.type_, uint32(entry.unsigned_));
+      break;
+    case INT16:
+      builder.addValue(entry.identity_, entry.type_, int16(entry.signed_));
+      break;
+    case UINT16:
+      builder.addValue(entry.identity_, entry.type_, uint16(entry.unsigned_));
+      break;
+    case INT8:
+      builder.addValue(entry.identity_, entry.type_, int8(entry.signed_));
+      break;
+    case UINT8:
+      builder.addValue(entry.identity_, entry.type_, uchar(entry.unsigned_));
+      break;
+    case DECIMAL:
+      builder.addValue(entry.identity_, entry.type_, Decimal(entry.signed_, exponent_t(int(entry.size_))));
+      break;
+    case BYTES:
+      builder.addValue(
+        entry.identity_,
+        entry.type_,
+        entry.size_ == 0 ? 0 : &bytes_[entry.offset_],
+        entry.size_);
+      break;
+    case START_MESSAGE:
+      builders_.push_back(&builder.startMessage(
+        names_[entry.applicationType_], names_[entry.applicationTypeNamespace_], entry.size_));
+      break;
+    case END_MESSAGE:
+      builders_.pop_back();
+      result = builders_.back()->endMessage(builder);
+      break;
+    case IGNORE_MESSAGE:
+      builders_.pop_back();
+      builders_.back()->ignoreMessage(builder);
+      break;
+    case START_SEQUENCE:
+      {
+        Entry & length = entries_[++nEntry];
+        builders_.push_back(&builder.startSequence(
+          entry.identity_,
+          names_[entry.applicationType_],
+          names_[entry.applicationTypeNamespace_],
+          entry.size_,
+          length.identity_,
+          length.size_));
+        break;
+      }
+    case SEQUENCE_LENGTH:
+      // consumed with START_SEQUENCE
+      break;
+    case END_SEQUENCE:
+      builders_.pop_back();
+      builders_.back()->endSequence(entry.identity_, builder);
+      break;
+    case START_ENTRY:
+      builders_.push_back(&builder.startSequenceEntry(
+        names_[entry.applicationType_], names_[entry.applicationTypeNamespace_], entry.size_));
+      break;
+    case END_ENTRY:
+      builders_.pop_back();
+      builders_.back()->endSequenceEntry(builder);
+      break;
+    case START_GROUP:
+      builders_.push_back(&builder.startGroup(
+        entry.identity_,
+        names_[entry.applicationType_],
+        names_[entry.applicationTypeNamespace_],
+        entry.size_));
+      break;
+    case END_GROUP:
+      builders_.pop_back();
+      builders_.back()->endGroup(entry.identity_, builder);
+      break;
+    }
+  }
+  return result;
+}
@@ -0,0 +1,221 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef RECORDEDMESSAGE_H
+#define RECORDEDMESSAGE_H
+#include "RecordedMessage_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Common/Types.h>
+#include <Common/Decimal.h>
+#include <Messages/FieldIdentity.h>
+#include <Messages/IdentityKeeper.h>
+#include <Messages/ValueMessageBuilder_fwd.h>
+
+namespace QuickFAST{
+  namespace Messages{
+    /// @brief The calls a decoder made to a ValueMessageBuilder for one message, saved for replay.
+    ///
+    /// Every call becomes one fixed-size entry in a flat vector.  String and
+    /// byte vector values are copied into a single byte buffer owned by the
+    /// message.  clear() keeps the memory, so a recycled RecordedMessage stops
+    /// allocating once it has held the largest message in the feed.
+    ///
+    /// Application type names are copied too, into strings that are reused
+    /// from one recording to the next, so a recording does not depend on the
+    /// templates that produced it.
+    class QuickFAST_Export RecordedMessage
+    {
+    public:
+      RecordedMessage();
+      ~RecordedMessage();
+
+      /// @brief Forget the recording, but keep its memory.
+      void clear();
+
+      /// @brief True if nothing has been recorded since clear().
+      bool empty()const
+      {
+        return entries_.empty();
+      }
+
+      /// @brief How many calls were recorded.
+      size_t size()const
+      {
+        return entries_.size();
+      }
+
+      /// @brief Remember when the data for this message arrived.
+      /// @param nanoseconds as passed to ValueMessageBuilder::setReceiveTime().
+      void setReceiveTime(uint64 nanoseconds)
+      {
+        receiveTime_ = nanoseconds;
+      }
+
+      /// @brief Record startMessage().
+      void startMessage(const std::string & applicationType, const std::string & applicationTypeNamespace, size_t size);
+      /// @brief Record endMessage() or, if ignored is true, ignoreMessage().
+      void endMessage(bool ignored);
+      /// @brief Record startSequence().
+      void startSequence(
+        FieldIdentityCPtr & identity,
+        const std::string & applicationType,
+        const std::string & applicationTypeNamespace,
+        size_t fieldCount,
+        FieldIdentityCPtr & lengthIdentity,
+        size_t length);
+      /// @brief Record endSequence().
+      void endSequence(FieldIdentityCPtr & identity);
+      /// @brief Record startSequenceEntry().
+      void startSequenceEntry(const std::string & applicationType, const std::string & applicationTypeNamespace, size_t size);
+      /// @brief Record endSequenceEntry().
+      void endSequenceEntry();
+      /// @brief Record startGroup().
+      void startGroup(
+        FieldIdentityCPtr & identity,
+        const std::string & applicationType,
+        const std::string & applicationTypeNamespace,
+        size_t size);
+      /// @brief Record endGroup().
+      void endGroup(FieldIdentityCPtr & identity);
+
+      /// @brief Record addValue() for a signed integer.
+      void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const int64 value)
+      {
+        add(INT64, identity, type).signed_ = value;
+      }
+      /// @brief Record addValue() for an unsigned integer.
+      void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const uint64 value)
+      {
+        add(UINT64, identity, type).unsigned_ = value;
+      }
+      /// @brief Record addValue() for a signed integer.
+      void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const int32 value)
+      {
+        add(INT32, identity, type).signed_ = value;
+      }
+      /// @brief Record addValue() for an unsigned integer.
+      void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const uint32 value)
+      {
+        add(UINT32, identity, type).unsigned_ = value;
+      }
+      /// @brief Record addValue() for a signed integer.
+      void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const int16 value)
+      {
+        add(INT16, identity, type).signed_ = value;
+      }
+      /// @brief Record addValue() for an unsigned integer.
+      void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const uint16 value)
+      {
+        add(UINT16, identity, type).unsigned_ = value;
+      }
+      /// @brief Record addValue() for a signed integer.
+      void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const int8 value)
+      {
+        add(INT8, identity, type).signed_ = value;
+      }
+      /// @brief Record addValue() for an unsigned integer.
+      void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const uchar value)
+      {
+        add(UINT8, identity, type).unsigned_ = value;
+      }
+      /// @brief Record addValue() for a decimal.
+      void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const Decimal & value)
+      {
+        Entry & entry = add(DECIMAL, identity, type);
+        entry.signed_ = value.getMantissa();
+        entry.size_ = size_t(int(value.getExponent()));
+      }
+      /// @brief Record addValue() for a string or byte vector.  The value is copied.
+      void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const unsigned char * value, size_t length);
+
+      /// @brief Make the recorded calls again, this time to a real builder.
+      /// @param builder receives the message.
+      /// @returns the result of builder.endMessage(), or true if the message
+      ///          was ignored or incomplete.
+      bool replay(ValueMessageBuilder & builder);
+
+    private:
+      enum Operation
+      {
+        INT64,
+        UINT64,
+        INT32,
+        UINT32,
+        INT16,
+        UINT16,
+        INT8,
+        UINT8,
+        DECIMAL,
+        BYTES,
+        START_MESSAGE,
+        END_MESSAGE,
+        IGNORE_MESSAGE,
+        START_SEQUENCE,
+        SEQUENCE_LENGTH, // always follows START_SEQUENCE
+        END_SEQUENCE,
+        START_ENTRY,
+        END_ENTRY,
+        START_GROUP,
+        END_GROUP
+      };
+
+      /// One recorded call.  Fields not needed by the operation are left alone.
+      struct Entry
+      {
+        Operation operation_;
+        ValueType::Type type_;
+        FieldIdentityCPtr identity_;
+        union
+        {
+          int64 signed_;
+          uint64 unsigned_;
+          /// index into names_
+          size_t applicationType_;
+        };
+        /// index into names_
+        size_t applicationTypeNamespace_;
+        /// field count, sequence length, decimal exponent, or byte count
+        size_t size_;
+        /// where a BYTES value starts in bytes_
+        size_t offset_;
+      };
+
+      Entry & add(Operation operation, FieldIdentityCPtr & identity, ValueType::Type type)
+      {
+        entries_.resize(entries_.size() + 1);
+        Entry & entry = entries_.back();
+        entry.operation_ = operation;
+        entry.type_ = type;
+        if(identity)
+        {
+          keepers_.hold(*identity);
+        }
+        entry.identity_ = identity;
+        return entry;
+      }
+
+      void addScope(
+        Operation operation,
+        const std::string & applicationType,
+        const std::string & applicationTypeNamespace,
+        size_t size);
+
+      size_t keepName(const std::string & name);
+
+    private:
+      /// Declared first so it outlives the identities in entries_.
+      IdentityKeeperSet keepers_;
+      std::vector<Entry> entries_;
+      std::vector<unsigned char> bytes_;
+      /// Copies of application type names. Only the first namesUsed_ belong to this recording.
+      std::vector<std::string> names_;
+      size_t namesUsed_;
+      std::vector<ValueMessageBuilder *> builders_;
+      uint64 receiveTime_;
+    };
+  }
+}
+#endif // RECORDEDMESSAGE_H
@@ -0,0 +1,14 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef RECORDEDMESSAGE_FWD_H
+#define RECORDEDMESSAGE_FWD_H
+namespace QuickFAST{
+  namespace Messages{
+    class RecordedMessage;
+  }
+}
+#endif // RECORDEDMESSAGE_FWD_H
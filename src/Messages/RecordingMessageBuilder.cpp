@@ -0,0 +1,283 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+#include "RecordingMessageBuilder.h"
+
+using namespace ::QuickFAST;
+using namespace ::QuickFAST::Messages;
+
+namespace
+{
+  const std::string noApplicationType;
+}
+
+RecordingMessageBuilder::RecordingMessageBuilder(Common::Logger & logger)
+: logger_(logger)
+, current_(0)
+, receiveTime_(0)
+, discarded_(0)
+{
+}
+
+RecordingMessageBuilder::~RecordingMessageBuilder()
+{
+}
+
+ValueMessageBuilder &
+RecordingMessageBuilder::startMessage(
+  const std::string & applicationType,
+  const std::string & applicationTypeNamespace,
+  size_t size)
+{
+  // The recording of a message abandoned part way through (by an exception)
+  // is emptied and reused.
+  if(current_ == 0)
+  {
+    current_ = nextRecording();
+    if(current_ == 0)
+    {
+      current_ = &discard_;
+    }
+  }
+  current_->clear();
+  scopes_.clear();
+  current_->setReceiveTime(receiveTime_);
+  receiveTime_ = 0;
+  current_->startMessage(applicationType, applicationTypeNamespace, size);
+  pushScope(applicationType, applicationTypeNamespace);
+  return *this;
+}
+
+void
+RecordingMessageBuilder::setReceiveTime(uint64 nanoseconds)
+{
+  receiveTime_ = nanoseconds;
+}
+
+bool
+RecordingMessageBuilder::finishMessage(bool ignored)
+{
+  scopes_.clear();
+  RecordedMessage * finished = current_;
+  current_ = 0;
+  if(finished == 0)
+  {
+    return keepDecoding();
+  }
+  finished->endMessage(ignored);
+  if(finished == &discard_)
+  {
+    ++discarded_;
+    return keepDecoding();
+  }
+  return messageRecorded(*finished);
+}
+
+bool
+RecordingMessageBuilder::keepDecoding()
+{
+  return true;
+}
+
+bool
+RecordingMessageBuilder::endMessage(ValueMessageBuilder &)
+{
+  return finishMessage(false);
+}
+
+bool
+RecordingMessageBuilder::ignoreMessage(ValueMessageBuilder &)
+{
+  if(current_ != 0 && scopes_.size() > 2)
+  {
+    // Abandoned by a decoding error with a sequence or group still open.
+    // There is nothing worth replaying, so the recording is emptied and reused.
+    current_->clear();
+    scopes_.clear();
+    return keepDecoding();
+  }
+  return finishMessage(true);
+}
+
+void
+RecordingMessageBuilder::pushScope(const std::string & applicationType, const std::string & applicationTypeNamespace)
+{
+  scopes_.push_back(&applicationType);
+  scopes_.push_back(&applicationTypeNamespace);
+}
+
+void
+RecordingMessageBuilder::popScope()
+{
+  if(scopes_.size() > 2)
+  {
+    scopes_.resize(scopes_.size() - 2);
+  }
+}
+
+const std::string &
+RecordingMessageBuilder::getApplicationType()const
+{
+  if(scopes_.empty())
+  {
+    return noApplicationType;
+  }
+  return *scopes_[scopes_.size() - 2];
+}
+
+const std::string &
+RecordingMessageBuilder::getApplicationTypeNs()const
+{
+  if(scopes_.empty())
+  {
+    return noApplicationType;
+  }
+  return *scopes_.back();
+}
+
+void
+RecordingMessageBuilder::addValue(FieldIdentityCPtr & identity, ValueType::Type type, const int64 value)
+{
+  current().addValue(identity, type, value);
+}
+
+void
+RecordingMessageBuilder::addValue(FieldIdentityCPtr & identity, ValueType::Type type, const uint64 value)
+{
+  current().addValue(identity, type, value);
+}
+
+void
+RecordingMessageBuilder::addValue(FieldIdentityCPtr & identity, ValueType::Type type, const int32 value)
+{
+  current().addValue(identity, type, value);
+}
+
+void
+RecordingMessageBuilder::addValue(FieldIdentityCPtr & identity, ValueType::Type type, const uint32 value)
+{
+  current().addValue(identity, type, value);
+}
+
+void
+RecordingMessageBuilder::addValue(FieldIdentityCPtr & identity, ValueType::Type type, const int16 value)
+{
+  current().addValue(identity, type, value);
+}
+
+void
+RecordingMessageBuilder::addValue(FieldIdentityCPtr & identity, ValueType::Type type, const uint16 value)
+{
+  current().addValue(identity, type, value);
+}
+
+void
+RecordingMessageBuilder::addValue(FieldIdentityCPtr & identity, ValueType::Type type, const int8 value)
+{
+  current().addValue(identity, type, value);
+}
+
+void
+RecordingMessageBuilder::addValue(FieldIdentityCPtr & identity, ValueType::Type type, const uchar value)
+{
+  current().addValue(identity, type, value);
+}
+
+void
+RecordingMessageBuilder::addValue(FieldIdentityCPtr & identity, ValueType::Type type, const Decimal& value)
+{
+  current().addValue(identity, type, value);
+}
+
+void
+RecordingMessageBuilder::addValue(FieldIdentityCPtr & identity, ValueType::Type type, const unsigned char * value, size_t length)
+{
+  current().addValue(identity, type, value, length);
+}
+
+ValueMessageBuilder &
+RecordingMessageBuilder::startSequence(
+  FieldIdentityCPtr & identity,
+  const std::string & applicationType,
+  const std::string & applicationTypeNamespace,
+  size_t fieldCount,
+  FieldIdentityCPtr & lengthIdentity,
+  size_t length)
+{
+  current().startSequence(identity, applicationType, applicationTypeNamespace, fieldCount, lengthIdentity, length);
+  pushScope(applicationType, applicationTypeNamespace);
+  return *this;
+}
+
+void
+RecordingMessageBuilder::endSequence(
+  FieldIdentityCPtr & identity,
+  ValueMessageBuilder &)
+{
+  current().endSequence(identity);
+  popScope();
+}
+
+ValueMessageBuilder &
+RecordingMessageBuilder::startSequenceEntry(
+  const std::string & applicationType,
+  const std::string & applicationTypeNamespace,
+  size_t size)
+{
+  current().startSequenceEntry(applicationType, applicationTypeNamespace, size);
+  pushScope(applicationType, applicationTypeNamespace);
+  return *this;
+}
+
+void
+RecordingMessageBuilder::endSequenceEntry(ValueMessageBuilder &)
+{
+  current().endSequenceEntry();
+  popScope();
+}
+
+ValueMessageBuilder &
+RecordingMessageBuilder::startGroup(
+  FieldIdentityCPtr & identity,
+  const std::string & applicationType,
+  const std::string & applicationTypeNamespace,
+  size_t size)
+{
+  current().startGroup(identity, applicationType, applicationTypeNamespace, size);
+  pushScope(applicationType, applicationTypeNamespace);
+  return *this;
+}
+
+void
+RecordingMessageBuilder::endGroup(
+  FieldIdentityCPtr & identity,
+  ValueMessageBuilder &)
+{
+  current().endGroup(identity);
+  popScope();
+}
+
+bool
+RecordingMessageBuilder::wantLog(unsigned short level)
+{
+  return logger_.wantLog(level);
+}
+
+bool
+RecordingMessageBuilder::logMessage(unsigned short level, const std::string & logMessage)
+{
+  return logger_.logMessage(level, logMessage);
+}
+
+bool
+RecordingMessageBuilder::reportDecodingError(const std::string & errorMessage)
+{
+  return logger_.reportDecodingError(errorMessage);
+}
+
+bool
+RecordingMessageBuilder::reportCommunicationError(const std::string & errorMessage)
+{
+  return logger_.reportCommunicationError(errorMessage);
+}
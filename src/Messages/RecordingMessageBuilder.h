@@ -0,0 +1,129 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef RECORDINGMESSAGEBUILDER_H
+#define RECORDINGMESSAGEBUILDER_H
+#include "RecordingMessageBuilder_fwd.h"
+#include <Common/QuickFAST_Export.h>
+#include <Messages/ValueMessageBuilder.h>
+#include <Messages/RecordedMessage.h>
+
+namespace QuickFAST{
+  namespace Messages{
+    /// @brief A ValueMessageBuilder that records each message for later replay.
+    ///
+    /// A derived class decides where the recordings come from and what
+    /// becomes of them by implementing nextRecording() and messageRecorded().
+    /// When nextRecording() has nothing to offer the message is still decoded
+    /// but recorded nowhere, and discarded() counts it.
+    ///
+    /// The Logger methods do not wait for replay.  They are forwarded at once
+    /// to the logger given to the constructor.
+    class QuickFAST_Export RecordingMessageBuilder : public ValueMessageBuilder
+    {
+    public:
+      /// @brief Construct
+      /// @param logger receives log messages and error reports as they happen.
+      explicit RecordingMessageBuilder(Common::Logger & logger);
+
+      virtual ~RecordingMessageBuilder();
+
+      /// @brief Statistic: How many messages were decoded but not recorded?
+      size_t discarded()const
+      {
+        return discarded_;
+      }
+
+      ///////////////////////////
+      // Implement ValueMessageBuilder
+      virtual const std::string & getApplicationType()const;
+      virtual const std::string & getApplicationTypeNs()const;
+      virtual void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const int64 value);
+      virtual void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const uint64 value);
+      virtual void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const int32 value);
+      virtual void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const uint32 value);
+      virtual void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const int16 value);
+      virtual void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const uint16 value);
+      virtual void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const int8 value);
+      virtual void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const uchar value);
+      virtual void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const Decimal& value);
+      virtual void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const unsigned char * value, size_t length);
+      virtual ValueMessageBuilder & startMessage(
+        const std::string & applicationType,
+        const std::string & applicationTypeNamespace,
+        size_t size);
+      virtual void setReceiveTime(uint64 nanoseconds);
+      virtual bool endMessage(ValueMessageBuilder & messageBuilder);
+      virtual bool ignoreMessage(ValueMessageBuilder & messageBuilder);
+      virtual ValueMessageBuilder & startSequence(
+        FieldIdentityCPtr & identity,
+        const std::string & applicationType,
+        const std::string & applicationTypeNamespace,
+        size_t fieldCount,
+        FieldIdentityCPtr & lengthIdentity,
+        size_t length);
+      virtual void endSequence(
+        FieldIdentityCPtr & identity,
+        ValueMessageBuilder & sequenceBuilder);
+      virtual ValueMessageBuilder & startSequenceEntry(
+        const std::string & applicationType,
+        const std::string & applicationTypeNamespace,
+        size_t size);
+      virtual void endSequenceEntry(ValueMessageBuilder & entry);
+      virtual ValueMessageBuilder & startGroup(
+        FieldIdentityCPtr & identity,
+        const std::string & applicationType,
+        const std::string & applicationTypeNamespace,
+        size_t size);
+      virtual void endGroup(
+        FieldIdentityCPtr & identity,
+        ValueMessageBuilder & groupBuilder);
+
+      ///////////////////
+      // Implement Logger
+      virtual bool wantLog(unsigned short level);
+      virtual bool logMessage(unsigned short level, const std::string & logMessage);
+      virtual bool reportDecodingError(const std::string & errorMessage);
+      virtual bool reportCommunicationError(const std::string & errorMessage);
+
+    protected:
+      /// @brief Supply an empty recording for the message that is starting.
+      /// @returns the recording, or zero to decode the message without recording it.
+      virtual RecordedMessage * nextRecording() = 0;
+
+      /// @brief Take charge of a complete recording.
+      /// @param recording holds the message.  It was supplied by nextRecording().
+      /// @returns false to stop decoding.
+      virtual bool messageRecorded(RecordedMessage & recording) = 0;
+
+      /// @brief Should decoding continue after a message that was not recorded?
+      /// @returns true unless overridden.
+      virtual bool keepDecoding();
+
+    private:
+      RecordingMessageBuilder(const RecordingMessageBuilder &);
+      RecordingMessageBuilder & operator=(const RecordingMessageBuilder &);
+
+      RecordedMessage & current()
+      {
+        // values outside a message are recorded nowhere.
+        return current_ != 0 ? *current_ : discard_;
+      }
+      void pushScope(const std::string & applicationType, const std::string & applicationTypeNamespace);
+      void popScope();
+      bool finishMessage(bool ignored);
+
+    private:
+      Common::Logger & logger_;
+      RecordedMessage * current_;
+      RecordedMessage discard_;
+      uint64 receiveTime_;
+      std::vector<const std::string *> scopes_;
+      size_t discarded_;
+    };
+  }
+}
+#endif // RECORDINGMESSAGEBUILDER_H
@@ -30,6 +30,10 @@ namespace QuickFAST{
         size_t sequenceLength)
         : lengthIdentity_(lengthFieldIdentity)
       {
+        if(lengthIdentity_)
+        {
+          keepers_.hold(*lengthIdentity_);
+        }
         this->entries_.reserve(sequenceLength);
       }
 
@@ -97,6 +101,8 @@ namespace QuickFAST{
       Sequence& operator=(const Sequence&);
     private:
       std::string applicationType_;
+      /// Declared first so it outlives lengthIdentity_.
+      IdentityKeeperSet keepers_;
       Messages::FieldIdentityCPtr lengthIdentity_;
       Entries entries_;
     };
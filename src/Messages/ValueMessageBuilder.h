@@ -84,6 +84,10 @@ namespace QuickFAST{
       virtual void addValue(FieldIdentityCPtr & identity, ValueType::Type type, const Decimal& value) = 0;
       /// @brief Add a field to the set.
       ///
+      /// The value may point directly into the buffer supplied by the DataSource
+      /// rather than into a copy, so it is only guaranteed to be valid for the
+      /// duration of this call.  Builders that keep the value must copy it.
+      ///
       /// @param identity identifies this field
       /// @param type is the type of data to be added
       /// @param value is the value to be assigned.
@@ -102,6 +106,15 @@ namespace QuickFAST{
         const std::string & applicationTypeNamespace,
         size_t size) = 0;
 
+      /// @brief Learn when the data for the messages that follow arrived.
+      ///
+      /// Assemblers call this before decoding each message.  The default
+      /// implementation ignores it.
+      /// @param nanoseconds since the epoch (see LatencyHistogram::now()), or zero if unknown.
+      virtual void setReceiveTime(uint64 /*nanoseconds*/)
+      {
+      }
+
       /// @brief Finish a message.  Process the result.
       ///
       /// @param messageBuilder is the builder provided by startMessage()
@@ -110,6 +123,8 @@ namespace QuickFAST{
 
       /// @brief Finish a message.  Ignore the result.
       ///
+      /// The decoder also calls this to abandon a message it could not decode,
+      /// so sequences or groups started within the message may still be open.
       /// @param messageBuilder is the builder provided by startMessage()
       /// @returns true if decoding should continue
       virtual bool ignoreMessage(ValueMessageBuilder & messageBuilder) = 0;
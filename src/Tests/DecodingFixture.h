@@ -0,0 +1,279 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#ifdef _MSC_VER
+# pragma once
+#endif
+#ifndef DECODINGFIXTURE_H
+#define DECODINGFIXTURE_H
+// Templates, messages, and consumers shared by the decoding tests.
+// Include after boost/test/unit_test.hpp.
+#include <Codecs/Template.h>
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/FieldInstructionInt32.h>
+#include <Codecs/FieldInstructionUInt32.h>
+#include <Codecs/FieldInstructionInt64.h>
+#include <Codecs/FieldInstructionUInt64.h>
+#include <Codecs/FieldInstructionAscii.h>
+#include <Codecs/FieldInstructionGroup.h>
+#include <Codecs/FieldInstructionSequence.h>
+#include <Codecs/FieldOpConstant.h>
+#include <Codecs/FieldOpCopy.h>
+#include <Codecs/FieldOpDefault.h>
+#include <Codecs/FieldOpDelta.h>
+#include <Codecs/FieldOpIncrement.h>
+#include <Codecs/FieldOpNop.h>
+#include <Codecs/Encoder.h>
+#include <Codecs/DataDestination.h>
+#include <Codecs/MessageConsumer.h>
+#include <Messages/Message.h>
+#include <Messages/FieldIdentity.h>
+#include <Messages/FieldInt32.h>
+#include <Messages/FieldUInt32.h>
+#include <Messages/FieldInt64.h>
+#include <Messages/FieldUInt64.h>
+#include <Messages/FieldAscii.h>
+#include <Messages/FieldSequence.h>
+#include <Messages/Sequence.h>
+
+namespace QuickFAST{
+  namespace Tests{
+    /// Add a field with the given operator (and optional initial value) to a template.
+    inline void addField(
+      Codecs::TemplatePtr & templ,
+      Codecs::FieldInstructionPtr instruction,
+      Codecs::FieldOp * op,
+      bool mandatory,
+      const char * value = 0)
+    {
+      instruction->setPresence(mandatory);
+      Codecs::FieldOpPtr fieldOp(op);
+      if(value != 0)
+      {
+        fieldOp->setValue(value);
+      }
+      instruction->setFieldOp(fieldOp);
+      templ->addInstruction(instruction);
+    }
+
+    /// Add a mandatory copied uint32 field to a segment.
+    inline void addCopyField(Codecs::SegmentBody & segment, const char * name)
+    {
+      Codecs::FieldInstructionPtr instruction(new Codecs::FieldInstructionUInt32(name, ""));
+      instruction->setFieldOp(Codecs::FieldOpPtr(new Codecs::FieldOpCopy));
+      segment.addInstruction(instruction);
+    }
+
+    /// Add a group named name holding body to a segment.
+    inline void addGroup(Codecs::SegmentBody & segment, const char * name, Codecs::SegmentBodyPtr body)
+    {
+      body->setApplicationType(name, "");
+      Codecs::FieldInstructionGroup * group = new Codecs::FieldInstructionGroup(name, "");
+      group->setSegmentBody(body);
+      Codecs::FieldInstructionPtr instruction(group);
+      segment.addInstruction(instruction);
+    }
+
+    /// A registry holding template 1, "Plan", with a field for each kind of operator.
+    inline Codecs::TemplateRegistryPtr createPlanRegistry()
+    {
+      Codecs::TemplatePtr templ(new Codecs::Template);
+      templ->setId(1);
+      templ->setTemplateName("Plan");
+      addField(templ, Codecs::FieldInstructionPtr(new Codecs::FieldInstructionUInt32("copyU32", "")), new Codecs::FieldOpCopy, true);
+      addField(templ, Codecs::FieldInstructionPtr(new Codecs::FieldInstructionInt32("deltaI32", "")), new Codecs::FieldOpDelta, false);
+      addField(templ, Codecs::FieldInstructionPtr(new Codecs::FieldInstructionUInt64("incrementU64", "")), new Codecs::FieldOpIncrement, true, "1");
+      addField(templ, Codecs::FieldInstructionPtr(new Codecs::FieldInstructionInt64("defaultI64", "")), new Codecs::FieldOpDefault, false, "-5");
+      addField(templ, Codecs::FieldInstructionPtr(new Codecs::FieldInstructionUInt32("constantU32", "")), new Codecs::FieldOpConstant, true, "7");
+      addField(templ, Codecs::FieldInstructionPtr(new Codecs::FieldInstructionInt32("nopI32", "")), new Codecs::FieldOpNop, false);
+      addField(templ, Codecs::FieldInstructionPtr(new Codecs::FieldInstructionAscii("copyAscii", "")), new Codecs::FieldOpCopy, true);
+
+      Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+      registry->addTemplate(templ);
+      registry->finalize();
+      return registry;
+    }
+
+    /// Identities for building messages to be encoded with the Plan template.
+    struct PlanIdentities
+    {
+      PlanIdentities()
+        : copyU32_(new Messages::FieldIdentity("copyU32"))
+        , deltaI32_(new Messages::FieldIdentity("deltaI32"))
+        , incrementU64_(new Messages::FieldIdentity("incrementU64"))
+        , defaultI64_(new Messages::FieldIdentity("defaultI64"))
+        , constantU32_(new Messages::FieldIdentity("constantU32"))
+        , nopI32_(new Messages::FieldIdentity("nopI32"))
+        , copyAscii_(new Messages::FieldIdentity("copyAscii"))
+      {
+      }
+
+      /// Message nMsg of a typical Plan series: every third one leaves out deltaI32.
+      Messages::MessagePtr message(Codecs::TemplateRegistryPtr registry, size_t nMsg)const
+      {
+        Messages::MessagePtr msg(new Messages::Message(registry->maxFieldCount()));
+        msg->addField(copyU32_, Messages::FieldUInt32::create(uint32(nMsg)));
+        if(nMsg % 3 != 0)
+        {
+          msg->addField(deltaI32_, Messages::FieldInt32::create(-int32(nMsg)));
+        }
+        msg->addField(incrementU64_, Messages::FieldUInt64::create(uint64(nMsg + 1)));
+        msg->addField(constantU32_, Messages::FieldUInt32::create(7));
+        msg->addField(copyAscii_, Messages::FieldAscii::create(nMsg % 2 == 0 ? "even" : "odd"));
+        return msg;
+      }
+
+      Messages::FieldIdentityCPtr copyU32_;
+      Messages::FieldIdentityCPtr deltaI32_;
+      Messages::FieldIdentityCPtr incrementU64_;
+      Messages::FieldIdentityCPtr defaultI64_;
+      Messages::FieldIdentityCPtr constantU32_;
+      Messages::FieldIdentityCPtr nopI32_;
+      Messages::FieldIdentityCPtr copyAscii_;
+    };
+
+    /// Encode the first messageCount messages of the typical Plan series into one string.
+    inline std::string encodePlanMessages(Codecs::TemplateRegistryPtr registry, size_t messageCount)
+    {
+      PlanIdentities identities;
+      Codecs::Encoder encoder(registry);
+      Codecs::DataDestination destination;
+      for(size_t nMsg = 0; nMsg < messageCount; ++nMsg)
+      {
+        encoder.encodeMessage(destination, 1, *identities.message(registry, nMsg));
+      }
+      std::string fastString;
+      destination.toString(fastString);
+      return fastString;
+    }
+
+    /// A registry holding template 6, "Snapshot": seqNum followed by a sequence of prices.
+    inline Codecs::TemplateRegistryPtr createSnapshotRegistry()
+    {
+      Codecs::SegmentBodyPtr entry(new Codecs::SegmentBody);
+      addCopyField(*entry, "price");
+      entry->setApplicationType("Entry", "");
+      Codecs::FieldInstructionSequence * sequenceInstruction = new Codecs::FieldInstructionSequence("Entries", "");
+      sequenceInstruction->setSegmentBody(entry);
+      Codecs::FieldInstructionPtr instruction(sequenceInstruction);
+      Codecs::TemplatePtr templ(new Codecs::Template);
+      templ->setId(6);
+      templ->setTemplateName("Snapshot");
+      addCopyField(*templ, "seqNum");
+      templ->addInstruction(instruction);
+      Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+      registry->addTemplate(templ);
+      registry->finalize();
+      return registry;
+    }
+
+    /// Encode snapshots; message n has n * entriesPerMessage prices of n * 1000 + entry.
+    /// @param[out] expectedPrices receives every price in order.
+    inline std::string encodeSnapshots(
+      Codecs::TemplateRegistryPtr registry,
+      size_t messageCount,
+      size_t entriesPerMessage,
+      std::vector<uint32> & expectedPrices)
+    {
+      Messages::FieldIdentityCPtr identity_seqNum = new Messages::FieldIdentity("seqNum");
+      Messages::FieldIdentityCPtr identity_Entries = new Messages::FieldIdentity("Entries");
+      Messages::FieldIdentityCPtr identity_length = new Messages::FieldIdentity("length");
+      Messages::FieldIdentityCPtr identity_price = new Messages::FieldIdentity("price");
+      Codecs::Encoder encoder(registry);
+      Codecs::DataDestination destination;
+      for(size_t nMsg = 0; nMsg < messageCount; ++nMsg)
+      {
+        size_t length = nMsg * entriesPerMessage;
+        Messages::SequencePtr sequence(new Messages::Sequence(identity_length, length));
+        for(size_t nEntry = 0; nEntry < length; ++nEntry)
+        {
+          Messages::FieldSetPtr entrySet(new Messages::FieldSet(1));
+          uint32 price = uint32(nMsg * 1000 + nEntry);
+          entrySet->addField(identity_price, Messages::FieldUInt32::create(price));
+          sequence->addEntry(entrySet);
+          expectedPrices.push_back(price);
+        }
+        Messages::Message msg(registry->maxFieldCount());
+        msg.addField(identity_seqNum, Messages::FieldUInt32::create(uint32(nMsg)));
+        msg.addField(identity_Entries, Messages::FieldSequence::create(sequence));
+        encoder.encodeMessage(destination, 6, msg);
+      }
+      std::string fastString;
+      destination.toString(fastString);
+      return fastString;
+    }
+
+    /// A MessageConsumer that accepts everything and logs nothing.
+    class StubConsumer : public Codecs::MessageConsumer
+    {
+    public:
+      virtual bool consumeMessage(Messages::Message & /*message*/){return true;}
+      virtual void decodingStarted(){}
+      virtual void decodingStopped(){}
+      virtual bool wantLog(unsigned short){return false;}
+      virtual bool logMessage(unsigned short, const std::string &){return true;}
+      virtual bool reportDecodingError(const std::string &){return true;}
+      virtual bool reportCommunicationError(const std::string &){return true;}
+    };
+
+    /// Keep a printable copy of each message, its receive time, and the thread that delivered it.
+    class CollectingConsumer : public StubConsumer
+    {
+    public:
+      virtual bool consumeMessage(Messages::Message & message)
+      {
+        std::ostringstream text;
+        for(size_t nField = 0; nField < message.size(); ++nField)
+        {
+          text << message[nField].name() << '=' << message[nField].getField()->displayString() << ';';
+        }
+        messages_.push_back(text.str());
+        receiveTimes_.push_back(message.receiveTime());
+        thread_ = boost::this_thread::get_id();
+        return true;
+      }
+
+      std::vector<std::string> messages_;
+      std::vector<uint64> receiveTimes_;
+      boost::thread::id thread_;
+    };
+
+    /// Check each Snapshot while it is still alive; an arena backed message is gone afterwards.
+    class SnapshotConsumer : public StubConsumer
+    {
+    public:
+      virtual bool consumeMessage(Messages::Message & message)
+      {
+        Messages::FieldCPtr value;
+        BOOST_REQUIRE(message.getField("seqNum", value));
+        seqNums_.push_back(value->toUInt32());
+        BOOST_REQUIRE(message.getField("Entries", value));
+        const Messages::SequenceCPtr & sequence = value->toSequence();
+        for(Messages::Sequence::const_iterator it = sequence->begin(); it != sequence->end(); ++it)
+        {
+          BOOST_REQUIRE((*it)->getField("price", value));
+          prices_.push_back(value->toUInt32());
+        }
+        return true;
+      }
+
+      std::vector<uint32> seqNums_;
+      std::vector<uint32> prices_;
+    };
+
+    /// Check that two messages hold the same fields with the same values.
+    inline void compareMessages(const Messages::Message & expected, const Messages::Message & actual)
+    {
+      BOOST_REQUIRE_EQUAL(expected.size(), actual.size());
+      for(size_t nField = 0; nField < expected.size(); ++nField)
+      {
+        BOOST_CHECK_EQUAL(expected[nField].name(), actual[nField].name());
+        const Messages::FieldCPtr & expectedField = expected[nField].getField();
+        const Messages::FieldCPtr & actualField = actual[nField].getField();
+        BOOST_CHECK_EQUAL(expectedField->getType(), actualField->getType());
+        BOOST_CHECK_EQUAL(std::string(expectedField->displayString()), std::string(actualField->displayString()));
+      }
+    }
+  }
+}
+#endif // DECODINGFIXTURE_H
@@ -0,0 +1,278 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Codecs/ArbitratingAssembler.h>
+#include <Codecs/FixedSizeHeaderAnalyzer.h>
+#include <Codecs/FastEncodedHeaderAnalyzer.h>
+#include <Codecs/NoHeaderAnalyzer.h>
+#include <Codecs/DataSourceBuffer.h>
+#include <Codecs/Template.h>
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/FieldInstructionUInt32.h>
+#include <Codecs/FieldOpCopy.h>
+#include <Codecs/Encoder.h>
+#include <Codecs/DataDestination.h>
+#include <Codecs/GenericMessageBuilder.h>
+#include <Codecs/MessageConsumer.h>
+#include <Communication/BufferReceiver.h>
+#include <Messages/Message.h>
+#include <Messages/FieldUInt32.h>
+
+using namespace QuickFAST;
+
+namespace
+{
+  class SequenceConsumer : public Codecs::MessageConsumer
+  {
+  public:
+    SequenceConsumer()
+      : verbosity_(Common::Logger::QF_LOG_WARNING)
+    {
+    }
+    virtual bool consumeMessage(Messages::Message & message)
+    {
+      Messages::FieldCPtr value;
+      BOOST_REQUIRE(message.getField("seqNum", value));
+      seqNums_.push_back(value->toUInt32());
+      return true;
+    }
+    virtual void decodingStarted(){}
+    virtual void decodingStopped(){}
+    virtual bool wantLog(unsigned short level)
+    {
+      return level <= verbosity_;
+    }
+    virtual bool logMessage(unsigned short, const std::string & message)
+    {
+      warnings_.push_back(message);
+      return true;
+    }
+    virtual bool reportDecodingError(const std::string & message)
+    {
+      errors_.push_back(message);
+      return true;
+    }
+    virtual bool reportCommunicationError(const std::string &){return true;}
+
+    std::vector<uint32> seqNums_;
+    std::vector<std::string> warnings_;
+    std::vector<std::string> errors_;
+    unsigned short verbosity_;
+  };
+
+  Codecs::TemplateRegistryPtr sequenceTemplates()
+  {
+    Codecs::TemplatePtr templ(new Codecs::Template);
+    templ->setId(3);
+    templ->setTemplateName("Sequenced");
+    Codecs::FieldInstructionPtr instruction(new Codecs::FieldInstructionUInt32("seqNum", ""));
+    instruction->setFieldOp(Codecs::FieldOpPtr(new Codecs::FieldOpCopy));
+    templ->addInstruction(instruction);
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    registry->addTemplate(templ);
+    registry->finalize();
+    return registry;
+  }
+
+  /// A packet with a four byte big endian sequence number ahead of one message.
+  std::string makePacket(Codecs::TemplateRegistryPtr registry, uint32 sequence)
+  {
+    Messages::FieldIdentityCPtr identity_seqNum = new Messages::FieldIdentity("seqNum");
+    Codecs::Encoder encoder(registry);
+    Messages::Message msg(registry->maxFieldCount());
+    msg.addField(identity_seqNum, Messages::FieldUInt32::create(sequence));
+    Codecs::DataDestination destination;
+    encoder.encodeMessage(destination, 3, msg);
+    std::string encoded;
+    destination.toString(encoded);
+
+    std::string packet;
+    for(size_t nByte = 0; nByte < 4; ++nByte)
+    {
+      packet += char((sequence >> (8 * (3 - nByte))) & 0xFF);
+    }
+    return packet + encoded;
+  }
+
+  void deliver(Communication::BufferReceiver & receiver, const std::string & packet)
+  {
+    receiver.receiveBuffer(reinterpret_cast<const unsigned char *>(packet.data()), packet.size());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestArbitratingAssemblerAB)
+{
+  Codecs::TemplateRegistryPtr registry = sequenceTemplates();
+  SequenceConsumer consumer;
+  Codecs::GenericMessageBuilder builder(consumer);
+  Codecs::FixedSizeHeaderAnalyzer packetHeader(0, true, 4);
+  packetHeader.setSequenceNumber(0, 4);
+  Codecs::NoHeaderAnalyzer messageHeader;
+  Codecs::ArbitratingAssembler assembler(registry, packetHeader, messageHeader, builder);
+  assembler.setReset(true);
+
+  Communication::BufferReceiver feedA;
+  Communication::BufferReceiver feedB;
+  feedA.start(assembler);
+  feedB.start(assembler);
+  BOOST_CHECK_EQUAL(assembler.feedCount(), 2);
+
+  // A loses 4, B is the first to deliver 2 and 6, and both lose 7 and 8.
+  deliver(feedA, makePacket(registry, 1));
+  deliver(feedB, makePacket(registry, 1));
+  deliver(feedB, makePacket(registry, 2));
+  deliver(feedA, makePacket(registry, 2));
+  deliver(feedA, makePacket(registry, 3));
+  deliver(feedB, makePacket(registry, 3));
+  deliver(feedA, makePacket(registry, 5));
+  // too late to decode in order
+  deliver(feedB, makePacket(registry, 4));
+  deliver(feedB, makePacket(registry, 5));
+  deliver(feedB, makePacket(registry, 6));
+  deliver(feedA, makePacket(registry, 6));
+  deliver(feedA, makePacket(registry, 9));
+
+  const uint32 expected[] = {1, 2, 3, 5, 6, 9};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    consumer.seqNums_.begin(), consumer.seqNums_.end(),
+    expected, expected + sizeof(expected)/sizeof(expected[0]));
+  BOOST_CHECK_EQUAL(assembler.accepted(), 6);
+  BOOST_CHECK_EQUAL(assembler.duplicates(), 6);
+  BOOST_CHECK_EQUAL(assembler.gaps(), 2);
+  BOOST_CHECK_EQUAL(assembler.missing(), 3);
+  BOOST_CHECK_EQUAL(assembler.firstArrivals(0), 4);
+  BOOST_CHECK_EQUAL(assembler.firstArrivals(1), 2);
+  BOOST_CHECK_EQUAL(consumer.warnings_.size(), 2);
+  BOOST_CHECK(consumer.errors_.empty());
+
+  // A header too short to hold a sequence number is passed to the decoder, which rejects it.
+  deliver(feedA, std::string("\x00\x01", 2));
+  BOOST_CHECK_EQUAL(assembler.unsequenced(), 1);
+  BOOST_CHECK_EQUAL(consumer.errors_.size(), 1);
+
+  // The publisher started over.
+  deliver(feedB, makePacket(registry, 1));
+  BOOST_CHECK_EQUAL(assembler.duplicates(), 7);
+  assembler.restartSequence();
+  deliver(feedB, makePacket(registry, 1));
+  deliver(feedA, makePacket(registry, 1));
+  BOOST_CHECK_EQUAL(consumer.seqNums_.size(), 7);
+  BOOST_CHECK_EQUAL(assembler.duplicates(), 8);
+  BOOST_CHECK_EQUAL(assembler.gaps(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(TestArbitratingAssemblerRestart)
+{
+  Codecs::TemplateRegistryPtr registry = sequenceTemplates();
+  SequenceConsumer consumer;
+  Codecs::GenericMessageBuilder builder(consumer);
+  Codecs::FixedSizeHeaderAnalyzer packetHeader(0, true, 4);
+  packetHeader.setSequenceNumber(0, 4);
+  Codecs::NoHeaderAnalyzer messageHeader;
+  Codecs::ArbitratingAssembler assembler(registry, packetHeader, messageHeader, builder);
+  assembler.setReset(true);
+  assembler.setRestartWindow(3);
+
+  Communication::BufferReceiver feedA;
+  Communication::BufferReceiver feedB;
+  feedA.start(assembler);
+  feedB.start(assembler);
+
+  // Both feeds go through a restart after 10; B lags two packets behind A.
+  for(uint32 sequence = 1; sequence <= 10; ++sequence)
+  {
+    deliver(feedA, makePacket(registry, sequence));
+    if(sequence > 2)
+    {
+      deliver(feedB, makePacket(registry, sequence - 2));
+    }
+  }
+  for(uint32 sequence = 1; sequence <= 5; ++sequence)
+  {
+    deliver(feedA, makePacket(registry, sequence));
+    // B still sends 9 and 10 from before the restart after A has restarted.
+    deliver(feedB, makePacket(registry, sequence <= 2 ? sequence + 8 : sequence - 2));
+  }
+  for(uint32 sequence = 4; sequence <= 6; ++sequence)
+  {
+    deliver(feedB, makePacket(registry, sequence));
+  }
+  deliver(feedA, makePacket(registry, 6));
+
+  const uint32 expected[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 1, 2, 3, 4, 5, 6};
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    consumer.seqNums_.begin(), consumer.seqNums_.end(),
+    expected, expected + sizeof(expected)/sizeof(expected[0]));
+  BOOST_CHECK_EQUAL(assembler.restarts(), 1);
+  BOOST_CHECK_EQUAL(assembler.gaps(), 0);
+  BOOST_CHECK_EQUAL(assembler.duplicates(), 8 + 2 + 5 + 1);
+  BOOST_CHECK_EQUAL(assembler.firstArrivals(0), 15);
+  BOOST_CHECK_EQUAL(assembler.firstArrivals(1), 1);
+  BOOST_REQUIRE_EQUAL(consumer.warnings_.size(), 1);
+  BOOST_CHECK_EQUAL(consumer.warnings_[0], "Sequence restart: expecting 11 received 1");
+  BOOST_CHECK(consumer.errors_.empty());
+}
+
+BOOST_AUTO_TEST_CASE(TestArbitratingAssemblerStartStop)
+{
+  Codecs::TemplateRegistryPtr registry = sequenceTemplates();
+  SequenceConsumer consumer;
+  consumer.verbosity_ = Common::Logger::QF_LOG_INFO;
+  Codecs::GenericMessageBuilder builder(consumer);
+  Codecs::FixedSizeHeaderAnalyzer packetHeader(0, true, 4);
+  packetHeader.setSequenceNumber(0, 4);
+  Codecs::NoHeaderAnalyzer messageHeader;
+  Codecs::ArbitratingAssembler assembler(registry, packetHeader, messageHeader, builder);
+
+  // The shared decoder starts with the first feed and stops with the last.
+  Communication::BufferReceiver feedA;
+  Communication::BufferReceiver feedB;
+  assembler.receiverStarted(feedA);
+  assembler.receiverStarted(feedB);
+  BOOST_CHECK_EQUAL(assembler.feedCount(), 2);
+  BOOST_REQUIRE_EQUAL(consumer.warnings_.size(), 1);
+  BOOST_CHECK_EQUAL(consumer.warnings_[0], "Receiver started");
+  assembler.receiverStopped(feedA);
+  BOOST_CHECK_EQUAL(consumer.warnings_.size(), 1);
+  assembler.receiverStopped(feedB);
+  BOOST_REQUIRE_EQUAL(consumer.warnings_.size(), 2);
+  BOOST_CHECK_EQUAL(consumer.warnings_[1], "Receiver stopped");
+}
+
+BOOST_AUTO_TEST_CASE(TestHeaderAnalyzerSequenceNumbers)
+{
+  size_t blockSize = 0;
+  bool skip = false;
+  uint64 sequence = 0;
+
+  // prefix: 2 byte channel, 3 byte little endian sequence number; then a 2 byte size.
+  const unsigned char fixed[] = {0x09, 0x00, 0x03, 0x02, 0x01, 0x05, 0x00};
+  Codecs::FixedSizeHeaderAnalyzer fixedAnalyzer(2, false, 5);
+  BOOST_CHECK(!fixedAnalyzer.getSequenceNumber(sequence));
+  fixedAnalyzer.setSequenceNumber(2, 3);
+  Codecs::DataSourceBuffer fixedSource(fixed, sizeof(fixed));
+  BOOST_REQUIRE(fixedAnalyzer.analyzeHeader(fixedSource, blockSize, skip));
+  BOOST_CHECK_EQUAL(blockSize, 5);
+  BOOST_REQUIRE(fixedAnalyzer.getSequenceNumber(sequence));
+  BOOST_CHECK_EQUAL(sequence, 0x010203);
+
+  // prefix: two FAST fields, the second is the sequence number (300).
+  const unsigned char fast[] = {0x81, 0x02, 0xAC, 0x85};
+  Codecs::FastEncodedHeaderAnalyzer fastAnalyzer(2, 0, true);
+  fastAnalyzer.setSequenceNumberField(1);
+  Codecs::DataSourceBuffer fastSource(fast, sizeof(fast));
+  BOOST_REQUIRE(fastAnalyzer.analyzeHeader(fastSource, blockSize, skip));
+  BOOST_CHECK_EQUAL(blockSize, 5);
+  BOOST_REQUIRE(fastAnalyzer.getSequenceNumber(sequence));
+  BOOST_CHECK_EQUAL(sequence, 300);
+
+  // an incomplete header has no sequence number.
+  Codecs::DataSourceBuffer shortSource(fast, 2);
+  BOOST_CHECK(!fastAnalyzer.analyzeHeader(shortSource, blockSize, skip));
+  BOOST_CHECK(!fastAnalyzer.getSequenceNumber(sequence));
+}
@@ -0,0 +1,210 @@
+// Copyright (c) 2011, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <Communication/AsynchFileReceiver.h>
+
+#if defined(QUICKFAST_HAS_IO_URING)
+#include <Communication/Assembler.h>
+#include <Communication/LinkedBuffer.h>
+#include <Codecs/TemplateRegistry.h>
+
+using namespace QuickFAST;
+
+namespace
+{
+  const size_t bufferSize = 4096;
+
+  class RecordingLogger : public Common::Logger
+  {
+  public:
+    virtual bool wantLog(unsigned short level)
+    {
+      return level <= Common::Logger::QF_LOG_WARNING;
+    }
+    virtual bool logMessage(unsigned short, const std::string &){return true;}
+    virtual bool reportDecodingError(const std::string & message)
+    {
+      errors_.push_back(message);
+      return true;
+    }
+    virtual bool reportCommunicationError(const std::string & message)
+    {
+      errors_.push_back(message);
+      return true;
+    }
+
+    std::vector<std::string> errors_;
+  };
+
+  /// Keep a copy of every byte the receiver delivers, in the order delivered.
+  class CopyingAssembler : public Communication::Assembler
+  {
+  public:
+    CopyingAssembler(Common::Logger & logger, size_t stopAfter = 0)
+      : Communication::Assembler(Codecs::TemplateRegistryPtr(new Codecs::TemplateRegistry), logger)
+      , stopAfter_(stopAfter)
+      , buffers_(0)
+      , started_(0)
+      , inArena_(true)
+    {
+    }
+
+    virtual void receiverStarted(Communication::Receiver &)
+    {
+      ++started_;
+    }
+
+    virtual void receiverStopped(Communication::Receiver &)
+    {
+    }
+
+    virtual bool serviceQueue(Communication::Receiver & receiver)
+    {
+      Communication::LinkedBuffer * buffer = receiver.getBuffer(false);
+      while(buffer != 0)
+      {
+        data_.append(reinterpret_cast<const char *>(buffer->get()), buffer->used());
+        // Arena slices have no capacity of their own and keep the arena's alignment.
+        inArena_ = inArena_
+          && buffer->capacity() == 0
+          && (reinterpret_cast<size_t>(buffer->get()) % 4096) == 0;
+        ++buffers_;
+        receiver.releaseBuffer(buffer);
+        if(stopAfter_ != 0 && buffers_ >= stopAfter_)
+        {
+          return false;
+        }
+        buffer = receiver.getBuffer(false);
+      }
+      return true;
+    }
+
+    std::string data_;
+    size_t stopAfter_;
+    size_t buffers_;
+    size_t started_;
+    bool inArena_;
+  };
+
+  std::string fileName()
+  {
+    return std::string(std::getenv("QUICKFAST_ROOT")) + "/src/Tests/resources/asynchFileReceiverTest.out";
+  }
+
+  std::string writeTestFile(size_t size)
+  {
+    std::string contents;
+    for(size_t pos = 0; pos < size; ++pos)
+    {
+      contents += char(pos % 251);
+    }
+    std::ofstream file(fileName().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), contents.size());
+    return contents;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestAsynchFileReceiverInOrder)
+{
+  if(!Communication::UringFileReader::isSupported())
+  {
+    BOOST_TEST_MESSAGE("io_uring is not available.  Skipping TestAsynchFileReceiverInOrder.");
+    return;
+  }
+  // Many buffers with several reads in flight; the last one is short.
+  std::string contents = writeTestFile(bufferSize * 50 - 123);
+  RecordingLogger logger;
+  CopyingAssembler assembler(logger);
+  {
+    // a private io_service, since the shared one stays stopped once run() returns
+    boost::asio::io_service ioService;
+    Communication::AsynchFileReceiver receiver(ioService, fileName());
+    receiver.setReadDepth(6);
+    BOOST_REQUIRE(receiver.start(assembler, bufferSize, 8));
+    receiver.run();
+  }
+  BOOST_CHECK_EQUAL(assembler.started_, 1);
+  BOOST_CHECK(logger.errors_.empty());
+  BOOST_CHECK_EQUAL(assembler.data_.size(), contents.size());
+  BOOST_CHECK(assembler.data_ == contents);
+  // every buffer was a slice of the arena registered with the kernel.
+  BOOST_CHECK(assembler.inArena_);
+  boost::filesystem::remove(fileName());
+}
+
+BOOST_AUTO_TEST_CASE(TestAsynchFileReceiverEndOfFile)
+{
+  if(!Communication::UringFileReader::isSupported())
+  {
+    BOOST_TEST_MESSAGE("io_uring is not available.  Skipping TestAsynchFileReceiverEndOfFile.");
+    return;
+  }
+  // An exact number of buffers, so the end is found by a read that returns nothing.
+  const size_t sizes[] = {0, bufferSize, bufferSize * 3};
+  for(size_t nSize = 0; nSize < sizeof(sizes) / sizeof(sizes[0]); ++nSize)
+  {
+    std::string contents = writeTestFile(sizes[nSize]);
+    RecordingLogger logger;
+    CopyingAssembler assembler(logger);
+    boost::asio::io_service ioService;
+    Communication::AsynchFileReceiver receiver(ioService, fileName());
+    BOOST_REQUIRE(receiver.start(assembler, bufferSize, 4));
+    // returns once the file is exhausted
+    receiver.run();
+    BOOST_CHECK(logger.errors_.empty());
+    BOOST_CHECK(assembler.data_ == contents);
+  }
+  boost::filesystem::remove(fileName());
+
+  RecordingLogger logger;
+  CopyingAssembler assembler(logger);
+  boost::asio::io_service ioService;
+  Communication::AsynchFileReceiver missing(ioService, fileName() + ".missing");
+  BOOST_CHECK(!missing.start(assembler, bufferSize, 4));
+  BOOST_CHECK_EQUAL(logger.errors_.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(TestAsynchFileReceiverStop)
+{
+  if(!Communication::UringFileReader::isSupported())
+  {
+    BOOST_TEST_MESSAGE("io_uring is not available.  Skipping TestAsynchFileReceiverStop.");
+    return;
+  }
+  std::string contents = writeTestFile(bufferSize * 200);
+  RecordingLogger logger;
+  // The assembler asks the receiver to stop after three buffers.
+  CopyingAssembler assembler(logger, 3);
+  {
+    boost::asio::io_service ioService;
+    Communication::AsynchFileReceiver receiver(ioService, fileName());
+    receiver.setReadDepth(8);
+    BOOST_REQUIRE(receiver.start(assembler, bufferSize, 12));
+    receiver.run();
+    // Reads may still be in flight into the arena; destroying the receiver waits for them.
+  }
+  BOOST_CHECK_EQUAL(assembler.buffers_, 3);
+  BOOST_CHECK(assembler.data_ == contents.substr(0, assembler.data_.size()));
+  BOOST_CHECK(assembler.data_.size() < contents.size());
+
+  // stop() from outside while the receiver is busy.
+  CopyingAssembler unlimited(logger);
+  {
+    boost::asio::io_service ioService;
+    Communication::AsynchFileReceiver receiver(ioService, fileName());
+    BOOST_REQUIRE(receiver.start(unlimited, bufferSize, 12));
+    receiver.stop();
+    receiver.run();
+  }
+  BOOST_CHECK(unlimited.data_ == contents.substr(0, unlimited.data_.size()));
+  BOOST_CHECK(logger.errors_.empty());
+  boost::filesystem::remove(fileName());
+}
+
+#endif // QUICKFAST_HAS_IO_URING
@@ -0,0 +1,238 @@
+// Copyright (c) 2011, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Tests/DecodingFixture.h>
+#include <Codecs/ChannelGroup.h>
+#include <Codecs/GenericMessageBuilder.h>
+#include <Common/AtomicOps.h>
+#include <Common/Exceptions.h>
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+namespace
+{
+  const char * const multicastGroup = "239.255.0.2";
+
+  /// Count a channel's messages and remember the thread that delivered them.
+  class ChannelConsumer : public StubConsumer
+  {
+  public:
+    ChannelConsumer()
+      : messages_(0)
+      , errors_(0)
+    {
+    }
+
+    virtual bool consumeMessage(Messages::Message &)
+    {
+      thread_ = boost::this_thread::get_id();
+      atomic_increment_long(&messages_);
+      return true;
+    }
+
+    /// The channel stops itself when it cannot decode a packet.
+    virtual bool reportDecodingError(const std::string &)
+    {
+      atomic_increment_long(&errors_);
+      return false;
+    }
+
+    /// @brief Wait up to five seconds for a counter to reach a value.
+    static bool waitFor(const volatile long & counter, long expected)
+    {
+      for(size_t nWait = 0; nWait < 500 && atomicLoadAcquire(&counter) < expected; ++nWait)
+      {
+        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+      }
+      return atomicLoadAcquire(&counter) >= expected;
+    }
+
+    volatile long messages_;
+    volatile long errors_;
+    boost::thread::id thread_;
+  };
+
+  /// Everything the group needs to decode one channel.
+  struct TestChannel
+  {
+    TestChannel()
+      : builder_(consumer_)
+    {
+    }
+    ChannelConsumer consumer_;
+    Codecs::GenericMessageBuilder builder_;
+  };
+
+  unsigned short channelPort(size_t channel)
+  {
+    return static_cast<unsigned short>(30411 + channel);
+  }
+
+  void sendPacket(size_t channel, const std::string & packet)
+  {
+    boost::asio::io_service ioService;
+    boost::asio::ip::udp::socket socket(ioService, boost::asio::ip::udp::v4());
+    socket.set_option(boost::asio::ip::multicast::outbound_interface(boost::asio::ip::address_v4::loopback()));
+    socket.set_option(boost::asio::ip::multicast::enable_loopback(true));
+    boost::asio::ip::udp::endpoint target(boost::asio::ip::address::from_string(multicastGroup), channelPort(channel));
+    socket.send_to(boost::asio::buffer(packet), target);
+  }
+
+  void addChannels(
+    Codecs::ChannelGroup & group,
+    Codecs::TemplateRegistryPtr registry,
+    TestChannel * channels,
+    size_t count)
+  {
+    for(size_t nChannel = 0; nChannel < count; ++nChannel)
+    {
+      std::stringstream name;
+      name << "channel" << nChannel;
+      group.addChannel(
+        name.str(),
+        registry,
+        multicastGroup,
+        "127.0.0.1",
+        "0.0.0.0",
+        channelPort(nChannel),
+        channels[nChannel].builder_);
+    }
+  }
+
+  /// @brief Start the group, or explain why multicast on the loopback interface is unavailable.
+  bool startGroup(Codecs::ChannelGroup & group)
+  {
+    try
+    {
+      group.start();
+      return true;
+    }
+    catch(const std::exception & ex)
+    {
+      BOOST_TEST_MESSAGE("Multicast on the loopback interface is not available: " << ex.what());
+    }
+    return false;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestChannelGroupAssignment)
+{
+  Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+  TestChannel channels[5];
+  Codecs::ChannelGroup group(2);
+  addChannels(group, registry, channels, 5);
+  BOOST_CHECK_EQUAL(group.workerCount(), 2);
+  BOOST_CHECK_EQUAL(group.channelCount(), 5);
+  for(size_t nChannel = 0; nChannel < group.channelCount(); ++nChannel)
+  {
+    Codecs::ChannelStatistics statistics;
+    group.getStatistics(nChannel, statistics);
+    BOOST_CHECK_EQUAL(statistics.worker_, nChannel % 2);
+    BOOST_CHECK_EQUAL(statistics.name_, std::string("channel") + char('0' + nChannel));
+  }
+  BOOST_CHECK_THROW(group.receiver(5), UsageError);
+
+  // zero workers still means one.
+  Codecs::ChannelGroup single(0);
+  BOOST_CHECK_EQUAL(single.workerCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(TestChannelGroupStartStop)
+{
+  Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+  std::string packet = encodePlanMessages(registry, 3);
+  TestChannel channels[3];
+  Codecs::ChannelGroup group(2);
+  addChannels(group, registry, channels, 3);
+  if(!startGroup(group))
+  {
+    return;
+  }
+  BOOST_CHECK_THROW(
+    group.addChannel("late", registry, multicastGroup, "127.0.0.1", "0.0.0.0", channelPort(3), channels[0].builder_),
+    UsageError);
+  for(size_t nChannel = 0; nChannel < 3; ++nChannel)
+  {
+    sendPacket(nChannel, packet);
+  }
+  for(size_t nChannel = 0; nChannel < 3; ++nChannel)
+  {
+    BOOST_CHECK(ChannelConsumer::waitFor(channels[nChannel].consumer_.messages_, 3));
+  }
+  group.stop();
+  group.joinThreads();
+
+  // each channel was decoded by its own worker.
+  BOOST_CHECK(channels[0].consumer_.thread_ == channels[2].consumer_.thread_);
+  BOOST_CHECK(channels[0].consumer_.thread_ != channels[1].consumer_.thread_);
+  BOOST_CHECK(channels[0].consumer_.thread_ != boost::this_thread::get_id());
+  for(size_t nChannel = 0; nChannel < 3; ++nChannel)
+  {
+    BOOST_CHECK_EQUAL(channels[nChannel].consumer_.messages_, 3);
+    BOOST_CHECK_EQUAL(channels[nChannel].consumer_.errors_, 0);
+    Codecs::ChannelStatistics statistics;
+    group.getStatistics(nChannel, statistics);
+    BOOST_CHECK_EQUAL(statistics.packetsReceived_, 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestChannelGroupChannelStops)
+{
+  Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+  std::string packet = encodePlanMessages(registry, 3);
+  // an undefined template ID.
+  std::string bad("\xC0\x85", 2);
+  TestChannel channels[3];
+  Codecs::ChannelGroup group(2);
+  addChannels(group, registry, channels, 3);
+  if(!startGroup(group))
+  {
+    return;
+  }
+
+  // Channel 1 is alone on worker 1.  Stopping it stops only that worker.
+  sendPacket(1, bad);
+  BOOST_CHECK(ChannelConsumer::waitFor(channels[1].consumer_.errors_, 1));
+  sendPacket(0, packet);
+  sendPacket(2, packet);
+  BOOST_CHECK(ChannelConsumer::waitFor(channels[0].consumer_.messages_, 3));
+  BOOST_CHECK(ChannelConsumer::waitFor(channels[2].consumer_.messages_, 3));
+
+  // joinThreads() returns although worker 1 stopped long ago.
+  group.stop();
+  group.joinThreads();
+  BOOST_CHECK_EQUAL(channels[1].consumer_.messages_, 0);
+  BOOST_CHECK_EQUAL(channels[1].consumer_.errors_, 1);
+}
+
+BOOST_AUTO_TEST_CASE(TestChannelGroupCountsMessages)
+{
+  Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+  // two packets carrying five messages between them.
+  std::string first = encodePlanMessages(registry, 3);
+  std::string second = encodePlanMessages(registry, 2);
+  TestChannel channels[1];
+  Codecs::ChannelGroup group(1);
+  addChannels(group, registry, channels, 1);
+  if(!startGroup(group))
+  {
+    return;
+  }
+  sendPacket(0, first);
+  sendPacket(0, second);
+  BOOST_CHECK(ChannelConsumer::waitFor(channels[0].consumer_.messages_, 5));
+  group.stop();
+  group.joinThreads();
+
+  Codecs::ChannelStatistics statistics;
+  group.getStatistics(0, statistics);
+  BOOST_CHECK_EQUAL(statistics.packetsReceived_, 2);
+  BOOST_CHECK_EQUAL(statistics.messagesDecoded_, 5);
+  BOOST_CHECK_EQUAL(channels[0].consumer_.messages_, 5);
+}
@@ -8,10 +8,20 @@
 #include <boost/filesystem.hpp>
 
 #include <Communication/LinkedBuffer.h>
+#include <Communication/BufferRing.h>
+#include <Communication/AtomicQueue.h>
 #include <Common/StringBuffer.h>
 #include <Common/WorkingBuffer.h>
+#include <Common/Arena.h>
+#include <Common/LatencyHistogram.h>
+#include <Common/ThreadOptions.h>
+#include <Common/Logger.h>
+#include <Application/DecoderConfiguration.h>
 #include <Common/Exceptions.h>
 #include <Common/Decimal.h>
+#include <Messages/FieldPool.h>
+#include <Messages/FieldUInt32.h>
+#include <Messages/FieldAscii.h>
 
 using namespace QuickFAST;
 BOOST_AUTO_TEST_CASE(TestLinkedBuffer)
@@ -336,6 +346,175 @@ BOOST_AUTO_TEST_CASE(TestSingleServerBufferQueue)
   }
 }
 
+namespace
+{
+  /// Push buffers[0..count) in order, retrying while the ring is full.
+  void fillRing(Communication::BufferRing * ring, Communication::LinkedBuffer * buffers, size_t count)
+  {
+    for(size_t nBuffer = 0; nBuffer < count; ++nBuffer)
+    {
+      while(!ring->push(&buffers[nBuffer]))
+      {
+        boost::this_thread::yield();
+      }
+    }
+  }
+
+  /// Consume from several producers, checking each one's buffers arrive in order.
+  void drainRing(Communication::BufferRing & ring, size_t producers, size_t count)
+  {
+    std::vector<size_t> expected(producers, 0);
+    for(size_t nBuffer = 0; nBuffer < producers * count; ++nBuffer)
+    {
+      Communication::LinkedBuffer * buffer = ring.popWait();
+      BOOST_REQUIRE(buffer != 0);
+      size_t producer = reinterpret_cast<size_t>(buffer->extra());
+      BOOST_REQUIRE(producer < producers);
+      BOOST_CHECK_EQUAL(buffer->used(), expected[producer]);
+      ++expected[producer];
+    }
+    BOOST_CHECK(ring.pop() == 0);
+  }
+
+  void runRing(Communication::BufferRing & ring, size_t producers, size_t count)
+  {
+    std::vector<Communication::LinkedBuffer> buffers(producers * count);
+    for(size_t nBuffer = 0; nBuffer < buffers.size(); ++nBuffer)
+    {
+      buffers[nBuffer].setUsed(nBuffer % count);
+      buffers[nBuffer].setExtra(reinterpret_cast<void *>(nBuffer / count));
+    }
+    boost::thread_group threads;
+    for(size_t nProducer = 0; nProducer < producers; ++nProducer)
+    {
+      threads.create_thread(boost::bind(fillRing, &ring, &buffers[nProducer * count], count));
+    }
+    drainRing(ring, producers, count);
+    threads.join_all();
+    BOOST_CHECK_EQUAL(ring.pushes(), producers * count);
+    BOOST_CHECK_EQUAL(ring.pops(), producers * count);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestBufferRing)
+{
+  Communication::BufferRing ring(3);
+  BOOST_CHECK_EQUAL(ring.capacity(), 4);
+  BOOST_CHECK(ring.isEmpty());
+  BOOST_CHECK(ring.pop() == 0);
+
+  Communication::LinkedBuffer buffers[5];
+  for(size_t loop = 0; loop < 3; ++loop)
+  {
+    for(size_t nBuffer = 0; nBuffer < 4; ++nBuffer)
+    {
+      BOOST_CHECK(ring.push(&buffers[nBuffer]));
+    }
+    // full
+    BOOST_CHECK(!ring.push(&buffers[4]));
+    BOOST_CHECK(ring.peek(0) == &buffers[0]);
+    BOOST_CHECK(ring.peek(3) == &buffers[3]);
+    BOOST_CHECK(ring.peek(4) == 0);
+    BOOST_CHECK(ring.pop() == &buffers[0]);
+    BOOST_CHECK(ring.push(&buffers[4]));
+    for(size_t nBuffer = 1; nBuffer < 5; ++nBuffer)
+    {
+      BOOST_CHECK(ring.pop() == &buffers[nBuffer]);
+    }
+    BOOST_CHECK(ring.pop() == 0);
+  }
+  BOOST_CHECK_EQUAL(ring.fullCount(), 3);
+  BOOST_CHECK_EQUAL(ring.pushes(), 15);
+  BOOST_CHECK_EQUAL(ring.pops(), 15);
+
+  // an interrupted consumer does not wait.
+  ring.interrupt();
+  BOOST_CHECK(ring.popWait() == 0);
+  ring.clearInterrupt();
+
+  const size_t count = 20000;
+  {
+    Communication::BufferRing spsc(64, Communication::BufferRing::SINGLE_PRODUCER, Communication::BufferRing::BLOCK);
+    runRing(spsc, 1, count);
+  }
+  {
+    Communication::BufferRing spsc(64, Communication::BufferRing::SINGLE_PRODUCER, Communication::BufferRing::BUSY_POLL);
+    runRing(spsc, 1, count);
+  }
+  {
+    Communication::BufferRing mpsc(64, Communication::BufferRing::MULTIPLE_PRODUCERS, Communication::BufferRing::BLOCK);
+    runRing(mpsc, 3, count);
+  }
+  {
+    Communication::BufferRing mpsc(64, Communication::BufferRing::MULTIPLE_PRODUCERS, Communication::BufferRing::BUSY_POLL);
+    runRing(mpsc, 3, count);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestSingleServerBufferRing)
+{
+  boost::mutex dummyMutex;
+  boost::mutex::scoped_lock lock(dummyMutex);
+
+  Communication::SingleServerBufferRing queue(2);
+  Communication::LinkedBuffer buffers[4];
+
+  for(size_t loop = 0; loop < 2; ++loop)
+  {
+    BOOST_CHECK( queue.push(&buffers[0], lock));
+    BOOST_CHECK( queue.startService(lock));
+    // be sure only one service at a time
+    BOOST_CHECK(!queue.startService(lock));
+    BOOST_CHECK(!queue.push(&buffers[1], lock));
+    // No batches: buffers pushed during service are seen immediately.
+    BOOST_CHECK( queue.serviceNext() == &buffers[0]);
+    BOOST_CHECK( queue.peekOutgoing() == &buffers[1]);
+    BOOST_CHECK( queue.serviceNext() == &buffers[1]);
+    BOOST_CHECK( queue.serviceNext() == 0);
+    BOOST_CHECK(!queue.endService(true, lock));
+  }
+
+  // Overflow keeps its place in line.
+  BOOST_CHECK( queue.push(&buffers[0], lock));
+  BOOST_CHECK( queue.push(&buffers[1], lock));
+  BOOST_CHECK( queue.push(&buffers[2], lock));
+  BOOST_CHECK_EQUAL(queue.overflows(), 1);
+  BOOST_CHECK( queue.startService(lock));
+  BOOST_CHECK( queue.serviceNext() == &buffers[0]);
+  BOOST_CHECK(!queue.push(&buffers[3], lock));
+  BOOST_CHECK_EQUAL(queue.overflows(), 2);
+  BOOST_CHECK( queue.serviceNext() == &buffers[1]);
+  BOOST_CHECK( queue.serviceNext() == 0);
+  BOOST_CHECK( queue.refresh(lock, false));
+  BOOST_CHECK( queue.serviceNext() == &buffers[2]);
+  BOOST_CHECK( queue.serviceNext() == &buffers[3]);
+  BOOST_CHECK(!queue.refresh(lock, false));
+  BOOST_CHECK(!queue.endService(true, lock));
+}
+
+BOOST_AUTO_TEST_CASE(TestAtomicSingleServerBufferQueue)
+{
+  boost::mutex dummyMutex;
+  boost::mutex::scoped_lock lock(dummyMutex);
+
+  Communication::AtomicSingleServerBufferQueue queue;
+  Communication::LinkedBuffer buffers[3];
+  for(size_t loop = 0; loop < 2; ++loop)
+  {
+    BOOST_CHECK( queue.push(&buffers[0], lock));
+    BOOST_CHECK(!queue.push(&buffers[1], lock));
+    BOOST_CHECK( queue.startService(lock));
+    BOOST_CHECK(!queue.push(&buffers[2], lock));
+    BOOST_CHECK( queue.serviceNext() == &buffers[0]);
+    BOOST_CHECK( queue.serviceNext() == &buffers[1]);
+    BOOST_CHECK( queue.serviceNext() == 0);
+    BOOST_CHECK( queue.endService(true, lock));
+    BOOST_CHECK( queue.serviceNext() == &buffers[2]);
+    BOOST_CHECK( queue.serviceNext() == 0);
+    BOOST_CHECK(!queue.endService(true, lock));
+  }
+}
+
 BOOST_AUTO_TEST_CASE(TestStringBuffer)
 {
   typedef StringBufferT<10> String10;
@@ -377,6 +556,39 @@ BOOST_AUTO_TEST_CASE(TestStringBuffer)
   BOOST_CHECK(s2.growCount() == 2);
 }
 
+BOOST_AUTO_TEST_CASE(TestStringBufferReplace)
+{
+  typedef StringBufferT<10> String10;
+  const unsigned char * abc(reinterpret_cast<const unsigned char *>("ABC"));
+  const unsigned char * xy(reinterpret_cast<const unsigned char *>("XY"));
+
+  String10 s1("12345");
+  s1.replaceBack(2, abc, 3);
+  BOOST_CHECK(s1 == "123ABC");
+  s1.replaceFront(4, xy, 2);
+  BOOST_CHECK(s1 == "XYBC");
+  s1.replaceFront(0, abc, 3);
+  BOOST_CHECK(s1 == "ABCXYBC");
+  s1.replaceBack(0, xy, 2);
+  BOOST_CHECK(s1 == "ABCXYBCXY");
+  // removing more than is there empties the string first.
+  s1.replaceFront(20, xy, 2);
+  BOOST_CHECK(s1 == "XY");
+  s1.replaceBack(20, abc, 0);
+  BOOST_CHECK(s1.empty());
+  BOOST_CHECK(s1 == "");
+  // all editing was done in the internal buffer.
+  BOOST_CHECK(s1.growCount() == 0);
+
+  String10 s2("123456789");
+  s2.replaceFront(1, abc, 3);
+  BOOST_CHECK(s2 == "ABC23456789");
+  BOOST_CHECK(s2.growCount() == 1);
+  s2.replaceBack(3, abc, 3);
+  BOOST_CHECK(s2 == "ABC23456ABC");
+  BOOST_CHECK(s2.growCount() == 1);
+}
+
 BOOST_AUTO_TEST_CASE(TestWorkingBuffer)
 {
   WorkingBuffer a;
@@ -504,3 +716,283 @@ BOOST_AUTO_TEST_CASE(TestDecimal)
   BOOST_CHECK_GT(f, g);
 
 }
+
+BOOST_AUTO_TEST_CASE(TestFieldPool)
+{
+  const size_t size = sizeof(Messages::FieldUInt32);
+  size_t available = Messages::FieldPool::available(size);
+  const void * address = 0;
+  {
+    Messages::FieldCPtr field = Messages::FieldUInt32::create(42);
+    address = field.get();
+    if(available > 0)
+    {
+      --available;
+    }
+    BOOST_CHECK_EQUAL(Messages::FieldPool::available(size), available);
+  }
+  // releasing the field recycles its memory...
+  BOOST_CHECK_EQUAL(Messages::FieldPool::available(size), available + 1);
+  {
+    // ...and the next field of that size reuses it.
+    Messages::FieldCPtr field = Messages::FieldUInt32::create(7);
+    BOOST_CHECK(field.get() == address);
+    BOOST_CHECK_EQUAL(field->toUInt32(), 7);
+    Messages::FieldCPtr ascii = Messages::FieldAscii::create("recycled");
+    BOOST_CHECK_EQUAL(ascii->toAscii(), "recycled");
+  }
+
+  // Sizes beyond the pooled range still work.
+  void * big = Messages::FieldPool::allocate(Messages::FieldPool::maxPooledSize + 1);
+  BOOST_CHECK(big != 0);
+  Messages::FieldPool::release(big, Messages::FieldPool::maxPooledSize + 1);
+  BOOST_CHECK_EQUAL(Messages::FieldPool::available(Messages::FieldPool::maxPooledSize + 1), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestArena)
+{
+  Arena arena(1024);
+  BOOST_CHECK_EQUAL(arena.capacity(), 0);
+  void * first = arena.allocate(1);
+  BOOST_CHECK_EQUAL(reinterpret_cast<size_t>(first) % Arena::alignment, 0);
+  void * second = arena.allocate(24);
+  BOOST_CHECK_EQUAL(static_cast<unsigned char *>(second) - static_cast<unsigned char *>(first), 16);
+  BOOST_CHECK_EQUAL(arena.allocated(), 48);
+  BOOST_CHECK_EQUAL(arena.capacity(), 1024);
+
+  // bigger than a block
+  void * big = arena.allocate(4000);
+  BOOST_CHECK(big != 0);
+  BOOST_CHECK_EQUAL(arena.capacity(), 1024 + 4000);
+
+  // After reset the same memory is handed out again without growing.
+  arena.reset();
+  BOOST_CHECK_EQUAL(arena.allocated(), 0);
+  BOOST_CHECK(arena.allocate(1) == first);
+  BOOST_CHECK(arena.allocate(2000) == big);
+  BOOST_CHECK_EQUAL(arena.capacity(), 1024 + 4000);
+
+  std::vector<int, ArenaAllocator<int> > values((ArenaAllocator<int>(arena)));
+  for(int nValue = 0; nValue < 100; ++nValue)
+  {
+    values.push_back(nValue);
+  }
+  BOOST_CHECK_EQUAL(values[99], 99);
+}
+
+BOOST_AUTO_TEST_CASE(TestLatencyHistogram)
+{
+  BOOST_CHECK_EQUAL(LatencyHistogram::bucketFor(0), 0);
+  BOOST_CHECK_EQUAL(LatencyHistogram::bucketFor(1), 1);
+  BOOST_CHECK_EQUAL(LatencyHistogram::bucketFor(2), 2);
+  BOOST_CHECK_EQUAL(LatencyHistogram::bucketFor(3), 2);
+  BOOST_CHECK_EQUAL(LatencyHistogram::bucketFor(1024), 11);
+  BOOST_CHECK_EQUAL(LatencyHistogram::bucketFor(~uint64(0)), LatencyHistogram::bucketCount - 1);
+  for(size_t nBucket = 0; nBucket < LatencyHistogram::bucketCount; ++nBucket)
+  {
+    BOOST_CHECK_EQUAL(LatencyHistogram::bucketFor(LatencyHistogram::bucketLimit(nBucket)), nBucket);
+  }
+
+  LatencyHistogram histogram;
+  BOOST_CHECK_EQUAL(histogram.count(), 0);
+  BOOST_CHECK_EQUAL(histogram.mean(), 0);
+  BOOST_CHECK_EQUAL(histogram.percentile(.5), 0);
+
+  // 98 fast, one medium, one slow
+  for(size_t n = 0; n < 98; ++n)
+  {
+    histogram.record(100);
+  }
+  histogram.record(5000);
+  histogram.record(1000000);
+  BOOST_CHECK_EQUAL(histogram.count(), 100);
+  BOOST_CHECK_EQUAL(histogram.minimum(), 100);
+  BOOST_CHECK_EQUAL(histogram.maximum(), 1000000);
+  BOOST_CHECK_EQUAL(histogram.mean(), (98 * 100 + 5000 + 1000000) / 100);
+  BOOST_CHECK_EQUAL(histogram.bucket(LatencyHistogram::bucketFor(100)), 98);
+  BOOST_CHECK_EQUAL(histogram.percentile(.5), LatencyHistogram::bucketLimit(LatencyHistogram::bucketFor(100)));
+  BOOST_CHECK_EQUAL(histogram.percentile(.99), LatencyHistogram::bucketLimit(LatencyHistogram::bucketFor(5000)));
+  BOOST_CHECK_EQUAL(histogram.percentile(1.0), 1000000);
+
+  // backwards clocks count as zero.
+  histogram.recordInterval(200, 100);
+  BOOST_CHECK_EQUAL(histogram.minimum(), 0);
+  BOOST_CHECK_EQUAL(histogram.bucket(0), 1);
+
+  std::ostringstream out;
+  histogram.print(out);
+  BOOST_CHECK(out.str().find("count 101") != std::string::npos);
+
+  histogram.reset();
+  BOOST_CHECK_EQUAL(histogram.count(), 0);
+  BOOST_CHECK_EQUAL(histogram.maximum(), 0);
+
+  uint64 first = LatencyHistogram::now();
+  uint64 second = LatencyHistogram::now();
+  BOOST_CHECK(first != 0);
+  BOOST_CHECK(second >= first);
+}
+
+namespace
+{
+  struct PlacedThread
+  {
+    PlacedThread(const ThreadOptions & options)
+      : options_(options)
+      , applied_(false)
+    {
+    }
+
+    void operator()()
+    {
+      applied_ = options_.applyToCurrentThread(error_);
+#if defined(__linux__)
+      readPlacement();
+#endif // __linux__
+    }
+
+#if defined(__linux__)
+    void readPlacement()
+    {
+      char name[16] = {0};
+      pthread_getname_np(pthread_self(), name, sizeof(name));
+      name_ = name;
+      cpu_set_t cpuSet;
+      CPU_ZERO(&cpuSet);
+      pthread_getaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+      cpuCount_ = CPU_COUNT(&cpuSet);
+    }
+#endif // __linux__
+
+    ThreadOptions options_;
+    bool applied_;
+    std::string error_;
+    std::string name_;
+    int cpuCount_;
+  };
+
+  /// Collects the communication errors reported to it.
+  class ErrorLog : public Common::Logger
+  {
+  public:
+    virtual bool wantLog(LogLevel /*level*/)
+    {
+      return false;
+    }
+    virtual bool logMessage(LogLevel /*level*/, const std::string & /*message*/)
+    {
+      return true;
+    }
+    virtual bool reportDecodingError(const std::string & /*message*/)
+    {
+      return true;
+    }
+    virtual bool reportCommunicationError(const std::string & message)
+    {
+      errors_.push_back(message);
+      return true;
+    }
+    std::vector<std::string> errors_;
+  };
+}
+
+BOOST_AUTO_TEST_CASE(TestThreadOptions)
+{
+  ThreadOptions none;
+  BOOST_CHECK(none.isDefault());
+  ThreadOptions any("*");
+  BOOST_CHECK(any.isDefault());
+
+  ThreadOptions full("2,4-6:80:decode");
+  BOOST_REQUIRE_EQUAL(full.cpus().size(), 4);
+  BOOST_CHECK_EQUAL(full.cpus()[0], 2);
+  BOOST_CHECK_EQUAL(full.cpus()[1], 4);
+  BOOST_CHECK_EQUAL(full.cpus()[3], 6);
+  BOOST_CHECK_EQUAL(full.priority(), 80);
+  BOOST_CHECK_EQUAL(full.name(), "decode");
+
+  ThreadOptions nameOnly("::receive");
+  BOOST_CHECK(nameOnly.cpus().empty());
+  BOOST_CHECK_EQUAL(nameOnly.priority(), 0);
+  BOOST_CHECK_EQUAL(nameOnly.name(), "receive");
+
+  BOOST_CHECK_THROW(ThreadOptions("x"), UsageError);
+  BOOST_CHECK_THROW(ThreadOptions("3-1"), UsageError);
+  BOOST_CHECK_THROW(ThreadOptions("1,"), UsageError);
+  BOOST_CHECK_THROW(ThreadOptions("1:100"), UsageError);
+  BOOST_CHECK_THROW(ThreadOptions("1:high"), UsageError);
+
+  // entries are used in order; threads past the end share the last one and are numbered.
+  ThreadOptionsList list;
+  BOOST_CHECK(ThreadOptions::select(list, 3).isDefault());
+  list.push_back(ThreadOptions("1::rx"));
+  list.push_back(ThreadOptions("2::dec"));
+  BOOST_CHECK_EQUAL(ThreadOptions::select(list, 0).name(), "rx");
+  BOOST_CHECK_EQUAL(ThreadOptions::select(list, 0).cpus()[0], 1);
+  BOOST_CHECK_EQUAL(ThreadOptions::select(list, 1).name(), "dec");
+  BOOST_CHECK_EQUAL(ThreadOptions::select(list, 2).name(), "dec2");
+  BOOST_CHECK_EQUAL(ThreadOptions::select(list, 3).name(), "dec3");
+  BOOST_CHECK_EQUAL(ThreadOptions::select(list, 3).cpus()[0], 2);
+
+  // options reach the configuration from the command line.
+  Application::DecoderConfiguration configuration;
+  char arg0[] = "-threadopts";
+  char arg1[] = "0:0:fastrx";
+  char * argv[] = {arg0, arg1};
+  BOOST_CHECK_EQUAL(configuration.parseSingleArg(2, argv), 2);
+  BOOST_REQUIRE_EQUAL(configuration.threadOptions().size(), 1);
+  BOOST_CHECK_EQUAL(configuration.threadOptions()[0].name(), "fastrx");
+  Application::DecoderConfiguration copy(configuration);
+  BOOST_CHECK_EQUAL(copy.threadOptions().size(), 1);
+
+#if defined(__linux__)
+  // pin a thread to a processor it is already allowed to use.
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  BOOST_REQUIRE_EQUAL(pthread_getaffinity_np(pthread_self(), sizeof(allowed), &allowed), 0);
+  unsigned int cpu = 0;
+  while(!CPU_ISSET(cpu, &allowed))
+  {
+    ++cpu;
+  }
+  ThreadOptions placement;
+  placement.addCpu(cpu);
+  placement.setName("quickfast-test-thread");
+  PlacedThread placed(placement);
+  boost::thread thread(boost::ref(placed));
+  thread.join();
+  BOOST_CHECK_MESSAGE(placed.applied_, placed.error_);
+  BOOST_CHECK_EQUAL(placed.name_, "quickfast-test-");
+  BOOST_CHECK_EQUAL(placed.cpuCount_, 1);
+
+  // a borrowed thread gets its own settings back.
+  PlacedThread before(placement);
+  before.readPlacement();
+  {
+    ScopedThreadOptions scoped(placement);
+    std::string error;
+    BOOST_CHECK_MESSAGE(scoped.apply(error), error);
+    PlacedThread during(placement);
+    during.readPlacement();
+    BOOST_CHECK_EQUAL(during.name_, "quickfast-test-");
+    BOOST_CHECK_EQUAL(during.cpuCount_, 1);
+  }
+  PlacedThread after(placement);
+  after.readPlacement();
+  BOOST_CHECK_EQUAL(after.name_, before.name_);
+  BOOST_CHECK_EQUAL(after.cpuCount_, before.cpuCount_);
+
+  // a thread that can't be placed says so through the logger.
+  ThreadOptions impossible;
+  impossible.addCpu(CPU_SETSIZE);
+  ErrorLog log;
+  BOOST_CHECK(!impossible.applyToCurrentThread(&log));
+  BOOST_REQUIRE_EQUAL(log.errors_.size(), 1);
+  BOOST_CHECK(log.errors_[0].find("processor affinity") != std::string::npos);
+  {
+    ScopedThreadOptions scoped(impossible);
+    BOOST_CHECK(!scoped.apply(&log));
+  }
+  BOOST_CHECK_EQUAL(log.errors_.size(), 2);
+#endif // __linux__
+}
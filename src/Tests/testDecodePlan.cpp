@@ -0,0 +1,91 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Tests/DecodingFixture.h>
+#include <Codecs/DecodePlan.h>
+#include <Codecs/Decoder.h>
+#include <Codecs/DataSourceString.h>
+#include <Codecs/SingleMessageConsumer.h>
+#include <Codecs/GenericMessageBuilder.h>
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+BOOST_AUTO_TEST_CASE(testDecodePlanCompile)
+{
+  Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+  Codecs::TemplateCPtr templ;
+  BOOST_REQUIRE(registry->getTemplate(1, templ));
+  const Codecs::DecodePlan * plan = templ->getDecodePlan();
+  BOOST_REQUIRE(plan != 0);
+  BOOST_CHECK_EQUAL(plan->size(), 7);
+  // every integer field is specialized; the ascii field is not.
+  BOOST_CHECK_EQUAL(plan->specializedCount(), 6);
+  BOOST_CHECK_EQUAL(plan->getStep(6).opCode_, Codecs::DecodeStep::GENERIC);
+}
+
+BOOST_AUTO_TEST_CASE(testDecodePlanMatchesInstructions)
+{
+  Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+
+  PlanIdentities identities;
+
+  // a series of messages exercising present, absent, and null values.
+  std::vector<Messages::MessagePtr> messages;
+  for(size_t nMsg = 0; nMsg < 6; ++nMsg)
+  {
+    Messages::MessagePtr msg(new Messages::Message(registry->maxFieldCount()));
+    msg->addField(identities.copyU32_, Messages::FieldUInt32::create(uint32(100 + nMsg / 2)));
+    if(nMsg % 3 != 1)
+    {
+      msg->addField(identities.deltaI32_, Messages::FieldInt32::create(int32(-1000 + 37 * int32(nMsg))));
+    }
+    msg->addField(identities.incrementU64_, Messages::FieldUInt64::create(uint64(nMsg == 4 ? 50 : nMsg + 1)));
+    if(nMsg % 2 == 0)
+    {
+      msg->addField(identities.defaultI64_, Messages::FieldInt64::create(int64(nMsg == 2 ? -5 : 123456789012LL)));
+    }
+    msg->addField(identities.constantU32_, Messages::FieldUInt32::create(7));
+    if(nMsg != 3)
+    {
+      msg->addField(identities.nopI32_, Messages::FieldInt32::create(int32(nMsg) - 2));
+    }
+    msg->addField(identities.copyAscii_, Messages::FieldAscii::create(nMsg < 3 ? "abc" : "xyz"));
+    messages.push_back(msg);
+  }
+
+  Codecs::Encoder encoder(registry);
+  Codecs::DataDestination destination;
+  for(size_t nMsg = 0; nMsg < messages.size(); ++nMsg)
+  {
+    encoder.encodeMessage(destination, 1, *messages[nMsg]);
+  }
+  std::string fastString;
+  destination.toString(fastString);
+
+  Codecs::Decoder genericDecoder(registry);
+  Codecs::DataSourceString genericSource(fastString);
+  Codecs::Decoder planDecoder(registry);
+  planDecoder.setUseDecodePlans(true);
+  BOOST_CHECK(planDecoder.getUseDecodePlans());
+  Codecs::DataSourceString planSource(fastString);
+
+  for(size_t nMsg = 0; nMsg < messages.size(); ++nMsg)
+  {
+    Codecs::SingleMessageConsumer genericConsumer;
+    Codecs::GenericMessageBuilder genericBuilder(genericConsumer);
+    genericDecoder.decodeMessage(genericSource, genericBuilder);
+
+    Codecs::SingleMessageConsumer planConsumer;
+    Codecs::GenericMessageBuilder planBuilder(planConsumer);
+    planDecoder.decodeMessage(planSource, planBuilder);
+
+    compareMessages(*messages[nMsg], genericConsumer.message());
+    compareMessages(genericConsumer.message(), planConsumer.message());
+  }
+}
@@ -0,0 +1,212 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Tests/DecodingFixture.h>
+#include <Codecs/Decoder.h>
+#include <Codecs/DataSourceString.h>
+#include <Codecs/SingleMessageConsumer.h>
+#include <Codecs/GenericMessageBuilder.h>
+#include <Codecs/SynchronousDecoder.h>
+#include <Messages/FieldGroup.h>
+#include <Common/Exceptions.h>
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+namespace
+{
+  /// Count the messages the decoder abandons.
+  class AbandonCountingBuilder : public Codecs::GenericMessageBuilder
+  {
+  public:
+    explicit AbandonCountingBuilder(Codecs::MessageConsumer & consumer)
+      : Codecs::GenericMessageBuilder(consumer)
+      , ignored_(0)
+    {
+    }
+
+    virtual bool ignoreMessage(Messages::ValueMessageBuilder & messageBuilder)
+    {
+      ++ignored_;
+      return Codecs::GenericMessageBuilder::ignoreMessage(messageBuilder);
+    }
+
+    size_t ignored_;
+  };
+}
+
+BOOST_AUTO_TEST_CASE(testNestedGroupPresenceMaps)
+{
+  // outer, Middle{middle, Inner{inner}, after}, last -- every field copied.
+  Codecs::SegmentBodyPtr inner(new Codecs::SegmentBody);
+  addCopyField(*inner, "inner");
+  Codecs::SegmentBodyPtr middle(new Codecs::SegmentBody);
+  addCopyField(*middle, "middle");
+  addGroup(*middle, "Inner", inner);
+  addCopyField(*middle, "after");
+  Codecs::TemplatePtr templ(new Codecs::Template);
+  templ->setId(4);
+  templ->setTemplateName("Nested");
+  addCopyField(*templ, "outer");
+  addGroup(*templ, "Middle", middle);
+  addCopyField(*templ, "last");
+
+  Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+  registry->addTemplate(templ);
+  registry->finalize();
+  BOOST_CHECK_EQUAL(registry->maxNestingDepth(), 2);
+
+  Messages::FieldIdentityCPtr identity_outer = new Messages::FieldIdentity("outer");
+  Messages::FieldIdentityCPtr identity_middle = new Messages::FieldIdentity("middle");
+  Messages::FieldIdentityCPtr identity_inner = new Messages::FieldIdentity("inner");
+  Messages::FieldIdentityCPtr identity_after = new Messages::FieldIdentity("after");
+  Messages::FieldIdentityCPtr identity_last = new Messages::FieldIdentity("last");
+  Messages::FieldIdentityCPtr identity_Middle = new Messages::FieldIdentity("Middle");
+  Messages::FieldIdentityCPtr identity_Inner = new Messages::FieldIdentity("Inner");
+
+  // Repeated values are copied, so each level must keep its own presence map.
+  const uint32 values[][5] = {{1, 2, 3, 4, 5}, {1, 7, 3, 4, 9}, {8, 7, 3, 6, 9}};
+  const size_t messageCount = sizeof(values) / sizeof(values[0]);
+
+  Codecs::Encoder encoder(registry);
+  Codecs::DataDestination destination;
+  for(size_t nMsg = 0; nMsg < messageCount; ++nMsg)
+  {
+    Messages::FieldSetPtr innerSet(new Messages::FieldSet(1));
+    innerSet->addField(identity_inner, Messages::FieldUInt32::create(values[nMsg][2]));
+    Messages::FieldSetPtr middleSet(new Messages::FieldSet(3));
+    middleSet->addField(identity_middle, Messages::FieldUInt32::create(values[nMsg][1]));
+    middleSet->addField(identity_Inner, Messages::FieldGroup::create(innerSet));
+    middleSet->addField(identity_after, Messages::FieldUInt32::create(values[nMsg][3]));
+    Messages::Message msg(registry->maxFieldCount());
+    msg.addField(identity_outer, Messages::FieldUInt32::create(values[nMsg][0]));
+    msg.addField(identity_Middle, Messages::FieldGroup::create(middleSet));
+    msg.addField(identity_last, Messages::FieldUInt32::create(values[nMsg][4]));
+    encoder.encodeMessage(destination, 4, msg);
+  }
+  std::string fastString;
+  destination.toString(fastString);
+
+  Codecs::Decoder decoder(registry);
+  Codecs::DataSourceString source(fastString);
+  for(size_t nMsg = 0; nMsg < messageCount; ++nMsg)
+  {
+    Codecs::SingleMessageConsumer consumer;
+    Codecs::GenericMessageBuilder builder(consumer);
+    decoder.decodeMessage(source, builder);
+    Messages::Message & msgOut = consumer.message();
+
+    Messages::FieldCPtr value;
+    BOOST_REQUIRE(msgOut.getField("outer", value));
+    BOOST_CHECK_EQUAL(value->toUInt32(), values[nMsg][0]);
+    BOOST_REQUIRE(msgOut.getField("last", value));
+    BOOST_CHECK_EQUAL(value->toUInt32(), values[nMsg][4]);
+    BOOST_REQUIRE(msgOut.getField("Middle", value));
+    Messages::FieldSetCPtr middleOut = value->toGroup();
+    BOOST_REQUIRE(middleOut->getField("middle", value));
+    BOOST_CHECK_EQUAL(value->toUInt32(), values[nMsg][1]);
+    BOOST_REQUIRE(middleOut->getField("after", value));
+    BOOST_CHECK_EQUAL(value->toUInt32(), values[nMsg][3]);
+    BOOST_REQUIRE(middleOut->getField("Inner", value));
+    Messages::FieldSetCPtr innerOut = value->toGroup();
+    BOOST_REQUIRE(innerOut->getField("inner", value));
+    BOOST_CHECK_EQUAL(value->toUInt32(), values[nMsg][2]);
+  }
+  uchar byte;
+  BOOST_CHECK(!source.getByte(byte));
+}
+
+BOOST_AUTO_TEST_CASE(testDecodeErrorStatus)
+{
+  Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+
+  Messages::MessagePtr msg = PlanIdentities().message(registry, 0);
+  std::string good = encodePlanMessages(registry, 1);
+
+  // pmap with the template ID bit set, then an undefined template ID (5).
+  std::string unknownTemplate("\xC0\x85", 2);
+  // pmap and template ID, but none of the fields.
+  std::string truncated(good, 0, 2);
+
+  for(int usePlans = 0; usePlans < 2; ++usePlans)
+  {
+    std::string fastString = unknownTemplate + good + truncated;
+    Codecs::Decoder decoder(registry);
+    decoder.setUseDecodePlans(usePlans != 0);
+    decoder.setThrowOnError(false);
+    Codecs::DataSourceString source(fastString);
+
+    Codecs::SingleMessageConsumer consumer;
+    Codecs::GenericMessageBuilder builder(consumer);
+    BOOST_CHECK(!decoder.decodeMessage(source, builder));
+    BOOST_CHECK(decoder.hasError());
+    BOOST_CHECK_EQUAL(decoder.getErrorMessage().substr(0, 8), "[ERR D9]");
+
+    // the decoder recovers for the next message.
+    BOOST_CHECK(decoder.decodeMessage(source, builder));
+    BOOST_CHECK(!decoder.hasError());
+    compareMessages(*msg, consumer.message());
+
+    BOOST_CHECK(!decoder.decodeMessage(source, builder));
+    BOOST_CHECK(decoder.hasError());
+    BOOST_CHECK_EQUAL(decoder.getErrorMessage().substr(0, 9), "[ERR U03]");
+  }
+
+  // By default errors are still thrown.
+  Codecs::Decoder decoder(registry);
+  BOOST_CHECK(decoder.getThrowOnError());
+  Codecs::DataSourceString source(truncated);
+  Codecs::SingleMessageConsumer consumer;
+  Codecs::GenericMessageBuilder builder(consumer);
+  BOOST_CHECK_THROW(decoder.decodeMessage(source, builder), EncodingError);
+}
+
+BOOST_AUTO_TEST_CASE(testDecodeErrorAbandonsMessage)
+{
+  Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+  std::string good = encodePlanMessages(registry, 1);
+  // the message is started, then the fields run out.
+  std::string truncated(good, 0, 2);
+
+  for(int throwOnError = 0; throwOnError < 2; ++throwOnError)
+  {
+    Codecs::Decoder decoder(registry);
+    decoder.setThrowOnError(throwOnError != 0);
+    Codecs::DataSourceString source(truncated);
+    Codecs::SingleMessageConsumer consumer;
+    AbandonCountingBuilder builder(consumer);
+    try
+    {
+      BOOST_CHECK(!decoder.decodeMessage(source, builder));
+      BOOST_CHECK(throwOnError == 0);
+    }
+    catch(const EncodingError &)
+    {
+      BOOST_CHECK(throwOnError != 0);
+    }
+    BOOST_CHECK_EQUAL(builder.ignored_, 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testSynchronousDecoderCountsDecodedMessages)
+{
+  Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+  std::string good = encodePlanMessages(registry, 1);
+  std::string unknownTemplate("\xC0\x85", 2);
+  std::string truncated(good, 0, 2);
+  std::string fastString = unknownTemplate + good + truncated;
+
+  Codecs::SynchronousDecoder decoder(registry);
+  decoder.setThrowOnError(false);
+  Codecs::DataSourceString source(fastString);
+  Codecs::SingleMessageConsumer consumer;
+  Codecs::GenericMessageBuilder builder(consumer);
+  decoder.decode(source, builder);
+  // the two failures are reported, not counted.
+  BOOST_CHECK_EQUAL(decoder.messageCount(), 1);
+}
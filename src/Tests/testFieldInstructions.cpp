@@ -2401,3 +2401,245 @@ BOOST_AUTO_TEST_CASE(test_issue_31)
   BOOST_CHECK_EQUAL(result, testString);
   BOOST_CHECK(pmap == pmapResult);
 }
+
+namespace
+{
+  template<typename IntType>
+  void decodeSignedBothWays(Codecs::Context & context, int64 expected)
+  {
+    Codecs::DataDestination destination;
+    destination.startBuffer();
+    WorkingBuffer workingBuffer;
+    Codecs::FieldInstruction::encodeSignedInteger(destination, workingBuffer, expected);
+    destination.endMessage();
+    std::string encoded;
+    destination.toString(encoded);
+
+    // Too short for hasContiguous(): decoded a byte at a time.
+    Codecs::DataSourceString shortSource(encoded);
+    IntType shortValue = 0;
+    Codecs::FieldInstruction::decodeSignedInteger(shortSource, context, shortValue, "short");
+    BOOST_CHECK_EQUAL(int64(shortValue), expected);
+
+    // Followed by another field: decoded from a word load.
+    Codecs::DataSourceString paddedSource(encoded + "\x81\x82\x83\x84\x85\x86\x87\x88");
+    IntType paddedValue = 0;
+    Codecs::FieldInstruction::decodeSignedInteger(paddedSource, context, paddedValue, "padded");
+    BOOST_CHECK_EQUAL(int64(paddedValue), expected);
+    uchar byte = 0;
+    BOOST_CHECK(paddedSource.getByte(byte));
+    BOOST_CHECK_EQUAL(int(byte), 0x81);
+  }
+
+  template<typename IntType>
+  void decodeUnsignedBothWays(Codecs::Context & context, uint64 expected)
+  {
+    Codecs::DataDestination destination;
+    destination.startBuffer();
+    WorkingBuffer workingBuffer;
+    Codecs::FieldInstruction::encodeUnsignedInteger(destination, workingBuffer, expected);
+    destination.endMessage();
+    std::string encoded;
+    destination.toString(encoded);
+
+    Codecs::DataSourceString shortSource(encoded);
+    IntType shortValue = 0;
+    Codecs::FieldInstruction::decodeUnsignedInteger(shortSource, context, shortValue, "short");
+    BOOST_CHECK_EQUAL(uint64(shortValue), expected);
+
+    Codecs::DataSourceString paddedSource(encoded + "\x81\x82\x83\x84\x85\x86\x87\x88");
+    IntType paddedValue = 0;
+    Codecs::FieldInstruction::decodeUnsignedInteger(paddedSource, context, paddedValue, "padded");
+    BOOST_CHECK_EQUAL(uint64(paddedValue), expected);
+    uchar byte = 0;
+    BOOST_CHECK(paddedSource.getByte(byte));
+    BOOST_CHECK_EQUAL(int(byte), 0x81);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testDecodeIntegerContiguous)
+{
+  Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry(3,3,0));
+  Codecs::Decoder decoder(registry);
+
+  const int64 signedValues[] = {
+    0, 1, -1, 63, -64, 64, -65, 8191, -8192, 8192, -8193,
+    1048575, -1048576, 134217727, -134217728, 134217728, -134217729,
+    2147483647LL, -2147483647LL - 1,
+    34359738367LL, -34359738368LL, 0x00FFFFFFFFFFFFFFLL, -0x0100000000000000LL,
+    0x7FFFFFFFFFFFFFFFLL, -0x7FFFFFFFFFFFFFFFLL - 1};
+  for(size_t n = 0; n < sizeof(signedValues)/sizeof(signedValues[0]); ++n)
+  {
+    int64 value = signedValues[n];
+    decodeSignedBothWays<int64>(decoder, value);
+    if(value >= -2147483647LL - 1 && value <= 2147483647LL)
+    {
+      decodeSignedBothWays<int32>(decoder, value);
+    }
+  }
+
+  const uint64 unsignedValues[] = {
+    0, 1, 127, 128, 16383, 16384, 2097151, 2097152, 268435455, 268435456,
+    0xFFFFFFFFULL, 34359738367ULL, 34359738368ULL, 0x00FFFFFFFFFFFFFFULL,
+    0x0100000000000000ULL, 0xFFFFFFFFFFFFFFFFULL};
+  for(size_t n = 0; n < sizeof(unsignedValues)/sizeof(unsignedValues[0]); ++n)
+  {
+    uint64 value = unsignedValues[n];
+    decodeUnsignedBothWays<uint64>(decoder, value);
+    if(value <= 0xFFFFFFFFULL)
+    {
+      decodeUnsignedBothWays<uint32>(decoder, value);
+    }
+  }
+
+  // A six byte integer doesn't fit in 32 bits no matter how it's decoded.
+  std::string tooBig("\x01\x02\x03\x04\x05\x86\x81\x82\x83", 9);
+  Codecs::DataSourceString source(tooBig);
+  uint32 value = 0;
+  BOOST_CHECK_THROW(
+    Codecs::FieldInstruction::decodeUnsignedInteger(source, decoder, value, "tooBig"),
+    EncodingError);
+}
+
+namespace
+{
+  void decodeStrings(Codecs::DataSource & source)
+  {
+    Codecs::DictionaryIndexer indexer;
+    Codecs::PresenceMap pmap(1);
+
+    Codecs::FieldInstructionByteVector bytes("Bytes", "");
+    bytes.setPresence(true);
+    bytes.indexDictionaries(indexer, "global","", "");
+    Codecs::FieldInstructionAscii ascii("Ascii", "");
+    ascii.setPresence(true);
+    ascii.indexDictionaries(indexer, "global","", "");
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry(3,3,indexer.size()));
+    bytes.finalize(*registry);
+    ascii.finalize(*registry);
+
+    Codecs::Decoder decoder(registry);
+    Codecs::SingleMessageConsumer consumer;
+    Codecs::GenericMessageBuilder builder(consumer);
+    builder.startMessage("UNIT_TEST", "", 10);
+    bytes.decode(source, pmap, decoder, builder);
+    ascii.decode(source, pmap, decoder, builder);
+    BOOST_REQUIRE(builder.endMessage(builder));
+
+    // the byte following the strings must be untouched.
+    uchar byte = 0;
+    BOOST_CHECK(source.getByte(byte));
+    BOOST_CHECK_EQUAL(int(byte), 0x81);
+
+    Messages::Message & fieldSet = consumer.message();
+    BOOST_REQUIRE_EQUAL(fieldSet.size(), 2);
+    Messages::FieldSet::const_iterator pFieldEntry = fieldSet.begin();
+    BOOST_CHECK_EQUAL(pFieldEntry->getField()->toByteVector(), "ABC\xC1\x45\x46G");
+    ++pFieldEntry;
+    BOOST_CHECK_EQUAL(pFieldEntry->getField()->toAscii(), "HIJKL");
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testDecodeStringsContiguous)
+{
+  // byte vector: length 7, the data includes a byte with the high bit set.
+  // ascii: "HIJKL" with the stop bit on the last character.
+  std::string testString("\x87" "ABC\xC1\x45\x46G" "HIJK\xCC" "\x81");
+
+  // all data is in one buffer so the strings are handled in place.
+  Codecs::DataSourceString contiguousSource(testString);
+  decodeStrings(contiguousSource);
+
+  // small buffers split the strings.
+  std::istringstream sourceStream(testString, std::ios::binary);
+  Codecs::DataSourceStream splitSource(sourceStream, 3);
+  decodeStrings(splitSource);
+}
+
+BOOST_AUTO_TEST_CASE(testContextDictionary)
+{
+  // numeric and string entries are indexed separately, even with the same key.
+  Codecs::DictionaryIndexer indexer;
+  size_t price = indexer.getIndex("global", "", "", "Price", "");
+  size_t size = indexer.getIndex("global", "", "", "Size", "");
+  size_t symbol = indexer.getIndex("global", "", "", "Symbol", "", true);
+  size_t priceText = indexer.getIndex("global", "", "", "Price", "", true);
+  BOOST_CHECK_EQUAL(price, 0);
+  BOOST_CHECK_EQUAL(size, 1);
+  BOOST_CHECK_EQUAL(symbol, 0);
+  BOOST_CHECK_EQUAL(priceText, 1);
+  BOOST_CHECK_EQUAL(indexer.getIndex("global", "", "", "Size", ""), size);
+  BOOST_CHECK_EQUAL(indexer.numericSize(), 2);
+  BOOST_CHECK_EQUAL(indexer.stringSize(), 2);
+  BOOST_CHECK_EQUAL(indexer.size(), 4);
+
+  Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry(3,3,indexer.size()));
+  Codecs::Decoder decoder(registry);
+
+  Decimal decimal;
+  BOOST_CHECK_EQUAL(decoder.getDictionaryValue(price, decimal), Codecs::Context::UNDEFINED_VALUE);
+  decoder.setDictionaryValue(price, Decimal(12345, -2));
+  BOOST_CHECK_EQUAL(decoder.getDictionaryValue(price, decimal), Codecs::Context::OK_VALUE);
+  BOOST_CHECK_EQUAL(decimal, Decimal(12345, -2));
+
+  uint64 unsignedValue = 0;
+  decoder.setDictionaryValue(size, uint64(0xFFFFFFFFFFFFFFFFULL));
+  BOOST_CHECK_EQUAL(decoder.getDictionaryValue(size, unsignedValue), Codecs::Context::OK_VALUE);
+  BOOST_CHECK_EQUAL(unsignedValue, 0xFFFFFFFFFFFFFFFFULL);
+  decoder.setDictionaryValueNull(size);
+  BOOST_CHECK_EQUAL(decoder.getDictionaryValue(size, unsignedValue), Codecs::Context::NULL_VALUE);
+  decoder.setDictionaryValue(size, int32(-5));
+  int32 signedValue = 0;
+  BOOST_CHECK_EQUAL(decoder.getDictionaryValue(size, signedValue), Codecs::Context::OK_VALUE);
+  BOOST_CHECK_EQUAL(signedValue, -5);
+
+  std::string text;
+  decoder.setDictionaryValue(symbol, std::string("IBM"));
+  decoder.setDictionaryStringNull(priceText);
+  BOOST_CHECK_EQUAL(decoder.getDictionaryValue(symbol, text), Codecs::Context::OK_VALUE);
+  BOOST_CHECK_EQUAL(text, "IBM");
+  BOOST_CHECK_EQUAL(decoder.getDictionaryValue(priceText, text), Codecs::Context::NULL_VALUE);
+  // the numeric entry with the same index is unaffected by the string entry.
+  BOOST_CHECK_EQUAL(decoder.getDictionaryValue(price, decimal), Codecs::Context::OK_VALUE);
+
+  decoder.reset();
+  BOOST_CHECK_EQUAL(decoder.getDictionaryValue(price, decimal), Codecs::Context::UNDEFINED_VALUE);
+  BOOST_CHECK_EQUAL(decoder.getDictionaryValue(size, signedValue), Codecs::Context::UNDEFINED_VALUE);
+  BOOST_CHECK_EQUAL(decoder.getDictionaryValue(symbol, text), Codecs::Context::UNDEFINED_VALUE);
+  BOOST_CHECK_EQUAL(decoder.getDictionaryValue(priceText, text), Codecs::Context::UNDEFINED_VALUE);
+
+#if defined(DICTIONARY_INDEX_CHECK)
+  // checked builds reject indexes beyond the dictionary.
+  BOOST_CHECK_THROW(decoder.getDictionaryValue(100, decimal), TemplateDefinitionError);
+  BOOST_CHECK_THROW(decoder.setDictionaryValueNull(100), TemplateDefinitionError);
+  BOOST_CHECK_THROW(decoder.getDictionaryValue(100, text), TemplateDefinitionError);
+  BOOST_CHECK_THROW(decoder.setDictionaryStringNull(100), TemplateDefinitionError);
+#endif // DICTIONARY_INDEX_CHECK
+}
+
+BOOST_AUTO_TEST_CASE(testValidateDictionaryIndexes)
+{
+  Codecs::DictionaryIndexer indexer;
+  (void)indexer.getIndex("global", "", "", "Other", "");
+
+  Codecs::FieldInstructionUInt32 copyField("Copy", "");
+  copyField.setFieldOp(Codecs::FieldOpPtr(new Codecs::FieldOpCopy));
+  Codecs::FieldInstructionAscii asciiField("Ascii", "");
+  asciiField.setFieldOp(Codecs::FieldOpPtr(new Codecs::FieldOpCopy));
+  Codecs::FieldInstructionUInt32 nopField("Nop", "");
+
+  // before indexing a field that uses the dictionary is invalid.
+  BOOST_CHECK_THROW(copyField.validateDictionaryIndexes(10, 10), TemplateDefinitionError);
+
+  copyField.indexDictionaries(indexer, "global", "", "");
+  asciiField.indexDictionaries(indexer, "global", "", "");
+  nopField.indexDictionaries(indexer, "global", "", "");
+
+  // copyField got numeric index 1; asciiField got string index 0
+  BOOST_CHECK_NO_THROW(copyField.validateDictionaryIndexes(2, 0));
+  BOOST_CHECK_THROW(copyField.validateDictionaryIndexes(1, 10), TemplateDefinitionError);
+  BOOST_CHECK_NO_THROW(asciiField.validateDictionaryIndexes(0, 1));
+  BOOST_CHECK_THROW(asciiField.validateDictionaryIndexes(10, 0), TemplateDefinitionError);
+  // no dictionary, nothing to check
+  BOOST_CHECK_NO_THROW(nopField.validateDictionaryIndexes(0, 0));
+}
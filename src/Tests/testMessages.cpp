@@ -0,0 +1,248 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Tests/DecodingFixture.h>
+#include <Codecs/Decoder.h>
+#include <Codecs/DataSourceString.h>
+#include <Codecs/GenericMessageBuilder.h>
+#include <Codecs/SingleMessageConsumer.h>
+#include <Messages/FieldGroup.h>
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+BOOST_AUTO_TEST_CASE(testFieldIdentityOrdinals)
+{
+  Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+  Codecs::TemplateCPtr templ;
+  BOOST_REQUIRE(registry->getTemplate(1, templ));
+  for(size_t nField = 0; nField < templ->size(); ++nField)
+  {
+    BOOST_CHECK_EQUAL(templ->getInstruction(nField)->getIdentity()->ordinal(), nField);
+  }
+  Messages::FieldIdentity unnumbered("copyAscii");
+  BOOST_CHECK_EQUAL(unnumbered.ordinal(), Messages::FieldIdentity::noOrdinal);
+
+  // Leave out the optional fields so the rest are not where their ordinals expect.
+  Messages::FieldSet fieldSet(templ->size());
+  for(size_t nField = 0; nField < templ->size(); ++nField)
+  {
+    const Codecs::FieldInstructionCPtr & instruction = templ->getInstruction(nField);
+    if(instruction->isMandatory())
+    {
+      fieldSet.addField(instruction->getIdentity(), Messages::FieldUInt32::create(uint32(nField)));
+    }
+  }
+  BOOST_REQUIRE_EQUAL(fieldSet.size(), 4);
+
+  for(size_t nField = 0; nField < templ->size(); ++nField)
+  {
+    const Codecs::FieldInstructionCPtr & instruction = templ->getInstruction(nField);
+    Messages::FieldCPtr value;
+    // by identity (indexed by the ordinal) and by name (searched)
+    BOOST_CHECK_EQUAL(fieldSet.getField(*instruction->getIdentity(), value), instruction->isMandatory());
+    if(instruction->isMandatory())
+    {
+      BOOST_CHECK_EQUAL(value->toUInt32(), nField);
+    }
+    BOOST_CHECK_EQUAL(fieldSet.getField(instruction->getName(), value), instruction->isMandatory());
+    BOOST_CHECK_EQUAL(fieldSet.isPresent(*instruction->getIdentity()), instruction->isMandatory());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testFieldSetOrdinalMismatch)
+{
+  // Identities whose ordinals disagree with the fields actually present,
+  // as when templates that share identities are merged.
+  Messages::FieldIdentityPtr first(new Messages::FieldIdentity("first"));
+  Messages::FieldIdentityPtr second(new Messages::FieldIdentity("second"));
+  Messages::FieldIdentityPtr third(new Messages::FieldIdentity("third"));
+  Messages::FieldIdentityPtr beyond(new Messages::FieldIdentity("beyond"));
+  first->setOrdinal(0);
+  second->setOrdinal(0);
+  third->setOrdinal(1);
+  beyond->setOrdinal(50);
+
+  Messages::FieldSet fieldSet(2);
+  fieldSet.addField(second, Messages::FieldUInt32::create(2));
+  fieldSet.addField(first, Messages::FieldUInt32::create(1));
+  // grows the set; the ordinals already recorded must survive.
+  fieldSet.addField(beyond, Messages::FieldUInt32::create(50));
+
+  Messages::FieldCPtr value;
+  BOOST_REQUIRE(fieldSet.getField(*first, value));
+  BOOST_CHECK_EQUAL(value->toUInt32(), 1);
+  BOOST_REQUIRE(fieldSet.getField(*second, value));
+  BOOST_CHECK_EQUAL(value->toUInt32(), 2);
+  BOOST_REQUIRE(fieldSet.getField(*beyond, value));
+  BOOST_CHECK_EQUAL(value->toUInt32(), 50);
+  BOOST_CHECK(!fieldSet.isPresent(*third));
+
+  // An equal identity with a different ordinal finds the same field.
+  Messages::FieldIdentity moved("first");
+  moved.setOrdinal(1);
+  BOOST_REQUIRE(fieldSet.getField(moved, value));
+  BOOST_CHECK_EQUAL(value->toUInt32(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(testMessageOutlivesRegistry)
+{
+  // A decoded message keeps its identities alive after the registry is gone.
+  Codecs::SingleMessageConsumer consumer;
+  {
+    Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+    std::string fastString = encodePlanMessages(registry, 1);
+    Codecs::Decoder decoder(registry);
+    Codecs::DataSourceString source(fastString);
+    Codecs::GenericMessageBuilder builder(consumer);
+    decoder.decodeMessage(source, builder);
+  }
+  const Messages::Message & message = consumer.message();
+  BOOST_REQUIRE(message.size() > 1);
+  BOOST_CHECK(message[0].getIdentity()->isImmortal());
+  BOOST_CHECK_EQUAL(message[0].getIdentity()->name(), "copyU32");
+  BOOST_CHECK_EQUAL(message[message.size() - 1].getIdentity()->name(), "copyAscii");
+  PlanIdentities identities;
+  Messages::FieldCPtr value;
+  BOOST_REQUIRE(message.getField(*identities.copyU32_, value));
+  BOOST_CHECK_EQUAL(value->toUInt32(), 0);
+  // the consumer releases the message, and with it the identities, last.
+}
+
+BOOST_AUTO_TEST_CASE(testFieldSetApplicationIdentities)
+{
+  // The encoder looks fields up with the template's identities, which have
+  // ordinals, in a set the application built from identities of its own.
+  const char * names[] = {"a", "b", "c", "d", "e"};
+  const size_t count = sizeof(names) / sizeof(names[0]);
+  std::vector<Messages::FieldIdentityPtr> templateIdentities;
+  Messages::FieldSet fieldSet(count);
+  for(size_t nField = 0; nField < count; ++nField)
+  {
+    templateIdentities.push_back(Messages::FieldIdentityPtr(new Messages::FieldIdentity(names[nField])));
+    templateIdentities.back()->setOrdinal(nField);
+    // optional field "b" is absent, so later fields sit ahead of their ordinals.
+    if(nField != 1)
+    {
+      Messages::FieldIdentityPtr own(new Messages::FieldIdentity(names[nField]));
+      fieldSet.addField(own, Messages::FieldUInt32::create(uint32(nField)));
+    }
+  }
+  // and one added out of order.
+  Messages::FieldIdentityPtr late(new Messages::FieldIdentity("b"));
+  fieldSet.addField(late, Messages::FieldUInt32::create(1));
+
+  Messages::FieldCPtr value;
+  for(size_t nField = 0; nField < count; ++nField)
+  {
+    BOOST_REQUIRE(fieldSet.getField(*templateIdentities[nField], value));
+    BOOST_CHECK_EQUAL(value->toUInt32(), nField);
+  }
+  Messages::FieldIdentity missing("f");
+  missing.setOrdinal(2);
+  BOOST_CHECK(!fieldSet.isPresent(missing));
+  BOOST_REQUIRE(fieldSet.getField("e", value));
+  BOOST_CHECK_EQUAL(value->toUInt32(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(testArenaMessageBuilder)
+{
+  Codecs::TemplateRegistryPtr registry = createSnapshotRegistry();
+  const size_t messageCount = 20;
+  std::vector<uint32> expectedPrices;
+  // enough entries that later messages outgrow the first arena block.
+  std::string fastString = encodeSnapshots(registry, messageCount, 40, expectedPrices);
+
+  for(int useArena = 0; useArena < 2; ++useArena)
+  {
+    Codecs::Decoder decoder(registry);
+    Codecs::DataSourceString source(fastString);
+    SnapshotConsumer consumer;
+    Codecs::GenericMessageBuilder builder(consumer);
+    if(useArena != 0)
+    {
+      builder.useArena(4096);
+    }
+    for(size_t nMsg = 0; nMsg < messageCount; ++nMsg)
+    {
+      BOOST_REQUIRE(decoder.decodeMessage(source, builder));
+    }
+    BOOST_REQUIRE_EQUAL(consumer.seqNums_.size(), messageCount);
+    for(size_t nMsg = 0; nMsg < messageCount; ++nMsg)
+    {
+      BOOST_CHECK_EQUAL(consumer.seqNums_[nMsg], nMsg);
+    }
+    BOOST_CHECK(consumer.prices_ == expectedPrices);
+  }
+
+  // A FieldSet in an arena can still grow.
+  Messages::FieldIdentityCPtr identity_price = new Messages::FieldIdentity("price");
+  Arena arena(256);
+  {
+    Messages::FieldSet fieldSet(1, arena);
+    for(uint32 nField = 0; nField < 20; ++nField)
+    {
+      fieldSet.addField(identity_price, Messages::FieldUInt32::create(nField));
+    }
+    BOOST_CHECK_EQUAL(fieldSet.size(), 20);
+    BOOST_CHECK_EQUAL(fieldSet[19].getField()->toUInt32(), 19);
+    BOOST_CHECK(arena.allocated() > 0);
+  }
+  arena.reset();
+  BOOST_CHECK_EQUAL(arena.allocated(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testImmortalIdentities)
+{
+  Codecs::TemplateCPtr templ;
+  {
+    Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+    BOOST_REQUIRE(registry->getTemplate(1, templ));
+    BOOST_CHECK_EQUAL(registry->immortalIdentityCount(), templ->size());
+    for(size_t nField = 0; nField < templ->size(); ++nField)
+    {
+      BOOST_CHECK(templ->getInstruction(nField)->getIdentity()->isImmortal());
+    }
+
+    // Decoded messages share the identities without counting them.
+    PlanIdentities identities;
+    Messages::MessagePtr msg = identities.message(registry, 0);
+    BOOST_CHECK(!identities.copyU32_->isImmortal());
+    std::string fastString = encodePlanMessages(registry, 1);
+    Codecs::Decoder decoder(registry);
+    Codecs::DataSourceString source(fastString);
+    Codecs::SingleMessageConsumer consumer;
+    Codecs::GenericMessageBuilder builder(consumer);
+    decoder.decodeMessage(source, builder);
+    compareMessages(*msg, consumer.message());
+    BOOST_CHECK(consumer.message()[0].getIdentity()->isImmortal());
+
+    // Publishing makes the counts safe to share between threads.
+    BOOST_CHECK(!consumer.message()[0].getField()->isPublished());
+    consumer.message().publish();
+    BOOST_CHECK(consumer.message()[0].getField()->isPublished());
+  }
+  // The template outlives the registry, and its identities are counted again.
+  for(size_t nField = 0; nField < templ->size(); ++nField)
+  {
+    BOOST_CHECK(!templ->getInstruction(nField)->getIdentity()->isImmortal());
+  }
+
+  // Groups are published along with their contents.
+  Messages::FieldIdentityCPtr identity_inner = new Messages::FieldIdentity("inner");
+  Messages::FieldSetPtr group(new Messages::FieldSet(1));
+  Messages::FieldCPtr innerField = Messages::FieldUInt32::create(1);
+  group->addField(identity_inner, innerField);
+  Messages::FieldCPtr groupField = Messages::FieldGroup::create(group);
+  groupField->publish();
+  BOOST_CHECK(groupField->isPublished());
+  BOOST_CHECK(innerField->isPublished());
+  Messages::FieldCPtr copy = innerField;
+  copy.reset();
+  BOOST_CHECK_EQUAL(innerField->toUInt32(), 1);
+}
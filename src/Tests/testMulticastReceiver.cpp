@@ -0,0 +1,222 @@
+// Copyright (c) 2011, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Communication/MulticastReceiver.h>
+
+#if defined(QUICKFAST_HAS_RECVMMSG)
+#include <Communication/Assembler.h>
+#include <Communication/LinkedBuffer.h>
+#include <Codecs/TemplateRegistry.h>
+#include <Common/AtomicOps.h>
+
+using namespace QuickFAST;
+
+namespace
+{
+  const char * const multicastGroup = "239.255.0.1";
+  const size_t bufferSize = 100;
+
+  class RecordingLogger : public Common::Logger
+  {
+  public:
+    virtual bool wantLog(unsigned short level)
+    {
+      return level <= Common::Logger::QF_LOG_WARNING;
+    }
+    virtual bool logMessage(unsigned short, const std::string &){return true;}
+    virtual bool reportDecodingError(const std::string & message)
+    {
+      errors_.push_back(message);
+      return true;
+    }
+    virtual bool reportCommunicationError(const std::string & message)
+    {
+      errors_.push_back(message);
+      return true;
+    }
+
+    std::vector<std::string> errors_;
+  };
+
+  /// Keep each packet the receiver delivers.  Ask to stop once enough have arrived.
+  class PacketAssembler : public Communication::Assembler
+  {
+  public:
+    PacketAssembler(Common::Logger & logger, size_t stopAfter)
+      : Communication::Assembler(Codecs::TemplateRegistryPtr(new Codecs::TemplateRegistry), logger)
+      , stopAfter_(stopAfter)
+      , finished_(0)
+    {
+    }
+
+    virtual void receiverStarted(Communication::Receiver &)
+    {
+    }
+
+    virtual void receiverStopped(Communication::Receiver &)
+    {
+    }
+
+    virtual bool serviceQueue(Communication::Receiver & receiver)
+    {
+      // Take everything that is waiting so no full buffers are left behind.
+      Communication::LinkedBuffer * buffer = receiver.getBuffer(false);
+      while(buffer != 0)
+      {
+        packets_.push_back(std::string(reinterpret_cast<const char *>(buffer->get()), buffer->used()));
+        receiver.releaseBuffer(buffer);
+        buffer = receiver.getBuffer(false);
+      }
+      if(packets_.size() >= stopAfter_)
+      {
+        atomicStoreRelease(&finished_, 1);
+        return false;
+      }
+      return true;
+    }
+
+    /// @brief Wait up to five seconds for serviceQueue() to ask to stop.
+    bool waitFinished()
+    {
+      for(size_t nWait = 0; nWait < 500 && atomicLoadAcquire(&finished_) == 0; ++nWait)
+      {
+        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+      }
+      return atomicLoadAcquire(&finished_) != 0;
+    }
+
+    std::vector<std::string> packets_;
+    size_t stopAfter_;
+    volatile long finished_;
+  };
+
+  /// Give the test a view of the buffers the receiver is holding.
+  class InspectableReceiver : public Communication::MulticastReceiver
+  {
+  public:
+    InspectableReceiver(boost::asio::io_service & ioService, unsigned short port)
+      : Communication::MulticastReceiver(ioService, multicastGroup, "127.0.0.1", "0.0.0.0", port)
+    {
+    }
+
+    /// @brief Count the buffers waiting to be filled, including those the assembler released.
+    size_t idleBufferCount()
+    {
+      boost::mutex::scoped_lock lock(bufferMutex_);
+      for(Communication::LinkedBuffer * idle = idleRing_.pop(); idle != 0; idle = idleRing_.pop())
+      {
+        idleBufferPool_.push(idle);
+      }
+      idleBufferPool_.push(idleBuffers_);
+      size_t count = 0;
+      for(Communication::LinkedBuffer * buffer = idleBufferPool_.begin(); buffer != 0; buffer = buffer->link())
+      {
+        ++count;
+      }
+      return count;
+    }
+  };
+
+  std::string packetContents(size_t nPacket)
+  {
+    std::stringstream packet;
+    packet << "packet " << nPacket;
+    return packet.str();
+  }
+
+  void sendPackets(unsigned short port, size_t count)
+  {
+    boost::asio::io_service ioService;
+    boost::asio::ip::udp::socket socket(ioService, boost::asio::ip::udp::v4());
+    socket.set_option(boost::asio::ip::multicast::outbound_interface(boost::asio::ip::address_v4::loopback()));
+    socket.set_option(boost::asio::ip::multicast::enable_loopback(true));
+    boost::asio::ip::udp::endpoint target(boost::asio::ip::address::from_string(multicastGroup), port);
+    for(size_t nPacket = 0; nPacket < count; ++nPacket)
+    {
+      std::string packet = packetContents(nPacket);
+      socket.send_to(boost::asio::buffer(packet), target);
+    }
+  }
+
+  /// @brief Start the receiver, or explain why multicast on the loopback interface is unavailable.
+  bool startReceiver(Communication::Receiver & receiver, Communication::Assembler & assembler, size_t bufferCount)
+  {
+    try
+    {
+      return receiver.start(assembler, bufferSize, bufferCount);
+    }
+    catch(const std::exception & ex)
+    {
+      BOOST_TEST_MESSAGE("Multicast on the loopback interface is not available: " << ex.what());
+    }
+    return false;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestMulticastReceiverBatch)
+{
+  const size_t packetCount = 10;
+  RecordingLogger logger;
+  PacketAssembler assembler(logger, packetCount);
+  boost::asio::io_service ioService;
+  InspectableReceiver receiver(ioService, 30401);
+  receiver.setBatchReceive(4);
+  if(!startReceiver(receiver, assembler, 12))
+  {
+    return;
+  }
+  receiver.runThreads(1, false);
+  sendPackets(30401, packetCount);
+  BOOST_CHECK(assembler.waitFinished());
+  receiver.joinThreads();
+
+  BOOST_REQUIRE_EQUAL(assembler.packets_.size(), packetCount);
+  for(size_t nPacket = 0; nPacket < packetCount; ++nPacket)
+  {
+    BOOST_CHECK_EQUAL(assembler.packets_[nPacket], packetContents(nPacket));
+  }
+  BOOST_CHECK(receiver.batchesReceived() >= 1);
+  BOOST_CHECK(receiver.batchesReceived() <= packetCount);
+  BOOST_CHECK(logger.errors_.empty());
+}
+
+BOOST_AUTO_TEST_CASE(TestMulticastReceiverBusyPollStop)
+{
+  const size_t bufferCount = 12;
+  RecordingLogger logger;
+  {
+    // Stopped from outside while a batch waits for packets that never come.
+    PacketAssembler assembler(logger, 1);
+    boost::asio::io_service ioService;
+    InspectableReceiver receiver(ioService, 30402);
+    receiver.setBatchReceive(4, true);
+    if(!startReceiver(receiver, assembler, bufferCount))
+    {
+      return;
+    }
+    receiver.stop();
+    BOOST_CHECK_EQUAL(receiver.idleBufferCount(), bufferCount);
+  }
+  {
+    // The assembler asks to stop, so stop() runs on the polling thread.
+    PacketAssembler assembler(logger, 3);
+    boost::asio::io_service ioService;
+    InspectableReceiver receiver(ioService, 30403);
+    receiver.setBatchReceive(4, true);
+    BOOST_REQUIRE(startReceiver(receiver, assembler, bufferCount));
+    sendPackets(30403, 10);
+    BOOST_CHECK(assembler.waitFinished());
+    // waits for the polling thread, which then gives back the batch it had ready.
+    receiver.joinThreads();
+    BOOST_CHECK(assembler.packets_.size() >= 3);
+    BOOST_CHECK_EQUAL(receiver.idleBufferCount(), bufferCount);
+  }
+  BOOST_CHECK(logger.errors_.empty());
+}
+
+#endif // QUICKFAST_HAS_RECVMMSG
@@ -0,0 +1,239 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <Communication/PCapReader.h>
+#include <Common/MappedFile.h>
+
+using namespace QuickFAST;
+
+namespace
+{
+  /// Build capture files one field at a time in native byte order.
+  class CaptureWriter
+  {
+  public:
+    void put32(uint32 value)
+    {
+      append(&value, sizeof(value));
+    }
+
+    void put16(uint16 value)
+    {
+      append(&value, sizeof(value));
+    }
+
+    void pad()
+    {
+      while(data_.size() % 4 != 0)
+      {
+        data_.push_back(0);
+      }
+    }
+
+    /// An Ethernet frame carrying a UDP datagram.
+    static std::string udpFrame(const std::string & payload)
+    {
+      std::string frame(14, '\0');   // Ethernet II
+      frame[12] = 0x08;              // IP
+      std::string ip(20, '\0');
+      ip[0] = 0x45;                  // version 4, 5 words
+      ip[9] = 17;                    // UDP
+      frame += ip;
+      size_t udpLength = payload.size() + 8;
+      std::string udp(8, '\0');
+      udp[4] = char(udpLength >> 8); // network byte order
+      udp[5] = char(udpLength & 0xFF);
+      frame += udp;
+      return frame + payload;
+    }
+
+    void append(const void * data, size_t size)
+    {
+      const char * bytes = static_cast<const char *>(data);
+      data_.append(bytes, bytes + size);
+    }
+
+    void write(const std::string & filename)const
+    {
+      std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      file.write(data_.data(), data_.size());
+    }
+
+  private:
+    std::string data_;
+  };
+
+  std::string workingFile(const char * name)
+  {
+    std::string root(std::getenv("QUICKFAST_ROOT"));
+    return root + "/src/Tests/resources/" + name;
+  }
+
+  std::string nextPayload(Communication::PCapReader & reader)
+  {
+    const unsigned char * buffer = 0;
+    size_t size = 0;
+    if(!reader.read(buffer, size))
+    {
+      return "<none>";
+    }
+    return std::string(reinterpret_cast<const char *>(buffer), size);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestMappedFile)
+{
+  std::string filename = workingFile("mappedFileTest.out");
+  CaptureWriter writer;
+  writer.append("0123456789", 10);
+  writer.write(filename);
+
+  MappedFile file;
+  BOOST_CHECK(!file.isOpen());
+  BOOST_REQUIRE_MESSAGE(file.open(filename.c_str()), file.error());
+  BOOST_CHECK_EQUAL(file.size(), 10);
+  BOOST_CHECK_EQUAL(std::string(reinterpret_cast<const char *>(file.data()), 10), "0123456789");
+  // advice never changes the data
+  file.adviseSequential();
+  file.prefetch(0, 10);
+  file.release(0, 10);
+  BOOST_CHECK_EQUAL(file.data()[9], '9');
+  file.close();
+  BOOST_CHECK(!file.isOpen());
+  BOOST_CHECK(file.data() == 0);
+
+  BOOST_CHECK(!file.open(workingFile("noSuchFile.pcap").c_str()));
+  BOOST_CHECK(!file.error().empty());
+  boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_CASE(TestPCapReaderClassic)
+{
+  std::string filename = workingFile("pcapReaderTest.out");
+  CaptureWriter writer;
+  writer.put32(0xa1b2c3d4);  // magic
+  writer.put16(2);           // version
+  writer.put16(4);
+  writer.put32(0);           // zone
+  writer.put32(0);           // sigfigs
+  writer.put32(65535);       // snap length
+  writer.put32(1);           // Ethernet
+
+  const char * payloads[] = {"first", "truncated", "third packet"};
+  for(size_t nPacket = 0; nPacket < 3; ++nPacket)
+  {
+    std::string frame = CaptureWriter::udpFrame(payloads[nPacket]);
+    uint32 captured = uint32(frame.size());
+    if(nPacket == 1)
+    {
+      captured -= 2;
+    }
+    writer.put32(1234567890);  // seconds
+    writer.put32(nPacket);     // microseconds
+    writer.put32(captured);
+    writer.put32(uint32(frame.size()));
+    writer.append(frame.data(), captured);
+  }
+  writer.write(filename);
+
+  Communication::PCapReader reader;
+  reader.set32bit();
+  BOOST_REQUIRE(reader.open(filename.c_str()));
+  BOOST_CHECK(!reader.isPcapNg());
+  BOOST_CHECK_EQUAL(nextPayload(reader), "first");
+  // the truncated packet is skipped
+  BOOST_CHECK_EQUAL(nextPayload(reader), "third packet");
+  BOOST_CHECK_EQUAL(nextPayload(reader), "<none>");
+  BOOST_CHECK(!reader.good());
+
+  BOOST_REQUIRE(reader.rewind());
+  BOOST_CHECK_EQUAL(nextPayload(reader), "first");
+  reader.close();
+  boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_CASE(TestPCapReaderPcapNg)
+{
+  std::string filename = workingFile("pcapngReaderTest.out");
+  CaptureWriter writer;
+  // section header
+  writer.put32(0x0A0D0D0A);
+  writer.put32(28);
+  writer.put32(0x1A2B3C4D);
+  writer.put16(1);
+  writer.put16(0);
+  writer.put32(0xFFFFFFFF);  // section length unknown
+  writer.put32(0xFFFFFFFF);
+  writer.put32(28);
+
+  // interface description: Ethernet
+  writer.put32(1);
+  writer.put32(20);
+  writer.put16(1);
+  writer.put16(0);
+  writer.put32(65535);
+  writer.put32(20);
+
+  // a block type the reader does not care about
+  writer.put32(0x00000BAD);
+  writer.put32(16);
+  writer.put32(42);
+  writer.put32(16);
+
+  // enhanced packet
+  std::string frame = CaptureWriter::udpFrame("enhanced");
+  uint32 padded = uint32((frame.size() + 3) / 4 * 4);
+  writer.put32(6);
+  writer.put32(32 + padded);
+  writer.put32(0);           // interface
+  writer.put32(0);           // time stamp
+  writer.put32(0);
+  writer.put32(uint32(frame.size()));
+  writer.put32(uint32(frame.size()));
+  writer.append(frame.data(), frame.size());
+  writer.pad();
+  writer.put32(32 + padded);
+
+  // simple packet
+  frame = CaptureWriter::udpFrame("simple");
+  padded = uint32((frame.size() + 3) / 4 * 4);
+  writer.put32(3);
+  writer.put32(16 + padded);
+  writer.put32(uint32(frame.size()));
+  writer.append(frame.data(), frame.size());
+  writer.pad();
+  writer.put32(16 + padded);
+
+  // enhanced packet from an interface that was never described
+  frame = CaptureWriter::udpFrame("orphan");
+  padded = uint32((frame.size() + 3) / 4 * 4);
+  writer.put32(6);
+  writer.put32(32 + padded);
+  writer.put32(7);
+  writer.put32(0);
+  writer.put32(0);
+  writer.put32(uint32(frame.size()));
+  writer.put32(uint32(frame.size()));
+  writer.append(frame.data(), frame.size());
+  writer.pad();
+  writer.put32(32 + padded);
+  writer.write(filename);
+
+  Communication::PCapReader reader;
+  BOOST_REQUIRE(reader.open(filename.c_str()));
+  BOOST_CHECK(reader.isPcapNg());
+  BOOST_CHECK_EQUAL(nextPayload(reader), "enhanced");
+  BOOST_CHECK_EQUAL(nextPayload(reader), "simple");
+  BOOST_CHECK_EQUAL(nextPayload(reader), "<none>");
+
+  BOOST_REQUIRE(reader.rewind());
+  BOOST_CHECK_EQUAL(nextPayload(reader), "enhanced");
+  reader.close();
+  boost::filesystem::remove(filename);
+}
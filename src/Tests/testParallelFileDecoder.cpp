@@ -0,0 +1,233 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Codecs/ParallelFileDecoder.h>
+#include <Codecs/FixedSizeHeaderAnalyzer.h>
+#include <Codecs/Template.h>
+#include <Codecs/TemplateRegistry.h>
+#include <Codecs/Context.h>
+#include <Codecs/FieldInstructionUInt32.h>
+#include <Codecs/FieldOpCopy.h>
+#include <Codecs/Encoder.h>
+#include <Codecs/DataDestination.h>
+#include <Codecs/GenericMessageBuilder.h>
+#include <Codecs/MessageConsumer.h>
+#include <Messages/Message.h>
+#include <Messages/FieldUInt32.h>
+#include <Common/Exceptions.h>
+
+using namespace QuickFAST;
+
+namespace
+{
+  class TradeConsumer : public Codecs::MessageConsumer
+  {
+  public:
+    virtual bool consumeMessage(Messages::Message & message)
+    {
+      Messages::FieldCPtr value;
+      BOOST_REQUIRE(message.getField("seqNum", value));
+      seqNums_.push_back(value->toUInt32());
+      BOOST_REQUIRE(message.getField("price", value));
+      prices_.push_back(value->toUInt32());
+      return true;
+    }
+    virtual void decodingStarted(){}
+    virtual void decodingStopped(){}
+    virtual bool wantLog(unsigned short){return false;}
+    virtual bool logMessage(unsigned short, const std::string &){return true;}
+    virtual bool reportDecodingError(const std::string & message)
+    {
+      errors_.push_back(message);
+      return true;
+    }
+    virtual bool reportCommunicationError(const std::string &){return true;}
+
+    std::vector<uint32> seqNums_;
+    std::vector<uint32> prices_;
+    std::vector<std::string> errors_;
+  };
+
+  /// Trades use template 7; a nonzero alternateId adds a second template with the same fields.
+  Codecs::TemplateRegistryPtr tradeTemplates(template_id_t alternateId = 0)
+  {
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    template_id_t ids[] = {7, alternateId};
+    for(size_t nTemplate = 0; nTemplate < 2 && ids[nTemplate] != 0; ++nTemplate)
+    {
+      // Both fields use copy, so decoding depends on the messages before.
+      Codecs::TemplatePtr templ(new Codecs::Template);
+      templ->setId(ids[nTemplate]);
+      templ->setTemplateName(nTemplate == 0 ? "Trade" : "AlternateTrade");
+      const char * names[] = {"seqNum", "price"};
+      for(size_t nField = 0; nField < 2; ++nField)
+      {
+        Codecs::FieldInstructionPtr instruction(new Codecs::FieldInstructionUInt32(names[nField], ""));
+        instruction->setFieldOp(Codecs::FieldOpPtr(new Codecs::FieldOpCopy));
+        templ->addInstruction(instruction);
+      }
+      registry->addTemplate(templ);
+    }
+    registry->finalize();
+    return registry;
+  }
+
+  uint32 priceOf(size_t nMsg)
+  {
+    return uint32(1000 + nMsg / 4);
+  }
+
+  /// Append a block with a two byte big endian size header.
+  void appendBlock(std::string & file, const std::string & body)
+  {
+    file += char(body.size() >> 8);
+    file += char(body.size() & 0xFF);
+    file += body;
+  }
+
+  /// One message per block.  The encoder starts over every resetEvery
+  /// messages; with resetInBand an SCP reset message says so.  A nonzero
+  /// alternateId encodes every other message with that template instead.
+  std::string encodeTrades(
+    Codecs::TemplateRegistryPtr registry,
+    size_t messageCount,
+    size_t resetEvery,
+    bool resetInBand,
+    template_id_t alternateId = 0)
+  {
+    Messages::FieldIdentityCPtr identity_seqNum = new Messages::FieldIdentity("seqNum");
+    Messages::FieldIdentityCPtr identity_price = new Messages::FieldIdentity("price");
+    Codecs::Encoder encoder(registry);
+    std::string file;
+    for(size_t nMsg = 0; nMsg < messageCount; ++nMsg)
+    {
+      std::string body;
+      if(nMsg % resetEvery == 0)
+      {
+        encoder.reset();
+        if(resetInBand)
+        {
+          body = std::string("\xC0\xF8", 2);
+        }
+      }
+      Messages::Message msg(registry->maxFieldCount());
+      msg.addField(identity_seqNum, Messages::FieldUInt32::create(uint32(nMsg)));
+      msg.addField(identity_price, Messages::FieldUInt32::create(priceOf(nMsg)));
+      Codecs::DataDestination destination;
+      encoder.encodeMessage(destination, (alternateId != 0 && nMsg % 2 != 0) ? alternateId : 7, msg);
+      std::string encoded;
+      destination.toString(encoded);
+      appendBlock(file, body + encoded);
+    }
+    return file;
+  }
+
+  void checkTrades(const TradeConsumer & consumer, size_t messageCount)
+  {
+    BOOST_REQUIRE_EQUAL(consumer.seqNums_.size(), messageCount);
+    for(size_t nMsg = 0; nMsg < messageCount; ++nMsg)
+    {
+      BOOST_CHECK_EQUAL(consumer.seqNums_[nMsg], nMsg);
+      BOOST_CHECK_EQUAL(consumer.prices_[nMsg], priceOf(nMsg));
+    }
+  }
+
+  const unsigned char * bytesOf(const std::string & file)
+  {
+    return reinterpret_cast<const unsigned char *>(file.data());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestParallelFileDecoderResetEveryBlock)
+{
+  Codecs::TemplateRegistryPtr registry = tradeTemplates();
+  const size_t messageCount = 100;
+  std::string file = encodeTrades(registry, messageCount, 1, false);
+
+  Codecs::FixedSizeHeaderAnalyzer analyzer(2, true);
+  Codecs::ParallelFileDecoder decoder(registry, analyzer);
+  decoder.setResetOnMessage(true);
+  decoder.setThreadCount(3);
+  decoder.setChunkSize(1);
+  // fewer slots than threads still works; the spare thread just waits.
+  decoder.setLookAhead(2);
+  TradeConsumer consumer;
+  Codecs::GenericMessageBuilder builder(consumer);
+  decoder.decode(bytesOf(file), file.size(), builder);
+
+  BOOST_CHECK_EQUAL(decoder.blockCount(), messageCount);
+  BOOST_CHECK_EQUAL(decoder.chunkCount(), messageCount);
+  BOOST_CHECK_EQUAL(decoder.messageCount(), messageCount);
+  BOOST_CHECK(consumer.errors_.empty());
+  checkTrades(consumer, messageCount);
+}
+
+BOOST_AUTO_TEST_CASE(TestParallelFileDecoderSCPReset)
+{
+  Codecs::TemplateRegistryPtr registry = tradeTemplates();
+  const size_t messageCount = 100;
+  std::string file = encodeTrades(registry, messageCount, 10, true);
+  // a block cut short at the end of the file
+  file += std::string("\x00\x10\xC0", 3);
+
+  Codecs::FixedSizeHeaderAnalyzer analyzer(2, true);
+  Codecs::ParallelFileDecoder decoder(registry, analyzer);
+  decoder.setThreadCount(4);
+  decoder.setChunkSize(1);
+  TradeConsumer consumer;
+  Codecs::GenericMessageBuilder builder(consumer);
+  decoder.decode(bytesOf(file), file.size(), builder);
+
+  BOOST_CHECK_EQUAL(decoder.blockCount(), messageCount);
+  // Only the blocks that begin with a reset can start a chunk.
+  BOOST_CHECK_EQUAL(decoder.chunkCount(), messageCount / 10);
+  BOOST_CHECK_EQUAL(consumer.errors_.size(), 1);
+  checkTrades(consumer, messageCount);
+
+  // Large chunks hold several reset intervals each.
+  decoder.setChunkSize(file.size() / 3);
+  TradeConsumer fewer;
+  Codecs::GenericMessageBuilder fewerBuilder(fewer);
+  decoder.decode(bytesOf(file), file.size(), fewerBuilder);
+  BOOST_CHECK(decoder.chunkCount() > 1);
+  BOOST_CHECK(decoder.chunkCount() < messageCount / 10);
+  checkTrades(fewer, messageCount);
+}
+
+BOOST_AUTO_TEST_CASE(TestParallelFileDecoderApplicationTemplate120)
+{
+  // An application template may use the SCP reset ID; it does not reset.
+  // Alternating templates puts a template ID in every message.
+  Codecs::TemplateRegistryPtr registry = tradeTemplates(Codecs::Context::SCPResetTemplateId);
+  const size_t messageCount = 40;
+  std::string file = encodeTrades(registry, messageCount, messageCount, false, Codecs::Context::SCPResetTemplateId);
+
+  Codecs::FixedSizeHeaderAnalyzer analyzer(2, true);
+  Codecs::ParallelFileDecoder decoder(registry, analyzer);
+  decoder.setThreadCount(4);
+  decoder.setChunkSize(1);
+  TradeConsumer consumer;
+  Codecs::GenericMessageBuilder builder(consumer);
+  decoder.decode(bytesOf(file), file.size(), builder);
+
+  BOOST_CHECK_EQUAL(decoder.blockCount(), messageCount);
+  BOOST_CHECK_EQUAL(decoder.chunkCount(), 1);
+  BOOST_CHECK(consumer.errors_.empty());
+  checkTrades(consumer, messageCount);
+}
+
+BOOST_AUTO_TEST_CASE(TestParallelFileDecoderNeedsBlockSize)
+{
+  Codecs::TemplateRegistryPtr registry = tradeTemplates();
+  std::string file = encodeTrades(registry, 3, 1, false);
+  Codecs::FixedSizeHeaderAnalyzer analyzer(0, true, 2);
+  Codecs::ParallelFileDecoder decoder(registry, analyzer);
+  TradeConsumer consumer;
+  Codecs::GenericMessageBuilder builder(consumer);
+  BOOST_CHECK_THROW(decoder.decode(bytesOf(file), file.size(), builder), UsageError);
+}
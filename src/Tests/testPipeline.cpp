@@ -0,0 +1,134 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Tests/DecodingFixture.h>
+#include <Codecs/Decoder.h>
+#include <Codecs/DataSourceString.h>
+#include <Codecs/GenericMessageBuilder.h>
+#include <Messages/PipelinedMessageBuilder.h>
+#include <Messages/RecordedMessage.h>
+#include <Codecs/SingleMessageConsumer.h>
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+BOOST_AUTO_TEST_CASE(testPipelinedMessageBuilder)
+{
+  Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+  const size_t messageCount = 200;
+  std::string fastString = encodePlanMessages(registry, messageCount);
+
+  CollectingConsumer direct;
+  {
+    Codecs::GenericMessageBuilder builder(direct);
+    Codecs::Decoder decoder(registry);
+    Codecs::DataSourceString source(fastString);
+    for(size_t nMsg = 0; nMsg < messageCount; ++nMsg)
+    {
+      decoder.decodeMessage(source, builder);
+    }
+  }
+  BOOST_REQUIRE_EQUAL(direct.messages_.size(), messageCount);
+
+  // A small ring makes the decoder wait for the consumer now and then.
+  CollectingConsumer piped;
+  Codecs::GenericMessageBuilder pipedBuilder(piped);
+  Messages::PipelinedMessageBuilder pipeline(pipedBuilder, 4);
+  pipeline.setBatchLimit(3);
+  pipeline.start();
+  {
+    Codecs::Decoder decoder(registry);
+    Codecs::DataSourceString source(fastString);
+    for(size_t nMsg = 0; nMsg < messageCount; ++nMsg)
+    {
+      decoder.decodeMessage(source, pipeline);
+    }
+  }
+  pipeline.flush();
+  BOOST_CHECK_EQUAL(pipeline.published(), messageCount);
+  BOOST_CHECK_EQUAL(pipeline.consumed(), messageCount);
+  BOOST_CHECK_EQUAL(pipeline.discarded(), 0);
+  BOOST_CHECK(pipeline.batches() > 0);
+  BOOST_CHECK(pipeline.largestBatch() <= 3);
+  pipeline.stop();
+  BOOST_CHECK(piped.thread_ != boost::this_thread::get_id());
+  BOOST_REQUIRE_EQUAL(piped.messages_.size(), messageCount);
+  for(size_t nMsg = 0; nMsg < messageCount; ++nMsg)
+  {
+    BOOST_CHECK_EQUAL(piped.messages_[nMsg], direct.messages_[nMsg]);
+  }
+
+  // With nobody consuming, a discarding pipeline keeps only what fits.
+  CollectingConsumer dropped;
+  Codecs::GenericMessageBuilder droppedBuilder(dropped);
+  Messages::PipelinedMessageBuilder lossy(droppedBuilder, 2, Messages::PipelinedMessageBuilder::DISCARD);
+  {
+    Codecs::Decoder decoder(registry);
+    Codecs::DataSourceString source(fastString);
+    for(size_t nMsg = 0; nMsg < 5; ++nMsg)
+    {
+      decoder.decodeMessage(source, lossy);
+    }
+  }
+  BOOST_CHECK_EQUAL(lossy.published(), 2);
+  BOOST_CHECK_EQUAL(lossy.discarded(), 3);
+  lossy.start();
+  lossy.stop();
+  BOOST_REQUIRE_EQUAL(dropped.messages_.size(), 2);
+  BOOST_CHECK_EQUAL(dropped.messages_[1], direct.messages_[1]);
+
+  // Sequences are replayed entry by entry.
+  Codecs::TemplateRegistryPtr sequenceRegistry = createSnapshotRegistry();
+  std::vector<uint32> expectedPrices;
+  fastString = encodeSnapshots(sequenceRegistry, 10, 1, expectedPrices);
+
+  SnapshotConsumer snapshots;
+  Codecs::GenericMessageBuilder snapshotBuilder(snapshots);
+  Messages::PipelinedMessageBuilder sequencePipeline(snapshotBuilder, 3);
+  sequencePipeline.start();
+  {
+    Codecs::Decoder decoder(sequenceRegistry);
+    Codecs::DataSourceString source(fastString);
+    for(size_t nMsg = 0; nMsg < 10; ++nMsg)
+    {
+      BOOST_REQUIRE(decoder.decodeMessage(source, sequencePipeline));
+    }
+  }
+  sequencePipeline.stop();
+  BOOST_REQUIRE_EQUAL(snapshots.seqNums_.size(), 10);
+  BOOST_CHECK_EQUAL(snapshots.seqNums_[9], 9);
+  BOOST_CHECK(snapshots.prices_ == expectedPrices);
+}
+
+BOOST_AUTO_TEST_CASE(testRecordedMessageKeepsNames)
+{
+  // The recording outlives the strings it was given.
+  Messages::FieldIdentityCPtr identity_price = new Messages::FieldIdentity("price");
+  Messages::RecordedMessage recording;
+  for(int pass = 0; pass < 2; ++pass)
+  {
+    recording.clear();
+    {
+      std::string applicationType(pass == 0 ? "Trade" : "Quote");
+      std::string applicationTypeNamespace("ns");
+      recording.startMessage(applicationType, applicationTypeNamespace, 1);
+      recording.addValue(identity_price, ValueType::UINT32, uint32(42 + pass));
+      recording.endMessage(false);
+      applicationType.assign(applicationType.size(), '?');
+    }
+
+    Codecs::SingleMessageConsumer consumer;
+    Codecs::GenericMessageBuilder builder(consumer);
+    BOOST_CHECK(recording.replay(builder));
+    BOOST_CHECK_EQUAL(consumer.message().getApplicationType(), pass == 0 ? "Trade" : "Quote");
+    BOOST_CHECK_EQUAL(consumer.message().getApplicationTypeNs(), "ns");
+    Messages::FieldCPtr value;
+    BOOST_REQUIRE(consumer.message().getField("price", value));
+    BOOST_CHECK_EQUAL(value->toUInt32(), uint32(42 + pass));
+  }
+}
@@ -146,3 +146,63 @@ BOOST_AUTO_TEST_CASE(testPmapEncoding2)
   const char expected[] = "\x80";
   BOOST_CHECK(result == expected);
 }
+
+BOOST_AUTO_TEST_CASE(testPmapRegister)
+{
+  // Short presence maps are decoded into a register; long ones into a buffer.
+  // Either way, every method should see the same presence map.
+  for(size_t byteCount = 1; byteCount <= 11; ++byteCount)
+  {
+    std::string encoded;
+    for(size_t nByte = 0; nByte < byteCount; ++nByte)
+    {
+      encoded += char((0x5B + 0x13 * nByte) & 0x7F);
+    }
+    encoded[byteCount - 1] |= char(0x80);
+    const std::string padding("\x81\x82\x83\x84\x85\x86\x87\x88");
+    const size_t bitCount = byteCount * 7;
+
+    Codecs::DataSourceString shortSource(encoded);
+    Codecs::PresenceMap shortPmap(1);
+    shortPmap.decode(shortSource);
+
+    Codecs::DataSourceString paddedSource(encoded + padding);
+    Codecs::PresenceMap paddedPmap(1);
+    paddedPmap.decode(paddedSource);
+    uchar byte = 0;
+    BOOST_CHECK(paddedSource.getByte(byte));
+    BOOST_CHECK_EQUAL(int(byte), 0x81);
+
+    std::string memory(encoded + padding);
+    size_t offset = 0;
+    Codecs::PresenceMap bufferPmap(1);
+    bufferPmap.decode(reinterpret_cast<const uchar *>(memory.data()), offset);
+    BOOST_CHECK_EQUAL(offset, byteCount);
+
+    const uchar * raw = 0;
+    size_t rawLength = 0;
+    paddedPmap.getRaw(raw, rawLength);
+    BOOST_REQUIRE(rawLength >= byteCount);
+    BOOST_CHECK(std::string(reinterpret_cast<const char *>(raw), byteCount) == encoded);
+
+    Codecs::PresenceMap expected(bitCount);
+    for(size_t bit = 0; bit < bitCount + 10; ++bit)
+    {
+      bool present = bit < bitCount && (uchar(encoded[bit / 7]) & (0x40 >> (bit % 7))) != 0;
+      BOOST_CHECK_EQUAL(paddedPmap.checkSpecificField(bit), present);
+      BOOST_CHECK_EQUAL(shortPmap.checkNextField(), present);
+      BOOST_CHECK_EQUAL(paddedPmap.checkNextField(), present);
+      BOOST_CHECK_EQUAL(bufferPmap.checkNextField(), present);
+      if(bit < bitCount - 4)
+      {
+        expected.setNextField(present);
+      }
+    }
+    bufferPmap.rewind();
+    for(size_t bit = 0; bit < bitCount - 4; ++bit)
+    {
+      (void)bufferPmap.checkNextField();
+    }
+    BOOST_CHECK(bufferPmap == expected);
+  }
+}
@@ -0,0 +1,128 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <Tests/DecodingFixture.h>
+#include <Codecs/GenericMessageBuilder.h>
+#include <Codecs/MessagePerPacketAssembler.h>
+#include <Codecs/NoHeaderAnalyzer.h>
+#include <Communication/BufferReceiver.h>
+#include <Codecs/StreamingAssembler.h>
+#include <Communication/MappedFileReceiver.h>
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+BOOST_AUTO_TEST_CASE(testReceiveLatencyTracking)
+{
+  Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+  const size_t messageCount = 4;
+  std::string fastString = encodePlanMessages(registry, messageCount);
+
+  for(size_t tracking = 0; tracking < 2; ++tracking)
+  {
+    CollectingConsumer consumer;
+    Codecs::GenericMessageBuilder builder(consumer);
+    Codecs::NoHeaderAnalyzer packetHeader;
+    Codecs::NoHeaderAnalyzer messageHeader;
+    Codecs::MessagePerPacketAssembler assembler(registry, packetHeader, messageHeader, builder);
+    Communication::BufferReceiver receiver;
+    receiver.setLatencyTracking(tracking != 0);
+    BOOST_CHECK_EQUAL(receiver.latencyTracking(), tracking != 0);
+    receiver.start(assembler);
+
+    uint64 before = LatencyHistogram::now();
+    receiver.receiveBuffer(reinterpret_cast<const unsigned char *>(fastString.data()), fastString.size());
+    uint64 after = LatencyHistogram::now();
+
+    BOOST_REQUIRE_EQUAL(consumer.receiveTimes_.size(), messageCount);
+    if(tracking == 0)
+    {
+      BOOST_CHECK_EQUAL(consumer.receiveTimes_[0], 0);
+      BOOST_CHECK_EQUAL(receiver.wireToDecodeLatency().count(), 0);
+      BOOST_CHECK_EQUAL(receiver.decodeAndConsumeLatency().count(), 0);
+    }
+    else
+    {
+      // every message in the packet shares the packet's arrival time.
+      for(size_t nMsg = 0; nMsg < messageCount; ++nMsg)
+      {
+        BOOST_CHECK(consumer.receiveTimes_[nMsg] >= before);
+        BOOST_CHECK(consumer.receiveTimes_[nMsg] <= after);
+        BOOST_CHECK_EQUAL(consumer.receiveTimes_[nMsg], consumer.receiveTimes_[0]);
+      }
+      BOOST_CHECK_EQUAL(receiver.wireToDecodeLatency().count(), messageCount);
+      BOOST_CHECK_EQUAL(receiver.decodeAndConsumeLatency().count(), messageCount);
+      BOOST_CHECK(receiver.wireToDecodeLatency().maximum() <= after - before);
+    }
+  }
+}
+
+namespace
+{
+  /// Take a measurable amount of time with each message.
+  class SlowConsumer : public StubConsumer
+  {
+  public:
+    virtual bool consumeMessage(Messages::Message &)
+    {
+      boost::this_thread::sleep(boost::posix_time::milliseconds(2));
+      return true;
+    }
+  };
+}
+
+BOOST_AUTO_TEST_CASE(testDecodeAndConsumeLatency)
+{
+  Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+  const size_t messageCount = 3;
+  std::string fastString = encodePlanMessages(registry, messageCount);
+
+  SlowConsumer consumer;
+  Codecs::GenericMessageBuilder builder(consumer);
+  Codecs::NoHeaderAnalyzer packetHeader;
+  Codecs::NoHeaderAnalyzer messageHeader;
+  Codecs::MessagePerPacketAssembler assembler(registry, packetHeader, messageHeader, builder);
+  Communication::BufferReceiver receiver;
+  receiver.setLatencyTracking();
+  receiver.start(assembler);
+  receiver.receiveBuffer(reinterpret_cast<const unsigned char *>(fastString.data()), fastString.size());
+
+  // the consumer's time is part of the measurement.
+  BOOST_CHECK_EQUAL(receiver.decodeAndConsumeLatency().count(), messageCount);
+  BOOST_CHECK(receiver.decodeAndConsumeLatency().minimum() >= 2000000);
+}
+
+BOOST_AUTO_TEST_CASE(testMappedFileReceiver)
+{
+  Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+  const size_t messageCount = 50;
+  std::string fastString = encodePlanMessages(registry, messageCount);
+
+  std::string root(std::getenv("QUICKFAST_ROOT"));
+  std::string filename = root + "/src/Tests/resources/mappedFileReceiverTest.out";
+  {
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(fastString.data(), fastString.size());
+  }
+
+  // a tiny chunk size makes most messages straddle buffers.
+  CollectingConsumer consumer;
+  Codecs::GenericMessageBuilder builder(consumer);
+  Codecs::NoHeaderAnalyzer messageHeader;
+  Codecs::StreamingAssembler assembler(registry, messageHeader, builder);
+  Communication::MappedFileReceiver receiver(filename, 7, 4096);
+  BOOST_REQUIRE(receiver.start(assembler, 16, 4));
+  receiver.run();
+  BOOST_CHECK_EQUAL(consumer.receiveTimes_.size(), messageCount);
+  BOOST_CHECK_EQUAL(receiver.position(), fastString.size());
+
+  Communication::MappedFileReceiver missing(root + "/src/Tests/resources/noSuchFile.fast");
+  BOOST_CHECK(!missing.start(assembler));
+  boost::filesystem::remove(filename);
+}
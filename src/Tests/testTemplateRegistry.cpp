@@ -0,0 +1,114 @@
+// Copyright (c) 2009, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+
+#include <Tests/DecodingFixture.h>
+
+using namespace QuickFAST;
+using namespace QuickFAST::Tests;
+
+BOOST_AUTO_TEST_CASE(testTemplateRegistryFindTemplate)
+{
+  Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+  Codecs::TemplatePtr sparse(new Codecs::Template);
+  sparse->setId(100000);
+  sparse->setTemplateName("Sparse");
+  addField(sparse, Codecs::FieldInstructionPtr(new Codecs::FieldInstructionUInt32("copyU32", "")), new Codecs::FieldOpCopy, true);
+  registry->addTemplate(sparse);
+  registry->finalize();
+
+  Codecs::TemplateCPtr templ;
+  BOOST_REQUIRE(registry->getTemplate(1, templ));
+  BOOST_CHECK(registry->findTemplate(1) == templ.get());
+  BOOST_CHECK(registry->findTemplate(100000) == sparse.get());
+  BOOST_CHECK(registry->findTemplate(0) == 0);
+  BOOST_CHECK(registry->findTemplate(2) == 0);
+  BOOST_CHECK(registry->findTemplate(99999) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(testTemplateRegistryDictionarySizes)
+{
+  // copyU32, deltaI32 and incrementU64 keep numeric entries; copyAscii keeps a string.
+  Codecs::TemplateRegistryPtr registry = createPlanRegistry();
+  BOOST_CHECK_EQUAL(registry->numericDictionarySize(), 3);
+  BOOST_CHECK_EQUAL(registry->stringDictionarySize(), 1);
+  // the total is enough for either kind.
+  BOOST_CHECK_EQUAL(registry->dictionarySize(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(testTemplateRegistryFreesIdentities)
+{
+  // Hold counted references to the identities, then destroy everything else.
+  std::vector<Messages::FieldIdentityCPtr> held;
+  Codecs::TemplatePtr templ(new Codecs::Template);
+  templ->setId(2);
+  templ->setTemplateName("Held");
+  addField(templ, Codecs::FieldInstructionPtr(new Codecs::FieldInstructionUInt32("first", "")), new Codecs::FieldOpCopy, true);
+  addField(templ, Codecs::FieldInstructionPtr(new Codecs::FieldInstructionAscii("second", "")), new Codecs::FieldOpCopy, true);
+  for(size_t nField = 0; nField < templ->size(); ++nField)
+  {
+    held.push_back(templ->getInstruction(nField)->getIdentity());
+  }
+  {
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    registry->addTemplate(templ);
+    templ.reset();
+    registry->finalize();
+    BOOST_CHECK_EQUAL(registry->immortalIdentityCount(), held.size());
+    for(size_t nField = 0; nField < held.size(); ++nField)
+    {
+      BOOST_CHECK(held[nField]->isImmortal());
+    }
+  }
+  // Only our references remain, so the identities are freed with them.
+  for(size_t nField = 0; nField < held.size(); ++nField)
+  {
+    BOOST_CHECK(!held[nField]->isImmortal());
+    BOOST_CHECK_EQUAL(held[nField]->useCount(), 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testTemplateRegistryReleasedBeforeMessage)
+{
+  std::vector<Messages::FieldIdentityCPtr> held;
+  Codecs::TemplatePtr templ(new Codecs::Template);
+  templ->setId(2);
+  templ->setTemplateName("Held");
+  addField(templ, Codecs::FieldInstructionPtr(new Codecs::FieldInstructionUInt32("first", "")), new Codecs::FieldOpCopy, true);
+  addField(templ, Codecs::FieldInstructionPtr(new Codecs::FieldInstructionAscii("second", "")), new Codecs::FieldOpCopy, true);
+  for(size_t nField = 0; nField < templ->size(); ++nField)
+  {
+    held.push_back(templ->getInstruction(nField)->getIdentity());
+  }
+  Messages::FieldSetPtr fieldSet(new Messages::FieldSet(2));
+  {
+    Codecs::TemplateRegistryPtr registry(new Codecs::TemplateRegistry);
+    registry->addTemplate(templ);
+    templ.reset();
+    registry->finalize();
+    for(size_t nField = 0; nField < held.size(); ++nField)
+    {
+      fieldSet->addField(held[nField], Messages::FieldUInt32::create(uint32(nField)));
+    }
+  }
+  // The field set keeps the identities, and the template, immortal.
+  for(size_t nField = 0; nField < held.size(); ++nField)
+  {
+    BOOST_CHECK(held[nField]->isImmortal());
+  }
+  Messages::FieldCPtr value;
+  BOOST_REQUIRE(fieldSet->getField(*held[1], value));
+  BOOST_CHECK_EQUAL(value->toUInt32(), 1);
+
+  // Releasing it frees everything but our own references.
+  fieldSet.reset();
+  for(size_t nField = 0; nField < held.size(); ++nField)
+  {
+    BOOST_CHECK(!held[nField]->isImmortal());
+    BOOST_CHECK_EQUAL(held[nField]->useCount(), 1);
+  }
+}
@@ -0,0 +1,135 @@
+// Copyright (c) 2011, Object Computing, Inc.
+// All rights reserved.
+// See the file license.txt for licensing information.
+#include <Common/QuickFASTPch.h>
+
+#define BOOST_TEST_NO_MAIN QuickFASTTest
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <Communication/UringFileReader.h>
+
+#if defined(QUICKFAST_HAS_IO_URING)
+#include <poll.h>
+
+using namespace QuickFAST;
+
+namespace
+{
+  const size_t blockSize = 1000;
+  const size_t blockCount = 10;
+  const size_t fileSize = blockSize * blockCount - 123; // the last block is short
+
+  std::string writeTestFile()
+  {
+    std::string filename(std::getenv("QUICKFAST_ROOT"));
+    filename += "/src/Tests/resources/uringFileReaderTest.out";
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    for(size_t pos = 0; pos < fileSize; ++pos)
+    {
+      file.put(char(pos % 251));
+    }
+    return filename;
+  }
+
+  /// Read the whole file through the reader, several blocks at a time.
+  void readAll(Communication::UringFileReader & reader, unsigned char * memory)
+  {
+    size_t nextBlock = 0;
+    size_t received = 0;
+    size_t total = 0;
+    while(received < blockCount)
+    {
+      while(nextBlock < blockCount
+        && reader.read(memory + nextBlock * blockSize, blockSize, nextBlock * blockSize, nextBlock))
+      {
+        ++nextBlock;
+      }
+      BOOST_REQUIRE_MESSAGE(reader.submit(), reader.error());
+      struct pollfd event;
+      event.fd = reader.eventFd();
+      event.events = POLLIN;
+      BOOST_REQUIRE_EQUAL(::poll(&event, 1, 5000), 1);
+      reader.clearEvent();
+      uint64 block;
+      int result;
+      while(reader.complete(block, result))
+      {
+        BOOST_REQUIRE(block < blockCount);
+        BOOST_CHECK_EQUAL(size_t(result), std::min(blockSize, fileSize - size_t(block) * blockSize));
+        total += size_t(result);
+        ++received;
+      }
+    }
+    BOOST_CHECK_EQUAL(total, fileSize);
+    BOOST_CHECK_EQUAL(reader.inFlight(), 0);
+    for(size_t pos = 0; pos < fileSize; ++pos)
+    {
+      if(memory[pos] != (unsigned char)(pos % 251))
+      {
+        BOOST_FAIL("Wrong data at " << pos);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestUringFileReader)
+{
+  if(!Communication::UringFileReader::isSupported())
+  {
+    BOOST_TEST_MESSAGE("io_uring is not available.  Skipping TestUringFileReader.");
+    return;
+  }
+  std::string filename = writeTestFile();
+  std::vector<unsigned char> memory(blockSize * blockCount);
+
+  Communication::UringFileReader reader;
+  BOOST_CHECK(!reader.isOpen());
+  BOOST_REQUIRE_MESSAGE(reader.open(filename, 0, 4), reader.error());
+  BOOST_CHECK(reader.isOpen());
+  // no more than depth reads at once
+  BOOST_CHECK(reader.read(&memory[0], blockSize, 0, 0));
+  BOOST_CHECK(reader.read(&memory[0], blockSize, 0, 0));
+  BOOST_CHECK(reader.read(&memory[0], blockSize, 0, 0));
+  BOOST_CHECK(reader.read(&memory[0], blockSize, 0, 0));
+  BOOST_CHECK(!reader.read(&memory[0], blockSize, 0, 0));
+  reader.close();
+  BOOST_CHECK(!reader.isOpen());
+
+  // close() waits for submitted reads, so the memory may be reused at once.
+  BOOST_REQUIRE_MESSAGE(reader.open(filename, 0, 4), reader.error());
+  for(size_t nBlock = 0; nBlock < 4; ++nBlock)
+  {
+    BOOST_CHECK(reader.read(&memory[nBlock * blockSize], blockSize, nBlock * blockSize, nBlock));
+  }
+  BOOST_REQUIRE_MESSAGE(reader.submit(), reader.error());
+  reader.close();
+  BOOST_CHECK_EQUAL(reader.inFlight(), 0);
+  for(size_t pos = 0; pos < 4 * blockSize; ++pos)
+  {
+    if(memory[pos] != (unsigned char)(pos % 251))
+    {
+      BOOST_FAIL("Wrong data at " << pos);
+    }
+  }
+
+  std::fill(memory.begin(), memory.end(), 0);
+  BOOST_REQUIRE_MESSAGE(reader.open(filename, 0, 4), reader.error());
+  readAll(reader, &memory[0]);
+
+  // Registration can be refused by resource limits; reads work either way.
+  std::fill(memory.begin(), memory.end(), 0);
+  BOOST_REQUIRE_MESSAGE(reader.open(filename, 0, 3), reader.error());
+  if(!reader.registerBuffers(&memory[0], memory.size()))
+  {
+    BOOST_TEST_MESSAGE(reader.error());
+  }
+  readAll(reader, &memory[0]);
+  reader.close();
+
+  BOOST_CHECK(!reader.open(filename + ".missing", 0, 4));
+  BOOST_CHECK(!reader.error().empty());
+  boost::filesystem::remove(filename);
+}
+
+#endif // QUICKFAST_HAS_IO_URING